@@ -562,6 +562,18 @@ Unable to run hostname to check the network')
     '''):
       self.addDefine('HAVE_MPI_PERSISTENT_NEIGHBORHOOD_COLLECTIVES', 1)
 
+    if self.checkLink('#include <mpi.h>\n',
+    '''
+      MPI_Request req;
+      MPI_Info    info = MPI_INFO_NULL;
+      int         buf[2] = {0};
+      if (MPI_Psend_init(buf,2,1,MPI_INT,1,0,MPI_COMM_WORLD,info,&req)) return 1;
+      if (MPI_Precv_init(buf,2,1,MPI_INT,1,0,MPI_COMM_WORLD,info,&req)) return 1;
+      if (MPI_Pready(0,req)) return 1;
+      if (MPI_Pready_range(0,1,req)) return 1;
+    '''):
+      self.addDefine('HAVE_MPI_PARTITIONED', 1)
+
     self.compilers.CPPFLAGS = oldFlags
     self.compilers.LIBS = oldLibs
     self.logWrite(self.framework.restoreLog())
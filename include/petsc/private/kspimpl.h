@@ -280,6 +280,7 @@ static inline PetscErrorCode KSPSetNoisy_Private(Mat A, Vec v)
 PETSC_INTERN PetscErrorCode KSPSetUpNorms_Private(KSP, PetscBool, KSPNormType *, PCSide *);
 
 PETSC_INTERN PetscErrorCode KSPPlotEigenContours_Private(KSP, PetscInt, const PetscReal *, const PetscReal *);
+PETSC_INTERN PetscErrorCode KSPSStepBasisSetUp_Private(KSPSStepBasisType, PetscInt, PetscInt, PetscReal[], PetscReal[], PetscScalar[], PetscScalar[], PetscScalar[]);
 
 typedef struct _p_DMKSP  *DMKSP;
 typedef struct _DMKSPOps *DMKSPOps;
@@ -477,6 +478,7 @@ static inline PetscErrorCode KSP_PCApplyBAorABTranspose(KSP ksp, Vec x, Vec y, V
 }
 
 PETSC_EXTERN PetscLogEvent KSP_GMRESOrthogonalization;
+PETSC_EXTERN PetscLogEvent KSP_GCRODRRecycle;
 PETSC_EXTERN PetscLogEvent KSP_SetUp;
 PETSC_EXTERN PetscLogEvent KSP_Solve;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_0;
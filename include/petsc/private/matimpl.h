@@ -385,6 +385,22 @@ struct _MatStash {
   MPI_Datatype    blocktype;
   size_t          blocktype_size;
   InsertMode     *insertmode; /* Pointer to check mat->insertmode and set upon message arrival in case no local values have been set. */
+
+  /* The following variables are used to replay the first BTS assembly with persistent requests, see -matstash_persistent */
+  PetscBool    persistent;            /* Record the communication pattern of the first assembly */
+  PetscBool    pready;                /* The pattern has been recorded and the persistent requests created */
+  PetscBool    pactive;               /* The current assembly uses the persistent requests */
+  InsertMode   pinsertmode;           /* InsertMode of the recorded assembly */
+  PetscInt     pn;                    /* Number of stashed entries in the recorded assembly */
+  PetscInt    *prow, *pcol;           /* Global row and column of each stashed entry, in stashing order */
+  PetscCount  *pmap;                  /* Send block each stashed entry is combined into */
+  PetscMPIInt  pnsends, pnrecvs;      /* Number of persistent sends and receives */
+  PetscInt    *psendoffset;           /* Offset of the blocks sent to each rank, of length pnsends+1 */
+  PetscInt    *precvoffset;           /* Offset of the blocks received from each rank, of length pnrecvs+1 */
+  PetscInt    *precvrow, *precvcol;   /* Global row and column of each received block */
+  PetscScalar *psendvals, *precvvals; /* Values of the send and receive blocks, bs2 each */
+  MPI_Request *preqs;                 /* Persistent receives followed by the persistent sends */
+  PetscMPIInt  precvcount;            /* Number of persistent receives processed so far */
 };
 
 #if !defined(PETSC_HAVE_MPIUNI)
@@ -505,6 +521,8 @@ struct _p_Mat {
   PetscBool            transupdated;            /* whether or not the explicitly generated transpose is up-to-date */
   char                *factorprefix;            /* the prefix to use with factored matrix that is created */
   PetscBool            hash_active;             /* indicates MatSetValues() is being handled by hashing */
+  PetscBool            threadsafe_setvalues;    /* set by MAT_THREAD_SAFE_SET_VALUES */
+  PetscSpinlock        setvalues_lock;          /* guards insertmode and assembled when MatSetValues() is called concurrently */
 };
 
 PETSC_INTERN PetscErrorCode MatAXPY_Basic(Mat, PetscScalar, Mat, MatStructure);
@@ -1672,6 +1690,7 @@ PETSC_SINGLE_LIBRARY_VISIBILITY_INTERNAL PetscErrorCode MatFDColoringApply_AIJ(M
 
 PETSC_EXTERN PetscLogEvent MAT_Mult;
 PETSC_EXTERN PetscLogEvent MAT_MultAdd;
+PETSC_EXTERN PetscLogEvent MAT_MatrixPowers;
 PETSC_EXTERN PetscLogEvent MAT_MultTranspose;
 PETSC_EXTERN PetscLogEvent MAT_MultHermitianTranspose;
 PETSC_EXTERN PetscLogEvent MAT_MultTransposeAdd;
@@ -1778,5 +1797,7 @@ PETSC_EXTERN PetscLogEvent MAT_H2Opus_Build;
 PETSC_EXTERN PetscLogEvent MAT_H2Opus_Compress;
 PETSC_EXTERN PetscLogEvent MAT_H2Opus_Orthog;
 PETSC_EXTERN PetscLogEvent MAT_H2Opus_LR;
+PETSC_EXTERN PetscLogEvent MAT_MultAVX2;
+PETSC_EXTERN PetscLogEvent MAT_MultAVX512;
 PETSC_EXTERN PetscLogEvent MAT_CUDACopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_HIPCopyToGPU;
@@ -48,6 +48,7 @@ typedef const char *KSPType;
 #define KSPPIPELCG    "pipelcg"
 #define KSPPIPEPRCG   "pipeprcg"
 #define KSPPIPECG2    "pipecg2"
+#define KSPSCG        "scg"
 #define KSPCGNE       "cgne"
 #define KSPNASH       "nash"
 #define KSPSTCG       "stcg"
@@ -63,6 +64,8 @@ typedef const char *KSPType;
 #define KSPLGMRES     "lgmres"
 #define KSPDGMRES     "dgmres"
 #define KSPPGMRES     "pgmres"
+#define KSPSGMRES     "sgmres"
+#define KSPGCRODR     "gcrodr"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define KSPIBCGS      "ibcgs"
@@ -322,6 +325,7 @@ PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP, PetscBool);
 PETSC_EXTERN PetscErrorCode KSPChebyshevSetKind(KSP, KSPChebyshevKind);
 PETSC_EXTERN PetscErrorCode KSPChebyshevGetKind(KSP, KSPChebyshevKind *);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigGetKSP(KSP, KSP *);
+PETSC_EXTERN PetscErrorCode KSPChebyshevSetUseMatrixPowers(KSP, PetscBool);
 PETSC_EXTERN PetscErrorCode KSPComputeExtremeSingularValues(KSP, PetscReal *, PetscReal *);
 PETSC_EXTERN PetscErrorCode KSPComputeEigenvalues(KSP, PetscInt, PetscReal[], PetscReal[], PetscInt *);
 PETSC_EXTERN PetscErrorCode KSPComputeEigenvaluesExplicitly(KSP, PetscInt, PetscReal[], PetscReal[]);
@@ -555,6 +559,40 @@ M*/
 PETSC_EXTERN PetscErrorCode KSPGMRESSetCGSRefinementType(KSP, KSPGMRESCGSRefinementType);
 PETSC_EXTERN PetscErrorCode KSPGMRESGetCGSRefinementType(KSP, KSPGMRESCGSRefinementType *);
 
+/*E
+   KSPSStepBasisType - The polynomial basis used by the s-step Krylov methods to generate `s` Krylov vectors at once
+
+   Values:
++  `KSP_SSTEP_BASIS_MONOMIAL`  - the monomial basis $v, Av, A^2v, \ldots$, whose vectors quickly become numerically linearly dependent
+.  `KSP_SSTEP_BASIS_NEWTON`    - the Newton basis $v, (A - \theta_0 I)v, (A - \theta_1 I)(A - \theta_0 I)v, \ldots$ with Leja ordered Ritz values $\theta_i$
+-  `KSP_SSTEP_BASIS_CHEBYSHEV` - the Chebyshev basis on the interval spanned by the real parts of the Ritz values
+
+   Level: advanced
+
+   Note:
+   The Ritz values are computed from `s` iterations of the standard method at the beginning of each solve.
+
+.seealso: [](ch_ksp), `KSP`, `KSPSGMRES`, `KSPSCG`, `KSPSGMRESSetBasisType()`, `KSPSCGSetBasisType()`
+E*/
+typedef enum {
+  KSP_SSTEP_BASIS_MONOMIAL,
+  KSP_SSTEP_BASIS_NEWTON,
+  KSP_SSTEP_BASIS_CHEBYSHEV
+} KSPSStepBasisType;
+PETSC_EXTERN const char *const KSPSStepBasisTypes[];
+
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetSteps(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSGMRESGetSteps(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetBasisType(KSP, KSPSStepBasisType);
+PETSC_EXTERN PetscErrorCode KSPSGMRESGetBasisType(KSP, KSPSStepBasisType *);
+PETSC_EXTERN PetscErrorCode KSPSCGSetSteps(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSCGGetSteps(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPSCGSetBasisType(KSP, KSPSStepBasisType);
+PETSC_EXTERN PetscErrorCode KSPSCGGetBasisType(KSP, KSPSStepBasisType *);
+
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleDimension(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleDimension(KSP, PetscInt *);
+
 PETSC_EXTERN KSPFlexibleModifyPCFn KSPFGMRESModifyPCNoChange;
 PETSC_EXTERN KSPFlexibleModifyPCFn KSPFGMRESModifyPCKSP;
 PETSC_EXTERN PetscErrorCode        KSPFGMRESSetModifyPC(KSP, KSPFlexibleModifyPCFn *, void *, PetscCtxDestroyFn *);
@@ -1334,6 +1372,7 @@ PETSC_EXTERN PetscErrorCode DMCheckInterpolator(DM, Mat, Mat, Mat, PetscReal);
 
 PETSC_EXTERN PetscErrorCode PCBJKOKKOSSetKSP(PC, KSP);
 PETSC_EXTERN PetscErrorCode PCBJKOKKOSGetKSP(PC, KSP *);
+PETSC_EXTERN PetscErrorCode PCBJBATCHGetKSP(PC, KSP *);
 
 PETSC_EXTERN PetscErrorCode DMCopyDMKSP(DM, DM);
 
@@ -194,6 +194,7 @@ PETSC_DEPRECATED_FUNCTION(3, 18, 0, "PetscLogObjectMemory()", ) static inline Pe
 
 /* Global flop counter */
 PETSC_EXTERN PetscLogDouble petsc_TotalFlops;
+PETSC_EXTERN PetscLogDouble petsc_TotalBytes;
 PETSC_EXTERN PetscLogDouble petsc_irecv_ct;
 PETSC_EXTERN PetscLogDouble petsc_isend_ct;
 PETSC_EXTERN PetscLogDouble petsc_recv_ct;
@@ -212,6 +213,7 @@ PETSC_EXTERN PetscLogDouble petsc_sum_of_waits_ct;
 
 /* Thread local storage */
 PETSC_EXTERN_TLS PetscLogDouble petsc_TotalFlops_th;
+PETSC_EXTERN_TLS PetscLogDouble petsc_TotalBytes_th;
 PETSC_EXTERN_TLS PetscLogDouble petsc_irecv_ct_th;
 PETSC_EXTERN_TLS PetscLogDouble petsc_isend_ct_th;
 PETSC_EXTERN_TLS PetscLogDouble petsc_recv_ct_th;
@@ -269,6 +271,8 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject, const char[], ...)
 PETSC_EXTERN PetscErrorCode PetscLogDefaultBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogNestedBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogTraceBegin(FILE *);
+PETSC_EXTERN PetscErrorCode PetscLogSampleBegin(void);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogMPEBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogPerfstubsBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogLegacyCallbacksBegin(PetscErrorCode (*)(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject), PetscErrorCode (*)(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject), PetscErrorCode (*)(PetscObject), PetscErrorCode (*)(PetscObject));
@@ -281,6 +285,8 @@ PETSC_EXTERN PetscErrorCode PetscLogView(PetscViewer);
 PETSC_EXTERN PetscErrorCode PetscLogViewFromOptions(void);
 PETSC_EXTERN PetscErrorCode PetscLogDump(const char[]);
 PETSC_EXTERN PetscErrorCode PetscLogMPEDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogSampleDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineDump(const char[]);
 
 PETSC_EXTERN PetscErrorCode PetscLogGetState(PetscLogState *);
 PETSC_EXTERN PetscErrorCode PetscLogGetDefaultHandler(PetscLogHandler *);
@@ -438,6 +444,27 @@ static inline PetscErrorCode PetscLogFlops(PetscLogDouble n)
   return PetscAddLogDouble(&petsc_TotalFlops, &petsc_TotalFlops_th, PETSC_FLOPS_PER_OP * n);
 }
 
+/*@
+   PetscLogBytes - Log an estimate of how many bytes a calculation moves between the memory and the processor
+
+   Input Parameter:
+.   n - the number of bytes
+
+   Level: developer
+
+   Note:
+   The estimate is the size of the data a kernel must read and write at least once, for example the values, the column indices,
+   and the vectors of a sparse matrix-vector product. `-log_view_roofline` uses it to compare the memory bandwidth and the flop rate of each
+   event with the bandwidth of the machine.
+
+.seealso: [](ch_profiling), `PetscLogView()`, `PetscLogFlops()`
+@*/
+static inline PetscErrorCode PetscLogBytes(PetscLogDouble n)
+{
+  PetscAssert(n >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Cannot log negative bytes");
+  return PetscAddLogDouble(&petsc_TotalBytes, &petsc_TotalBytes_th, n);
+}
+
   /*
      These are used internally in the PETSc routines to keep a count of MPI messages and
    their sizes.
@@ -617,6 +644,7 @@ static inline int PetscMPIParallelComm(MPI_Comm comm)
   #define PetscLogHandlerStop(a)       ((void)(a), PETSC_SUCCESS)
 
   #define PetscLogFlops(n) ((void)(n), PETSC_SUCCESS)
+  #define PetscLogBytes(n) ((void)(n), PETSC_SUCCESS)
   #define PetscGetFlops(a) (*(a) = 0.0, PETSC_SUCCESS)
 
   #define PetscLogStageRegister(a, b)    ((void)(a), *(b) = -1, PETSC_SUCCESS)
@@ -660,6 +688,8 @@ static inline int PetscMPIParallelComm(MPI_Comm comm)
   #define PetscLogDefaultBegin()                   PETSC_SUCCESS
   #define PetscLogNestedBegin()                    PETSC_SUCCESS
   #define PetscLogTraceBegin(file)                 ((void)(file), PETSC_SUCCESS)
+  #define PetscLogSampleBegin()                    PETSC_SUCCESS
+  #define PetscLogTimelineBegin()                  PETSC_SUCCESS
   #define PetscLogMPEBegin()                       PETSC_SUCCESS
   #define PetscLogPerfstubsBegin()                 PETSC_SUCCESS
   #define PetscLogLegacyCallbacksBegin(a, b, c, d) ((void)(a), (void)(b), (void)(c), (void)(d), PETSC_SUCCESS)
@@ -673,6 +703,8 @@ static inline int PetscMPIParallelComm(MPI_Comm comm)
   #define PetscLogViewFromOptions() PETSC_SUCCESS
   #define PetscLogDump(c)           ((void)(c), PETSC_SUCCESS)
   #define PetscLogMPEDump(c)        ((void)(c), PETSC_SUCCESS)
+  #define PetscLogSampleDump(c)     ((void)(c), PETSC_SUCCESS)
+  #define PetscLogTimelineDump(c)   ((void)(c), PETSC_SUCCESS)
 
   #define PetscLogEventSync(e, comm)                            ((void)(e), (void)(comm), PETSC_SUCCESS)
   #define PetscLogEventBegin(e, o1, o2, o3, o4)                 ((void)(e), (void)(o1), (void)(o2), (void)(o3), PETSC_SUCCESS)
@@ -33,6 +33,7 @@ typedef struct {
   PetscLogDouble numMessages;         /* The number of messages in this event */
   PetscLogDouble messageLength;       /* The total message lengths in this event */
   PetscLogDouble numReductions;       /* The number of reductions in this event */
+  PetscLogDouble bytes;               /* The memory traffic in this event estimated with PetscLogBytes() */
   PetscLogDouble memIncrease;         /* How much the resident memory has increased in this event */
   PetscLogDouble mallocIncrease;      /* How much the maximum malloced space has increased in this event */
   PetscLogDouble mallocSpace;         /* How much the space was malloced and kept during this event */
@@ -134,6 +135,8 @@ typedef struct _p_PetscLogHandler *PetscLogHandler;
 + `PETSCLOGHANDLERDEFAULT` (`PetscLogDefaultBegin()`)        - formats data for PETSc's default summary (`PetscLogView()`) and data-dump (`PetscLogDump()`) formats.
 . `PETSCLOGHANDLERNESTED` (`PetscLogNestedBegin()`)          - formats data for XML or flamegraph output
 . `PETSCLOGHANDLERTRACE` (`PetscLogTraceBegin()`)            - traces profiling events in an output stream
+. `PETSCLOGHANDLERSAMPLE` (`PetscLogSampleBegin()`)          - samples the stack of active events with a timer signal
+. `PETSCLOGHANDLERTIMELINE` (`PetscLogTimelineBegin()`)      - records the events of each process for a Chrome trace-event timeline
 . `PETSCLOGHANDLERMPE` (`PetscLogMPEBegin()`)                - outputs parallel performance visualization using MPE
 . `PETSCLOGHANDLERPERFSTUBS` (`PetscLogPerfstubsBegin()`)    - outputs instrumentation data for PerfStubs/TAU
 . `PETSCLOGHANDLERLEGACY` (`PetscLogLegacyCallbacksBegin()`) - adapts legacy callbacks to the `PetscLogHandler` interface
@@ -146,6 +149,8 @@ typedef const char *PetscLogHandlerType;
 #define PETSCLOGHANDLERDEFAULT   "default"
 #define PETSCLOGHANDLERNESTED    "nested"
 #define PETSCLOGHANDLERTRACE     "trace"
+#define PETSCLOGHANDLERSAMPLE    "sample"
+#define PETSCLOGHANDLERTIMELINE  "timeline"
 #define PETSCLOGHANDLERMPE       "mpe"
 #define PETSCLOGHANDLERPERFSTUBS "perfstubs"
 #define PETSCLOGHANDLERLEGACY    "legacy"
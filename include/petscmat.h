@@ -66,6 +66,9 @@ typedef const char *MatType;
 #define MATAIJSELL                   "aijsell"
 #define MATSEQAIJSELL                "seqaijsell"
 #define MATMPIAIJSELL                "mpiaijsell"
+#define MATAIJSINGLE                 "aijsingle"
+#define MATSEQAIJSINGLE              "seqaijsingle"
+#define MATMPIAIJSINGLE              "mpiaijsingle"
 #define MATAIJMKL                    "aijmkl"
 #define MATSEQAIJMKL                 "seqaijmkl"
 #define MATMPIAIJMKL                 "mpiaijmkl"
@@ -430,6 +433,8 @@ PETSC_EXTERN PetscErrorCode MatSeqSELLGetVarSliceSize(Mat, PetscReal *);
 
 PETSC_EXTERN PetscErrorCode MatCreateSeqAIJSELL(MPI_Comm, PetscInt, PetscInt, PetscInt, const PetscInt[], Mat *);
 PETSC_EXTERN PetscErrorCode MatCreateMPIAIJSELL(MPI_Comm, PetscInt, PetscInt, PetscInt, PetscInt, PetscInt, const PetscInt[], PetscInt, const PetscInt[], Mat *);
+PETSC_EXTERN PetscErrorCode MatCreateSeqAIJSingle(MPI_Comm, PetscInt, PetscInt, PetscInt, const PetscInt[], Mat *);
+PETSC_EXTERN PetscErrorCode MatCreateMPIAIJSingle(MPI_Comm, PetscInt, PetscInt, PetscInt, PetscInt, PetscInt, const PetscInt[], PetscInt, const PetscInt[], Mat *);
 PETSC_EXTERN PetscErrorCode MatMPISELLGetLocalMatCondensed(Mat, MatReuse, IS *, IS *, Mat *);
 PETSC_EXTERN PetscErrorCode MatMPISELLGetSeqSELL(Mat, Mat *, Mat *, const PetscInt *[]);
 
@@ -647,7 +652,8 @@ typedef enum {
   MAT_FORM_EXPLICIT_TRANSPOSE     = 24,
   MAT_STRUCTURAL_SYMMETRY_ETERNAL = 25,
   MAT_SPD_ETERNAL                 = 26,
-  MAT_OPTION_MAX                  = 27
+  MAT_THREAD_SAFE_SET_VALUES      = 27,
+  MAT_OPTION_MAX                  = 28
 } MatOption;
 
 PETSC_EXTERN const char *const *MatOptions;
@@ -721,6 +727,7 @@ PETSC_EXTERN PetscErrorCode MatIsTranspose(Mat, Mat, PetscReal, PetscBool *);
 PETSC_EXTERN PetscErrorCode MatIsHermitianTranspose(Mat, Mat, PetscReal, PetscBool *);
 PETSC_EXTERN PetscErrorCode MatMultTransposeAdd(Mat, Vec, Vec, Vec);
 PETSC_EXTERN PetscErrorCode MatMultHermitianTransposeAdd(Mat, Vec, Vec, Vec);
+PETSC_EXTERN PetscErrorCode MatMatrixPowers(Mat, PetscInt, Vec, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec, Vec[]);
 PETSC_EXTERN PetscErrorCode MatMatSolve(Mat, Mat, Mat);
 PETSC_EXTERN PetscErrorCode MatMatSolveTranspose(Mat, Mat, Mat);
 PETSC_EXTERN PetscErrorCode MatMatTransposeSolve(Mat, Mat, Mat);
@@ -904,6 +911,7 @@ PETSC_EXTERN PetscErrorCode MatGetGhosts(Mat, PetscInt *, const PetscInt *[]);
 PETSC_EXTERN PetscErrorCode MatIncreaseOverlap(Mat, PetscInt, IS[], PetscInt);
 PETSC_EXTERN PetscErrorCode MatIncreaseOverlapSplit(Mat, PetscInt, IS[], PetscInt);
 PETSC_EXTERN PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat, PetscBool);
+PETSC_EXTERN PetscErrorCode MatMPIAIJSetUseSplitMult(Mat, PetscBool);
 
 PETSC_EXTERN PetscErrorCode MatMatMult(Mat, Mat, MatReuse, PetscReal, Mat *);
 
@@ -1544,6 +1552,8 @@ typedef struct {
   PetscReal shiftamount;   /* how large the shift is */
   PetscBool factoronhost;  /* do factorization on host instead of device (for device matrix types) */
   PetscBool solveonhost;   /* do mat solve on host with the factor (for device matrix types) */
+  /* compute and store the factor in single precision, the solves accumulate in PetscScalar */
+  PetscBool singleprecision;
 } MatFactorInfo;
 
 PETSC_EXTERN PetscErrorCode MatFactorInfoInitialize(MatFactorInfo *);
@@ -24,14 +24,17 @@ typedef struct _p_PetscSF *PetscSF;
 .seealso: `PetscSFSetType()`, `PetscSF`
 J*/
 typedef const char *PetscSFType;
-#define PETSCSFBASIC      "basic"
-#define PETSCSFNEIGHBOR   "neighbor"
-#define PETSCSFALLGATHERV "allgatherv"
-#define PETSCSFALLGATHER  "allgather"
-#define PETSCSFGATHERV    "gatherv"
-#define PETSCSFGATHER     "gather"
-#define PETSCSFALLTOALL   "alltoall"
-#define PETSCSFWINDOW     "window"
+#define PETSCSFBASIC        "basic"
+#define PETSCSFNEIGHBOR     "neighbor"
+#define PETSCSFALLGATHERV   "allgatherv"
+#define PETSCSFALLGATHER    "allgather"
+#define PETSCSFGATHERV      "gatherv"
+#define PETSCSFGATHER       "gather"
+#define PETSCSFALLTOALL     "alltoall"
+#define PETSCSFWINDOW       "window"
+#define PETSCSFSHMEM        "shmem"
+#define PETSCSFHIERARCHICAL "hierarchical"
+#define PETSCSFAUTO         "auto"
 
 /*S
    PetscSFNode - specifier of owner and index
@@ -127,6 +127,7 @@ PETSC_EXTERN PetscErrorCode PetscViewerCheckWritable(PetscViewer);
                                         matrices are stored as dense), `DMDA` vectors are dumped directly to the
                                         file instead of being first put in the natural ordering
 .    `PETSC_VIEWER_ASCII_LATEX`       - output the data in LaTeX
+.    `PETSC_VIEWER_ASCII_JSON`        - output the data as a JSON document
 .    `PETSC_VIEWER_BINARY_MATLAB`     - output additional information that can be used to read the data into MATLAB
 .    `PETSC_VIEWER_DRAW_BASIC`        - views the vector with a simple 1d plot
 .    `PETSC_VIEWER_DRAW_LG`           - views the vector with a line graph
@@ -159,6 +160,7 @@ typedef enum {
   PETSC_VIEWER_ASCII_FLAMEGRAPH,
   PETSC_VIEWER_ASCII_GLVIS,
   PETSC_VIEWER_ASCII_CSV,
+  PETSC_VIEWER_ASCII_JSON,
   PETSC_VIEWER_DRAW_BASIC,
   PETSC_VIEWER_DRAW_LG,
   PETSC_VIEWER_DRAW_LG_XRANGE,
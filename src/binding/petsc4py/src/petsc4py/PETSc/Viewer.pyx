@@ -40,6 +40,7 @@ class ViewerFormat(object):
     ASCII_XML         = PETSC_VIEWER_ASCII_XML
     ASCII_GLVIS       = PETSC_VIEWER_ASCII_GLVIS
     ASCII_CSV         = PETSC_VIEWER_ASCII_CSV
+    ASCII_JSON        = PETSC_VIEWER_ASCII_JSON
     DRAW_BASIC        = PETSC_VIEWER_DRAW_BASIC
     DRAW_LG           = PETSC_VIEWER_DRAW_LG
     DRAW_LG_XRANGE    = PETSC_VIEWER_DRAW_LG_XRANGE
@@ -37,6 +37,7 @@ cdef extern from * nogil:
         PETSC_VIEWER_ASCII_XML
         PETSC_VIEWER_ASCII_GLVIS
         PETSC_VIEWER_ASCII_CSV
+        PETSC_VIEWER_ASCII_JSON
         PETSC_VIEWER_DRAW_BASIC
         PETSC_VIEWER_DRAW_LG
         PETSC_VIEWER_DRAW_LG_XRANGE
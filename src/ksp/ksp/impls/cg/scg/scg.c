@@ -0,0 +1,572 @@
+/*
+    This file implements s-step, or communication-avoiding, conjugate gradients {cite}`chronopoulos_gear_1989`
+
+    Each outer iteration generates the bases
+       V = [p, (BA) p, ..., (BA)^s p, z, (BA) z, ..., (BA)^{s-1} z]  and  W = B^{-1} V
+    of the preconditioned and unpreconditioned spaces, where the powers stand for the three-term recurrence of
+    KSPSStepBasisSetUp_Private(), and computes the Gram matrix G = V^H W with a single reduction. The s inner iterations of
+    preconditioned CG then only update the coordinates of x, r, and p in these bases, since BA V = V Bm and A V = W Bm with the
+    change of basis matrix Bm, and (r, z) = r'^H G r', (p, Ap) = p'^H G Bm p'.
+*/
+
+#include <petsc/private/kspimpl.h>
+#include <petscblaslapack.h>
+
+#define SCG_DEFAULT_S 4
+
+typedef struct {
+  PetscInt          s;                     /* number of iterations per outer iteration */
+  KSPSStepBasisType basis;                 /* polynomial basis used to generate the Krylov vectors */
+  PetscBool         haveshifts;            /* the basis coefficients have been computed from Ritz values */
+  PetscScalar      *gamma, *alpha, *delta; /* coefficients of the three-term recurrence generating the basis */
+  Vec              *V, *W;                 /* 2s + 1 basis vectors and two spare vectors in each space */
+  PetscScalar      *G, *Gn;                /* Gram matrix V^H W and the one defining the residual norm, (2s + 1) x (2s + 1) */
+  PetscScalar      *Bm;                    /* change of basis matrix, (2s + 1) x (2s + 1) */
+  PetscScalar      *xc, *rc, *pc, *wc;     /* coordinates of the correction to x, of r, p, and Ap */
+  PetscInt          nx;                    /* number of coordinates of a correction to x that is not yet in ksp->vec_sol */
+  PetscReal        *la, *lb;               /* CG coefficients of the first s iterations, they define the Lanczos matrix */
+  PetscInt          nl;                    /* number of CG coefficients collected */
+  Vec               sol_temp;
+} KSP_SCG;
+
+static PetscErrorCode KSPSetUp_SCG(KSP ksp)
+{
+  KSP_SCG *scg = (KSP_SCG *)ksp->data;
+  PetscInt s = scg->s, n = 2 * s + 1;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCreateVecs(ksp, n + 2, &scg->V, n + 2, &scg->W));
+  PetscCall(PetscMalloc3(s, &scg->gamma, s, &scg->alpha, s, &scg->delta));
+  PetscCall(PetscMalloc7(n * n, &scg->G, n * n, &scg->Gn, n * n, &scg->Bm, n, &scg->xc, n, &scg->rc, n, &scg->pc, n, &scg->wc));
+  PetscCall(PetscMalloc2(s, &scg->la, s, &scg->lb));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_SCG(KSP ksp)
+{
+  KSP_SCG *scg = (KSP_SCG *)ksp->data;
+  PetscInt n   = 2 * scg->s + 1;
+
+  PetscFunctionBegin;
+  if (scg->V) PetscCall(VecDestroyVecs(n + 2, &scg->V));
+  if (scg->W) PetscCall(VecDestroyVecs(n + 2, &scg->W));
+  PetscCall(VecDestroy(&scg->sol_temp));
+  PetscCall(PetscFree3(scg->gamma, scg->alpha, scg->delta));
+  PetscCall(PetscFree7(scg->G, scg->Gn, scg->Bm, scg->xc, scg->rc, scg->pc, scg->wc));
+  PetscCall(PetscFree2(scg->la, scg->lb));
+  scg->nx = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_SCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_SCG(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGSetSteps_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGGetSteps_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGSetBasisType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGGetBasisType_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* x^H G y for the n x n matrix G */
+static PetscScalar KSPSCGInnerProduct_Private(PetscInt n, const PetscScalar *x, const PetscScalar *G, const PetscScalar *y)
+{
+  PetscScalar sum = 0.0;
+
+  for (PetscInt j = 0; j < n; j++) {
+    PetscScalar gy = 0.0;
+
+    if (y[j] == 0.0) continue;
+    for (PetscInt i = 0; i < n; i++) gy += PetscConj(x[i]) * G[i + j * n];
+    sum += gy * y[j];
+  }
+  return sum;
+}
+
+/* The eigenvalues of the Lanczos matrix of the first s iterations define the shifts of the Newton and Chebyshev bases */
+static PetscErrorCode KSPSCGComputeShifts(KSP ksp)
+{
+  KSP_SCG     *scg = (KSP_SCG *)ksp->data;
+  PetscInt     s   = scg->s;
+  PetscReal   *d, *e, *im, *work;
+  PetscScalar  sdummy = 0.0;
+  PetscBLASInt bs, ldz = 1, info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscBLASIntCast(s, &bs));
+  PetscCall(PetscCalloc4(s, &d, s, &e, s, &im, 2 * s, &work));
+  for (PetscInt i = 0; i < s; i++) {
+    d[i] = 1.0 / scg->la[i] + (i ? scg->lb[i - 1] / scg->la[i - 1] : 0.0);
+    if (i) e[i - 1] = PetscSqrtReal(PetscAbsReal(scg->lb[i - 1])) / scg->la[i - 1];
+  }
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKstev", LAPACKstev_("N", &bs, d, e, &sdummy, &ldz, work, &info));
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, info);
+  PetscCall(KSPSStepBasisSetUp_Private(scg->basis, s, s, d, im, scg->gamma, scg->alpha, scg->delta));
+  PetscCall(PetscFree4(d, e, im, work));
+  scg->haveshifts = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Generates the k vectors following V[j0] and W[j0] with the recurrence, V = B W */
+static PetscErrorCode KSPSCGGenerateBasis(KSP ksp, Mat Amat, PetscInt j0, PetscInt k)
+{
+  KSP_SCG     *scg = (KSP_SCG *)ksp->data;
+  Vec         *V = scg->V + j0, *W = scg->W + j0;
+  PetscScalar *gamma = scg->gamma, *alpha = scg->alpha, *delta = scg->delta;
+
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < k; j++) {
+    PetscCall(KSP_MatMult(ksp, Amat, V[j], W[j + 1]));
+    if (j && delta[j] != 0.0) PetscCall(VecAXPBYPCZ(W[j + 1], -gamma[j] * alpha[j], -gamma[j] * delta[j], gamma[j], W[j], W[j - 1]));
+    else if (alpha[j] != 0.0 || gamma[j] != 1.0) PetscCall(VecAXPBY(W[j + 1], -gamma[j] * alpha[j], gamma[j], W[j]));
+    PetscCall(KSP_PCApply(ksp, W[j + 1], V[j + 1]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_SCG(KSP ksp)
+{
+  KSP_SCG     *scg = (KSP_SCG *)ksp->data;
+  PetscInt     s = scg->s, sc, n, np = 2 * s + 1, np2 = 2 * s + 2;
+  PetscScalar *G = scg->G, *Gn = scg->Gn, *Bm = scg->Bm, *xc = scg->xc, *rc = scg->rc, *pc = scg->pc, *wc = scg->wc;
+  PetscScalar  rz = 0.0;
+  PetscReal    dp = 0.0;
+  Vec          X, B, *V = scg->V, *W = scg->W;
+  Mat          Amat, Pmat;
+  PetscBool    diagonalscale;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+
+  X = ksp->vec_sol;
+  B = ksp->vec_rhs;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+
+  /* the shifts are recomputed for each solve since the operator may have changed */
+  PetscCall(KSPSStepBasisSetUp_Private(scg->basis, s, 0, NULL, NULL, scg->gamma, scg->alpha, scg->delta));
+  scg->haveshifts = PETSC_FALSE;
+  scg->nl         = 0;
+  scg->nx         = 0;
+  /* until the Ritz values that define the shifts of the Newton and Chebyshev bases are known, do one iteration at a time */
+  sc = scg->basis == KSP_SSTEP_BASIS_MONOMIAL ? s : 1;
+
+  /* V[0] = p, W[0] = B^{-1} p, V[sc + 1] = z, W[sc + 1] = r */
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, X, W[sc + 1])); /*     r <- b - Ax     */
+    PetscCall(VecAYPX(W[sc + 1], -1.0, B));
+  } else {
+    PetscCall(VecCopy(B, W[sc + 1])); /*     r <- b (x is 0) */
+  }
+  PetscCall(KSP_PCApply(ksp, W[sc + 1], V[sc + 1])); /*     z <- Br         */
+  PetscCall(VecCopy(V[sc + 1], V[0]));
+  PetscCall(VecCopy(W[sc + 1], W[0]));
+
+  switch (ksp->normtype) {
+  case KSP_NORM_PRECONDITIONED:
+    PetscCall(VecNorm(V[sc + 1], NORM_2, &dp)); /*     dp <- z'*z       */
+    break;
+  case KSP_NORM_UNPRECONDITIONED:
+    PetscCall(VecNorm(W[sc + 1], NORM_2, &dp)); /*     dp <- r'*r       */
+    break;
+  case KSP_NORM_NATURAL:
+    PetscCall(VecDot(W[sc + 1], V[sc + 1], &rz)); /*     rz <- r'*z       */
+    KSPCheckDot(ksp, rz);
+    dp = PetscSqrtReal(PetscAbsScalar(rz));
+    break;
+  case KSP_NORM_NONE:
+    dp = 0.0;
+    break;
+  default:
+    SETERRQ(PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "%s", KSPNormTypes[ksp->normtype]);
+  }
+  PetscCall(KSPLogResidualHistory(ksp, dp));
+  PetscCall(KSPMonitor(ksp, 0, dp));
+  ksp->rnorm = dp;
+  PetscCall((*ksp->converged)(ksp, 0, dp, &ksp->reason, ksp->cnvP)); /* test for convergence */
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+
+  while (!ksp->reason) {
+    PetscInt scnext;
+
+    n = 2 * sc + 1;
+    /* the bases, p-part in the columns 0, ..., sc and r-part in the columns sc + 1, ..., 2 sc */
+    PetscCall(KSPSCGGenerateBasis(ksp, Amat, 0, sc));
+    PetscCall(KSPSCGGenerateBasis(ksp, Amat, sc + 1, sc - 1));
+
+    /* a single reduction computes the upper triangles of the Gram matrices */
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(VecMDotBegin(W[j], j + 1, V, G + j * n));
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecMDotBegin(W[j], j + 1, W, Gn + j * n));
+      else if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecMDotBegin(V[j], j + 1, V, Gn + j * n));
+    }
+    PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)X)));
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(VecMDotEnd(W[j], j + 1, V, G + j * n));
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecMDotEnd(W[j], j + 1, W, Gn + j * n));
+      else if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecMDotEnd(V[j], j + 1, V, Gn + j * n));
+    }
+    for (PetscInt j = 0; j < n; j++) {
+      for (PetscInt i = j + 1; i < n; i++) {
+        G[i + j * n] = PetscConj(G[j + i * n]);
+        if (ksp->normtype == KSP_NORM_PRECONDITIONED || ksp->normtype == KSP_NORM_UNPRECONDITIONED) Gn[i + j * n] = PetscConj(Gn[j + i * n]);
+      }
+    }
+
+    /* A V = W Bm, the columns sc and 2 sc, of the last vectors of both parts, are never used */
+    PetscCall(PetscArrayzero(Bm, n * n));
+    for (PetscInt j = 0; j < sc; j++) {
+      for (PetscInt c = j; c < n - 1; c += sc + 1) {
+        Bm[c + 1 + c * n] = 1.0 / scg->gamma[j];
+        Bm[c + c * n]     = scg->alpha[j];
+        if (j) Bm[c - 1 + c * n] = scg->delta[j];
+      }
+    }
+
+    PetscCall(PetscArrayzero(xc, n));
+    PetscCall(PetscArrayzero(rc, n));
+    PetscCall(PetscArrayzero(pc, n));
+    pc[0]      = 1.0;
+    rc[sc + 1] = 1.0;
+    rz         = G[sc + 1 + (sc + 1) * n];
+    scg->nx    = n;
+    for (PetscInt j = 0; j < sc; j++) {
+      PetscScalar a, b, rznew, pAp;
+
+      for (PetscInt i = 0; i < n; i++) {
+        wc[i] = 0.0;
+        for (PetscInt l = PetscMax(i - 1, 0); l <= PetscMin(i + 1, n - 1); l++) wc[i] += Bm[i + l * n] * pc[l];
+      }
+      pAp = KSPSCGInnerProduct_Private(n, pc, G, wc); /*     pAp <- p'*A*p    */
+      KSPCheckDot(ksp, pAp);
+      if (PetscRealPart(pAp) <= 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite matrix, pAp %g", (double)PetscRealPart(pAp));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        PetscCall(PetscInfo(ksp, "diverging due to indefinite matrix\n"));
+        break;
+      }
+      a = rz / pAp;
+      for (PetscInt i = 0; i < n; i++) {
+        xc[i] += a * pc[i]; /*     x <- x + a p     */
+        rc[i] -= a * wc[i]; /*     r <- r - a Ap    */
+      }
+      rznew = KSPSCGInnerProduct_Private(n, rc, G, rc); /*     rz <- r'*z       */
+      KSPCheckDot(ksp, rznew);
+      if (PetscRealPart(rznew) < 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite preconditioner, rz %g", (double)PetscRealPart(rznew));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        PetscCall(PetscInfo(ksp, "diverging due to indefinite preconditioner\n"));
+        break;
+      }
+      b = rznew / rz;
+      for (PetscInt i = 0; i < n; i++) pc[i] = rc[i] + b * pc[i]; /*     p <- r + b p     */
+      rz = rznew;
+      if (!scg->haveshifts && scg->nl < s) {
+        scg->la[scg->nl]   = PetscRealPart(a);
+        scg->lb[scg->nl++] = PetscRealPart(b);
+      }
+
+      switch (ksp->normtype) {
+      case KSP_NORM_PRECONDITIONED:
+      case KSP_NORM_UNPRECONDITIONED:
+        dp = PetscSqrtReal(PetscAbsScalar(KSPSCGInnerProduct_Private(n, rc, Gn, rc)));
+        break;
+      case KSP_NORM_NATURAL:
+        dp = PetscSqrtReal(PetscAbsScalar(rz));
+        break;
+      default:
+        dp = 0.0;
+      }
+      ksp->its++;
+      ksp->rnorm = dp;
+      PetscCall(KSPLogResidualHistory(ksp, dp));
+      PetscCall(KSPMonitor(ksp, ksp->its, dp));
+      PetscCall((*ksp->converged)(ksp, ksp->its, dp, &ksp->reason, ksp->cnvP));
+      if (!ksp->reason && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+      if (ksp->reason) break;
+    }
+
+    /* x <- x + V x' */
+    PetscCall(VecMAXPY(X, n, xc, V));
+    scg->nx = 0;
+    if (ksp->reason) break;
+
+    if (!scg->haveshifts && scg->basis != KSP_SSTEP_BASIS_MONOMIAL && scg->nl == s) PetscCall(KSPSCGComputeShifts(ksp));
+    scnext = scg->haveshifts || scg->basis == KSP_SSTEP_BASIS_MONOMIAL ? s : 1;
+
+    /* p <- V p', B^{-1} p <- W p', z <- V r', r <- W r' in the spare vectors, then move them to their place in the next bases */
+    PetscCall(VecMAXPBY(V[np], n, pc, 0.0, V));
+    PetscCall(VecMAXPBY(W[np], n, pc, 0.0, W));
+    PetscCall(VecMAXPBY(V[np2], n, rc, 0.0, V));
+    PetscCall(VecMAXPBY(W[np2], n, rc, 0.0, W));
+    {
+      Vec t;
+
+      t             = V[0];
+      V[0]          = V[np];
+      V[np]         = t;
+      t             = W[0];
+      W[0]          = W[np];
+      W[np]         = t;
+      t             = V[scnext + 1];
+      V[scnext + 1] = V[np2];
+      V[np2]        = t;
+      t             = W[scnext + 1];
+      W[scnext + 1] = W[np2];
+      W[np2]        = t;
+    }
+    sc = scnext;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the solution includes the correction of the current outer iteration that has not yet been added to ksp->vec_sol */
+static PetscErrorCode KSPBuildSolution_SCG(KSP ksp, Vec ptr, Vec *result)
+{
+  KSP_SCG *scg = (KSP_SCG *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!scg->nx) {
+    PetscCall(KSPBuildSolutionDefault(ksp, ptr, result));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (!ptr) {
+    if (!scg->sol_temp) PetscCall(VecDuplicate(ksp->vec_sol, &scg->sol_temp));
+    ptr = scg->sol_temp;
+  }
+  PetscCall(VecCopy(ksp->vec_sol, ptr));
+  PetscCall(VecMAXPY(ptr, scg->nx, scg->xc, scg->V));
+  if (result) *result = ptr;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_SCG(KSP ksp, PetscViewer viewer)
+{
+  KSP_SCG  *scg = (KSP_SCG *)ksp->data;
+  PetscBool iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  %" PetscInt_FMT " steps per outer iteration using the %s basis\n", scg->s, KSPSStepBasisTypes[scg->basis]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_SCG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_SCG          *scg = (KSP_SCG *)ksp->data;
+  PetscInt          s;
+  KSPSStepBasisType basis;
+  PetscBool         flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP s-step CG Options");
+  PetscCall(PetscOptionsInt("-ksp_scg_steps", "Number of iterations per outer iteration", "KSPSCGSetSteps", scg->s, &s, &flg));
+  if (flg) PetscCall(KSPSCGSetSteps(ksp, s));
+  PetscCall(PetscOptionsEnum("-ksp_scg_basis", "Polynomial basis used to generate the Krylov vectors", "KSPSCGSetBasisType", KSPSStepBasisTypes, (PetscEnum)scg->basis, (PetscEnum *)&basis, &flg));
+  if (flg) PetscCall(KSPSCGSetBasisType(ksp, basis));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSCGSetSteps_SCG(KSP ksp, PetscInt s)
+{
+  KSP_SCG *scg = (KSP_SCG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(s >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The number of steps must be positive");
+  if (!ksp->setupstage) {
+    scg->s = s;
+  } else if (scg->s != s) {
+    /* free the data structures with the old sizes, then create them again */
+    PetscCall(KSPReset_SCG(ksp));
+    scg->s          = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSCGGetSteps_SCG(KSP ksp, PetscInt *s)
+{
+  PetscFunctionBegin;
+  *s = ((KSP_SCG *)ksp->data)->s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSCGSetBasisType_SCG(KSP ksp, KSPSStepBasisType basis)
+{
+  PetscFunctionBegin;
+  ((KSP_SCG *)ksp->data)->basis = basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSCGGetBasisType_SCG(KSP ksp, KSPSStepBasisType *basis)
+{
+  PetscFunctionBegin;
+  *basis = ((KSP_SCG *)ksp->data)->basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSCGSetSteps - Sets the number of iterations of `KSPSCG` per outer iteration, that is per global reduction
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space solver context
+- s   - the number of steps
+
+  Options Database Key:
+. -ksp_scg_steps <s> - the number of steps
+
+  Level: intermediate
+
+  Note:
+  The default is 4. Each outer iteration stores `2s + 1` vectors in both the preconditioned and the unpreconditioned spaces and
+  the basis they form becomes more ill-conditioned as `s` grows, which delays the convergence compared to `KSPCG`.
+
+.seealso: [](ch_ksp), `KSPSCG`, `KSPSCGGetSteps()`, `KSPSCGSetBasisType()`
+@*/
+PetscErrorCode KSPSCGSetSteps(KSP ksp, PetscInt s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, s, 2);
+  PetscTryMethod(ksp, "KSPSCGSetSteps_C", (KSP, PetscInt), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSCGGetSteps - Gets the number of iterations of `KSPSCG` per outer iteration
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. s - the number of steps
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSCG`, `KSPSCGSetSteps()`
+@*/
+PetscErrorCode KSPSCGGetSteps(KSP ksp, PetscInt *s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(s, 2);
+  PetscUseMethod(ksp, "KSPSCGGetSteps_C", (KSP, PetscInt *), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSCGSetBasisType - Sets the polynomial basis that `KSPSCG` uses to generate the Krylov vectors
+
+  Logically Collective
+
+  Input Parameters:
++ ksp   - the Krylov space solver context
+- basis - the basis, `KSP_SSTEP_BASIS_MONOMIAL`, `KSP_SSTEP_BASIS_NEWTON`, or `KSP_SSTEP_BASIS_CHEBYSHEV`
+
+  Options Database Key:
+. -ksp_scg_basis <chebyshev,monomial,newton> - the basis
+
+  Level: intermediate
+
+  Note:
+  The default is `KSP_SSTEP_BASIS_CHEBYSHEV`. The Newton and Chebyshev bases need estimates of the eigenvalues, so the first `s` iterations
+  of each solve are done one at a time.
+
+.seealso: [](ch_ksp), `KSPSCG`, `KSPSStepBasisType`, `KSPSCGGetBasisType()`, `KSPSCGSetSteps()`
+@*/
+PetscErrorCode KSPSCGSetBasisType(KSP ksp, KSPSStepBasisType basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, basis, 2);
+  PetscTryMethod(ksp, "KSPSCGSetBasisType_C", (KSP, KSPSStepBasisType), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSCGGetBasisType - Gets the polynomial basis that `KSPSCG` uses to generate the Krylov vectors
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. basis - the basis
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSCG`, `KSPSStepBasisType`, `KSPSCGSetBasisType()`
+@*/
+PetscErrorCode KSPSCGGetBasisType(KSP ksp, KSPSStepBasisType *basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(basis, 2);
+  PetscUseMethod(ksp, "KSPSCGGetBasisType_C", (KSP, KSPSStepBasisType *), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPSCG - s-step, or communication-avoiding, preconditioned conjugate gradient method {cite}`chronopoulos_gear_1989`
+
+   Options Database Keys:
++  -ksp_scg_steps <s>                           - the number of iterations per outer iteration
+-  -ksp_scg_basis <chebyshev,monomial,newton>   - the polynomial basis used to generate the Krylov vectors
+
+   Level: intermediate
+
+   Notes:
+   Each outer iteration applies the operator and the preconditioner `2s - 1` times to build bases of the Krylov spaces of the search direction
+   and of the residual, computes their Gram matrix with a single global reduction, and performs `s` iterations of `KSPCG` in the coordinates
+   of these bases. `KSPCG` needs two reductions per iteration.
+
+   Both the operator and the preconditioner must be symmetric (Hermitian) positive definite. The default basis is the Chebyshev basis on
+   the interval of the eigenvalues estimated from the first `s` iterations, which are done one at a time. The residual norms are computed
+   from the Gram matrix, for the natural norm, the default, without additional inner products.
+
+   `KSPBuildSolution()` includes the correction of the current outer iteration so that monitors see the current iterate.
+
+.seealso: [](ch_ksp), [](sec_pipelineksp), `KSPCreate()`, `KSPSetType()`, `KSPCG`, `KSPPIPECG`, `KSPSGMRES`, `KSPSCGSetSteps()`,
+          `KSPSCGSetBasisType()`, `KSPSStepBasisType`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SCG(KSP ksp)
+{
+  KSP_SCG *scg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&scg));
+  scg->s     = SCG_DEFAULT_S;
+  scg->basis = KSP_SSTEP_BASIS_CHEBYSHEV;
+  ksp->data  = (void *)scg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NATURAL, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_SCG;
+  ksp->ops->solve          = KSPSolve_SCG;
+  ksp->ops->reset          = KSPReset_SCG;
+  ksp->ops->destroy        = KSPDestroy_SCG;
+  ksp->ops->view           = KSPView_SCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SCG;
+  ksp->ops->buildsolution  = KSPBuildSolution_SCG;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGSetSteps_C", KSPSCGSetSteps_SCG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGGetSteps_C", KSPSCGGetSteps_SCG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGSetBasisType_C", KSPSCGSetBasisType_SCG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSCGGetBasisType_C", KSPSCGGetBasisType_SCG));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
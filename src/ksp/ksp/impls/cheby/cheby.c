@@ -9,6 +9,9 @@ static PetscErrorCode KSPReset_Chebyshev(KSP ksp)
 
   PetscFunctionBegin;
   if (cheb->kspest) PetscCall(KSPReset(cheb->kspest));
+  if (cheb->mpvecs) PetscCall(VecDestroyVecs(cheb->nmpvecs, &cheb->mpvecs));
+  cheb->nmpvecs = 0;
+  PetscCall(VecDestroy(&cheb->mpdiag));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -130,6 +133,15 @@ static PetscErrorCode KSPChebyshevSetKind_Chebyshev(KSP ksp, KSPChebyshevKind ki
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode KSPChebyshevSetUseMatrixPowers_Chebyshev(KSP ksp, PetscBool use)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+
+  PetscFunctionBegin;
+  cheb->matpowers = use;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode KSPChebyshevGetKind_Chebyshev(KSP ksp, KSPChebyshevKind *kind)
 {
   KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
@@ -249,6 +261,40 @@ PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP ksp, PetscBool use)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  KSPChebyshevSetUseMatrixPowers - use the matrix-powers kernel `MatMatrixPowers()` to apply the Chebyshev polynomial with a single
+  exchange of ghost values
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - linear solver context
+- use - `PETSC_TRUE` to use the matrix-powers kernel
+
+  Options Database Key:
+. -ksp_chebyshev_matrix_powers <true,false> - use the matrix-powers kernel
+
+  Level: advanced
+
+  Notes:
+  This computes the Chebyshev basis of the Krylov space of the initial preconditioned residual, of dimension the number of iterations,
+  with `MatMatrixPowers()`, then runs the Chebyshev iteration on the coefficients in this basis. For `MATMPIAIJ` matrices this needs
+  two exchanges of ghost values per solve, one if the initial guess is zero, instead of one per iteration.
+
+  It is only used with `KSP_NORM_NONE`, the default for multigrid smoothers, and `PCJACOBI` or `PCNONE`, the preconditioners that are a
+  diagonal scaling; otherwise the usual iteration is done.
+
+.seealso: [](ch_ksp), `KSPCHEBYSHEV`, `MatMatrixPowers()`, `KSPSetNormType()`, `PCMG`
+@*/
+PetscErrorCode KSPChebyshevSetUseMatrixPowers(KSP ksp, PetscBool use)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(ksp, use, 2);
+  PetscTryMethod(ksp, "KSPChebyshevSetUseMatrixPowers_C", (KSP, PetscBool), (ksp, use));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   KSPChebyshevEstEigGetKSP - Get the Krylov method context used to estimate the eigenvalues for the Chebyshev method.
 
@@ -374,6 +420,7 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(KSP ksp, PetscOptionItems Pets
 
   cheb->chebykind = KSP_CHEBYSHEV_FIRST; /* Default to 1st-kind Chebyshev polynomial */
   PetscCall(PetscOptionsEnum("-ksp_chebyshev_kind", "Type of Chebyshev polynomial", "KSPChebyshevKind", KSPChebyshevKinds, (PetscEnum)cheb->chebykind, (PetscEnum *)&cheb->chebykind, NULL));
+  PetscCall(PetscOptionsBool("-ksp_chebyshev_matrix_powers", "Use the matrix-powers kernel", "KSPChebyshevSetUseMatrixPowers", cheb->matpowers, &cheb->matpowers, NULL));
 
   /* We need to estimate eigenvalues; need to set this here so that KSPSetFromOptions() is called on the estimator */
   if ((cheb->emin == 0. || cheb->emax == 0.) && !cheb->kspest) PetscCall(KSPChebyshevEstEigSet(ksp, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE));
@@ -708,6 +755,148 @@ static PetscErrorCode KSPSolve_Chebyshev_FourthKind(KSP ksp)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* out = Bm c, where BA Y = Y Bm for the basis Y generated by the recurrence with gamma, alpha, delta; c[m - 1] must be zero */
+static void KSPChebyshevBasisMult_Private(PetscInt m, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], const PetscScalar c[], PetscScalar out[])
+{
+  for (PetscInt i = 0; i < m; i++) out[i] = 0.0;
+  for (PetscInt j = 0; j < m - 1; j++) {
+    out[j + 1] += c[j] / gamma[j];
+    out[j] += alpha[j] * c[j];
+    if (j) out[j - 1] += delta[j] * c[j];
+  }
+}
+
+/*
+  The iterate after m iterations is x_0 + Y c, where the columns of Y are the Chebyshev basis of the Krylov space of B r_0 of
+  dimension m computed with MatMatrixPowers(). The iteration is done on the coefficients c, as in the s-step methods.
+*/
+static PetscErrorCode KSPSolve_Chebyshev_MatrixPowers(KSP ksp)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+  PetscInt       m    = ksp->max_it;
+  PetscScalar   *gamma, *alpha, *delta, *c[3], *u, *t;
+  PetscScalar    scale;
+  PetscReal      emax, emin, re[2], im[2] = {0.0, 0.0};
+  Vec            x, b, r, *Y, D = NULL;
+  Mat            Amat, Pmat;
+  PetscBool      isjacobi, isnone, diagonalscale;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp->pc, PCJACOBI, &isjacobi));
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp->pc, PCNONE, &isnone));
+  if (ksp->normtype != KSP_NORM_NONE || ksp->transpose_solve || !(isjacobi || isnone) || m < 1) {
+    if (cheb->chebykind == KSP_CHEBYSHEV_FIRST) PetscCall(KSPSolve_Chebyshev_FirstKind(ksp));
+    else PetscCall(KSPSolve_Chebyshev_FourthKind(ksp));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  x = ksp->vec_sol;
+  b = ksp->vec_rhs;
+  if (cheb->nmpvecs < m + 1) {
+    if (cheb->mpvecs) PetscCall(VecDestroyVecs(cheb->nmpvecs, &cheb->mpvecs));
+    PetscCall(KSPCreateVecs(ksp, m + 1, &cheb->mpvecs, 0, NULL));
+    cheb->nmpvecs = m + 1;
+  }
+  Y = cheb->mpvecs;
+  r = cheb->mpvecs[m];
+
+  /* the diagonal of the preconditioner, recomputed when the preconditioning matrix changes */
+  if (isjacobi) {
+    PetscObjectId    id;
+    PetscObjectState state;
+
+    PetscCall(PetscObjectGetId((PetscObject)Pmat, &id));
+    PetscCall(PetscObjectStateGet((PetscObject)Pmat, &state));
+    if (!cheb->mpdiag || id != cheb->mpdiagid || state != cheb->mpdiagstate) {
+      if (!cheb->mpdiag) PetscCall(VecDuplicate(b, &cheb->mpdiag));
+      PetscCall(VecSet(r, 1.0));
+      PetscCall(PCApply(ksp->pc, r, cheb->mpdiag));
+      cheb->mpdiagid    = id;
+      cheb->mpdiagstate = state;
+    }
+    D = cheb->mpdiag;
+  }
+
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, x, r)); /*  r = b - A*x */
+    PetscCall(VecAYPX(r, -1.0, b));
+  } else {
+    PetscCall(VecCopy(b, r));
+  }
+  PetscCall(KSP_PCApply(ksp, r, Y[0])); /*  Y[0] = B^{-1}r */
+
+  /* the Chebyshev basis on the target interval is well conditioned */
+  PetscCall(KSPChebyshevGetEigenvalues_Chebyshev(ksp, &emax, &emin));
+  re[0] = emin;
+  re[1] = emax;
+  PetscCall(PetscMalloc7(m, &gamma, m, &alpha, m, &delta, m, &c[0], m, &c[1], m, &c[2], 2 * m, &u));
+  t = u + m;
+  PetscCall(KSPSStepBasisSetUp_Private(KSP_SSTEP_BASIS_CHEBYSHEV, m - 1, 2, re, im, gamma, alpha, delta));
+  PetscCall(MatMatrixPowers(Amat, m - 1, D, gamma, alpha, delta, Y[0], Y));
+
+  /* the same iterations as KSPSolve_Chebyshev_FirstKind() and KSPSolve_Chebyshev_FourthKind() on the coefficients */
+  PetscCall(PetscArrayzero(c[0], m));
+  PetscCall(PetscArrayzero(c[1], m));
+  PetscCall(PetscArrayzero(u, m));
+  u[0] = 1.0;
+  if (cheb->chebykind == KSP_CHEBYSHEV_FIRST) {
+    PetscScalar alph, omegaprod, mu, omega, Gamma, cc[3];
+    PetscInt    km1 = 0, k = 1, kp1 = 2, ktmp;
+
+    scale     = 2.0 / (emax + emin);
+    alph      = 1.0 - scale * emin;
+    Gamma     = 1.0;
+    mu        = 1.0 / alph;
+    omegaprod = 2.0 / alph;
+    cc[km1]   = 1.0;
+    cc[k]     = mu;
+    c[k][0]   = scale; /* p[k] = scale B^{-1}r + p[km1] */
+    for (PetscInt i = 1; i < m; i++) {
+      KSPChebyshevBasisMult_Private(m, gamma, alpha, delta, c[k], t); /*  B^{-1}r = B^{-1}(b - Ap[k]) */
+      for (PetscInt j = 0; j < m; j++) t[j] = u[j] - t[j];
+      cc[kp1] = 2.0 * mu * cc[k] - cc[km1];
+      omega   = omegaprod * cc[k] / cc[kp1];
+      for (PetscInt j = 0; j < m; j++) c[kp1][j] = (1.0 - omega) * c[km1][j] + omega * c[k][j] + omega * Gamma * scale * t[j];
+      ktmp = km1;
+      km1  = k;
+      k    = kp1;
+      kp1  = ktmp;
+    }
+    PetscCall(VecMAXPY(x, m, c[k], Y));
+  } else {
+    PetscScalar *xc = c[0], *d = c[1];
+
+    scale = 1.0 / emax;
+    d[0]  = 4.0 / 3.0 * scale;
+    for (PetscInt i = 1; i < m; i++) {
+      PetscScalar rScale = scale * (8.0 * i + 4.0) / (2.0 * i + 3.0), dScale = (2.0 * i - 1.0) / (2.0 * i + 3.0);
+
+      KSPChebyshevBasisMult_Private(m, gamma, alpha, delta, d, t); /*  B^{-1}r = B^{-1}r - B^{-1}Ad */
+      for (PetscInt j = 0; j < m; j++) {
+        xc[j] += cheb->betas[i - 1] * d[j];
+        u[j] -= t[j];
+        d[j] = dScale * d[j] + rScale * u[j];
+      }
+    }
+    for (PetscInt j = 0; j < m; j++) xc[j] += cheb->betas[m - 1] * d[j];
+    PetscCall(VecMAXPY(x, m, xc, Y));
+  }
+  PetscCall(PetscFree7(gamma, alpha, delta, c[0], c[1], c[2], u));
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = m;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  ksp->reason = KSP_CONVERGED_ITS;
+  PetscCall(KSPLogErrorHistory(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode KSPView_Chebyshev(KSP ksp, PetscViewer viewer)
 {
   KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
@@ -727,6 +916,7 @@ static PetscErrorCode KSPView_Chebyshev(KSP ksp, PetscViewer viewer)
       PetscCall(PetscViewerASCIIPrintf(viewer, "  Chebyshev polynomial of opt. fourth kind\n"));
       break;
     }
+    if (cheb->matpowers) PetscCall(PetscViewerASCIIPrintf(viewer, "  using the matrix-powers kernel\n"));
     PetscReal emax, emin;
     PetscCall(KSPChebyshevGetEigenvalues_Chebyshev(ksp, &emax, &emin));
     PetscCall(PetscViewerASCIIPrintf(viewer, "  eigenvalue targets used: min %g, max %g\n", (double)emin, (double)emax));
@@ -763,6 +953,7 @@ static PetscErrorCode KSPSetUp_Chebyshev(KSP ksp)
     ksp->ops->solve = KSPSolve_Chebyshev_FourthKind;
     break;
   }
+  if (cheb->matpowers) ksp->ops->solve = KSPSolve_Chebyshev_MatrixPowers;
 
   if (ksp->max_it > cheb->num_betas_alloc) {
     PetscCall(PetscFree(cheb->betas));
@@ -871,6 +1062,7 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseNoisy_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetKind_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevGetKind_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetUseMatrixPowers_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigGetKSP_C", NULL));
   PetscCall(KSPDestroyDefault(ksp));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -885,7 +1077,8 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 .   -ksp_chebyshev_esteig <a,b,c,d>        - estimate eigenvalues using a Krylov method, then use this
                                              transform for Chebyshev eigenvalue bounds (`KSPChebyshevEstEigSet()`)
 .   -ksp_chebyshev_esteig_steps            - number of eigenvalue estimation steps
--   -ksp_chebyshev_esteig_noisy            - use a noisy random number generator to create right-hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_noisy            - use a noisy random number generator to create right-hand side for eigenvalue estimator
+-   -ksp_chebyshev_matrix_powers           - apply the polynomial with the matrix-powers kernel `MatMatrixPowers()`, see `KSPChebyshevSetUseMatrixPowers()`
 
    Level: beginner
 
@@ -901,8 +1094,8 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
    See `MatIsSPDKnown()` for how to indicate a `Mat`, matrix is SPD.
 
 .seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`,
-          `KSPChebyshevSetEigenvalues()`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetUseNoisy()`
-          `KSPRICHARDSON`, `KSPCG`, `PCMG`
+          `KSPChebyshevSetEigenvalues()`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetUseNoisy()`,
+          `KSPChebyshevSetUseMatrixPowers()`, `KSPRICHARDSON`, `KSPCG`, `PCMG`
 M*/
 
 PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
@@ -942,6 +1135,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseNoisy_C", KSPChebyshevEstEigSetUseNoisy_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetKind_C", KSPChebyshevSetKind_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevGetKind_C", KSPChebyshevGetKind_Chebyshev));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetUseMatrixPowers_C", KSPChebyshevSetUseMatrixPowers_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigGetKSP_C", KSPChebyshevEstEigGetKSP_Chebyshev));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
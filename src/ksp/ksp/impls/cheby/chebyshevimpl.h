@@ -21,6 +21,13 @@ typedef struct {
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid, pmatid;
   PetscObjectState amatstate, pmatstate;
+  /* For the matrix-powers kernel */
+  PetscBool        matpowers;
+  Vec             *mpvecs; /* basis of the Krylov space and the residual */
+  PetscInt         nmpvecs;
+  Vec              mpdiag; /* diagonal of PCJACOBI */
+  PetscObjectId    mpdiagid;
+  PetscObjectState mpdiagstate;
 } KSP_Chebyshev;
 
 /* given the polynomial order, return tabulated beta coefficients for use in opt. 4th-kind Chebyshev smoother */
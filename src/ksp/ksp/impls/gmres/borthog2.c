@@ -56,25 +56,18 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
   }
 
   /*
-     This is really a matrix-vector product, with the matrix stored
-     as pointer to rows
+     This is really two matrix-vector products, with the matrix stored
+     as pointer to rows: lhh = [v[0]; v[1]; ...]^H vnew and then
+     [lhh[0],lhh[1],...]*[ v[0]; v[1]; ...] subtracted from vnew = v[it+1].
+     The norm of the result, only needed to decide on the refinement, comes
+     from the same sweep over vnew.
   */
-  PetscCall(VecMDot(VEC_VV(it + 1), it + 1, &(VEC_VV(0)), lhh)); /* <v,vnew> */
+  PetscCall(VecOrthogonalize(VEC_VV(it + 1), it + 1, &(VEC_VV(0)), lhh, gmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED ? &wnrm : NULL)); /* <v,vnew> */
   for (j = 0; j <= it; j++) {
     KSPCheckDot(ksp, lhh[j]);
     if (ksp->reason) goto done;
-    lhh[j] = -lhh[j];
-  }
-
-  /*
-         This is really a matrix-vector product:
-         [h[0],h[1],...]*[ v[0]; v[1]; ...] subtracted from v[it+1].
-  */
-  PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0)));
-  /* note lhh[j] is -<v,vnew> , hence the subtraction */
-  for (j = 0; j <= it; j++) {
-    hh[j] -= lhh[j];  /* hh += <v,vnew> */
-    hes[j] -= lhh[j]; /* hes += <v,vnew> */
+    hh[j] += lhh[j];  /* hh += <v,vnew> */
+    hes[j] += lhh[j]; /* hes += <v,vnew> */
   }
 
   /*
@@ -86,7 +79,6 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
     for (j = 0; j <= it; j++) hnrm += PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
     hnrm = PetscSqrtReal(hnrm);
-    PetscCall(VecNorm(VEC_VV(it + 1), NORM_2, &wnrm));
     KSPCheckNorm(ksp, wnrm);
     if (ksp->reason) goto done;
     if (wnrm < hnrm) {
@@ -96,17 +88,12 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
   }
 
   if (refine) {
-    PetscCall(VecMDot(VEC_VV(it + 1), it + 1, &(VEC_VV(0)), lhh)); /* <v,vnew> */
+    PetscCall(VecOrthogonalize(VEC_VV(it + 1), it + 1, &(VEC_VV(0)), lhh, NULL)); /* <v,vnew> */
     for (j = 0; j <= it; j++) {
       KSPCheckDot(ksp, lhh[j]);
       if (ksp->reason) goto done;
-      lhh[j] = -lhh[j];
-    }
-    PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0)));
-    /* note lhh[j] is -<v,vnew> , hence the subtraction */
-    for (j = 0; j <= it; j++) {
-      hh[j] -= lhh[j];  /* hh += <v,vnew> */
-      hes[j] -= lhh[j]; /* hes += <v,vnew> */
+      hh[j] += lhh[j];  /* hh += <v,vnew> */
+      hes[j] += lhh[j]; /* hes += <v,vnew> */
     }
   }
 done:
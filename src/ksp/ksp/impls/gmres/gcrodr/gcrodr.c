@@ -0,0 +1,749 @@
+/*
+    This file implements GCRO-DR, the Generalized Conjugate Residual method with inner Orthogonalization and Deflated Restarting
+    {cite}`parks2006recycling`, which keeps a recycled subspace between restarts and between consecutive calls to KSPSolve().
+
+    The recycled space U of dimension r is stored with C = op(A) U, whose columns are orthonormal, where op(A) is the preconditioned
+    operator. The residual at the start of each cycle is made orthogonal to C, then the cycle runs Arnoldi with (I - C C^H) op(A), so that
+       op(A) [U V_m] = [C V_{m+1}] [I B; 0 Hbar_m]  with  B = C^H op(A) V_m,
+    and the minimal residual solution over range([U V_m]) is U y_1 + V_m y_2 where y_2 solves the usual GMRES least-squares problem with
+    Hbar_m and y_1 = -B y_2. At the end of each cycle the recycled space is replaced by the harmonic Ritz vectors of op(A) in range([U V_m])
+    associated with the harmonic Ritz values of smallest magnitude. When the operators change between solves, C = op(A) U is recomputed
+    and orthonormalized, which costs r applications of the operator.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/gcrodr/gcrodrimpl.h> /*I  "petscksp.h"  I*/
+
+static PetscErrorCode KSPGCRODRUpdateHessenberg(KSP, PetscInt, PetscBool, PetscReal *);
+static PetscErrorCode KSPGCRODRBuildSoln(PetscScalar *, Vec, Vec, KSP, PetscInt);
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt    n = gcrodr->max_k, k = gcrodr->k;
+
+  PetscFunctionBegin;
+  PetscCheck(k < n, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The dimension of the recycled space %" PetscInt_FMT " must be smaller than the restart %" PetscInt_FMT, k, n);
+  PetscCall(KSPSetUp_GMRES(ksp));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->U, k, &gcrodr->C));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->U2, k, &gcrodr->C2));
+  PetscCall(PetscBLASIntCast(64 * (n + 1), &gcrodr->lwork));
+  PetscCall(PetscMalloc7(k * n, &gcrodr->B, (n + 1) * n, &gcrodr->G, (n + 1) * n, &gcrodr->G2, (n + 1) * n, &gcrodr->WV, n * n, &gcrodr->X, n * k, &gcrodr->P, gcrodr->lwork, &gcrodr->work));
+  PetscCall(PetscMalloc6(2 * n, &gcrodr->eig, k, &gcrodr->tau, n + 1, &gcrodr->h, k, &gcrodr->d, 2 * n, &gcrodr->rwork, n, &gcrodr->perm));
+  gcrodr->r = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Recomputes C = op(A) U if the operators have changed since the recycled space was computed, then orthonormalizes C with classical
+   Gram-Schmidt applied twice and applies the same transformations to U. Vectors of U whose image is numerically linearly dependent are dropped.
+*/
+static PetscErrorCode KSPGCRODRUpdateOperators(KSP ksp)
+{
+  KSP_GCRODR      *gcrodr = (KSP_GCRODR *)ksp->data;
+  Mat              Amat, Pmat;
+  PetscObjectId    Aid, Pid;
+  PetscObjectState Astate, Pstate;
+  PetscScalar     *h = gcrodr->h;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(PetscObjectGetId((PetscObject)Amat, &Aid));
+  PetscCall(PetscObjectGetId((PetscObject)Pmat, &Pid));
+  PetscCall(PetscObjectStateGet((PetscObject)Amat, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)Pmat, &Pstate));
+  if (gcrodr->r && (Aid != gcrodr->Aid || Pid != gcrodr->Pid || Astate != gcrodr->Astate || Pstate != gcrodr->Pstate || ksp->pc_side != gcrodr->side || ksp->transpose_solve != gcrodr->transpose)) {
+    PetscInt r = gcrodr->r;
+
+    PetscCall(PetscLogEventBegin(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+    for (PetscInt j = 0; j < r; j++) PetscCall(KSP_PCApplyBAorAB(ksp, gcrodr->U[j], gcrodr->C[j], VEC_TEMP_MATOP));
+    for (PetscInt j = 0; j < r;) {
+      PetscReal nrm0, nrm;
+
+      PetscCall(VecNorm(gcrodr->C[j], NORM_2, &nrm0));
+      for (PetscInt pass = 0; pass < 2; pass++) {
+        PetscCall(VecOrthogonalize(gcrodr->C[j], j, gcrodr->C, h, &nrm));
+        for (PetscInt i = 0; i < j; i++) h[i] = -h[i];
+        PetscCall(VecMAXPY(gcrodr->U[j], j, h, gcrodr->U));
+      }
+      if (nrm <= PETSC_SQRT_MACHINE_EPSILON * nrm0) {
+        Vec t;
+
+        PetscCall(PetscInfo(ksp, "Dropping recycled vector %" PetscInt_FMT " that is numerically linearly dependent for the new operator\n", j));
+        t                = gcrodr->U[j];
+        gcrodr->U[j]     = gcrodr->U[r - 1];
+        gcrodr->U[r - 1] = t;
+        t                = gcrodr->C[j];
+        gcrodr->C[j]     = gcrodr->C[r - 1];
+        gcrodr->C[r - 1] = t;
+        r--;
+        continue;
+      }
+      PetscCall(VecScale(gcrodr->C[j], 1.0 / nrm));
+      PetscCall(VecScale(gcrodr->U[j], 1.0 / nrm));
+      j++;
+    }
+    gcrodr->r = r;
+    PetscCall(PetscLogEventEnd(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+  }
+  gcrodr->Aid       = Aid;
+  gcrodr->Pid       = Pid;
+  gcrodr->Astate    = Astate;
+  gcrodr->Pstate    = Pstate;
+  gcrodr->side      = ksp->pc_side;
+  gcrodr->transpose = ksp->transpose_solve;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Replaces the recycled space by the harmonic Ritz vectors of op(A) in range([U D, V_it]) associated with the harmonic Ritz values of
+   smallest magnitude, where D scales the columns of U to unit norm. With G = [D B; 0 Hbar_it] such that op(A) [U D, V_it] = [C V_{it+1}] G,
+   they solve G^H G z = theta G^H [C V_{it+1}]^H [U D, V_it] z, which is the standard eigenvalue problem G^+ [C V_{it+1}]^H [U D, V_it] z = z / theta.
+   With P the selected eigenvectors and Q R = G P, the new recycled space is [U D, V_it] P R^{-1} and its image [C V_{it+1}] Q.
+*/
+static PetscErrorCode KSPGCRODRUpdateRecycledSpace(KSP ksp, PetscInt it)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt     r = gcrodr->r, n = r + it, m = n + 1, kmax = PetscMin(gcrodr->k, n - 1), knew = 0;
+  PetscScalar *G = gcrodr->G, *G2 = gcrodr->G2, *WV = gcrodr->WV, *X = gcrodr->X, *P = gcrodr->P, one = 1.0, zero = 0.0, sdummy = 0;
+  PetscReal   *d = gcrodr->d, *modulus = gcrodr->rwork;
+  PetscBLASInt bn, bm, bk, idummy = 1, info;
+  Vec         *t;
+
+  PetscFunctionBegin;
+  if (kmax < 1) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscLogEventBegin(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(m, &bm));
+
+  /* G and [C V_{it+1}]^H [U D, V_it], stored by columns with leading dimension m */
+  for (PetscInt i = 0; i < r; i++) PetscCall(VecNormBegin(gcrodr->U[i], NORM_2, &d[i]));
+  for (PetscInt i = 0; i < r; i++) PetscCall(VecNormEnd(gcrodr->U[i], NORM_2, &d[i]));
+  PetscCall(PetscArrayzero(G, m * n));
+  PetscCall(PetscArrayzero(WV, m * n));
+  for (PetscInt j = 0; j < r; j++) {
+    PetscCall(VecMDotBegin(gcrodr->U[j], r, gcrodr->C, WV + j * m));
+    PetscCall(VecMDotBegin(gcrodr->U[j], it + 1, &VEC_VV(0), WV + j * m + r));
+  }
+  for (PetscInt j = 0; j < r; j++) {
+    PetscCall(VecMDotEnd(gcrodr->U[j], r, gcrodr->C, WV + j * m));
+    PetscCall(VecMDotEnd(gcrodr->U[j], it + 1, &VEC_VV(0), WV + j * m + r));
+    d[j] = 1.0 / d[j];
+    for (PetscInt i = 0; i < m; i++) WV[i + j * m] *= d[j];
+    G[j + j * m] = d[j];
+  }
+  for (PetscInt j = 0; j < it; j++) {
+    for (PetscInt i = 0; i < r; i++) G[i + (r + j) * m] = gcrodr->B[i + j * gcrodr->k];
+    for (PetscInt i = 0; i <= j + 1; i++) G[r + i + (r + j) * m] = *HES(i, j);
+    WV[r + j + (r + j) * m] = 1.0;
+  }
+
+  /* G^+ [C V_{it+1}]^H [U D, V_it] overwrites the first n rows of WV */
+  PetscCall(PetscArraycpy(G2, G, m * n));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKgels", LAPACKgels_("N", &bm, &bn, &bn, G2, &bm, WV, &bm, gcrodr->work, &gcrodr->lwork, &info));
+  if (!info) {
+#if !defined(PETSC_USE_COMPLEX)
+    PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "V", &bn, WV, &bm, gcrodr->eig, gcrodr->eig + n, &sdummy, &idummy, X, &bn, gcrodr->work, &gcrodr->lwork, &info));
+#else
+    PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "V", &bn, WV, &bm, gcrodr->eig, &sdummy, &idummy, X, &bn, gcrodr->work, &gcrodr->lwork, gcrodr->rwork, &info));
+#endif
+  }
+  PetscCall(PetscFPTrapPop());
+  if (info) {
+    PetscCall(PetscInfo(ksp, "Keeping the recycled space, the harmonic Ritz problem failed with LAPACK error %" PetscBLASInt_FMT "\n", info));
+    PetscCall(PetscLogEventEnd(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* the eigenvectors of the eigenvalues of largest magnitude, a complex conjugate pair gives the real and imaginary parts of its eigenvector */
+  for (PetscInt i = 0; i < n; i++) {
+#if !defined(PETSC_USE_COMPLEX)
+    modulus[i] = PetscSqrtReal(PetscSqr(gcrodr->eig[i]) + PetscSqr(gcrodr->eig[n + i]));
+#else
+    modulus[i] = PetscAbsScalar(gcrodr->eig[i]);
+#endif
+    gcrodr->perm[i] = i;
+  }
+  PetscCall(PetscSortRealWithPermutation(n, modulus, gcrodr->perm));
+  for (PetscInt l = n - 1; l >= 0 && knew < kmax; l--) {
+    PetscInt j = gcrodr->perm[l];
+
+#if !defined(PETSC_USE_COMPLEX)
+    if (gcrodr->eig[n + j] != 0.0) {
+      if (modulus[j] < 0.0) continue; /* the other eigenvalue of the pair was already selected */
+      if (gcrodr->eig[n + j] < 0.0) j--;
+      if (knew + 2 > kmax) break;
+      PetscCall(PetscArraycpy(P + knew * n, X + j * n, 2 * n));
+      modulus[j] = modulus[j + 1] = -1.0;
+      knew += 2;
+      continue;
+    }
+#endif
+    PetscCall(PetscArraycpy(P + knew * n, X + j * n, n));
+    knew++;
+  }
+  if (!knew) {
+    PetscCall(PetscLogEventEnd(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* Q R = G P in G2, then P R^{-1} in P */
+  PetscCall(PetscBLASIntCast(knew, &bk));
+  PetscCallBLAS("BLASgemm", BLASgemm_("N", "N", &bm, &bk, &bn, &one, G, &bm, P, &bn, &zero, G2, &bm));
+  PetscCallBLAS("LAPACKgeqrf", LAPACKgeqrf_(&bm, &bk, G2, &bm, gcrodr->tau, gcrodr->work, &gcrodr->lwork, &info));
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine xGEQRF %" PetscBLASInt_FMT, info);
+  for (PetscInt j = 0; j < knew; j++) {
+    if (G2[j + j * m] == 0.0) {
+      PetscCall(PetscInfo(ksp, "Keeping the recycled space, the image of the harmonic Ritz vectors is rank deficient\n"));
+      PetscCall(PetscLogEventEnd(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  PetscCallBLAS("BLAStrsm", BLAStrsm_("R", "U", "N", "N", &bn, &bk, &one, G2, &bm, P, &bn));
+  PetscCallBLAS("LAPACKorgqr", LAPACKorgqr_(&bm, &bk, &bk, G2, &bm, gcrodr->tau, gcrodr->work, &gcrodr->lwork, &info));
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine xORGQR %" PetscBLASInt_FMT, info);
+  PetscCall(PetscLogFlops(2.0 * m * n * knew + 4.0 * m * knew * knew + n * knew * knew));
+
+  /* the new recycled space and its image */
+  for (PetscInt j = 0; j < knew; j++) {
+    for (PetscInt i = 0; i < r; i++) P[i + j * n] *= d[i];
+    PetscCall(VecMAXPBY(gcrodr->C2[j], it + 1, G2 + j * m + r, 0.0, &VEC_VV(0)));
+    PetscCall(VecMAXPY(gcrodr->C2[j], r, G2 + j * m, gcrodr->C));
+    PetscCall(VecMAXPBY(gcrodr->U2[j], it, P + j * n + r, 0.0, &VEC_VV(0)));
+    PetscCall(VecMAXPY(gcrodr->U2[j], r, P + j * n, gcrodr->U));
+  }
+  t          = gcrodr->U;
+  gcrodr->U  = gcrodr->U2;
+  gcrodr->U2 = t;
+  t          = gcrodr->C;
+  gcrodr->C  = gcrodr->C2;
+  gcrodr->C2 = t;
+  gcrodr->r  = knew;
+  PetscCall(PetscLogEventEnd(KSP_GCRODRRecycle, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Makes the residual in VEC_VV(0) orthogonal to C and adds the corresponding correction U C^H r to the solution
+*/
+static PetscErrorCode KSPGCRODRProject(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(VecOrthogonalize(VEC_VV(0), gcrodr->r, gcrodr->C, gcrodr->h, NULL));
+  PetscCall(VecMAXPBY(VEC_TEMP, gcrodr->r, gcrodr->h, 0.0, gcrodr->U));
+  PetscCall(KSPUnwindPreconditioner(ksp, VEC_TEMP, VEC_TEMP_MATOP));
+  PetscCall(VecAXPY(ksp->vec_sol, 1.0, VEC_TEMP));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRCycle(PetscInt *itcount, KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscReal   res, hapbnd, tt;
+  PetscInt    it = 0, r = gcrodr->r, max_k = gcrodr->max_k - r;
+  PetscBool   hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  PetscCall(VecNormalize(VEC_VV(0), &res));
+  KSPCheckNorm(ksp, res);
+  *GRS(0) = gcrodr->rnorm0 = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = res;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  gcrodr->it = it - 1;
+  PetscCall(KSPLogResidualHistory(ksp, res));
+  PetscCall(KSPLogErrorHistory(ksp));
+  PetscCall(KSPMonitor(ksp, ksp->its, res));
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* check for the convergence */
+  PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    if (it) {
+      PetscCall(KSPLogResidualHistory(ksp, res));
+      PetscCall(KSPLogErrorHistory(ksp));
+      PetscCall(KSPMonitor(ksp, ksp->its, res));
+    }
+    gcrodr->it = it - 1;
+    if (gcrodr->vv_allocated <= it + VEC_OFFSET + 1) PetscCall(KSPGMRESGetNewVectors(ksp, it + 1));
+    PetscCall(KSP_PCApplyBAorAB(ksp, VEC_VV(it), VEC_VV(1 + it), VEC_TEMP_MATOP));
+
+    /* project out the image of the recycled space, B(:, it) = C^H op(A) v_it */
+    PetscCall(VecOrthogonalize(VEC_VV(it + 1), r, gcrodr->C, gcrodr->B + it * gcrodr->k, NULL));
+
+    /* update Hessenberg matrix and do Gram-Schmidt */
+    PetscCall((*gcrodr->orthog)(ksp, it));
+    if (ksp->reason) break;
+
+    /* vv(i+1) . vv(i+1) */
+    PetscCall(VecNormalize(VEC_VV(it + 1), &tt));
+    KSPCheckNorm(ksp, tt);
+
+    /* save the magnitude */
+    *HH(it + 1, it)  = tt;
+    *HES(it + 1, it) = tt;
+
+    /* check for the happy breakdown */
+    hapbnd = PetscAbsScalar(tt / *GRS(it));
+    if (hapbnd > gcrodr->haptol) hapbnd = gcrodr->haptol;
+    if (tt < hapbnd) {
+      PetscCall(PetscInfo(ksp, "Detected happy ending, current hapbnd = %14.12e tt = %14.12e\n", (double)hapbnd, (double)tt));
+      hapend = PETSC_TRUE;
+    }
+    PetscCall(KSPGCRODRUpdateHessenberg(ksp, it, hapend, &res));
+
+    it++;
+    gcrodr->it = it - 1; /* For converged */
+    ksp->its++;
+    ksp->rnorm = res;
+    if (ksp->reason) break;
+
+    PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+
+    /* Catch error in happy breakdown and signal convergence and break from loop */
+    if (hapend) {
+      if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+        ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      } else if (!ksp->reason) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        break;
+      }
+    }
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far), then the recycled space for the next cycle or solve */
+  PetscCall(KSPGCRODRBuildSoln(GRS(0), ksp->vec_sol, ksp->vec_sol, ksp, it - 1));
+  if (it && !hapend && ksp->reason >= 0) PetscCall(KSPGCRODRUpdateRecycledSpace(ksp, it));
+
+  /* Monitor if we know that we will not return for a restart */
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (it && ksp->reason) {
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPLogErrorHistory(ksp));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt    its, itcount = 0, r0;
+  PetscBool   guess_zero = ksp->guess_zero;
+  PetscReal   rnorm = 0.0, rnormp = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+  PetscCall(KSPGCRODRUpdateOperators(ksp));
+  r0          = gcrodr->r;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, VEC_TEMP, VEC_TEMP_MATOP, VEC_VV(0), ksp->vec_rhs));
+    if (gcrodr->r) {
+      if (gcrodr->monitor && !itcount) PetscCall(VecNorm(VEC_VV(0), NORM_2, &rnorm));
+      PetscCall(KSPGCRODRProject(ksp));
+    }
+    PetscCall(KSPGCRODRCycle(&its, ksp));
+    if (!itcount) rnormp = gcrodr->rnorm0;
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+
+  if (r0) {
+    gcrodr->nrecycled++;
+    gcrodr->its_recycled += ksp->its;
+  } else gcrodr->its_first = ksp->its;
+  if (gcrodr->monitor) {
+    PetscViewer viewer = PETSC_VIEWER_STDOUT_(PetscObjectComm((PetscObject)ksp));
+
+    PetscCall(PetscViewerASCIIAddTab(viewer, ((PetscObject)ksp)->tablevel));
+    if (r0) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  GCRODR %" PetscInt_FMT " iterations with %" PetscInt_FMT " recycled vectors, %" PetscInt_FMT " in the last solve without recycling\n", ksp->its, r0, gcrodr->its_first));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  GCRODR the recycled space reduces the initial residual norm from %g to %g\n", (double)rnorm, (double)rnormp));
+    } else PetscCall(PetscViewerASCIIPrintf(viewer, "  GCRODR %" PetscInt_FMT " iterations without recycling, %" PetscInt_FMT " vectors recycled for the next solve\n", ksp->its, gcrodr->r));
+    PetscCall(PetscViewerASCIISubtractTab(viewer, ((PetscObject)ksp)->tablevel));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (gcrodr->U) {
+    PetscCall(VecDestroyVecs(gcrodr->k, &gcrodr->U));
+    PetscCall(VecDestroyVecs(gcrodr->k, &gcrodr->C));
+    PetscCall(VecDestroyVecs(gcrodr->k, &gcrodr->U2));
+    PetscCall(VecDestroyVecs(gcrodr->k, &gcrodr->C2));
+  }
+  PetscCall(PetscFree7(gcrodr->B, gcrodr->G, gcrodr->G2, gcrodr->WV, gcrodr->X, gcrodr->P, gcrodr->work));
+  PetscCall(PetscFree6(gcrodr->eig, gcrodr->tau, gcrodr->h, gcrodr->d, gcrodr->rwork, gcrodr->perm));
+  gcrodr->r            = 0;
+  gcrodr->its_first    = 0;
+  gcrodr->nrecycled    = 0;
+  gcrodr->its_recycled = 0;
+  PetscCall(KSPReset_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_GCRODR(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleDimension_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleDimension_C", NULL));
+  PetscCall(KSPDestroy_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRBuildSoln(PetscScalar *nrs, Vec vs, Vec vdest, KSP ksp, PetscInt it)
+{
+  PetscScalar tt;
+  PetscInt    ii, k, j;
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  /* Solve for solution vector that minimizes the residual */
+
+  /* If it is < 0, no gcrodr steps have been performed */
+  if (it < 0) {
+    PetscCall(VecCopy(vs, vdest)); /* VecCopy() is smart, exists immediately if vguess == vdest */
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (*HH(it, it) != 0.0) {
+    nrs[it] = *GRS(it) / *HH(it, it);
+  } else {
+    PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "You reached the break down in GCRODR; HH(it,it) = 0");
+    ksp->reason = KSP_DIVERGED_BREAKDOWN;
+
+    PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(it,it) is identically zero; it = %" PetscInt_FMT " GRS(it) = %g\n", it, (double)PetscAbsScalar(*GRS(it))));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (ii = 1; ii <= it; ii++) {
+    k  = it - ii;
+    tt = *GRS(k);
+    for (j = k + 1; j <= it; j++) tt = tt - *HH(k, j) * nrs[j];
+    if (*HH(k, k) == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT, k);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT "\n", k));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    nrs[k] = tt / *HH(k, k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP, the coefficients of U are -B nrs */
+  PetscCall(VecMAXPBY(VEC_TEMP, it + 1, nrs, 0, &VEC_VV(0)));
+  for (PetscInt i = 0; i < gcrodr->r; i++) {
+    gcrodr->h[i] = 0.0;
+    for (j = 0; j <= it; j++) gcrodr->h[i] -= gcrodr->B[i + j * gcrodr->k] * nrs[j];
+  }
+  PetscCall(VecMAXPY(VEC_TEMP, gcrodr->r, gcrodr->h, gcrodr->U));
+
+  PetscCall(KSPUnwindPreconditioner(ksp, VEC_TEMP, VEC_TEMP_MATOP));
+  /* add solution to previous solution */
+  if (vdest != vs) PetscCall(VecCopy(vs, vdest));
+  PetscCall(VecAXPY(vdest, 1.0, VEC_TEMP));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Do the scalar work for the orthogonalization.  Return new residual norm.
+ */
+static PetscErrorCode KSPGCRODRUpdateHessenberg(KSP ksp, PetscInt it, PetscBool hapend, PetscReal *res)
+{
+  PetscScalar *hh, *cc, *ss, tt;
+  PetscInt     j;
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  hh = HH(0, it);
+  cc = CC(0);
+  ss = SS(0);
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  for (j = 1; j <= it; j++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh + 1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+
+  /*
+    compute the new plane rotation, and apply it to:
+     1) the right-hand side of the Hessenberg system
+     2) the new column of the Hessenberg matrix
+    thus obtaining the updated value of the residual
+  */
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh + 1)) * *(hh + 1));
+    if (tt == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "tt == 0.0");
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    *cc          = *hh / tt;
+    *ss          = *(hh + 1) / tt;
+    *GRS(it + 1) = -(*ss * *GRS(it));
+    *GRS(it)     = PetscConj(*cc) * *GRS(it);
+    *hh          = PetscConj(*cc) * *hh + *ss * *(hh + 1);
+    *res         = PetscAbsScalar(*GRS(it + 1));
+  } else {
+    /* happy breakdown: HH(it+1, it) = 0, the residual is zero */
+    *res = 0.0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPBuildSolution_GCRODR(KSP ksp, Vec ptr, Vec *result)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!gcrodr->sol_temp) PetscCall(VecDuplicate(ksp->vec_sol, &gcrodr->sol_temp));
+    ptr = gcrodr->sol_temp;
+  }
+  if (!gcrodr->nrs) {
+    /* allocate the work area */
+    PetscCall(PetscMalloc1(gcrodr->max_k, &gcrodr->nrs));
+  }
+
+  PetscCall(KSPGCRODRBuildSoln(gcrodr->nrs, ksp->vec_sol, ptr, ksp, gcrodr->it));
+  if (result) *result = ptr;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp, PetscViewer viewer)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscBool   iascii, isstring;
+
+  PetscFunctionBegin;
+  PetscCall(KSPView_GMRES(ksp, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERSTRING, &isstring));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  recycled space of dimension %" PetscInt_FMT ", currently %" PetscInt_FMT "\n", gcrodr->k, gcrodr->r));
+    if (gcrodr->nrecycled) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  %g iterations on average in %" PetscInt_FMT " solves with a recycled space, %" PetscInt_FMT " in the last solve without\n", (double)gcrodr->its_recycled / gcrodr->nrecycled, gcrodr->nrecycled, gcrodr->its_first));
+    }
+  } else if (isstring) {
+    PetscCall(PetscViewerStringSPrintf(viewer, " recycle %" PetscInt_FMT, gcrodr->k));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt    k;
+  PetscBool   flg;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetFromOptions_GMRES(ksp, PetscOptionsObject));
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP GCRODR Options");
+  PetscCall(PetscOptionsInt("-ksp_gcrodr_recycle", "Dimension of the recycled space", "KSPGCRODRSetRecycleDimension", gcrodr->k, &k, &flg));
+  if (flg) PetscCall(KSPGCRODRSetRecycleDimension(ksp, k));
+  PetscCall(PetscOptionsBool("-ksp_gcrodr_monitor", "Print the iterations saved by the recycled space after each solve", NULL, gcrodr->monitor, &gcrodr->monitor, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRSetRestart_GCRODR(KSP ksp, PetscInt max_k)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Restart must be positive");
+  if (!ksp->setupstage) {
+    gcrodr->max_k = max_k;
+  } else if (gcrodr->max_k != max_k) {
+    gcrodr->max_k   = max_k;
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    PetscCall(KSPReset_GCRODR(ksp));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleDimension_GCRODR(KSP ksp, PetscInt k)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The dimension of the recycled space must be positive");
+  if (!ksp->setupstage) {
+    gcrodr->k = k;
+  } else if (gcrodr->k != k) {
+    PetscCall(KSPReset_GCRODR(ksp));
+    gcrodr->k       = k;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleDimension_GCRODR(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  *k = ((KSP_GCRODR *)ksp->data)->k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRSetRecycleDimension - Sets the dimension of the subspace that `KSPGCRODR` recycles between restarts and between solves
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space solver context
+- k   - the dimension of the recycled space
+
+  Options Database Key:
+. -ksp_gcrodr_recycle <k> - the dimension of the recycled space
+
+  Level: intermediate
+
+  Notes:
+  The default is 10. The dimension must be smaller than the restart, see `KSPGMRESSetRestart()`, each cycle after the first one builds
+  a Krylov space of dimension the restart minus `k`.
+
+  Changing the dimension after the solver has been set up discards the recycled space.
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRGetRecycleDimension()`, `KSPGMRESSetRestart()`
+@*/
+PetscErrorCode KSPGCRODRSetRecycleDimension(KSP ksp, PetscInt k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, k, 2);
+  PetscTryMethod(ksp, "KSPGCRODRSetRecycleDimension_C", (KSP, PetscInt), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRGetRecycleDimension - Gets the dimension of the subspace that `KSPGCRODR` recycles between restarts and between solves
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. k - the dimension of the recycled space
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRSetRecycleDimension()`
+@*/
+PetscErrorCode KSPGCRODRGetRecycleDimension(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(k, 2);
+  PetscUseMethod(ksp, "KSPGCRODRGetRecycleDimension_C", (KSP, PetscInt *), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPGCRODR - Implements the Generalized Conjugate Residual method with inner Orthogonalization and Deflated Restarting
+   {cite}`parks2006recycling`, a restarted `KSPGMRES` that recycles a subspace between restarts and between consecutive solves
+
+   Options Database Keys:
++  -ksp_gmres_restart <restart>                                                - the dimension of the approximation space of each cycle, including the recycled space
+.  -ksp_gmres_haptol <tol>                                                     - sets the tolerance for "happy ending" (exact convergence)
+.  -ksp_gmres_classicalgramschmidt                                             - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space
+.  -ksp_gmres_modifiedgramschmidt                                              - use modified Gram-Schmidt in the orthogonalization
+.  -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the stability of the classical Gram-Schmidt orthogonalization
+.  -ksp_gcrodr_recycle <k>                                                     - the dimension of the recycled space
+-  -ksp_gcrodr_monitor                                                         - print the number of iterations with and without the recycled space after each solve
+
+   Level: intermediate
+
+   Notes:
+   At the end of each cycle the recycled space is replaced by the `k` harmonic Ritz vectors of the preconditioned operator associated with
+   the harmonic Ritz values of smallest magnitude. The next cycle, or the next call to `KSPSolve()`, starts by removing the component of the
+   residual in the image of this space, and then builds a Krylov space orthogonal to that image, so the eigenvalues of smallest magnitude
+   are effectively deflated.
+
+   The recycled space is kept until `KSPReset()` is called. When the operators change between two solves, for example in a Newton method
+   or in a time-stepping loop, its image is recomputed with `k` applications of the new preconditioned operator. This is effective when the
+   operators change slowly, otherwise `KSPReset()` discards the space.
+
+   The event `KSPGCRODRRecycle` of `-log_view` measures the cost of recomputing and updating the recycled space. The option
+   `-ksp_gcrodr_monitor` and `KSPView()` report the number of iterations with the recycled space and without it.
+
+   `KSPHPDDM` also provides GCRO-DR, with block variants, when PETSc is configured with HPDDM.
+
+   Developer Note:
+   This object is subclassed off of `KSPGMRES`, see the source code in src/ksp/ksp/impls/gmres for comments on the structure of the code
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPDGMRES`, `KSPHPDDM`, `KSPGCRODRSetRecycleDimension()`,
+          `KSPGMRESSetRestart()`, `KSPGMRESSetHapTol()`, `KSPGuess`
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&gcrodr));
+
+  ksp->data                = (void *)gcrodr;
+  ksp->ops->buildsolution  = KSPBuildSolution_GCRODR;
+  ksp->ops->setup          = KSPSetUp_GCRODR;
+  ksp->ops->solve          = KSPSolve_GCRODR;
+  ksp->ops->reset          = KSPReset_GCRODR;
+  ksp->ops->destroy        = KSPDestroy_GCRODR;
+  ksp->ops->view           = KSPView_GCRODR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_GCRODR;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetPreAllocateVectors_C", KSPGMRESSetPreAllocateVectors_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetOrthogonalization_C", KSPGMRESSetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetOrthogonalization_C", KSPGMRESGetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGCRODRSetRestart_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", KSPGMRESSetHapTol_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", KSPGMRESSetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", KSPGMRESGetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleDimension_C", KSPGCRODRSetRecycleDimension_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleDimension_C", KSPGCRODRGetRecycleDimension_GCRODR));
+
+  gcrodr->haptol         = 1.0e-30;
+  gcrodr->q_preallocate  = 0;
+  gcrodr->delta_allocate = GCRODR_DELTA_DIRECTIONS;
+  gcrodr->orthog         = KSPGMRESClassicalGramSchmidtOrthogonalization;
+  gcrodr->nrs            = NULL;
+  gcrodr->sol_temp       = NULL;
+  gcrodr->max_k          = GCRODR_DEFAULT_MAXK;
+  gcrodr->Rsvd           = NULL;
+  gcrodr->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  gcrodr->orthogwork     = NULL;
+  gcrodr->k              = GCRODR_DEFAULT_K;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  PetscInt         k;              /* maximum dimension of the recycled space */
+  PetscInt         r;              /* current dimension of the recycled space */
+  Vec             *U, *C;          /* the recycled space, C = op(A) U has orthonormal columns */
+  Vec             *U2, *C2;        /* the recycled space being computed at the end of a cycle */
+  PetscScalar     *B;              /* B = C^H op(A) V of the current cycle, k x max_k */
+  PetscScalar     *G, *G2, *WV;    /* the matrices of the harmonic Ritz problem, (max_k + 1) x max_k */
+  PetscScalar     *X, *eig;        /* eigenvectors and eigenvalues of the harmonic Ritz problem */
+  PetscScalar     *P, *tau;        /* selected harmonic Ritz vectors and Householder scalars */
+  PetscScalar     *h, *work;       /* dot products and LAPACK workspace */
+  PetscReal       *d, *rwork;      /* scaling of the columns of U, and LAPACK workspace */
+  PetscInt        *perm;
+  PetscBLASInt     lwork;
+  PetscObjectId    Aid, Pid;       /* the operators for which C = op(A) U */
+  PetscObjectState Astate, Pstate;
+  PCSide           side;
+  PetscBool        transpose;
+  PetscBool        monitor;        /* print the iteration savings after each solve */
+  PetscInt         its_first;      /* iterations of the last solve that started without a recycled space */
+  PetscInt         nrecycled;      /* number of solves that started with a recycled space */
+  PetscInt         its_recycled;   /* and their total number of iterations */
+} KSP_GCRODR;
+
+#define HH(a, b)  (gcrodr->hh_origin + (b) * (gcrodr->max_k + 2) + (a))
+#define HES(a, b) (gcrodr->hes_origin + (b) * (gcrodr->max_k + 1) + (a))
+#define CC(a)     (gcrodr->cc_origin + (a))
+#define SS(a)     (gcrodr->ss_origin + (a))
+#define GRS(a)    (gcrodr->rs_origin + (a))
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       gcrodr->vecs[0]
+#define VEC_TEMP_MATOP gcrodr->vecs[1]
+#define VEC_VV(i)      gcrodr->vecs[VEC_OFFSET + i]
+
+#define GCRODR_DELTA_DIRECTIONS 10
+#define GCRODR_DEFAULT_MAXK     30
+#define GCRODR_DEFAULT_K        10
@@ -0,0 +1,765 @@
+/*
+    This file implements s-step GMRES, also called communication-avoiding GMRES {cite}`mohiyuddin2009minimizing`
+
+    Each block generates s Krylov vectors p_1, ..., p_s from the last basis vector p_0 with the three-term recurrence
+       p_{j+1} = gamma_j ((A - alpha_j I) p_j - delta_j p_{j-1})
+    of KSPSStepBasisSetUp_Private(), orthogonalizes them against the basis with one block classical Gram-Schmidt step and
+    among themselves with a Cholesky QR factorization, which together need a single reduction, and recovers the s new columns
+    of the Hessenberg matrix from the change of basis.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/sgmres/sgmresimpl.h> /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP, PetscInt, PetscBool, PetscReal *);
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar *, Vec, Vec, KSP, PetscInt);
+
+static PetscErrorCode KSPSetUp_SGMRES(KSP ksp)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt    ld = sgmres->max_k + 2, s = sgmres->s;
+
+  PetscFunctionBegin;
+  PetscCheck(s <= sgmres->max_k, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The number of steps %" PetscInt_FMT " cannot exceed the restart %" PetscInt_FMT, s, sgmres->max_k);
+  PetscCall(KSPSetUp_GMRES(ksp));
+  PetscCall(PetscMalloc1(ld, &sgmres->orthogwork));
+  PetscCall(PetscMalloc3(s, &sgmres->gamma, s, &sgmres->alpha, s, &sgmres->delta));
+  PetscCall(PetscMalloc6(ld * s, &sgmres->G, ld * s, &sgmres->G2, s * s, &sgmres->R, s * s, &sgmres->R2, ld * (s + 1), &sgmres->T, ld * s, &sgmres->X));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthogonalizes the m vectors VEC_VV(nq), ..., VEC_VV(nq + m - 1) against VEC_VV(0), ..., VEC_VV(nq - 1) and among themselves.
+
+   A single reduction computes G = [V P]^H P, the first nq rows of G are the coefficients B = V^H P of the block classical Gram-Schmidt step
+   and the Cholesky factor of P^H P - B^H B gives the upper triangular R (with leading dimension m) such that P = V B + Q R.
+
+   On output m is the number of leading vectors that remained numerically linearly independent, only those are orthonormalized.
+*/
+static PetscErrorCode KSPSGMRESBlockOrthogonalize(KSP ksp, PetscInt nq, PetscInt *m, PetscScalar *G, PetscScalar *R)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt     ld = sgmres->max_k + 2, ldr = *m, k = *m;
+  PetscScalar *work = sgmres->orthogwork;
+  PetscBLASInt bk, info;
+
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < k; j++) PetscCall(VecMDotBegin(VEC_VV(nq + j), nq + j + 1, &VEC_VV(0), G + j * ld));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(0))));
+  for (PetscInt j = 0; j < k; j++) PetscCall(VecMDotEnd(VEC_VV(nq + j), nq + j + 1, &VEC_VV(0), G + j * ld));
+
+  for (PetscInt j = 0; j < k; j++) {
+    for (PetscInt i = 0; i < k; i++) {
+      PetscScalar c = 0.0;
+
+      if (i <= j) {
+        c = G[nq + i + j * ld];
+        for (PetscInt l = 0; l < nq; l++) c -= PetscConj(G[l + i * ld]) * G[l + j * ld];
+      }
+      R[i + j * ldr] = c;
+    }
+  }
+  PetscCall(PetscBLASIntCast(k, &bk));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bk, R, &bk, &info));
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(info >= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, info);
+  if (info) k = info - 1;
+  /* a vector whose component orthogonal to the previous ones is at the level of the rounding errors in the Gram matrix is discarded */
+  for (PetscInt j = 0; j < k; j++) {
+    if (PetscSqr(PetscRealPart(R[j + j * ldr])) <= 100 * PETSC_MACHINE_EPSILON * PetscAbsScalar(G[nq + j + j * ld])) {
+      k = j;
+      break;
+    }
+  }
+
+  /* Q = (P - V B) R^{-1}, column by column since each column uses the previous ones */
+  for (PetscInt j = 0; j < k; j++) {
+    for (PetscInt l = 0; l < nq; l++) work[l] = -G[l + j * ld];
+    for (PetscInt l = 0; l < j; l++) work[nq + l] = -R[l + j * ldr];
+    PetscCall(VecMAXPY(VEC_VV(nq + j), nq + j, work, &VEC_VV(0)));
+    PetscCall(VecScale(VEC_VV(nq + j), 1.0 / R[j + j * ldr]));
+  }
+  *m = k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Generates up to k new basis vectors from VEC_VV(it) and the corresponding columns it, ..., it + k - 1 of the Hessenberg matrix.
+
+   With p_0 = v_it the block satisfies A [p_0 ... p_{k-1}] = [p_0 ... p_k] Bm, with the (k + 1) x k tridiagonal Bm given by the recurrence,
+   and [p_0 ... p_k] = V T after the orthogonalization. Splitting the first k columns of T as [T_top; T_bot], where T_bot is the upper
+   triangular block in the rows it, ..., it + k - 1, the new columns of the Hessenberg matrix are (T Bm - [H T_top; 0]) T_bot^{-1}.
+
+   On output k is the number of columns computed and hapend indicates that the last one has a zero subdiagonal entry.
+*/
+static PetscErrorCode KSPSGMRESBlock(KSP ksp, PetscInt it, PetscInt *k, PetscBool *hapend)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt     ld = sgmres->max_k + 2, nq = it + 1, ldr = *k, m = *k, ldr2;
+  PetscScalar *gamma = sgmres->gamma, *alpha = sgmres->alpha, *delta = sgmres->delta;
+  PetscScalar *G = sgmres->G, *G2 = sgmres->G2, *R = sgmres->R, *R2 = sgmres->R2, *T = sgmres->T, *X = sgmres->X;
+
+  PetscFunctionBegin;
+  *hapend = PETSC_FALSE;
+  for (PetscInt j = 0; j < m; j++) {
+    Vec p = VEC_VV(it + j), q = VEC_VV(it + j + 1);
+
+    PetscCall(KSP_PCApplyBAorAB(ksp, p, q, VEC_TEMP_MATOP));
+    if (j && delta[j] != 0.0) PetscCall(VecAXPBYPCZ(q, -gamma[j] * alpha[j], -gamma[j] * delta[j], gamma[j], p, VEC_VV(it + j - 1)));
+    else if (alpha[j] != 0.0 || gamma[j] != 1.0) PetscCall(VecAXPBY(q, -gamma[j] * alpha[j], gamma[j], p));
+  }
+  if (ksp->reason) {
+    *k = 0;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  PetscCall(KSPSGMRESBlockOrthogonalize(ksp, nq, &m, G, R));
+  if (!m) {
+    /* A p_0 is in the span of the basis, which is therefore an invariant subspace */
+    for (PetscInt r = 0; r <= nq; r++) *HES(r, it) = *HH(r, it) = r < nq ? G[r] / gamma[0] + (r == it ? alpha[0] : 0.0) : 0.0;
+    *k      = 1;
+    *hapend = PETSC_TRUE;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  ldr2 = m;
+  if (sgmres->cholqr2) PetscCall(KSPSGMRESBlockOrthogonalize(ksp, nq, &m, G2, R2));
+  *k = m;
+  if (!m) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscArrayzero(T, ld * (m + 1)));
+  T[nq - 1] = 1.0;
+  for (PetscInt j = 0; j < m; j++) {
+    PetscScalar *t = T + (j + 1) * ld;
+
+    for (PetscInt l = 0; l < nq; l++) t[l] = G[l + j * ld];
+    if (!sgmres->cholqr2) {
+      for (PetscInt l = 0; l <= j; l++) t[nq + l] = R[l + j * ldr];
+    } else {
+      /* P = V B + Q R and Q = V B2 + Q2 R2 give P = V (B + B2 R) + Q2 R2 R */
+      for (PetscInt i = 0; i <= j; i++) {
+        for (PetscInt l = 0; l < nq; l++) t[l] += G2[l + i * ld] * R[i + j * ldr];
+      }
+      for (PetscInt l = 0; l <= j; l++) {
+        t[nq + l] = 0.0;
+        for (PetscInt i = l; i <= j; i++) t[nq + l] += R2[l + i * ldr2] * R[i + j * ldr];
+      }
+    }
+  }
+
+  for (PetscInt i = 0; i < m; i++) {
+    PetscScalar *x = X + i * ld, *t = T + i * ld;
+
+    for (PetscInt r = 0; r < nq + m; r++) x[r] = t[ld + r] / gamma[i] + alpha[i] * t[r] + (i ? delta[i] * t[r - ld] : 0.0);
+    for (PetscInt l = 0; l < nq - 1; l++) {
+      if (t[l] == 0.0) continue;
+      for (PetscInt r = 0; r <= l + 1; r++) x[r] -= *HES(r, l) * t[l];
+    }
+    for (PetscInt l = 0; l < i; l++) {
+      for (PetscInt r = 0; r < nq + m; r++) x[r] -= X[r + l * ld] * t[nq - 1 + l];
+    }
+    for (PetscInt r = 0; r < nq + m; r++) x[r] /= t[nq - 1 + i];
+  }
+  for (PetscInt i = 0; i < m; i++) {
+    for (PetscInt r = 0; r < nq + m; r++) *HES(r, it + i) = *HH(r, it + i) = r <= it + i + 1 ? X[r + i * ld] : 0.0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* The Ritz values of the leading s x s block of the Hessenberg matrix define the shifts of the Newton and Chebyshev bases */
+static PetscErrorCode KSPSGMRESComputeShifts(KSP ksp)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt     s      = sgmres->s;
+  PetscScalar *H, *work, sdummy = 0.0;
+  PetscReal   *re, *im;
+  PetscBLASInt bs, lwork, idummy = 1, info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscBLASIntCast(s, &bs));
+  PetscCall(PetscBLASIntCast(5 * s, &lwork));
+  PetscCall(PetscMalloc4(s * s, &H, 5 * s, &work, s, &re, s, &im));
+  for (PetscInt j = 0; j < s; j++) {
+    for (PetscInt i = 0; i < s; i++) H[i + j * s] = *HES(i, j);
+  }
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "N", &bs, H, &bs, re, im, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, &info));
+#else
+  {
+    PetscScalar *eigs;
+    PetscReal   *rwork;
+
+    PetscCall(PetscMalloc2(s, &eigs, 2 * s, &rwork));
+    PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "N", &bs, H, &bs, eigs, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, rwork, &info));
+    for (PetscInt i = 0; i < s; i++) {
+      re[i] = PetscRealPart(eigs[i]);
+      im[i] = PetscImaginaryPart(eigs[i]);
+    }
+    PetscCall(PetscFree2(eigs, rwork));
+  }
+#endif
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, info);
+  PetscCall(KSPSStepBasisSetUp_Private(sgmres->basis, s, s, re, im, sgmres->gamma, sgmres->alpha, sgmres->delta));
+  PetscCall(PetscFree4(H, work, re, im));
+  sgmres->haveshifts = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESCycle(PetscInt *itcount, KSP ksp)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscReal   res;
+  PetscInt    it = 0, max_k = sgmres->max_k;
+  PetscBool   hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  PetscCall(VecNormalize(VEC_VV(0), &res));
+  KSPCheckNorm(ksp, res);
+  *RS(0) = sgmres->rnorm0 = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = res;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  sgmres->it = it - 1;
+  PetscCall(KSPLogResidualHistory(ksp, res));
+  PetscCall(KSPLogErrorHistory(ksp));
+  PetscCall(KSPMonitor(ksp, ksp->its, res));
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* check for the convergence */
+  PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    PetscInt  k, nk;
+    PetscBool invariant;
+
+    /* until the Ritz values that define the shifts of the Newton and Chebyshev bases are known, build one vector at a time */
+    k = sgmres->haveshifts || sgmres->basis == KSP_SSTEP_BASIS_MONOMIAL ? sgmres->s : 1;
+    k = PetscMin(k, PetscMin(max_k - it, ksp->max_it - ksp->its));
+    while (sgmres->vv_allocated <= it + k + VEC_OFFSET) PetscCall(KSPGMRESGetNewVectors(ksp, sgmres->vv_allocated - VEC_OFFSET));
+    nk = k;
+    PetscCall(KSPSGMRESBlock(ksp, it, &nk, &invariant));
+    if (ksp->reason) break;
+    if (!nk) {
+      PetscCall(PetscInfo(ksp, "The block of %" PetscInt_FMT " vectors at iteration %" PetscInt_FMT " is numerically rank deficient\n", k, ksp->its));
+      if (!it) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "The s-step basis broke down, use a smaller number of steps or another basis");
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      }
+      break;
+    }
+
+    for (PetscInt i = 0; i < nk; i++) {
+      PetscReal tt = PetscAbsScalar(*HES(it + 1, it)), hapbnd;
+
+      if (it) {
+        PetscCall(KSPLogResidualHistory(ksp, res));
+        PetscCall(KSPLogErrorHistory(ksp));
+        PetscCall(KSPMonitor(ksp, ksp->its, res));
+      }
+      /* check for the happy breakdown */
+      hapbnd = PetscMin(PetscAbsScalar(tt / *RS(it)), sgmres->haptol);
+      hapend = (PetscBool)(tt < hapbnd || (invariant && i == nk - 1));
+      if (hapend) PetscCall(PetscInfo(ksp, "Detected happy ending, current hapbnd = %14.12e tt = %14.12e\n", (double)hapbnd, (double)tt));
+      PetscCall(KSPSGMRESUpdateHessenberg(ksp, it, hapend, &res));
+
+      it++;
+      sgmres->it = it - 1; /* For converged */
+      ksp->its++;
+      ksp->rnorm = res;
+      if (ksp->reason) break;
+
+      PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+          ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        } else if (!ksp->reason) {
+          PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+          ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        }
+      }
+      if (ksp->reason) break;
+    }
+    if (ksp->reason) break;
+    if (!sgmres->haveshifts && sgmres->basis != KSP_SSTEP_BASIS_MONOMIAL && it >= sgmres->s) PetscCall(KSPSGMRESComputeShifts(ksp));
+    /* the remaining vectors of the block were numerically linearly dependent, restart from the new residual */
+    if (nk < k) {
+      PetscCall(PetscInfo(ksp, "Only %" PetscInt_FMT " of the %" PetscInt_FMT " vectors of the block are linearly independent, restarting\n", nk, k));
+      break;
+    }
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far) */
+  PetscCall(KSPSGMRESBuildSoln(RS(0), ksp->vec_sol, ksp->vec_sol, ksp, it - 1));
+
+  /* Monitor if we know that we will not return for a restart */
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (it && ksp->reason) {
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPLogErrorHistory(ksp));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_SGMRES(KSP ksp)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt    its, itcount;
+  PetscBool   guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  PetscCheck(!ksp->calc_sings || sgmres->Rsvd, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ORDER, "Must call KSPSetComputeSingularValues() before KSPSetUp() is called");
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+  /* the shifts are recomputed for each solve since the operator may have changed */
+  PetscCall(KSPSStepBasisSetUp_Private(sgmres->basis, sgmres->s, 0, NULL, NULL, sgmres->gamma, sgmres->alpha, sgmres->delta));
+  sgmres->haveshifts = PETSC_FALSE;
+
+  itcount     = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, VEC_TEMP, VEC_TEMP_MATOP, VEC_VV(0), ksp->vec_rhs));
+    PetscCall(KSPSGMRESCycle(&its, ksp));
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_SGMRES(KSP ksp)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree3(sgmres->gamma, sgmres->alpha, sgmres->delta));
+  PetscCall(PetscFree6(sgmres->G, sgmres->G2, sgmres->R, sgmres->R2, sgmres->T, sgmres->X));
+  PetscCall(KSPReset_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_SGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_SGMRES(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESSetSteps_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESGetSteps_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESSetBasisType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESGetBasisType_C", NULL));
+  PetscCall(KSPDestroy_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar *nrs, Vec vs, Vec vdest, KSP ksp, PetscInt it)
+{
+  PetscScalar tt;
+  PetscInt    ii, k, j;
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  /* Solve for solution vector that minimizes the residual */
+
+  /* If it is < 0, no sgmres steps have been performed */
+  if (it < 0) {
+    PetscCall(VecCopy(vs, vdest)); /* VecCopy() is smart, exists immediately if vguess == vdest */
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (*HH(it, it) != 0.0) {
+    nrs[it] = *RS(it) / *HH(it, it);
+  } else {
+    PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "You reached the break down in SGMRES; HH(it,it) = 0");
+    ksp->reason = KSP_DIVERGED_BREAKDOWN;
+
+    PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(it,it) is identically zero; it = %" PetscInt_FMT " RS(it) = %g\n", it, (double)PetscAbsScalar(*RS(it))));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (ii = 1; ii <= it; ii++) {
+    k  = it - ii;
+    tt = *RS(k);
+    for (j = k + 1; j <= it; j++) tt = tt - *HH(k, j) * nrs[j];
+    if (*HH(k, k) == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT, k);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT "\n", k));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    nrs[k] = tt / *HH(k, k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP */
+  PetscCall(VecMAXPBY(VEC_TEMP, it + 1, nrs, 0, &VEC_VV(0)));
+
+  PetscCall(KSPUnwindPreconditioner(ksp, VEC_TEMP, VEC_TEMP_MATOP));
+  /* add solution to previous solution */
+  if (vdest != vs) PetscCall(VecCopy(vs, vdest));
+  PetscCall(VecAXPY(vdest, 1.0, VEC_TEMP));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Do the scalar work for the orthogonalization.  Return new residual norm.
+ */
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP ksp, PetscInt it, PetscBool hapend, PetscReal *res)
+{
+  PetscScalar *hh, *cc, *ss, tt;
+  PetscInt     j;
+  KSP_SGMRES  *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  hh = HH(0, it);
+  cc = CC(0);
+  ss = SS(0);
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  for (j = 1; j <= it; j++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh + 1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+
+  /*
+    compute the new plane rotation, and apply it to:
+     1) the right-hand side of the Hessenberg system
+     2) the new column of the Hessenberg matrix
+    thus obtaining the updated value of the residual
+  */
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh + 1)) * *(hh + 1));
+    if (tt == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "tt == 0.0");
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    *cc         = *hh / tt;
+    *ss         = *(hh + 1) / tt;
+    *RS(it + 1) = -(*ss * *RS(it));
+    *RS(it)     = PetscConj(*cc) * *RS(it);
+    *hh         = PetscConj(*cc) * *hh + *ss * *(hh + 1);
+    *res        = PetscAbsScalar(*RS(it + 1));
+  } else {
+    /* happy breakdown: HH(it+1, it) = 0, the residual is zero */
+    *res = 0.0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPBuildSolution_SGMRES(KSP ksp, Vec ptr, Vec *result)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!sgmres->sol_temp) PetscCall(VecDuplicate(ksp->vec_sol, &sgmres->sol_temp));
+    ptr = sgmres->sol_temp;
+  }
+  if (!sgmres->nrs) {
+    /* allocate the work area */
+    PetscCall(PetscMalloc1(sgmres->max_k, &sgmres->nrs));
+  }
+
+  PetscCall(KSPSGMRESBuildSoln(sgmres->nrs, ksp->vec_sol, ptr, ksp, sgmres->it));
+  if (result) *result = ptr;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_SGMRES(KSP ksp, PetscViewer viewer)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+  const char *cstr   = sgmres->cholqr2 ? "block classical Gram-Schmidt and Cholesky QR applied twice" : "block classical Gram-Schmidt and Cholesky QR";
+  PetscBool   iascii, isstring;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERSTRING, &isstring));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  restart=%" PetscInt_FMT ", %" PetscInt_FMT " steps per block using the %s basis\n", sgmres->max_k, sgmres->s, KSPSStepBasisTypes[sgmres->basis]));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  orthogonalization with %s\n", cstr));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  happy breakdown tolerance %g\n", (double)sgmres->haptol));
+  } else if (isstring) {
+    PetscCall(PetscViewerStringSPrintf(viewer, "%s restart %" PetscInt_FMT " steps %" PetscInt_FMT, KSPSStepBasisTypes[sgmres->basis], sgmres->max_k, sgmres->s));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_SGMRES(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_SGMRES       *sgmres = (KSP_SGMRES *)ksp->data;
+  PetscInt          restart, s;
+  PetscReal         haptol;
+  KSPSStepBasisType basis;
+  PetscBool         flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP s-step GMRES Options");
+  PetscCall(PetscOptionsInt("-ksp_gmres_restart", "Number of Krylov search directions", "KSPGMRESSetRestart", sgmres->max_k, &restart, &flg));
+  if (flg) PetscCall(KSPGMRESSetRestart(ksp, restart));
+  PetscCall(PetscOptionsReal("-ksp_gmres_haptol", "Tolerance for exact convergence (happy ending)", "KSPGMRESSetHapTol", sgmres->haptol, &haptol, &flg));
+  if (flg) PetscCall(KSPGMRESSetHapTol(ksp, haptol));
+  PetscCall(PetscOptionsInt("-ksp_sgmres_steps", "Number of Krylov vectors generated and orthogonalized at once", "KSPSGMRESSetSteps", sgmres->s, &s, &flg));
+  if (flg) PetscCall(KSPSGMRESSetSteps(ksp, s));
+  PetscCall(PetscOptionsEnum("-ksp_sgmres_basis", "Polynomial basis used to generate the Krylov vectors", "KSPSGMRESSetBasisType", KSPSStepBasisTypes, (PetscEnum)sgmres->basis, (PetscEnum *)&basis, &flg));
+  if (flg) PetscCall(KSPSGMRESSetBasisType(ksp, basis));
+  PetscCall(PetscOptionsBool("-ksp_sgmres_cholqr2", "Orthogonalize each block twice", NULL, sgmres->cholqr2, &sgmres->cholqr2, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESSetRestart_SGMRES(KSP ksp, PetscInt max_k)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Restart must be positive");
+  if (!ksp->setupstage) {
+    sgmres->max_k = max_k;
+  } else if (sgmres->max_k != max_k) {
+    sgmres->max_k   = max_k;
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    PetscCall(KSPReset_SGMRES(ksp));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESSetSteps_SGMRES(KSP ksp, PetscInt s)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(s >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The number of steps must be positive");
+  if (!ksp->setupstage) {
+    sgmres->s = s;
+  } else if (sgmres->s != s) {
+    sgmres->s       = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+    PetscCall(KSPReset_SGMRES(ksp));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESGetSteps_SGMRES(KSP ksp, PetscInt *s)
+{
+  PetscFunctionBegin;
+  *s = ((KSP_SGMRES *)ksp->data)->s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESSetBasisType_SGMRES(KSP ksp, KSPSStepBasisType basis)
+{
+  PetscFunctionBegin;
+  ((KSP_SGMRES *)ksp->data)->basis = basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSGMRESGetBasisType_SGMRES(KSP ksp, KSPSStepBasisType *basis)
+{
+  PetscFunctionBegin;
+  *basis = ((KSP_SGMRES *)ksp->data)->basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSGMRESSetSteps - Sets the number of Krylov vectors that `KSPSGMRES` generates and orthogonalizes at once
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space solver context
+- s   - the number of steps
+
+  Options Database Key:
+. -ksp_sgmres_steps <s> - the number of steps
+
+  Level: intermediate
+
+  Notes:
+  The default is 4. The number of global reductions is reduced by a factor of about `s` compared to `KSPGMRES` with classical Gram-Schmidt,
+  but the basis of the Krylov space becomes more ill-conditioned as `s` grows, which limits `s` to about 10 with the Newton basis.
+
+  The number of steps cannot exceed the restart, see `KSPGMRESSetRestart()`.
+
+.seealso: [](ch_ksp), `KSPSGMRES`, `KSPSGMRESGetSteps()`, `KSPSGMRESSetBasisType()`, `KSPGMRESSetRestart()`
+@*/
+PetscErrorCode KSPSGMRESSetSteps(KSP ksp, PetscInt s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, s, 2);
+  PetscTryMethod(ksp, "KSPSGMRESSetSteps_C", (KSP, PetscInt), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSGMRESGetSteps - Gets the number of Krylov vectors that `KSPSGMRES` generates and orthogonalizes at once
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. s - the number of steps
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSGMRES`, `KSPSGMRESSetSteps()`
+@*/
+PetscErrorCode KSPSGMRESGetSteps(KSP ksp, PetscInt *s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(s, 2);
+  PetscUseMethod(ksp, "KSPSGMRESGetSteps_C", (KSP, PetscInt *), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSGMRESSetBasisType - Sets the polynomial basis that `KSPSGMRES` uses to generate the Krylov vectors
+
+  Logically Collective
+
+  Input Parameters:
++ ksp   - the Krylov space solver context
+- basis - the basis, `KSP_SSTEP_BASIS_MONOMIAL`, `KSP_SSTEP_BASIS_NEWTON`, or `KSP_SSTEP_BASIS_CHEBYSHEV`
+
+  Options Database Key:
+. -ksp_sgmres_basis <newton,monomial,chebyshev> - the basis
+
+  Level: intermediate
+
+  Note:
+  The default is `KSP_SSTEP_BASIS_NEWTON`. The Newton and Chebyshev bases need Ritz values, so the first `s` iterations of each solve build
+  one Krylov vector at a time.
+
+.seealso: [](ch_ksp), `KSPSGMRES`, `KSPSStepBasisType`, `KSPSGMRESGetBasisType()`, `KSPSGMRESSetSteps()`
+@*/
+PetscErrorCode KSPSGMRESSetBasisType(KSP ksp, KSPSStepBasisType basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, basis, 2);
+  PetscTryMethod(ksp, "KSPSGMRESSetBasisType_C", (KSP, KSPSStepBasisType), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSGMRESGetBasisType - Gets the polynomial basis that `KSPSGMRES` uses to generate the Krylov vectors
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. basis - the basis
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSGMRES`, `KSPSStepBasisType`, `KSPSGMRESSetBasisType()`
+@*/
+PetscErrorCode KSPSGMRESGetBasisType(KSP ksp, KSPSStepBasisType *basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(basis, 2);
+  PetscUseMethod(ksp, "KSPSGMRESGetBasisType_C", (KSP, KSPSStepBasisType *), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPSGMRES - Implements the s-step, or communication-avoiding, Generalized Minimal Residual method {cite}`mohiyuddin2009minimizing`
+
+   Options Database Keys:
++  -ksp_gmres_restart <restart>                    - the number of Krylov directions to orthogonalize against
+.  -ksp_gmres_haptol <tol>                         - sets the tolerance for "happy ending" (exact convergence)
+.  -ksp_sgmres_steps <s>                           - the number of Krylov vectors generated and orthogonalized at once
+.  -ksp_sgmres_basis <newton,monomial,chebyshev>   - the polynomial basis used to generate them
+-  -ksp_sgmres_cholqr2 <bool>                      - orthogonalize each block a second time, doubling the number of reductions
+
+   Level: intermediate
+
+   Notes:
+   Each block of `s` iterations applies the operator `s` times to generate `s` new Krylov vectors, then orthogonalizes them against the
+   previous basis vectors with a block classical Gram-Schmidt step and among themselves with a Cholesky QR factorization. Both need only
+   the Gram matrix of the block against the basis, so there is a single global reduction per block instead of one or two per iteration.
+
+   The monomial basis is quickly numerically rank deficient, the default Newton basis uses Leja ordered Ritz values as shifts
+   {cite}`philippe2012generation`. The Ritz values are computed from `s` iterations that build one vector at a time at the start of each solve.
+   A block that loses rank is truncated and the method restarts.
+
+   The residual norms are the same as those of `KSPGMRES` in exact arithmetic, only the first `s` iterations of a solve have the
+   same cost in reductions as `KSPGMRES`.
+
+   Developer Note:
+   This object is subclassed off of `KSPGMRES`, see the source code in src/ksp/ksp/impls/gmres for comments on the structure of the code
+
+.seealso: [](ch_ksp), [](sec_pipelineksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPPGMRES`, `KSPSCG`,
+          `KSPSGMRESSetSteps()`, `KSPSGMRESSetBasisType()`, `KSPSStepBasisType`, `KSPGMRESSetRestart()`, `KSPGMRESSetHapTol()`
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP ksp)
+{
+  KSP_SGMRES *sgmres;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&sgmres));
+
+  ksp->data                              = (void *)sgmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_SGMRES;
+  ksp->ops->setup                        = KSPSetUp_SGMRES;
+  ksp->ops->solve                        = KSPSolve_SGMRES;
+  ksp->ops->reset                        = KSPReset_SGMRES;
+  ksp->ops->destroy                      = KSPDestroy_SGMRES;
+  ksp->ops->view                         = KSPView_SGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_SGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetPreAllocateVectors_C", KSPGMRESSetPreAllocateVectors_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPSGMRESSetRestart_SGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", KSPGMRESSetHapTol_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESSetSteps_C", KSPSGMRESSetSteps_SGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESGetSteps_C", KSPSGMRESGetSteps_SGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESSetBasisType_C", KSPSGMRESSetBasisType_SGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSGMRESGetBasisType_C", KSPSGMRESGetBasisType_SGMRES));
+
+  sgmres->nextra_vecs    = 1;
+  sgmres->haptol         = 1.0e-30;
+  sgmres->q_preallocate  = 0;
+  sgmres->delta_allocate = SGMRES_DELTA_DIRECTIONS;
+  sgmres->orthog         = NULL;
+  sgmres->nrs            = NULL;
+  sgmres->sol_temp       = NULL;
+  sgmres->max_k          = SGMRES_DEFAULT_MAXK;
+  sgmres->Rsvd           = NULL;
+  sgmres->orthogwork     = NULL;
+  sgmres->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  sgmres->s              = SGMRES_DEFAULT_S;
+  sgmres->basis          = KSP_SSTEP_BASIS_NEWTON;
+  sgmres->cholqr2        = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  PetscInt          s;                     /* number of Krylov vectors generated and orthogonalized at once */
+  KSPSStepBasisType basis;                 /* polynomial basis used to generate them */
+  PetscBool         cholqr2;               /* orthogonalize each block a second time */
+  PetscBool         haveshifts;            /* the basis coefficients have been computed from Ritz values */
+  PetscScalar      *gamma, *alpha, *delta; /* coefficients of the three-term recurrence generating the basis */
+  PetscScalar      *G, *G2;                /* Gram matrices of the block against the basis, (max_k + 2) x s */
+  PetscScalar      *R, *R2;                /* Cholesky factors, s x s */
+  PetscScalar      *T;                     /* the block in the orthonormal basis, (max_k + 2) x (s + 1) */
+  PetscScalar      *X;                     /* new columns of the Hessenberg matrix, (max_k + 2) x s */
+} KSP_SGMRES;
+
+#define HH(a, b) (sgmres->hh_origin + (b) * (sgmres->max_k + 2) + (a))
+/* HH will be size (max_k+2)*(max_k+1)  -  think of HH as being stored columnwise for access purposes. */
+#define HES(a, b) (sgmres->hes_origin + (b) * (sgmres->max_k + 1) + (a))
+/* HES will be size (max_k + 1) * (max_k + 1) -  again, think of HES as being stored columnwise */
+#define CC(a) (sgmres->cc_origin + (a)) /* CC will be length (max_k+1) - cosines */
+#define SS(a) (sgmres->ss_origin + (a)) /* SS will be length (max_k+1) - sines */
+#define RS(a) (sgmres->rs_origin + (a)) /* RS will be length (max_k+2) - rt side */
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       sgmres->vecs[0]              /* work space */
+#define VEC_TEMP_MATOP sgmres->vecs[1]              /* work space */
+#define VEC_VV(i)      sgmres->vecs[VEC_OFFSET + i] /* use to access othog basis vectors */
+
+#define SGMRES_DELTA_DIRECTIONS 10
+#define SGMRES_DEFAULT_MAXK     30
+#define SGMRES_DEFAULT_S        4
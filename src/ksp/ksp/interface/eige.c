@@ -309,3 +309,111 @@ PetscErrorCode KSPPlotEigenContours_Private(KSP ksp, PetscInt neig, const PetscR
   PetscCall(PetscFree3(xloc, yloc, value));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+static PetscErrorCode KSPSStepSwap_Private(PetscReal re[], PetscReal im[], PetscInt i, PetscInt j)
+{
+  PetscReal tr = re[i], ti = im[i];
+
+  PetscFunctionBegin;
+  re[i] = re[j];
+  im[i] = im[j];
+  re[j] = tr;
+  im[j] = ti;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Leja ordering of the Ritz values, in real arithmetic the two members of a complex conjugate pair are kept adjacent */
+static PetscErrorCode KSPSStepLejaOrder_Private(PetscInt n, PetscReal re[], PetscReal im[])
+{
+  PetscFunctionBegin;
+  for (PetscInt k = 0; k < n;) {
+    PetscInt  best    = k;
+    PetscReal bestval = PETSC_NINFINITY;
+
+    for (PetscInt i = k; i < n; i++) {
+      PetscReal val = 0.0;
+
+#if !defined(PETSC_USE_COMPLEX)
+      if (im[i] < 0.0) continue;
+#endif
+      if (!k) val = PetscSqrtReal(PetscSqr(re[i]) + PetscSqr(im[i]));
+      else {
+        for (PetscInt j = 0; j < k; j++) val += PetscLogReal(PetscSqrtReal(PetscSqr(re[i] - re[j]) + PetscSqr(im[i] - im[j])));
+      }
+      if (val > bestval) {
+        best    = i;
+        bestval = val;
+      }
+    }
+    PetscCall(KSPSStepSwap_Private(re, im, k, best));
+    k++;
+#if !defined(PETSC_USE_COMPLEX)
+    if (im[k - 1] > 0.0) {
+      for (PetscInt i = k; i < n; i++) {
+        if (re[i] == re[k - 1] && im[i] == -im[k - 1]) {
+          PetscCall(KSPSStepSwap_Private(re, im, k, i));
+          k++;
+          break;
+        }
+      }
+    }
+#endif
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  KSPSStepBasisSetUp_Private - Computes the coefficients of the three-term recurrence p_{j+1} = gamma_j ((A - alpha_j I) p_j - delta_j p_{j-1}), j = 0, ..., s - 1,
+  that generates the s-step basis of the given type from n Ritz values of A; the Ritz values are reordered
+
+  The relation A p_j = p_{j+1} / gamma_j + alpha_j p_j + delta_j p_{j-1} gives the change of basis matrix used by the s-step methods. In real arithmetic a
+  complex conjugate pair of shifts theta, conj(theta) is applied as (A - Re(theta) I)^2 + Im(theta)^2 I so that the basis stays real.
+*/
+PetscErrorCode KSPSStepBasisSetUp_Private(KSPSStepBasisType type, PetscInt s, PetscInt n, PetscReal re[], PetscReal im[], PetscScalar gamma[], PetscScalar alpha[], PetscScalar delta[])
+{
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < s; j++) {
+    gamma[j] = 1.0;
+    alpha[j] = 0.0;
+    delta[j] = 0.0;
+  }
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  switch (type) {
+  case KSP_SSTEP_BASIS_MONOMIAL:
+    break;
+  case KSP_SSTEP_BASIS_NEWTON:
+    PetscCall(KSPSStepLejaOrder_Private(n, re, im));
+    for (PetscInt j = 0; j < s; j++) {
+      PetscInt i = j % n;
+
+#if defined(PETSC_USE_COMPLEX)
+      alpha[j] = PetscCMPLX(re[i], im[i]);
+#else
+      alpha[j] = re[i];
+      if (im[i] > 0.0 && j + 1 < s && i + 1 < n) {
+        alpha[j + 1] = re[i];
+        delta[j + 1] = -PetscSqr(im[i]);
+        j++;
+      }
+#endif
+    }
+    break;
+  case KSP_SSTEP_BASIS_CHEBYSHEV: {
+    PetscReal lmin = re[0], lmax = re[0], c, h;
+
+    for (PetscInt i = 1; i < n; i++) {
+      lmin = PetscMin(lmin, re[i]);
+      lmax = PetscMax(lmax, re[i]);
+    }
+    c = 0.5 * (lmax + lmin);
+    h = 0.5 * (lmax - lmin);
+    if (h <= PETSC_SMALL * PetscAbsReal(c)) h = PetscAbsReal(c) > 0.0 ? PetscAbsReal(c) : 1.0;
+    for (PetscInt j = 0; j < s; j++) {
+      gamma[j] = j ? 2.0 / h : 1.0 / h;
+      alpha[j] = c;
+      delta[j] = j ? 0.5 * h : 0.0;
+    }
+  } break;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -1292,7 +1292,12 @@ static PetscErrorCode KSPMatSolve_Private(KSP ksp, Mat B, Mat X)
 
   Unlike with `KSPSolve()`, `B` and `X` must be different matrices.
 
-.seealso: [](ch_ksp), `KSPSolve()`, `MatMatSolve()`, `KSPMatSolveTranspose()`, `MATDENSE`, `KSPHPDDM`, `PCBJACOBI`, `PCASM`, `KSPSetMatSolveBatchSize()`
+  The products of the operator with a block of vectors, for example in `KSPHPDDM` or for `-ksp_view_final_residual`, are done
+  with `MatMatMult()` and a `MATDENSE` block, there is no separate multi-vector `MatMult()`. For `MATSEQAIJ` and `MATMPIAIJ`
+  these products traverse the sparse matrix once for every 32 columns of the block.
+
+.seealso: [](ch_ksp), `KSPSolve()`, `MatMatSolve()`, `KSPMatSolveTranspose()`, `MATDENSE`, `KSPHPDDM`, `PCBJACOBI`, `PCASM`, `KSPSetMatSolveBatchSize()`,
+          `MatMatMult()`
 @*/
 PetscErrorCode KSPMatSolve(KSP ksp, Mat B, Mat X)
 {
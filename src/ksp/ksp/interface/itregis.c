@@ -9,6 +9,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_PIPECGRR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPELCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEPRCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPECG2(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_SCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_CGNE(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_NASH(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_STCG(KSP);
@@ -41,6 +42,8 @@ PETSC_EXTERN PetscErrorCode KSPCreate_LCD(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_GCR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEGCR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP);
 #if !defined(PETSC_USE_COMPLEX)
 PETSC_EXTERN PetscErrorCode KSPCreate_DGMRES(KSP);
 #endif
@@ -73,6 +76,7 @@ PetscErrorCode KSPRegisterAll(void)
   PetscCall(KSPRegister(KSPPIPELCG, KSPCreate_PIPELCG));
   PetscCall(KSPRegister(KSPPIPEPRCG, KSPCreate_PIPEPRCG));
   PetscCall(KSPRegister(KSPPIPECG2, KSPCreate_PIPECG2));
+  PetscCall(KSPRegister(KSPSCG, KSPCreate_SCG));
   PetscCall(KSPRegister(KSPCGNE, KSPCreate_CGNE));
   PetscCall(KSPRegister(KSPNASH, KSPCreate_NASH));
   PetscCall(KSPRegister(KSPSTCG, KSPCreate_STCG));
@@ -108,6 +112,8 @@ PetscErrorCode KSPRegisterAll(void)
   PetscCall(KSPRegister(KSPGCR, KSPCreate_GCR));
   PetscCall(KSPRegister(KSPPIPEGCR, KSPCreate_PIPEGCR));
   PetscCall(KSPRegister(KSPPGMRES, KSPCreate_PGMRES));
+  PetscCall(KSPRegister(KSPSGMRES, KSPCreate_SGMRES));
+  PetscCall(KSPRegister(KSPGCRODR, KSPCreate_GCRODR));
 #if !defined(PETSC_USE_COMPLEX)
   PetscCall(KSPRegister(KSPDGMRES, KSPCreate_DGMRES));
 #endif
@@ -0,0 +1,89 @@
+static char help[] = "Solves a sequence of slowly changing convection-diffusion problems, tests the recycled space of KSPGCRODR.\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **args)
+{
+  Mat       A;
+  Vec       x, b, r;
+  KSP       ksp;
+  PetscInt  n = 32, nsolves = 4, Istart, Iend, its;
+  PetscReal beta = 20.0, shift = 0.01, rtol = 1.e-8, rnorm, bnorm;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nsolves", &nsolves, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-beta", &beta, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-shift", &shift, NULL));
+
+  /* centered differences for -Laplacian(u) + beta du/dx on an n x n grid, scaled by h^2 */
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n * n, n * n));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSetUp(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    PetscInt  i = row / n, j = row - i * n;
+    PetscReal c = 0.5 * beta / (n + 1);
+
+    if (i > 0) PetscCall(MatSetValue(A, row, row - n, -1.0, INSERT_VALUES));
+    if (i < n - 1) PetscCall(MatSetValue(A, row, row + n, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, row, row - 1, -1.0 - c, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, row, row + 1, -1.0 + c, INSERT_VALUES));
+    PetscCall(MatSetValue(A, row, row, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(b, &r));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetType(ksp, KSPGCRODR));
+  PetscCall(KSPSetTolerances(ksp, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+
+  /* the operator and the right-hand side change slightly between the solves */
+  for (PetscInt s = 0; s < nsolves; s++) {
+    if (s) PetscCall(MatShift(A, shift));
+    for (PetscInt row = Istart; row < Iend; row++) PetscCall(VecSetValue(b, row, PetscSinReal(0.1 * (row + 1) * (1.0 + 0.1 * s)), INSERT_VALUES));
+    PetscCall(VecAssemblyBegin(b));
+    PetscCall(VecAssemblyEnd(b));
+    PetscCall(VecSet(x, 0.0));
+    PetscCall(KSPSetOperators(ksp, A, A));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+
+    PetscCall(MatMult(A, x, r));
+    PetscCall(VecAYPX(r, -1.0, b));
+    PetscCall(VecNorm(r, NORM_2, &rnorm));
+    PetscCall(VecNorm(b, NORM_2, &bnorm));
+    PetscCheck(rnorm <= 1.e3 * rtol * bnorm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Solve %" PetscInt_FMT " has a relative residual norm %g", s, (double)(rnorm / bnorm));
+    PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Solve %" PetscInt_FMT ": %" PetscInt_FMT " iterations\n", s, its));
+  }
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&r));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+    test:
+      nsize: {{1 2}}
+      args: -pc_type jacobi -ksp_gcrodr_monitor
+
+    test:
+      suffix: right
+      args: -pc_type jacobi -ksp_pc_side right -ksp_gmres_restart 20 -ksp_gcrodr_recycle 5 -ksp_view
+      filter: grep -e Solve -e restart= -e recycled
+
+    test:
+      suffix: gmres
+      args: -pc_type jacobi -ksp_type gmres
+
+TEST*/
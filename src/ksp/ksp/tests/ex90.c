@@ -0,0 +1,171 @@
+static char help[] = "Iterative refinement with a single precision LU factorization, compares with a double precision LU solve.\n\n";
+
+#include <petscksp.h>
+
+/* checks that MatSolveAdd(), MatSolveTransposeAdd(), MatMatSolve() and MatMatSolveTranspose() of the factor F agree with its MatSolve() and MatSolveTranspose() */
+static PetscErrorCode CheckSolves(Mat F, Vec b, Vec u)
+{
+  Mat       B, X;
+  Vec       y, z, col;
+  PetscInt  m, N;
+  PetscReal nrm, err;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecDuplicate(b, &y));
+  PetscCall(VecDuplicate(b, &z));
+  PetscCall(VecGetLocalSize(b, &m));
+  PetscCall(VecGetSize(b, &N));
+  PetscCall(MatCreateDense(PetscObjectComm((PetscObject)F), m, PETSC_DECIDE, N, 2, NULL, &B));
+  PetscCall(MatDenseGetColumnVecWrite(B, 0, &col));
+  PetscCall(VecCopy(b, col));
+  PetscCall(MatDenseRestoreColumnVecWrite(B, 0, &col));
+  PetscCall(MatDenseGetColumnVecWrite(B, 1, &col));
+  PetscCall(VecCopy(u, col));
+  PetscCall(MatDenseRestoreColumnVecWrite(B, 1, &col));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &X));
+  for (PetscInt trans = 0; trans < 2; trans++) {
+    if (trans) PetscCall(MatSolveTranspose(F, b, y));
+    else PetscCall(MatSolve(F, b, y));
+    PetscCall(VecNorm(y, NORM_2, &nrm));
+    if (trans) PetscCall(MatSolveTransposeAdd(F, b, u, z));
+    else PetscCall(MatSolveAdd(F, b, u, z));
+    PetscCall(VecAXPY(z, -1.0, u));
+    PetscCall(VecAXPY(z, -1.0, y));
+    PetscCall(VecNorm(z, NORM_2, &err));
+    PetscCheck(err <= 1.e-12 * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "%s differs from %s by %g", trans ? "MatSolveTransposeAdd()" : "MatSolveAdd()", trans ? "MatSolveTranspose()" : "MatSolve()", (double)(err / nrm));
+    if (trans) PetscCall(MatMatSolveTranspose(F, B, X));
+    else PetscCall(MatMatSolve(F, B, X));
+    PetscCall(MatDenseGetColumnVecRead(X, 0, &col));
+    PetscCall(VecWAXPY(z, -1.0, y, col));
+    PetscCall(MatDenseRestoreColumnVecRead(X, 0, &col));
+    PetscCall(VecNorm(z, NORM_2, &err));
+    PetscCheck(err <= 1.e-12 * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "%s differs from %s by %g", trans ? "MatMatSolveTranspose()" : "MatMatSolve()", trans ? "MatSolveTranspose()" : "MatSolve()", (double)(err / nrm));
+  }
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&X));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat       A;
+  Vec       x, b, u;
+  KSP       ksp, kspref;
+  PC        pc;
+  PetscInt  n = 24, Istart, Iend, its;
+  PetscReal beta = 40.0, err, errref, nrm;
+  PetscBool transpose = PETSC_FALSE, check_solves = PETSC_FALSE;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-beta", &beta, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-transpose", &transpose, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-check_solves", &check_solves, NULL));
+
+  /* centered differences for -Laplacian(u) + beta du/dx on an n x n grid, scaled by h^2 */
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n * n, n * n));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSetUp(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    PetscInt  i = row / n, j = row - i * n;
+    PetscReal c = 0.5 * beta / (n + 1);
+
+    if (i > 0) PetscCall(MatSetValue(A, row, row - n, -1.0, INSERT_VALUES));
+    if (i < n - 1) PetscCall(MatSetValue(A, row, row + n, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, row, row - 1, -1.0 - c, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, row, row + 1, -1.0 + c, INSERT_VALUES));
+    PetscCall(MatSetValue(A, row, row, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &u));
+  for (PetscInt row = Istart; row < Iend; row++) PetscCall(VecSetValue(u, row, PetscSinReal(0.1 * row) + 1.0, INSERT_VALUES));
+  PetscCall(VecAssemblyBegin(u));
+  PetscCall(VecAssemblyEnd(u));
+  if (transpose) PetscCall(MatMultTranspose(A, u, b));
+  else PetscCall(MatMult(A, u, b));
+  PetscCall(VecNorm(u, NORM_2, &nrm));
+
+  /* reference: a double precision LU factorization */
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &kspref));
+  PetscCall(KSPSetOperators(kspref, A, A));
+  PetscCall(KSPSetType(kspref, KSPPREONLY));
+  PetscCall(KSPGetPC(kspref, &pc));
+  PetscCall(PCSetType(pc, PCLU));
+  if (transpose) PetscCall(KSPSolveTranspose(kspref, b, x));
+  else PetscCall(KSPSolve(kspref, b, x));
+  PetscCall(VecAXPY(x, -1.0, u));
+  PetscCall(VecNorm(x, NORM_2, &errref));
+
+  /* iterative refinement with a factorization selected from the options, e.g. -pc_factor_mat_single_precision */
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPRICHARDSON));
+  PetscCall(KSPSetTolerances(ksp, 1.e-14, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCLU));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(VecSet(x, 0.0));
+  if (transpose) PetscCall(KSPSolveTranspose(ksp, b, x));
+  else PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PetscCall(VecAXPY(x, -1.0, u));
+  PetscCall(VecNorm(x, NORM_2, &err));
+  PetscCheck(err <= 10.0 * errref + 1.e-13 * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Relative error %g is larger than the one of the double precision LU solve %g", (double)(err / nrm), (double)(errref / nrm));
+  PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Error comparable to the double precision LU solve, %" PetscInt_FMT " iterations\n", its));
+  if (check_solves) {
+    Mat F;
+
+    PetscCall(PCFactorGetMatrix(pc, &F));
+    PetscCall(CheckSolves(F, b, u));
+  }
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(KSPDestroy(&kspref));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&u));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+    test:
+      suffix: richardson
+      args: -pc_factor_mat_single_precision -ksp_converged_reason
+
+    test:
+      suffix: fgmres
+      args: -ksp_type fgmres -pc_factor_mat_single_precision -ksp_converged_reason
+
+    test:
+      suffix: solves
+      args: -pc_type {{lu ilu}} -pc_factor_mat_ordering_type {{natural nd}} -pc_factor_mat_single_precision -check_solves
+      filter: grep -v "Error comparable"
+      output_file: output/empty.out
+
+    test:
+      suffix: ilu
+      args: -ksp_type fgmres -pc_type ilu -pc_factor_levels 2 -pc_factor_mat_single_precision -ksp_view
+      filter: grep -e "single precision" -e "Error comparable"
+
+    test:
+      suffix: transpose
+      args: -pc_factor_mat_single_precision -ksp_converged_reason -transpose
+
+    test:
+      suffix: cholesky
+      requires: !defined(PETSCTEST_VALGRIND) !defined(PETSC_HAVE_SANITIZER)
+      args: -pc_type cholesky -pc_factor_mat_single_precision -petsc_ci_portable_error_output -error_output_stdout
+      filter: grep -E "PETSC ERROR: Single precision"
+
+TEST*/
@@ -364,6 +364,26 @@ int main(int argc, char **args)
       nsize: 4
       args: -ksp_monitor_short -ksp_type pipecg2 -m 15 -n 9 -ksp_norm_type {{preconditioned unpreconditioned natural}}
 
+   test:
+      suffix: scg
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9 -ksp_scg_basis {{monomial newton chebyshev}}
+      output_file: output/ex2_scg.out
+
+   test:
+      suffix: scg_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type scg -m 15 -n 9 -ksp_scg_steps 3 -ksp_norm_type {{preconditioned unpreconditioned natural}separate output}
+
+   test:
+      suffix: sgmres
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9 -ksp_sgmres_basis {{monomial newton chebyshev}}
+      output_file: output/ex2_sgmres.out
+
+   test:
+      suffix: sgmres_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sgmres -m 15 -n 9 -ksp_gmres_restart 10 -ksp_sgmres_steps 3 -ksp_sgmres_cholqr2 {{0 1}} -ksp_pc_side {{left right}separate output}
+
    test:
       suffix: hpddm
       nsize: 4
@@ -305,6 +305,18 @@ PetscErrorCode ComputeMatrix(KSP ksp, Mat J, Mat jac, void *ctx)
        suffix: opt_fourth
        args: -mg_levels_ksp_chebyshev_kind opt_fourth
 
+   test:
+      suffix: shmem
+      nsize: 4
+      requires: defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      args: -pc_type mg -pc_mg_type full -ksp_type fgmres -ksp_monitor_short -da_refine 5 -ksp_rtol 1.e-3 -sf_type {{basic shmem}}
+      output_file: output/ex29_shmem.out
+
+   test:
+      suffix: matrix_powers
+      nsize: 4
+      args: -rho 1e3 -da_refine 4 -pc_type mg -pc_mg_levels 4 -ksp_monitor_short -mg_levels_pc_type jacobi -mg_levels_ksp_max_it 4 -mg_levels_ksp_chebyshev_matrix_powers -mg_levels_ksp_chebyshev_kind {{first opt_fourth}separate output}
+
    test:
       suffix: 5
       nsize: 2
@@ -0,0 +1,745 @@
+#include <petsc/private/pcimpl.h>
+#include <petsc/private/kspimpl.h>
+#include <petscksp.h> /*I "petscksp.h" I*/
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  #include <omp.h>
+#endif
+
+/* number of systems interleaved in the SIMD lanes of a batch */
+#define PCBJBATCH_LANES 8
+
+typedef enum {
+  PCBJBATCH_KSP_PREONLY,
+  PCBJBATCH_KSP_CG,
+  PCBJBATCH_KSP_BCGS
+} PCBJBatchKSPType;
+
+typedef enum {
+  PCBJBATCH_PC_NONE,
+  PCBJBATCH_PC_JACOBI,
+  PCBJBATCH_PC_ILU
+} PCBJBatchPCType;
+
+/*
+   A batch holds PCBJBATCH_LANES systems of the same size stored as structure-of-arrays: the entry k of the common
+   sparsity pattern of the systems is aa[k * PCBJBATCH_LANES + lane], and the same holds for the vectors.
+*/
+typedef struct {
+  PetscInt     bs;                   /* size of the systems */
+  PetscInt     row[PCBJBATCH_LANES]; /* first local row of the system in each lane, -1 for padding lanes */
+  PetscInt     nz;                   /* number of nonzeros of the union of the sparsity patterns of the systems */
+  PetscInt    *ai, *aj, *adiag;      /* the union pattern with sorted columns, it always contains the diagonal */
+  PetscScalar *aa, *fa;              /* the values of the systems and of their factors */
+} PCBJBatchSystems;
+
+typedef struct {
+  KSP               ksp; /* holds the configuration of the batched solver, it is never used to solve */
+  PCBJBatchKSPType  ksptype;
+  PCBJBatchPCType   pctype;
+  PetscInt          nwork, nthreads;
+  PetscInt          nblocks, min_bs, max_bs, nbatches, nz;
+  PCBJBatchSystems *batches;
+  PetscInt         *ai, *aj;  /* storage of the patterns of all the batches */
+  PetscScalar      *aa, *fa;  /* storage of the values of all the batches */
+  PetscScalar      *work;     /* nwork vectors of length max_bs * PCBJBATCH_LANES per thread */
+  PetscInt          its;      /* maximum number of iterations over the systems in the last application */
+  PetscInt          nfailed;  /* number of systems that did not converge in the last application */
+} PC_BJBatch;
+
+/* y = A x */
+static void PCBJBatchMult(const PCBJBatchSystems *bt, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt i = 0; i < bt->bs; i++) {
+    PetscScalar *yi = y + i * PCBJBATCH_LANES;
+
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] = 0.0;
+    for (PetscInt k = bt->ai[i]; k < bt->ai[i + 1]; k++) {
+      const PetscScalar *a = bt->aa + k * PCBJBATCH_LANES, *xj = x + bt->aj[k] * PCBJBATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] += a[l] * xj[l];
+    }
+  }
+}
+
+/* y = M^{-1} x with the factors in fa */
+static void PCBJBatchPCApply(PCBJBatchPCType type, const PCBJBatchSystems *bt, const PetscScalar *x, PetscScalar *y)
+{
+  const PetscInt bs = bt->bs, *ai = bt->ai, *aj = bt->aj, *adiag = bt->adiag;
+
+  switch (type) {
+  case PCBJBATCH_PC_NONE:
+    for (PetscInt i = 0; i < bs * PCBJBATCH_LANES; i++) y[i] = x[i];
+    break;
+  case PCBJBATCH_PC_JACOBI:
+    for (PetscInt i = 0; i < bs; i++) {
+      const PetscScalar *d = bt->fa + adiag[i] * PCBJBATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) y[i * PCBJBATCH_LANES + l] = d[l] * x[i * PCBJBATCH_LANES + l];
+    }
+    break;
+  case PCBJBATCH_PC_ILU:
+    /* L has a unit diagonal, the diagonal of U is stored inverted */
+    for (PetscInt i = 0; i < bs; i++) {
+      PetscScalar *yi = y + i * PCBJBATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] = x[i * PCBJBATCH_LANES + l];
+      for (PetscInt k = ai[i]; k < adiag[i]; k++) {
+        const PetscScalar *f = bt->fa + k * PCBJBATCH_LANES, *yj = y + aj[k] * PCBJBATCH_LANES;
+
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] -= f[l] * yj[l];
+      }
+    }
+    for (PetscInt i = bs - 1; i >= 0; i--) {
+      PetscScalar       *yi = y + i * PCBJBATCH_LANES;
+      const PetscScalar *d  = bt->fa + adiag[i] * PCBJBATCH_LANES;
+
+      for (PetscInt k = adiag[i] + 1; k < ai[i + 1]; k++) {
+        const PetscScalar *f = bt->fa + k * PCBJBATCH_LANES, *yj = y + aj[k] * PCBJBATCH_LANES;
+
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] -= f[l] * yj[l];
+      }
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] *= d[l];
+    }
+    break;
+  }
+}
+
+/* ILU(0) on the union pattern, or the inverse of the diagonal, for all the lanes at once; returns the number of zero pivots */
+static PetscInt PCBJBatchFactor(PCBJBatchPCType type, PCBJBatchSystems *bt)
+{
+  const PetscInt bs = bt->bs, *ai = bt->ai, *aj = bt->aj, *adiag = bt->adiag;
+  PetscScalar   *fa = bt->fa;
+  PetscInt       nzero = 0;
+
+  if (type == PCBJBATCH_PC_NONE) return 0;
+  if (type == PCBJBATCH_PC_ILU) {
+    for (PetscInt k = 0; k < bt->nz * PCBJBATCH_LANES; k++) fa[k] = bt->aa[k];
+  } else {
+    for (PetscInt i = 0; i < bs; i++) {
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) fa[adiag[i] * PCBJBATCH_LANES + l] = bt->aa[adiag[i] * PCBJBATCH_LANES + l];
+    }
+  }
+  for (PetscInt i = 0; i < bs; i++) {
+    PetscScalar *d = fa + adiag[i] * PCBJBATCH_LANES;
+
+    if (type == PCBJBATCH_PC_ILU) {
+      for (PetscInt k = ai[i]; k < adiag[i]; k++) {
+        const PetscInt     col = aj[k];
+        PetscScalar       *lik = fa + k * PCBJBATCH_LANES;
+        const PetscScalar *ukk = fa + adiag[col] * PCBJBATCH_LANES;
+        PetscInt           kk  = k + 1;
+
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) lik[l] *= ukk[l];
+        /* row i -= l_ik * (row col of U), restricted to the pattern of row i; both rows have sorted columns */
+        for (PetscInt j = adiag[col] + 1; j < ai[col + 1]; j++) {
+          while (kk < ai[i + 1] && aj[kk] < aj[j]) kk++;
+          if (kk == ai[i + 1]) break;
+          if (aj[kk] == aj[j]) {
+            PetscScalar       *aik = fa + kk * PCBJBATCH_LANES;
+            const PetscScalar *ukj = fa + j * PCBJBATCH_LANES;
+
+            PetscPragmaSIMD
+            for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) aik[l] -= lik[l] * ukj[l];
+          }
+        }
+      }
+    }
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (d[l] == (PetscScalar)0.0) nzero++;
+      d[l] = 1.0 / d[l];
+    }
+  }
+  return nzero;
+}
+
+/* d = y^H x for each lane */
+static void PCBJBatchDot(PetscInt bs, const PetscScalar *x, const PetscScalar *y, PetscScalar *d)
+{
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) d[l] = 0.0;
+  for (PetscInt i = 0; i < bs * PCBJBATCH_LANES; i += PCBJBATCH_LANES) {
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) d[l] += x[i + l] * PetscConj(y[i + l]);
+  }
+}
+
+static void PCBJBatchNorm(PetscInt bs, const PetscScalar *x, PetscReal *nrm)
+{
+  PetscScalar d[PCBJBATCH_LANES];
+
+  PCBJBatchDot(bs, x, x, d);
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) nrm[l] = PetscSqrtReal(PetscRealPart(d[l]));
+}
+
+/* y = y + alpha x for each lane */
+static void PCBJBatchAXPY(PetscInt bs, const PetscScalar *alpha, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt i = 0; i < bs * PCBJBATCH_LANES; i += PCBJBATCH_LANES) {
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) y[i + l] += alpha[l] * x[i + l];
+  }
+}
+
+/* lanes whose residual norm is below their tolerance stop; returns the number of lanes still iterating */
+static PetscInt PCBJBatchConverged(const PetscReal *nrm, const PetscReal *tol, PetscBool *active)
+{
+  PetscInt nactive = 0;
+
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    if (active[l] && nrm[l] <= tol[l]) active[l] = PETSC_FALSE;
+    nactive += active[l];
+  }
+  return nactive;
+}
+
+/*
+   Solves the systems of a batch with a zero initial guess, b and x are the first two work vectors.
+   Both Krylov methods are right preconditioned so that the convergence test uses the true residual norm of each system.
+   Returns the number of iterations, the lanes that did not converge are counted in nfailed.
+*/
+static PetscInt PCBJBatchSolve(const PC_BJBatch *jac, const PCBJBatchSystems *bt, PetscScalar *work, PetscInt *nfailed)
+{
+  const PetscInt bs = bt->bs, n = bs * PCBJBATCH_LANES;
+  PetscScalar   *b = work, *x = work + n, *r = work + 2 * n;
+  PetscScalar    alpha[PCBJBATCH_LANES], beta[PCBJBATCH_LANES], rho[PCBJBATCH_LANES], rhonew[PCBJBATCH_LANES], omega[PCBJBATCH_LANES], d[PCBJBATCH_LANES], e[PCBJBATCH_LANES];
+  PetscReal      nrm[PCBJBATCH_LANES], tol[PCBJBATCH_LANES];
+  PetscBool      active[PCBJBATCH_LANES];
+  PetscInt       its = 0, nactive;
+
+  if (jac->ksptype == PCBJBATCH_KSP_PREONLY) {
+    PCBJBatchPCApply(jac->pctype, bt, b, x);
+    return 1;
+  }
+  for (PetscInt i = 0; i < n; i++) {
+    x[i] = 0.0;
+    r[i] = b[i];
+  }
+  PCBJBatchNorm(bs, r, nrm);
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    tol[l]    = PetscMax(jac->ksp->rtol * nrm[l], jac->ksp->abstol);
+    active[l] = PETSC_TRUE;
+  }
+  nactive = PCBJBatchConverged(nrm, tol, active);
+  if (jac->ksptype == PCBJBATCH_KSP_CG) {
+    PetscScalar *z = work + 3 * n, *p = work + 4 * n, *q = work + 5 * n;
+
+    PCBJBatchPCApply(jac->pctype, bt, r, z);
+    PCBJBatchDot(bs, r, z, rho);
+    for (PetscInt i = 0; i < n; i++) p[i] = z[i];
+    while (nactive && its < jac->ksp->max_it) {
+      its++;
+      PCBJBatchMult(bt, p, q);
+      PCBJBatchDot(bs, q, p, d);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        if (active[l] && d[l] == (PetscScalar)0.0) active[l] = PETSC_FALSE; /* breakdown */
+        alpha[l] = active[l] ? rho[l] / d[l] : 0.0;
+        e[l]     = -alpha[l];
+      }
+      PCBJBatchAXPY(bs, alpha, p, x);
+      PCBJBatchAXPY(bs, e, q, r);
+      PCBJBatchNorm(bs, r, nrm);
+      nactive = PCBJBatchConverged(nrm, tol, active);
+      if (!nactive) break;
+      PCBJBatchPCApply(jac->pctype, bt, r, z);
+      PCBJBatchDot(bs, r, z, rhonew);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        beta[l] = active[l] ? rhonew[l] / rho[l] : 0.0;
+        rho[l]  = rhonew[l];
+      }
+      for (PetscInt i = 0; i < n; i += PCBJBATCH_LANES) {
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) p[i + l] = z[i + l] + beta[l] * p[i + l];
+      }
+    }
+  } else {
+    PetscScalar *rhat = work + 3 * n, *p = work + 4 * n, *v = work + 5 * n, *s = work + 6 * n, *t = work + 7 * n, *phat = work + 8 * n, *shat = work + 9 * n;
+
+    for (PetscInt i = 0; i < n; i++) {
+      rhat[i] = r[i];
+      p[i]    = 0.0;
+      v[i]    = 0.0;
+    }
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) rho[l] = alpha[l] = omega[l] = 1.0;
+    while (nactive && its < jac->ksp->max_it) {
+      its++;
+      PCBJBatchDot(bs, r, rhat, rhonew);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        if (active[l] && (rhonew[l] == (PetscScalar)0.0 || omega[l] == (PetscScalar)0.0)) active[l] = PETSC_FALSE; /* breakdown */
+        beta[l] = active[l] ? (rhonew[l] / rho[l]) * (alpha[l] / omega[l]) : 0.0;
+      }
+      for (PetscInt i = 0; i < n; i += PCBJBATCH_LANES) {
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) p[i + l] = r[i + l] + beta[l] * (p[i + l] - omega[l] * v[i + l]);
+      }
+      PCBJBatchPCApply(jac->pctype, bt, p, phat);
+      PCBJBatchMult(bt, phat, v);
+      PCBJBatchDot(bs, v, rhat, d);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        if (active[l] && d[l] == (PetscScalar)0.0) active[l] = PETSC_FALSE;
+        alpha[l] = active[l] ? rhonew[l] / d[l] : 0.0;
+        e[l]     = -alpha[l];
+      }
+      for (PetscInt i = 0; i < n; i++) s[i] = r[i];
+      PCBJBatchAXPY(bs, e, v, s);
+      PCBJBatchAXPY(bs, alpha, phat, x);
+      PCBJBatchNorm(bs, s, nrm);
+      nactive = PCBJBatchConverged(nrm, tol, active);
+      if (!nactive) {
+        for (PetscInt i = 0; i < n; i++) r[i] = s[i];
+        break;
+      }
+      PCBJBatchPCApply(jac->pctype, bt, s, shat);
+      PCBJBatchMult(bt, shat, t);
+      PCBJBatchDot(bs, s, t, e);
+      PCBJBatchDot(bs, t, t, d);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        omega[l] = active[l] && d[l] != (PetscScalar)0.0 ? e[l] / d[l] : 0.0;
+        e[l]     = -omega[l];
+        rho[l]   = rhonew[l];
+      }
+      PCBJBatchAXPY(bs, omega, shat, x);
+      for (PetscInt i = 0; i < n; i++) r[i] = s[i];
+      PCBJBatchAXPY(bs, e, t, r);
+      PCBJBatchNorm(bs, r, nrm);
+      nactive = PCBJBatchConverged(nrm, tol, active);
+    }
+  }
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) *nfailed += (bt->row[l] >= 0 && !(nrm[l] <= tol[l]));
+  return its;
+}
+
+static PetscErrorCode PCApply_BJBatch(PC pc, Vec x, Vec y)
+{
+  PC_BJBatch        *jac = (PC_BJBatch *)pc->data;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscInt           its = 0, nfailed = 0;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(x, &xx));
+  PetscCall(VecGetArrayWrite(y, &yy));
+  PetscPragmaUseOMPKernels(parallel for schedule(dynamic) reduction(max:its) reduction(+:nfailed))
+  for (PetscInt ib = 0; ib < jac->nbatches; ib++) {
+    const PCBJBatchSystems *bt   = jac->batches + ib;
+    const PetscInt          bs   = bt->bs;
+    PetscScalar            *work = jac->work, *b, *sol;
+
+#if defined(PETSC_USE_OPENMP_KERNELS)
+    work += omp_get_thread_num() * jac->nwork * jac->max_bs * PCBJBATCH_LANES;
+#endif
+    b   = work;
+    sol = work + bs * PCBJBATCH_LANES;
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      for (PetscInt i = 0; i < bs; i++) b[i * PCBJBATCH_LANES + l] = bt->row[l] >= 0 ? xx[bt->row[l] + i] : 0.0;
+    }
+    its = PetscMax(its, PCBJBatchSolve(jac, bt, work, &nfailed));
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (bt->row[l] < 0) continue;
+      for (PetscInt i = 0; i < bs; i++) yy[bt->row[l] + i] = sol[i * PCBJBATCH_LANES + l];
+    }
+  }
+  PetscCall(VecRestoreArrayRead(x, &xx));
+  PetscCall(VecRestoreArrayWrite(y, &yy));
+  jac->its     = its;
+  jac->nfailed = nfailed;
+  if (nfailed) {
+    PetscCall(PetscInfo(pc, "%" PetscInt_FMT " of the %" PetscInt_FMT " systems did not converge in %" PetscInt_FMT " iterations\n", nfailed, jac->nblocks, its));
+    PetscCheck(!pc->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_NOT_CONVERGED, "%" PetscInt_FMT " of the %" PetscInt_FMT " systems did not converge", nfailed, jac->nblocks);
+    pc->failedreason = PC_SUBPC_ERROR;
+  }
+  /* matrix and preconditioner applications per iteration, each about 2 nz flops per system */
+  PetscCall(PetscLogFlops(2.0 * its * (jac->ksptype == PCBJBATCH_KSP_BCGS ? 4 : jac->ksptype == PCBJBATCH_KSP_CG ? 2 : 1) * jac->nz * PCBJBATCH_LANES));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCBJBatchCreateKSP(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  const char *prefix;
+  PC          subpc;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCreate(PETSC_COMM_SELF, &jac->ksp));
+  PetscCall(KSPSetNestLevel(jac->ksp, pc->kspnestlevel));
+  PetscCall(PetscObjectIncrementTabLevel((PetscObject)jac->ksp, (PetscObject)pc, 1));
+  PetscCall(PCGetOptionsPrefix(pc, &prefix));
+  PetscCall(KSPSetOptionsPrefix(jac->ksp, prefix));
+  PetscCall(KSPAppendOptionsPrefix(jac->ksp, "pc_bjbatch_"));
+  PetscCall(KSPSetType(jac->ksp, KSPPREONLY));
+  PetscCall(KSPGetPC(jac->ksp, &subpc));
+  PetscCall(PCSetType(subpc, PCILU));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCBJBatchGetSolverType(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  PC          subpc;
+  PetscBool   flg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompareAny((PetscObject)jac->ksp, &flg, KSPPREONLY, KSPNONE, ""));
+  if (flg) {
+    jac->ksptype = PCBJBATCH_KSP_PREONLY;
+    jac->nwork   = 2;
+  } else {
+    PetscCall(PetscObjectTypeCompare((PetscObject)jac->ksp, KSPCG, &flg));
+    if (flg) {
+      jac->ksptype = PCBJBATCH_KSP_CG;
+      jac->nwork   = 6;
+    } else {
+      PetscCall(PetscObjectTypeCompare((PetscObject)jac->ksp, KSPBCGS, &flg));
+      PetscCheck(flg, PetscObjectComm((PetscObject)pc), PETSC_ERR_SUP, "KSP type %s is not supported by the batched solver, use %s, %s, or %s", ((PetscObject)jac->ksp)->type_name, KSPPREONLY, KSPCG, KSPBCGS);
+      jac->ksptype = PCBJBATCH_KSP_BCGS;
+      jac->nwork   = 10;
+    }
+  }
+  PetscCall(KSPGetPC(jac->ksp, &subpc));
+  PetscCall(PetscObjectTypeCompare((PetscObject)subpc, PCILU, &flg));
+  if (flg) jac->pctype = PCBJBATCH_PC_ILU;
+  else {
+    PetscCall(PetscObjectTypeCompare((PetscObject)subpc, PCJACOBI, &flg));
+    if (flg) jac->pctype = PCBJBATCH_PC_JACOBI;
+    else {
+      PetscCall(PetscObjectTypeCompare((PetscObject)subpc, PCNONE, &flg));
+      PetscCheck(flg, PetscObjectComm((PetscObject)pc), PETSC_ERR_SUP, "PC type %s is not supported by the batched solver, use %s, %s, or %s", ((PetscObject)subpc)->type_name, PCILU, PCJACOBI, PCNONE);
+      jac->pctype = PCBJBATCH_PC_NONE;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCReset_BJBatch_Batches(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(jac->batches));
+  PetscCall(PetscFree2(jac->ai, jac->aj));
+  PetscCall(PetscFree2(jac->aa, jac->fa));
+  jac->nbatches = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* computes the union pattern of row i of the systems of a batch in aj (if not NULL) and returns its length */
+static PetscInt PCBJBatchUnionRow(const PetscInt *ia, const PetscInt *ja, const PCBJBatchSystems *bt, PetscInt i, PetscBool *mark, PetscInt *aj)
+{
+  PetscInt nz = 0;
+
+  mark[i] = PETSC_TRUE;
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    const PetscInt row = bt->row[l];
+
+    if (row < 0) continue;
+    for (PetscInt k = ia[row + i]; k < ia[row + i + 1]; k++) {
+      if (ja[k] >= row && ja[k] < row + bt->bs) mark[ja[k] - row] = PETSC_TRUE;
+    }
+  }
+  for (PetscInt j = 0; j < bt->bs; j++) {
+    if (!mark[j]) continue;
+    if (aj) aj[nz] = j;
+    mark[j] = PETSC_FALSE;
+    nz++;
+  }
+  return nz;
+}
+
+/* sorts the blocks by size, groups them into batches, and computes the union pattern of each batch */
+static PetscErrorCode PCBJBatchSetUpBatches(PC pc, const PetscInt *ia, const PetscInt *ja)
+{
+  PC_BJBatch     *jac = (PC_BJBatch *)pc->data;
+  const PetscInt *vbsizes;
+  PetscInt        nlocal, bs = 1, nblocks, *bsizes, *perm, *start, nai = 0, naj = 0;
+  PetscBool       variable, *mark;
+
+  PetscFunctionBegin;
+  PetscCall(PCReset_BJBatch_Batches(pc));
+  PetscCall(MatGetLocalSize(pc->pmat, &nlocal, NULL));
+  PetscCall(MatGetVariableBlockSizes(pc->pmat, &nblocks, &vbsizes));
+  variable = nblocks ? PETSC_TRUE : PETSC_FALSE;
+  if (!variable) {
+    PetscCall(MatGetBlockSize(pc->pmat, &bs));
+    nblocks = nlocal / bs;
+  }
+  PetscCall(PetscMalloc3(nblocks, &bsizes, nblocks, &perm, nblocks + 1, &start));
+  start[0]    = 0;
+  jac->min_bs = PETSC_INT_MAX;
+  jac->max_bs = 0;
+  for (PetscInt i = 0; i < nblocks; i++) {
+    bsizes[i]    = variable ? vbsizes[i] : bs;
+    perm[i]      = i;
+    start[i + 1] = start[i] + bsizes[i];
+    jac->min_bs  = PetscMin(jac->min_bs, bsizes[i]);
+    jac->max_bs  = PetscMax(jac->max_bs, bsizes[i]);
+  }
+  PetscCheck(start[nblocks] == nlocal, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "The block sizes add up to %" PetscInt_FMT ", not to the local size %" PetscInt_FMT, start[nblocks], nlocal);
+  if (!nblocks) jac->min_bs = 0;
+  jac->nblocks = nblocks;
+
+  /* blocks of the same size, in their original order, fill the lanes of consecutive batches */
+  PetscCall(PetscSortIntWithArray(nblocks, bsizes, perm));
+  for (PetscInt i = 0, j; i < nblocks; i = j) {
+    j = i + 1;
+    while (j < nblocks && bsizes[j] == bsizes[i]) j++;
+    PetscCall(PetscSortInt(j - i, perm + i));
+    jac->nbatches += (j - i + PCBJBATCH_LANES - 1) / PCBJBATCH_LANES;
+  }
+  PetscCall(PetscCalloc1(jac->nbatches, &jac->batches));
+  for (PetscInt i = 0, ib = 0, j; i < nblocks; i = j) {
+    j = i + 1;
+    while (j < nblocks && bsizes[j] == bsizes[i]) j++;
+    for (PetscInt k = i; k < j; k += PCBJBATCH_LANES, ib++) {
+      jac->batches[ib].bs = bsizes[i];
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) jac->batches[ib].row[l] = k + l < j ? start[perm[k + l]] : -1;
+    }
+  }
+  PetscCall(PetscFree3(bsizes, perm, start));
+
+  /* union patterns: count, then fill */
+  PetscCall(PetscCalloc1(jac->max_bs, &mark));
+  for (PetscInt ib = 0; ib < jac->nbatches; ib++) {
+    PCBJBatchSystems *bt = jac->batches + ib;
+
+    bt->nz = 0;
+    for (PetscInt i = 0; i < bt->bs; i++) bt->nz += PCBJBatchUnionRow(ia, ja, bt, i, mark, NULL);
+    nai += 2 * bt->bs + 1;
+    naj += bt->nz;
+  }
+  jac->nz = naj;
+  PetscCall(PetscMalloc2(nai, &jac->ai, naj, &jac->aj));
+  PetscCall(PetscMalloc2(naj * PCBJBATCH_LANES, &jac->aa, naj * PCBJBATCH_LANES, &jac->fa));
+  nai = naj = 0;
+  for (PetscInt ib = 0; ib < jac->nbatches; ib++) {
+    PCBJBatchSystems *bt = jac->batches + ib;
+
+    bt->ai    = jac->ai + nai;
+    bt->adiag = bt->ai + bt->bs + 1;
+    bt->aj    = jac->aj + naj;
+    bt->aa    = jac->aa + naj * PCBJBATCH_LANES;
+    bt->fa    = jac->fa + naj * PCBJBATCH_LANES;
+    bt->ai[0] = 0;
+    for (PetscInt i = 0; i < bt->bs; i++) {
+      const PetscInt nz = PCBJBatchUnionRow(ia, ja, bt, i, mark, bt->aj + bt->ai[i]);
+
+      bt->ai[i + 1] = bt->ai[i] + nz;
+      PetscCall(PetscFindInt(i, nz, bt->aj + bt->ai[i], &bt->adiag[i]));
+      bt->adiag[i] += bt->ai[i];
+    }
+    nai += 2 * bt->bs + 1;
+    naj += bt->nz;
+  }
+  PetscCall(PetscFree(mark));
+  PetscCall(PetscInfo(pc, "%" PetscInt_FMT " systems of sizes %" PetscInt_FMT " to %" PetscInt_FMT " in %" PetscInt_FMT " batches of %d lanes\n", jac->nblocks, jac->min_bs, jac->max_bs, jac->nbatches, PCBJBATCH_LANES));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* copies the values of the diagonal blocks of A into the batches, the padding lanes hold the identity */
+static void PCBJBatchSetValues(const PetscInt *ia, const PetscInt *ja, const PetscScalar *va, PCBJBatchSystems *bt)
+{
+  for (PetscInt k = 0; k < bt->nz * PCBJBATCH_LANES; k++) bt->aa[k] = 0.0;
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    const PetscInt row = bt->row[l];
+
+    for (PetscInt i = 0; i < bt->bs; i++) {
+      PetscInt loc = bt->ai[i];
+
+      if (row < 0) {
+        bt->aa[bt->adiag[i] * PCBJBATCH_LANES + l] = 1.0;
+        continue;
+      }
+      /* the columns of the row and of the union pattern are both sorted */
+      for (PetscInt k = ia[row + i]; k < ia[row + i + 1]; k++) {
+        if (ja[k] < row || ja[k] >= row + bt->bs) continue;
+        while (bt->aj[loc] < ja[k] - row) loc++;
+        bt->aa[loc * PCBJBATCH_LANES + l] = va[k];
+      }
+    }
+  }
+}
+
+static PetscErrorCode PCSetUp_BJBatch(PC pc)
+{
+  PC_BJBatch        *jac = (PC_BJBatch *)pc->data;
+  Mat                A;
+  const PetscInt    *ia, *ja;
+  const PetscScalar *va;
+  PetscInt           n, nzero = 0;
+  PetscBool          flg;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP(pc));
+  PetscCall(PCBJBatchGetSolverType(pc));
+  PetscCall(MatGetDiagonalBlock(pc->pmat, &A));
+  PetscCall(PetscObjectBaseTypeCompare((PetscObject)A, MATSEQAIJ, &flg));
+  PetscCheck(flg, PetscObjectComm((PetscObject)pc), PETSC_ERR_SUP, "Matrix type %s is not supported by PCBJBATCH, use MATAIJ", ((PetscObject)A)->type_name);
+  PetscCall(MatGetRowIJ(A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the sparsity pattern of the matrix");
+  PetscCall(MatSeqAIJGetArrayRead(A, &va));
+  if (!pc->setupcalled || pc->flag != SAME_NONZERO_PATTERN) PetscCall(PCBJBatchSetUpBatches(pc, ia, ja));
+
+  jac->nthreads = 1;
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  jac->nthreads = (PetscInt)omp_get_max_threads();
+#endif
+  PetscCall(PetscFree(jac->work));
+  PetscCall(PetscMalloc1(jac->nthreads * jac->nwork * jac->max_bs * PCBJBATCH_LANES, &jac->work));
+
+  PetscPragmaUseOMPKernels(parallel for schedule(dynamic) reduction(+:nzero))
+  for (PetscInt ib = 0; ib < jac->nbatches; ib++) {
+    PCBJBatchSetValues(ia, ja, va, jac->batches + ib);
+    nzero += PCBJBatchFactor(jac->pctype, jac->batches + ib);
+  }
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &va));
+  PetscCall(MatRestoreRowIJ(A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &flg));
+  if (nzero) {
+    PetscCall(PetscInfo(pc, "Zero pivot in %" PetscInt_FMT " rows of the systems\n", nzero));
+    PetscCheck(!pc->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot in %" PetscInt_FMT " rows of the systems", nzero);
+    pc->failedreason = PC_FACTOR_NUMERIC_ZEROPIVOT;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCReset_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(PCReset_BJBatch_Batches(pc));
+  PetscCall(PetscFree(jac->work));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCDestroy_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(PCReset_BJBatch(pc));
+  PetscCall(KSPDestroy(&jac->ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCBJBATCHGetKSP_C", NULL));
+  PetscCall(PetscFree(pc->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCView_BJBatch(PC pc, PetscViewer viewer)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  PetscBool   iascii;
+  PC          subpc;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP(pc));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) {
+    PetscCall(KSPGetPC(jac->ksp, &subpc));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  batched solver: %s with %s, rtol=%g, abstol=%g, maximum iterations=%" PetscInt_FMT "\n", ((PetscObject)jac->ksp)->type_name, ((PetscObject)subpc)->type_name, (double)jac->ksp->rtol, (double)jac->ksp->abstol, jac->ksp->max_it));
+    if (pc->setupcalled) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  local systems: %" PetscInt_FMT " of sizes %" PetscInt_FMT " to %" PetscInt_FMT ", in %" PetscInt_FMT " batches of %d interleaved systems\n", jac->nblocks, jac->min_bs, jac->max_bs, jac->nbatches, PCBJBATCH_LANES));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  last application: at most %" PetscInt_FMT " iterations, %" PetscInt_FMT " systems did not converge\n", jac->its, jac->nfailed));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetFromOptions_BJBatch(PC pc, PetscOptionItems PetscOptionsObject)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP(pc));
+  PetscCall(KSPSetFromOptions(jac->ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCBJBATCHGetKSP_BJBatch(PC pc, KSP *ksp)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP(pc));
+  *ksp = jac->ksp;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCBJBATCHGetKSP - Gets the `KSP` that holds the configuration of the batched solver of a `PCBJBATCH`
+
+  Not Collective
+
+  Input Parameter:
+. pc - the preconditioner context
+
+  Output Parameter:
+. ksp - the `KSP`, on `PETSC_COMM_SELF`
+
+  Level: advanced
+
+  Notes:
+  Set the type, the preconditioner, and the tolerances of the solver on this `KSP`, the batched solver uses them for all the
+  systems; the `KSP` itself is never used to solve.
+
+  The supported `KSPType` are `KSPPREONLY`, `KSPCG`, and `KSPBCGS`, and the supported `PCType` are `PCILU`, `PCJACOBI`, and `PCNONE`.
+
+.seealso: [](ch_ksp), `PCBJBATCH`, `PCBJKOKKOSGetKSP()`
+@*/
+PetscErrorCode PCBJBATCHGetKSP(PC pc, KSP *ksp)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscAssertPointer(ksp, 2);
+  PetscUseMethod(pc, "PCBJBATCHGetKSP_C", (PC, KSP *), (pc, ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PCBJBATCH - A block Jacobi preconditioner that solves the diagonal blocks of the matrix as a batch of small systems on the CPU
+
+   Options Database Key:
+.  -pc_bjbatch_ - options prefix for the `KSP` and `PC` options of the batched solver, for example
+                  `-pc_bjbatch_ksp_type bcgs -pc_bjbatch_pc_type ilu -pc_bjbatch_ksp_rtol 1e-8`
+
+   Level: intermediate
+
+   Notes:
+   This works for `MATAIJ` matrices. The blocks are given by `MatSetVariableBlockSizes()` or, if it was not called, by the
+   block size of the matrix. Entries outside of the diagonal blocks are ignored. To solve many independent small systems in
+   one call, assemble them as a block diagonal matrix and use `-ksp_type preonly -pc_type bjbatch`.
+
+   All the systems are solved with the same `KSPType` and `PCType`, set with `PCBJBATCHGetKSP()` or the options database,
+   the default is `KSPPREONLY` with `PCILU`. `KSPCG` and `KSPBCGS` use right preconditioning and stop each system on its
+   own true residual norm. `PCILU` is ILU(0) on the union of the sparsity patterns of the systems in a batch, so it is an
+   LU factorization without pivoting when the blocks are dense.
+
+   Blocks of the same size are interleaved, eight by eight, in a structure-of-arrays layout so that all the operations of the
+   solver run over the systems in SIMD lanes. The batches are spread over OpenMP threads when PETSc is configured with
+   `--with-openmp-kernels`.
+
+.seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `PCBJACOBI`, `PCVPBJACOBI`, `PCBJKOKKOS`, `PCBJBATCHGetKSP()`,
+          `MatSetVariableBlockSizes()`
+M*/
+
+PETSC_EXTERN PetscErrorCode PCCreate_BJBatch(PC pc)
+{
+  PC_BJBatch *jac;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&jac));
+  pc->data = (void *)jac;
+
+  pc->ops->apply          = PCApply_BJBatch;
+  pc->ops->setup          = PCSetUp_BJBatch;
+  pc->ops->reset          = PCReset_BJBatch;
+  pc->ops->destroy        = PCDestroy_BJBatch;
+  pc->ops->setfromoptions = PCSetFromOptions_BJBatch;
+  pc->ops->view           = PCView_BJBatch;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCBJBATCHGetKSP_C", PCBJBATCHGetKSP_BJBatch));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
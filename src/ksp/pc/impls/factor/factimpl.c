@@ -250,6 +250,7 @@ PetscErrorCode PCSetFromOptions_Factor(PC pc, PetscOptionItems PetscOptionsObjec
   if (flg) PetscCall(PCFactorSetMatOrderingType(pc, tname));
   PetscCall(PetscOptionsBool("-pc_factor_mat_factor_on_host", "Do mat factorization on host (with device matrix types)", "MatGetFactor", factor->info.factoronhost, &factor->info.factoronhost, NULL));
   PetscCall(PetscOptionsBool("-pc_factor_mat_solve_on_host", "Do mat solve on host with the factor (with device matrix types)", "MatGetFactor", factor->info.solveonhost, &factor->info.solveonhost, NULL));
+  PetscCall(PetscOptionsBool("-pc_factor_mat_single_precision", "Compute and store the factor in single precision (native SeqAIJ LU and ILU)", "MatGetFactor", factor->info.singleprecision, &factor->info.singleprecision, NULL));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -286,6 +287,7 @@ PetscErrorCode PCView_Factor(PC pc, PetscViewer viewer)
     }
 
     PetscCall(PetscViewerASCIIPrintf(viewer, "  tolerance for zero pivot %g\n", (double)factor->info.zeropivot));
+    if (factor->info.singleprecision) PetscCall(PetscViewerASCIIPrintf(viewer, "  factor computed and stored in single precision\n"));
     if (MatFactorShiftTypesDetail[(int)factor->info.shifttype]) { /* Only print when using a nontrivial shift */
       PetscCall(PetscViewerASCIIPrintf(viewer, "  using %s [%s]\n", MatFactorShiftTypesDetail[(int)factor->info.shifttype], MatFactorShiftTypes[(int)factor->info.shifttype]));
     }
@@ -226,6 +226,7 @@ static PetscErrorCode PCMatApplyTranspose_LU(PC pc, Mat X, Mat Y)
 .  -pc_factor_shift_amount <shiftamount> - Sets shift amount or -1 for the default
 .  -pc_factor_nonzeros_along_diagonal - permutes the rows and columns to try to put nonzero value along the diagonal.
 .  -pc_factor_mat_solver_type <packagename> - use an external package for the solve, see `MatSolverType` for possibilities
+.  -pc_factor_mat_single_precision - compute and store the factor in single precision (`MATSEQAIJ` with `MATSOLVERPETSC` only)
 -  -mat_solvertype_optionname - options for a specific solver package, for example -mat_mumps_cntl_1
 
    Level: beginner
@@ -241,6 +242,10 @@ static PetscErrorCode PCMatApplyTranspose_LU(PC pc, Mat X, Mat Y)
    not need a Krylov method (i.e. you can use -ksp_type preonly, or
    `KSPSetType`(ksp,`KSPPREONLY`) for the Krylov method.
 
+   With `-pc_factor_mat_single_precision` the factor is only accurate to single precision; use it with `KSPRICHARDSON`
+   or `KSPFGMRES` and a small relative tolerance to refine the solution to double precision accuracy. It is an error with the
+   other solver types, for example `MATSOLVERMUMPS`; `MATSOLVERSUPERLU_DIST` has its own single precision factorization with `-pc_precision single`.
+
 .seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `MatSolverType`, `MatGetFactor()`, `PCQR`, `PCSVD`,
           `PCILU`, `PCCHOLESKY`, `PCICC`, `PCFactorSetReuseOrdering()`, `PCFactorSetReuseFill()`, `PCFactorGetMatrix()`,
           `PCFactorSetFill()`, `PCFactorSetUseInPlace()`, `PCFactorSetMatOrderingType()`, `PCFactorSetColumnPivot()`,
@@ -17,6 +17,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_GASM(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_KSP(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_BJKOKKOS(PC);
+PETSC_EXTERN PetscErrorCode PCCreate_BJBatch(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_Composite(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_Redundant(PC);
 PETSC_EXTERN PetscErrorCode PCCreate_NN(PC);
@@ -106,6 +107,7 @@ PetscErrorCode PCRegisterAll(void)
 #if defined(PETSC_HAVE_KOKKOS_KERNELS)
   PetscCall(PCRegister(PCBJKOKKOS, PCCreate_BJKOKKOS));
 #endif
+  PetscCall(PCRegister(PCBJBATCH, PCCreate_BJBatch));
   PetscCall(PCRegister(PCCOMPOSITE, PCCreate_Composite));
   PetscCall(PCRegister(PCREDUNDANT, PCCreate_Redundant));
   PetscCall(PCRegister(PCNN, PCCreate_NN));
@@ -0,0 +1,128 @@
+static char help[] = "Solves many small independent systems with PCBJBATCH.\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **args)
+{
+  Mat         A;
+  Vec         x, b, u;
+  KSP         ksp;
+  PetscInt    nsys = 37, bs_min = 10, bs_max = 20, nlocal = PETSC_DECIDE, first, *bsizes, n = 0, rstart, N;
+  PetscReal   coupling = 0.0, tol = 1.e-6, err, nrm;
+  PetscBool   symmetric = PETSC_FALSE, dense = PETSC_FALSE, constant = PETSC_FALSE;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nsys", &nsys, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs_min", &bs_min, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs_max", &bs_max, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-coupling", &coupling, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-tol", &tol, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-symmetric", &symmetric, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-dense", &dense, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-constant", &constant, NULL));
+  if (constant) bs_max = bs_min;
+
+  /* the systems are distributed over the processes, system i has size bs_min + 7 i mod (bs_max - bs_min + 1) */
+  PetscCall(PetscSplitOwnership(PETSC_COMM_WORLD, &nlocal, &nsys));
+  PetscCallMPI(MPI_Scan(&nlocal, &first, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD));
+  first -= nlocal;
+  PetscCall(PetscMalloc1(nlocal, &bsizes));
+  for (PetscInt i = 0; i < nlocal; i++) {
+    bsizes[i] = bs_min + (7 * (first + i)) % (bs_max - bs_min + 1);
+    n += bsizes[i];
+  }
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, n, n, PETSC_DETERMINE, PETSC_DETERMINE));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSetUp(A));
+  PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  if (constant) PetscCall(MatSetBlockSize(A, bs_min));
+  else PetscCall(MatSetVariableBlockSizes(A, nlocal, bsizes));
+  PetscCall(MatGetOwnershipRange(A, &rstart, NULL));
+  PetscCall(MatGetSize(A, &N, NULL));
+
+  /* diagonally dominant blocks whose sparsity patterns differ from system to system */
+  for (PetscInt i = 0, row = rstart; i < nlocal; row += bsizes[i], i++) {
+    const PetscInt bs = bsizes[i], s = first + i;
+
+    for (PetscInt j = 0; j < bs; j++) {
+      PetscCall(MatSetValue(A, row + j, row + j, 4.0 + 0.1 * (s % 5), ADD_VALUES));
+      if (j > 0) PetscCall(MatSetValue(A, row + j, row + j - 1, -1.0, ADD_VALUES));
+      if (j < bs - 1) PetscCall(MatSetValue(A, row + j, row + j + 1, symmetric ? -1.0 : -0.5, ADD_VALUES));
+      if (dense) {
+        for (PetscInt k = 0; k < bs; k++) {
+          if (PetscAbsInt(k - j) > 1) PetscCall(MatSetValue(A, row + j, row + k, 1.0 / (1 + j + k + (symmetric ? 0 : j)), ADD_VALUES));
+        }
+      } else {
+        const PetscInt k = (j + 2 + s % 3) % bs;
+
+        if (PetscAbsInt(k - j) > 1) {
+          PetscCall(MatSetValue(A, row + j, row + k, 0.5, ADD_VALUES));
+          if (symmetric) PetscCall(MatSetValue(A, row + k, row + j, 0.5, ADD_VALUES));
+        }
+      }
+    }
+    /* couplings between consecutive systems, ignored by the preconditioner */
+    if (coupling != 0.0 && row + bs < N) {
+      PetscCall(MatSetValue(A, row + bs - 1, row + bs, -coupling, ADD_VALUES));
+      PetscCall(MatSetValue(A, row + bs, row + bs - 1, -coupling, ADD_VALUES));
+    }
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(PetscFree(bsizes));
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &u));
+  for (PetscInt row = rstart; row < rstart + n; row++) PetscCall(VecSetValue(u, row, PetscSinReal(0.3 * row) + 1.0, INSERT_VALUES));
+  PetscCall(VecAssemblyBegin(u));
+  PetscCall(VecAssemblyEnd(u));
+  PetscCall(MatMult(A, u, b));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPPREONLY));
+  PetscCall(KSPSetTolerances(ksp, 1.e-10, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSolve(ksp, b, x));
+
+  PetscCall(VecNorm(u, NORM_2, &nrm));
+  PetscCall(VecAXPY(x, -1.0, u));
+  PetscCall(VecNorm(x, NORM_2, &err));
+  if (err > tol * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative error of the solution %g\n", (double)(err / nrm)));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&u));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    nsize: {{1 2}}
+    args: -pc_type bjbatch -pc_bjbatch_ksp_type bcgs -pc_bjbatch_pc_type {{ilu jacobi none}} -pc_bjbatch_ksp_rtol 1e-10
+    output_file: output/empty.out
+
+  test:
+    suffix: cg
+    nsize: 2
+    args: -symmetric -pc_type bjbatch -pc_bjbatch_ksp_type cg -pc_bjbatch_pc_type {{ilu jacobi}} -pc_bjbatch_ksp_rtol 1e-10
+    output_file: output/empty.out
+
+  test:
+    suffix: dense
+    args: -dense -constant {{0 1}} -pc_type bjbatch
+    output_file: output/empty.out
+
+  test:
+    suffix: gmres
+    args: -coupling 0.2 -ksp_type gmres -pc_type bjbatch -pc_bjbatch_ksp_type bcgs -pc_bjbatch_ksp_rtol 1e-6 -ksp_converged_reason -ksp_view
+    filter: grep -e CONVERGED -e "batched solver" -e "local systems" -e "last application"
+
+TEST*/
@@ -0,0 +1,161 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+/*@C
+  MatCreateMPIAIJSingle - Creates a sparse parallel matrix whose local
+  portions are stored as `MATSEQAIJSINGLE` matrices (a matrix class that inherits
+  from SEQAIJ but performs some operations with a single precision copy of the values).
+
+  Collective
+
+  Input Parameters:
++ comm  - MPI communicator
+. m     - number of local rows (or `PETSC_DECIDE` to have calculated if `M` is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+. n     - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or `PETSC_DECIDE` to have
+       calculated if `N` is given) For square matrices `n` is almost always `m`.
+. M     - number of global rows (or `PETSC_DETERMINE` to have calculated if `m` is given)
+. N     - number of global columns (or `PETSC_DETERMINE` to have calculated if `n` is given)
+. d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+. d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or `NULL`, if `d_nz` is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e `m`.
+           For matrices you plan to factor you must leave room for the diagonal entry and
+           put in the entry even if it is zero.
+. o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+- o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or `NULL`, if `o_nz` is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e `m`.
+
+  Output Parameter:
+. A - the matrix
+
+  Options Database Keys:
++ -mat_aijsingle_eager_shadow     - Construct the single precision copy upon matrix assembly; default is to take a "lazy" approach, performing this
+                                    step the first time the matrix is applied
+- -mat_aijsingle_compress_indices - Also store the column indices as 16-bit differences between consecutive columns of a row
+
+  Level: intermediate
+
+  Notes:
+  If the *_nnz parameter is given then the *_nz parameter is ignored
+
+  `m`,`n`,`M`,`N` parameters specify the size of the matrix, and its partitioning across
+  processors, while `d_nz`,`d_nnz`,`o_nz`,`o_nnz` parameters specify the approximate
+  storage requirements for this matrix.
+
+  If `PETSC_DECIDE` or `PETSC_DETERMINE` is used for a particular argument on one
+  processor than it must be used on all processors that share the object for
+  that argument.
+
+  The user MUST specify either the local or global matrix dimensions
+  (possibly both).
+
+  The parallel matrix is partitioned such that the first m0 rows belong to
+  process 0, the next m1 rows belong to process 1, the next m2 rows belong
+  to process 2 etc.. where m0,m1,m2... are the input parameter `m`.
+
+  The DIAGONAL portion of the local submatrix of a processor can be defined
+  as the submatrix which is obtained by extraction the part corresponding
+  to the rows r1-r2 and columns r1-r2 of the global matrix, where r1 is the
+  first row that belongs to the processor, and r2 is the last row belonging
+  to the this processor. This is a square mxm matrix. The remaining portion
+  of the local submatrix (mxN) constitute the OFF-DIAGONAL portion.
+
+  If `o_nnz`, `d_nnz` are specified, then `o_nz`, and `d_nz` are ignored.
+
+  When calling this routine with a single process communicator, a matrix of
+  type `MATSEQAIJSINGLE` is returned.  If a matrix of type `MATMPIAIJSINGLE` is desired
+  for this type of communicator, use the construction mechanism
+.vb
+   MatCreate(...,&A);
+   MatSetType(A,MPIAIJSINGLE);
+   MatMPIAIJSetPreallocation(A,...);
+.ve
+
+.seealso: [](ch_matrices), `Mat`, [Sparse Matrix Creation](sec_matsparse), `MATSEQAIJSINGLE`, `MATMPIAIJSINGLE`, `MATAIJSINGLE`, `MatCreate()`, `MatCreateSeqAIJSingle()`, `MatSetValues()`
+@*/
+PetscErrorCode MatCreateMPIAIJSingle(MPI_Comm comm, PetscInt m, PetscInt n, PetscInt M, PetscInt N, PetscInt d_nz, const PetscInt d_nnz[], PetscInt o_nz, const PetscInt o_nnz[], Mat *A)
+{
+  PetscMPIInt size;
+
+  PetscFunctionBegin;
+  PetscCall(MatCreate(comm, A));
+  PetscCall(MatSetSizes(*A, m, n, M, N));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  if (size > 1) {
+    PetscCall(MatSetType(*A, MATMPIAIJSINGLE));
+    PetscCall(MatMPIAIJSetPreallocation(*A, d_nz, d_nnz, o_nz, o_nnz));
+  } else {
+    PetscCall(MatSetType(*A, MATSEQAIJSINGLE));
+    PetscCall(MatSeqAIJSetPreallocation(*A, d_nz, d_nnz));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat, MatType, MatReuse, Mat *);
+
+static PetscErrorCode MatMPIAIJSetPreallocation_MPIAIJSingle(Mat B, PetscInt d_nz, const PetscInt d_nnz[], PetscInt o_nz, const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ *b = (Mat_MPIAIJ *)B->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatMPIAIJSetPreallocation_MPIAIJ(B, d_nz, d_nnz, o_nz, o_nnz));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(b->A, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->A));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(b->B, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat         B = *newmat;
+  Mat_MPIAIJ *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  /* the local blocks of an already preallocated matrix must be converted as well */
+  b = (Mat_MPIAIJ *)B->data;
+  if (b->A) PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(b->A, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->A));
+  if (b->B) PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(b->B, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->B));
+
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATMPIAIJSINGLE));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetPreallocation_C", MatMPIAIJSetPreallocation_MPIAIJSingle));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSingle(Mat A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSetType(A, MATMPIAIJ));
+  PetscCall(MatConvert_MPIAIJ_MPIAIJSingle(A, MATMPIAIJSINGLE, MAT_INPLACE_MATRIX, &A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   MATAIJSINGLE - "AIJSINGLE" - A matrix type to be used for sparse matrices.
+
+   This matrix type is identical to `MATSEQAIJSINGLE` when constructed with a single process communicator,
+   and `MATMPIAIJSINGLE` otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly `MatMPIAIJSetPreallocation()` is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   The matrix values are also kept in single precision, which is used for `MatMult()`, `MatSOR()` and the
+   `MatSolve()` of its `MATSOLVERPETSC` LU and ILU factors, see `MatCreateSeqAIJSingle()`. This type is intended for
+   the matrix from which a preconditioner, such as the smoothers of `PCMG` or `PCGAMG` or the blocks of `PCBJACOBI`
+   with `PCILU`, is built while the Krylov method uses a double precision `MATAIJ` operator.
+
+   Options Database Key:
+. -mat_type aijsingle - sets the matrix type to `MATAIJSINGLE`
+
+  Level: beginner
+
+.seealso: [](ch_matrices), `Mat`, `MatCreateMPIAIJSingle()`, `MATSEQAIJSINGLE`, `MATMPIAIJSINGLE`, `MATSEQAIJ`, `MATMPIAIJ`, `MATSEQAIJSELL`, `MATMPIAIJSELL`
+M*/
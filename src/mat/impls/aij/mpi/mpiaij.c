@@ -33,6 +33,7 @@ static PetscErrorCode MatReset_MPIAIJ(Mat mat)
   PetscCall(VecScatterDestroy(&aij->Mvctx));
   PetscCall(PetscFree2(aij->rowvalues, aij->rowindices));
   PetscCall(PetscFree(aij->ld));
+  PetscCall(PetscFree(aij->splitrows));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -67,8 +68,10 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetPreallocation_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatResetPreallocation_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatResetHash_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetUseSplitMult_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetPreallocationCSR_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatDiagonalScaleLocal_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMatrixPowers_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpibaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpisbaij_C", NULL));
 #if defined(PETSC_HAVE_CUDA)
@@ -97,6 +100,9 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetUseScalableIncreaseOverlap_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijperm_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijsell_C", NULL));
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijsingle_C", NULL));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijmkl_C", NULL));
 #endif
@@ -146,7 +152,7 @@ static PetscErrorCode MatRestoreRowIJ_MPIAIJ(Mat A, PetscInt oshift, PetscBool s
   Developer Note:
   Level: beginner
 
-    Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJMKL`, `MATAIJCRL`, `MATAIJKOKKOS`,and also automatically switches over to use inodes when
+    Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJSINGLE`, `MATAIJMKL`, `MATAIJCRL`, `MATAIJKOKKOS`,and also automatically switches over to use inodes when
    enough exist.
 
 .seealso: [](ch_matrices), `Mat`, `MATMPIAIJ`, `MATSEQAIJ`, `MatCreateAIJ()`, `MatCreateSeqAIJ()`, `MATSEQAIJ`, `MATMPIAIJ`
@@ -1087,6 +1093,120 @@ static PetscErrorCode MatMultAdd_MPIAIJ(Mat A, Vec xx, Vec yy, Vec zz)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* Computes the rows without entries in B while the ghost values are communicated */
+static PetscErrorCode MatMPIAIJSplitSetUp_Private(Mat A)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ *)A->data;
+  const PetscInt *bi;
+  PetscInt        m = A->rmap->n, nb = 0;
+
+  PetscFunctionBegin;
+  if (a->splitrows && a->splitstate == A->nonzerostate) PetscFunctionReturn(PETSC_SUCCESS);
+  bi = ((Mat_SeqAIJ *)a->B->data)->i;
+  PetscCall(PetscFree(a->splitrows));
+  PetscCall(PetscMalloc1(m, &a->splitrows));
+  a->nsplitinterior = 0;
+  for (PetscInt i = 0; i < m; i++) {
+    if (bi[i + 1] == bi[i]) a->splitrows[a->nsplitinterior++] = i;
+  }
+  for (PetscInt i = 0; i < m; i++) {
+    if (bi[i + 1] > bi[i]) a->splitrows[a->nsplitinterior + nb++] = i;
+  }
+  a->splitstate = A->nonzerostate;
+  PetscCall(PetscInfo(A, "%" PetscInt_FMT " interior rows and %" PetscInt_FMT " boundary rows\n", a->nsplitinterior, nb));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   zz = yy + A xx, or zz = A xx if yy is NULL, where the rows with entries in B are computed from both blocks once the
+   ghost values have arrived so each entry of zz is written once
+*/
+static PetscErrorCode MatMultAdd_MPIAIJ_Split_Private(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_MPIAIJ        *a = (Mat_MPIAIJ *)A->data;
+  Mat_SeqAIJ        *ad, *bd;
+  const PetscScalar *x, *lx, *aa, *ba;
+  PetscScalar       *y = NULL, *z;
+  const PetscInt    *rows;
+  PetscInt           m = A->rmap->n;
+
+  PetscFunctionBegin;
+  PetscCall(MatMPIAIJSplitSetUp_Private(A));
+  ad   = (Mat_SeqAIJ *)a->A->data;
+  bd   = (Mat_SeqAIJ *)a->B->data;
+  rows = a->splitrows;
+  PetscCall(VecScatterBegin(a->Mvctx, xx, a->lvec, INSERT_VALUES, SCATTER_FORWARD));
+  PetscCall(VecGetArrayRead(xx, &x));
+  if (yy) PetscCall(VecGetArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecGetArrayWrite(zz, &z));
+  PetscCall(MatSeqAIJGetArrayRead(a->A, &aa));
+  PetscCall(MatSeqAIJGetArrayRead(a->B, &ba));
+  for (PetscInt k = 0; k < a->nsplitinterior; k++) {
+    const PetscInt     r = rows[k], n = ad->i[r + 1] - ad->i[r], *aj = ad->j + ad->i[r];
+    const PetscScalar *av  = aa + ad->i[r];
+    PetscScalar        sum = y ? y[r] : 0.0;
+
+    PetscSparseDensePlusDot(sum, x, av, aj, n);
+    z[r] = sum;
+  }
+  PetscCall(VecScatterEnd(a->Mvctx, xx, a->lvec, INSERT_VALUES, SCATTER_FORWARD));
+  PetscCall(VecGetArrayRead(a->lvec, &lx));
+  for (PetscInt k = a->nsplitinterior; k < m; k++) {
+    const PetscInt     r = rows[k], n = ad->i[r + 1] - ad->i[r], nb = bd->i[r + 1] - bd->i[r], *aj = ad->j + ad->i[r], *bj = bd->j + bd->i[r];
+    const PetscScalar *av = aa + ad->i[r], *bv = ba + bd->i[r];
+    PetscScalar        sum = y ? y[r] : 0.0;
+
+    PetscSparseDensePlusDot(sum, x, av, aj, n);
+    PetscSparseDensePlusDot(sum, lx, bv, bj, nb);
+    z[r] = sum;
+  }
+  PetscCall(VecRestoreArrayRead(a->lvec, &lx));
+  PetscCall(MatSeqAIJRestoreArrayRead(a->A, &aa));
+  PetscCall(MatSeqAIJRestoreArrayRead(a->B, &ba));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  if (yy) PetscCall(VecRestoreArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecRestoreArrayWrite(zz, &z));
+  PetscCall(PetscLogFlops(2.0 * (ad->nz + bd->nz) - (yy ? 0 : m)));
+  PetscCall(MatSeqAIJLogBytes_Private(a->A, a->A->cmap->n + (yy ? 2.0 : 1.0) * m));
+  PetscCall(MatSeqAIJLogBytes_Private(a->B, a->B->cmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* The diagonal and off-diagonal blocks may have been converted to other types, e.g. by a subclass */
+static PetscErrorCode MatMPIAIJSplitUsable_Private(Mat A, PetscBool *usable)
+{
+  Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
+  PetscBool   isA, isB;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)a->A, MATSEQAIJ, &isA));
+  PetscCall(PetscObjectTypeCompare((PetscObject)a->B, MATSEQAIJ, &isB));
+  *usable = (PetscBool)(isA && isB);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMult_MPIAIJ_Split(Mat A, Vec xx, Vec yy)
+{
+  PetscBool usable;
+
+  PetscFunctionBegin;
+  PetscCall(MatMPIAIJSplitUsable_Private(A, &usable));
+  if (usable) PetscCall(MatMultAdd_MPIAIJ_Split_Private(A, xx, NULL, yy));
+  else PetscCall(MatMult_MPIAIJ(A, xx, yy));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultAdd_MPIAIJ_Split(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  PetscBool usable;
+
+  PetscFunctionBegin;
+  PetscCall(MatMPIAIJSplitUsable_Private(A, &usable));
+  if (usable) PetscCall(MatMultAdd_MPIAIJ_Split_Private(A, xx, yy, zz));
+  else PetscCall(MatMultAdd_MPIAIJ(A, xx, yy, zz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatMultTranspose_MPIAIJ(Mat A, Vec xx, Vec yy)
 {
   Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
@@ -2609,6 +2729,23 @@ static PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap_MPIAIJ(Mat A, Petsc
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode MatMPIAIJSetUseSplitMult_MPIAIJ(Mat A, PetscBool split)
+{
+  PetscFunctionBegin;
+  if (A->ops->mult != MatMult_MPIAIJ && A->ops->mult != MatMult_MPIAIJ_Split) { /* subclasses with their own MatMult() */
+    PetscCall(PetscInfo(A, "Ignoring the split rows for matrix type %s\n", ((PetscObject)A)->type_name));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (split) {
+    A->ops->mult    = MatMult_MPIAIJ_Split;
+    A->ops->multadd = MatMultAdd_MPIAIJ_Split;
+  } else {
+    A->ops->mult    = MatMult_MPIAIJ;
+    A->ops->multadd = MatMultAdd_MPIAIJ;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatMPIAIJGetNumberNonzeros - gets the number of nonzeros in the matrix on this MPI rank
 
@@ -2657,15 +2794,53 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A, PetscBool sc)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  MatMPIAIJSetUseSplitMult - Determine if `MatMult()` and `MatMultAdd()` split the local rows into interior rows, that only
+  have entries in the diagonal block, and boundary rows, that also have entries in the off-diagonal block
+
+  Logically Collective
+
+  Input Parameters:
++ A     - the matrix
+- split - `PETSC_TRUE` indicates use the split rows (default is not to split the rows)
+
+  Options Database Key:
+. -mat_mpiaij_split_mult <bool> - use the split rows
+
+  Level: advanced
+
+  Notes:
+  The default `MatMult()` applies the diagonal block to all the rows while the ghost values are communicated, then adds the
+  off-diagonal block in a second pass over the boundary rows of the result. With the split rows the interior rows are computed while
+  the ghost values are communicated, and the boundary rows apply both blocks at once after they arrive, so each entry of the
+  result is written once. This helps when many rows are boundary rows, e.g. with many MPI processes or a poor partitioning.
+
+  The split is recomputed when the nonzero structure changes. It is only used when both blocks are `MATSEQAIJ`, the I-node
+  routines of the diagonal block are then not used.
+
+.seealso: [](ch_matrices), `Mat`, `MATMPIAIJ`, `MatMult()`, `MatMultAdd()`
+@*/
+PetscErrorCode MatMPIAIJSetUseSplitMult(Mat A, PetscBool split)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A, MAT_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(A, split, 2);
+  PetscTryMethod(A, "MatMPIAIJSetUseSplitMult_C", (Mat, PetscBool), (A, split));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatSetFromOptions_MPIAIJ(Mat A, PetscOptionItems PetscOptionsObject)
 {
-  PetscBool sc = PETSC_FALSE, flg;
+  PetscBool sc = PETSC_FALSE, split, flg;
 
   PetscFunctionBegin;
   PetscOptionsHeadBegin(PetscOptionsObject, "MPIAIJ options");
   if (A->ops->increaseoverlap == MatIncreaseOverlap_MPIAIJ_Scalable) sc = PETSC_TRUE;
   PetscCall(PetscOptionsBool("-mat_increase_overlap_scalable", "Use a scalable algorithm to compute the overlap", "MatIncreaseOverlap", sc, &sc, &flg));
   if (flg) PetscCall(MatMPIAIJSetUseScalableIncreaseOverlap(A, sc));
+  split = (PetscBool)(A->ops->mult == MatMult_MPIAIJ_Split);
+  PetscCall(PetscOptionsBool("-mat_mpiaij_split_mult", "Compute the rows without off-diagonal entries while communicating", "MatMPIAIJSetUseSplitMult", split, &split, &flg));
+  if (flg) PetscCall(MatMPIAIJSetUseSplitMult(A, split));
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -5966,6 +6141,9 @@ PetscErrorCode MatGetBrowsOfAoCols_MPIAIJ(Mat A, Mat B, MatReuse scall, PetscInt
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat, MatType, MatReuse, Mat *);
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat, MatType, MatReuse, Mat *);
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat, MatType, MatReuse, Mat *);
 #endif
@@ -6824,6 +7002,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   b->spptr = NULL;
 
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetUseScalableIncreaseOverlap_C", MatMPIAIJSetUseScalableIncreaseOverlap_MPIAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetUseSplitMult_C", MatMPIAIJSetUseSplitMult_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatStoreValues_C", MatStoreValues_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatRetrieveValues_C", MatRetrieveValues_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatIsTranspose_C", MatIsTranspose_MPIAIJ));
@@ -6832,8 +7011,12 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatResetHash_C", MatResetHash_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetPreallocationCSR_C", MatMPIAIJSetPreallocationCSR_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatDiagonalScaleLocal_C", MatDiagonalScaleLocal_MPIAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMatrixPowers_C", MatMatrixPowers_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijperm_C", MatConvert_MPIAIJ_MPIAIJPERM));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijsell_C", MatConvert_MPIAIJ_MPIAIJSELL));
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijsingle_C", MatConvert_MPIAIJ_MPIAIJSingle));
+#endif
 #if defined(PETSC_HAVE_CUDA)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijcusparse_C", MatConvert_MPIAIJ_MPIAIJCUSPARSE));
 #endif
@@ -67,6 +67,11 @@ typedef struct {
   Vec       diag;
   PetscInt *ld; /* number of entries per row left of diagonal block */
 
+  /* Used by MatMult() with interior and boundary rows, see MatMPIAIJSetUseSplitMult() */
+  PetscInt        *splitrows;      /* local rows without entries in B followed by the rows with entries in B */
+  PetscInt         nsplitinterior; /* number of local rows without entries in B */
+  PetscObjectState splitstate;     /* nonzero state of the matrix when splitrows was computed */
+
   /* Used by device classes */
   void *spptr;
 
@@ -97,6 +102,7 @@ PETSC_INTERN PetscErrorCode MatDisAssemble_MPIAIJ(Mat, PetscBool);
 PETSC_INTERN PetscErrorCode MatDuplicate_MPIAIJ(Mat, MatDuplicateOption, Mat *);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ(Mat, PetscInt, IS[], PetscInt);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ_Scalable(Mat, PetscInt, IS[], PetscInt);
+PETSC_INTERN PetscErrorCode MatMatrixPowers_MPIAIJ(Mat, PetscInt, Vec, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec, Vec[]);
 PETSC_INTERN PetscErrorCode MatFDColoringCreate_MPIXAIJ(Mat, ISColoring, MatFDColoring);
 PETSC_INTERN PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat, ISColoring, MatFDColoring);
 PETSC_INTERN PetscErrorCode MatCreateSubMatrices_MPIAIJ(Mat, PetscInt, const IS[], const IS[], MatReuse, Mat *[]);
@@ -383,6 +383,8 @@ typedef struct {
   PetscInt      nsends, nrecvs;
   MPI_Datatype *stype, *rtype;
   PetscInt      blda;
+  PetscScalar  *work; /* work array of MatMatMultNumericAdd_SeqAIJ_SeqDense() for the off-diagonal block */
+  PetscInt      nwork;
 } MPIAIJ_MPIDense;
 
 static PetscErrorCode MatMPIAIJ_MPIDenseDestroy(void *ctx)
@@ -396,6 +398,7 @@ static PetscErrorCode MatMPIAIJ_MPIDenseDestroy(void *ctx)
   for (i = 0; i < contents->nsends; i++) PetscCallMPI(MPI_Type_free(&contents->stype[i]));
   for (i = 0; i < contents->nrecvs; i++) PetscCallMPI(MPI_Type_free(&contents->rtype[i]));
   PetscCall(PetscFree4(contents->stype, contents->rtype, contents->rwaits, contents->swaits));
+  PetscCall(PetscFree(contents->work));
   PetscCall(PetscFree(contents));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -507,7 +510,7 @@ static PetscErrorCode MatMatMultSymbolic_MPIAIJ_MPIDense(Mat A, Mat B, PetscReal
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PETSC_INTERN PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat, Mat, Mat, const PetscBool);
+PETSC_INTERN PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat, Mat, Mat, PetscScalar **, PetscInt *, const PetscBool);
 
 /*
     Performs an efficient scatter on the rows of B needed by this process; this is
@@ -592,7 +595,7 @@ static PetscErrorCode MatMatMultNumeric_MPIAIJ_MPIDense(Mat A, Mat B, Mat C)
     PetscCall(MatMPIDenseScatter(A, B, 0, C, &workB));
 
     /* off-diagonal block of A times nonlocal rows of B */
-    PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(aij->B, workB, cdense->A, PETSC_TRUE));
+    PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(aij->B, workB, cdense->A, &contents->work, &contents->nwork, PETSC_TRUE));
   } else {
     Mat       Bb, Cb;
     PetscInt  BN = B->cmap->N, n = contents->workB->cmap->n;
@@ -613,7 +616,7 @@ static PetscErrorCode MatMatMultNumeric_MPIAIJ_MPIDense(Mat A, Mat B, Mat C)
 
       /* off-diagonal block of A times nonlocal rows of B */
       cdense = (Mat_MPIDense *)Cb->data;
-      PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(aij->B, workB, cdense->A, PETSC_TRUE));
+      PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(aij->B, workB, cdense->A, &contents->work, &contents->nwork, PETSC_TRUE));
       PetscCall(MatDenseRestoreSubMatrix(B, &Bb));
       PetscCall(MatDenseRestoreSubMatrix(C, &Cb));
     }
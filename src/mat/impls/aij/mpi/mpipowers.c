@@ -0,0 +1,196 @@
+/*
+  Matrix-powers kernel for MPIAIJ matrices: computes a basis of the Krylov space of dimension k + 1 with a single
+  exchange of ghost values, by computing the intermediate vectors redundantly on the rows within distance k of the
+  rows owned by each MPI process.
+*/
+
+#include <../src/mat/impls/aij/mpi/mpiaij.h> /*I "petscmat.h" I*/
+#include <petscsf.h>
+
+typedef struct {
+  PetscInt         k;                   /* depth of the ghost region */
+  PetscObjectState nonzerostate, state; /* of the matrix when the submatrix was extracted */
+  IS               isrow, iscol;        /* the rows within distance k - 1 and the columns within distance k, sorted */
+  Mat             *sub;                 /* the submatrix of these rows and columns */
+  PetscInt         nc;                  /* number of columns of the submatrix, the length of the local work vectors */
+  PetscInt         rstart;              /* position of the first owned row in the work vectors */
+  PetscInt        *rowpos;              /* position of each row of the submatrix in the work vectors */
+  PetscInt        *perm;                /* rows of the submatrix sorted by their distance to the owned rows */
+  PetscInt        *cnt;                 /* cnt[l] is the number of rows at distance at most l */
+  PetscSF          sf;                  /* from the owned entries of x to the work vectors */
+  PetscScalar     *work, *dloc;         /* three work vectors and the ghosted diagonal scaling */
+  PetscObjectId    did;                 /* the diagonal scaling in dloc */
+  PetscObjectState dstate;
+} Mat_MatrixPowers_MPIAIJ;
+
+static PetscErrorCode MatMatrixPowersDestroy_MPIAIJ(void **data)
+{
+  Mat_MatrixPowers_MPIAIJ *mp = (Mat_MatrixPowers_MPIAIJ *)*data;
+
+  PetscFunctionBegin;
+  PetscCall(ISDestroy(&mp->isrow));
+  PetscCall(ISDestroy(&mp->iscol));
+  if (mp->sub) PetscCall(MatDestroySubMatrices(1, &mp->sub));
+  PetscCall(PetscFree3(mp->rowpos, mp->perm, mp->cnt));
+  PetscCall(PetscSFDestroy(&mp->sf));
+  PetscCall(PetscFree2(mp->work, mp->dloc));
+  PetscCall(PetscFree(mp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Builds the ghost region of depth k with k calls to MatIncreaseOverlap(), which give the distance of each row to
+  the owned rows, extracts the rows needed for the k products, and creates the PetscSF for the ghost values of x
+*/
+static PetscErrorCode MatMatrixPowersSetUp_MPIAIJ(Mat A, PetscInt k, Mat_MatrixPowers_MPIAIJ **mpout)
+{
+  Mat_MatrixPowers_MPIAIJ *mp;
+  IS                      *is;
+  PetscInt                 nr, nc, *level, *rows, m = A->rmap->n;
+  const PetscInt          *cidx, *idx;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&mp));
+  mp->k = k;
+  PetscCall(PetscMalloc1(k + 1, &is));
+  PetscCall(ISCreateStride(PETSC_COMM_SELF, m, A->rmap->rstart, 1, &is[0]));
+  for (PetscInt l = 1; l <= k; l++) {
+    PetscCall(ISDuplicate(is[l - 1], &is[l]));
+    PetscCall(MatIncreaseOverlap(A, 1, &is[l], 1));
+    PetscCall(ISSort(is[l]));
+  }
+
+  /* the distance of the columns to the owned rows, the sets are nested */
+  PetscCall(ISGetLocalSize(is[k], &nc));
+  PetscCall(ISGetIndices(is[k], &cidx));
+  PetscCall(PetscMalloc2(nc, &level, nc, &rows));
+  for (PetscInt i = 0; i < nc; i++) level[i] = k;
+  for (PetscInt l = k - 1; l >= 0; l--) {
+    PetscInt n;
+
+    PetscCall(ISGetLocalSize(is[l], &n));
+    PetscCall(ISGetIndices(is[l], &idx));
+    for (PetscInt i = 0, p = 0; i < n; i++) {
+      while (cidx[p] < idx[i]) p++;
+      level[p] = l;
+    }
+    PetscCall(ISRestoreIndices(is[l], &idx));
+  }
+  nr = 0;
+  for (PetscInt i = 0; i < nc; i++)
+    if (level[i] < k) rows[nr++] = cidx[i];
+  PetscCall(PetscFindInt(A->rmap->rstart, nc, cidx, &mp->rstart));
+  PetscCheck(!m || mp->rstart >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Owned rows missing from the ghost region");
+  mp->rstart = PetscMax(mp->rstart, 0);
+
+  /* the rows to compute at step j are those at distance at most k - 1 - j, so sort them by distance */
+  PetscCall(PetscMalloc3(nr, &mp->rowpos, nr, &mp->perm, k, &mp->cnt));
+  PetscCall(PetscArrayzero(mp->cnt, k));
+  for (PetscInt i = 0, r = 0; i < nc; i++) {
+    if (level[i] == k) continue;
+    mp->rowpos[r++] = i;
+    mp->cnt[level[i]]++;
+  }
+  for (PetscInt l = 1; l < k; l++) mp->cnt[l] += mp->cnt[l - 1];
+  for (PetscInt r = nr - 1; r >= 0; r--) mp->perm[--mp->cnt[level[mp->rowpos[r]]]] = r;
+  for (PetscInt l = 0; l < k; l++) mp->cnt[l] = l + 1 < k ? mp->cnt[l + 1] : nr;
+
+  PetscCall(ISCreateGeneral(PETSC_COMM_SELF, nr, rows, PETSC_COPY_VALUES, &mp->isrow));
+  PetscCall(ISCreateGeneral(PETSC_COMM_SELF, nc, cidx, PETSC_COPY_VALUES, &mp->iscol));
+  PetscCall(PetscFree2(level, rows));
+  PetscCall(MatCreateSubMatrices(A, 1, &mp->isrow, &mp->iscol, MAT_INITIAL_MATRIX, &mp->sub));
+  mp->nonzerostate = A->nonzerostate;
+  PetscCall(PetscObjectStateGet((PetscObject)A, &mp->state));
+
+  PetscCall(PetscSFCreate(PetscObjectComm((PetscObject)A), &mp->sf));
+  PetscCall(PetscSFSetGraphLayout(mp->sf, A->cmap, nc, NULL, PETSC_COPY_VALUES, cidx));
+  PetscCall(PetscSFSetUp(mp->sf));
+  PetscCall(ISRestoreIndices(is[k], &cidx));
+  for (PetscInt l = 0; l <= k; l++) PetscCall(ISDestroy(&is[l]));
+  PetscCall(PetscFree(is));
+
+  mp->nc  = nc;
+  mp->did = -1;
+  PetscCall(PetscMalloc2(3 * nc, &mp->work, nc, &mp->dloc));
+  *mpout = mp;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatMatrixPowers_MPIAIJ(Mat A, PetscInt k, Vec D, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], Vec x, Vec y[])
+{
+  Mat_MatrixPowers_MPIAIJ *mp;
+  PetscObjectState         state;
+  Mat_SeqAIJ              *a;
+  const PetscInt          *ai, *aj;
+  const PetscScalar       *aa, *xarray;
+  PetscScalar             *w[3], *yarray;
+  PetscInt                 m = A->rmap->n;
+  PetscLogDouble           flops = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectContainerQuery((PetscObject)A, "MatMatrixPowers_MPIAIJ", (void **)&mp));
+  if (mp && (mp->k < k || mp->nonzerostate != A->nonzerostate)) {
+    PetscCall(PetscObjectCompose((PetscObject)A, "MatMatrixPowers_MPIAIJ", NULL));
+    mp = NULL;
+  }
+  if (!mp) {
+    PetscCall(MatMatrixPowersSetUp_MPIAIJ(A, k, &mp));
+    PetscCall(PetscObjectContainerCompose((PetscObject)A, "MatMatrixPowers_MPIAIJ", mp, MatMatrixPowersDestroy_MPIAIJ));
+  }
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (state != mp->state) {
+    PetscCall(MatCreateSubMatrices(A, 1, &mp->isrow, &mp->iscol, MAT_REUSE_MATRIX, &mp->sub));
+    mp->state = state;
+  }
+
+  /* the single exchange of ghost values, the diagonal scaling is only sent when it has changed */
+  w[0] = mp->work;
+  w[1] = mp->work + mp->nc;
+  w[2] = mp->work + 2 * mp->nc;
+  if (D) {
+    PetscObjectId    did;
+    PetscObjectState dstate;
+
+    PetscCall(PetscObjectGetId((PetscObject)D, &did));
+    PetscCall(PetscObjectStateGet((PetscObject)D, &dstate));
+    if (did != mp->did || dstate != mp->dstate) {
+      PetscCall(VecGetArrayRead(D, &xarray));
+      PetscCall(PetscSFBcastBegin(mp->sf, MPIU_SCALAR, xarray, mp->dloc, MPI_REPLACE));
+      PetscCall(PetscSFBcastEnd(mp->sf, MPIU_SCALAR, xarray, mp->dloc, MPI_REPLACE));
+      PetscCall(VecRestoreArrayRead(D, &xarray));
+      mp->did    = did;
+      mp->dstate = dstate;
+    }
+  }
+  PetscCall(VecGetArrayRead(x, &xarray));
+  PetscCall(PetscSFBcastBegin(mp->sf, MPIU_SCALAR, xarray, w[0], MPI_REPLACE));
+  PetscCall(PetscSFBcastEnd(mp->sf, MPIU_SCALAR, xarray, w[0], MPI_REPLACE));
+  PetscCall(VecRestoreArrayRead(x, &xarray));
+
+  a  = (Mat_SeqAIJ *)mp->sub[0]->data;
+  ai = a->i;
+  aj = a->j;
+  PetscCall(MatSeqAIJGetArrayRead(mp->sub[0], &aa));
+  for (PetscInt j = 0; j < k; j++) {
+    PetscScalar *wp = w[(j + 2) % 3], *wc = w[j % 3], *wn = w[(j + 1) % 3];
+    PetscScalar  g = gamma ? gamma[j] : 1.0, al = alpha ? alpha[j] : 0.0, de = j && delta ? delta[j] : 0.0;
+    PetscInt     nrows = mp->cnt[k - 1 - j];
+
+    /* the vector j is in w[j % 3], the new one overwrites the vector j - 2 */
+    for (PetscInt t = 0; t < nrows; t++) {
+      PetscInt    r = mp->perm[t], p = mp->rowpos[r];
+      PetscScalar sum = 0.0;
+
+      for (PetscInt l = ai[r]; l < ai[r + 1]; l++) sum += aa[l] * wc[aj[l]];
+      if (D) sum *= mp->dloc[p];
+      wn[p] = g * (sum - al * wc[p] - (de != 0.0 ? de * wp[p] : 0.0));
+      flops += 2.0 * (ai[r + 1] - ai[r]) + 5.0;
+    }
+    PetscCall(VecGetArrayWrite(y[j + 1], &yarray));
+    PetscCall(PetscArraycpy(yarray, wn + mp->rstart, m));
+    PetscCall(VecRestoreArrayWrite(y[j + 1], &yarray));
+  }
+  PetscCall(MatSeqAIJRestoreArrayRead(mp->sub[0], &aa));
+  PetscCall(PetscLogFlops(flops));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
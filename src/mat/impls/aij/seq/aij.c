@@ -7,6 +7,9 @@
 #include <petscblaslapack.h>
 #include <petscbt.h>
 #include <petsc/private/kernels/blocktranspose.h>
+#if defined(PETSC_HAVE_OPENMP)
+  #include <omp.h>
+#endif
 
 /* defines MatSetValues_Seq_Hash(), MatAssemblyEnd_Seq_Hash(), MatSetUp_Seq_Hash() */
 #define TYPE AIJ
@@ -476,6 +479,214 @@ PetscErrorCode MatSetValues_SeqAIJ(Mat A, PetscInt m, const PetscInt im[], Petsc
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* the hash table used by the calling thread, with OpenMP each thread of the team has its own */
+static inline PetscInt MatSeqXAIJThreadSafeSlot_Private(Mat_SeqXAIJThreadSafe *ts)
+{
+#if defined(PETSC_HAVE_OPENMP)
+  return (PetscInt)omp_get_thread_num() % ts->n;
+#else
+  (void)ts;
+  return 0;
+#endif
+}
+
+PetscErrorCode MatSeqXAIJThreadSafeCreate_Private(Mat_SeqXAIJThreadSafe **ts)
+{
+  PetscInt n = 1;
+
+  PetscFunctionBegin;
+#if !defined(PETSC_HAVE_MATSEQXAIJ_THREADSAFE)
+  SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP_SYS, "MAT_THREAD_SAFE_SET_VALUES requires PETSc configured with --with-threadsafety, and with OpenMP or a compiler with GNU atomic builtins");
+#endif
+#if defined(PETSC_HAVE_OPENMP)
+  n = (PetscInt)omp_get_max_threads();
+#endif
+  PetscCall(PetscNew(ts));
+  (*ts)->n = n;
+  PetscCall(PetscMalloc2(n, &(*ts)->ht, n, &(*ts)->lock));
+  for (PetscInt t = 0; t < n; t++) {
+    PetscCall(PetscHMapIJVCreate(&(*ts)->ht[t]));
+    PetscCall(PetscSpinlockCreate(&(*ts)->lock[t]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqXAIJThreadSafeDestroy_Private(Mat_SeqXAIJThreadSafe **ts)
+{
+  PetscFunctionBegin;
+  if (!*ts) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt t = 0; t < (*ts)->n; t++) {
+    PetscCall(PetscHMapIJVDestroy(&(*ts)->ht[t]));
+    PetscCall(PetscSpinlockDestroy(&(*ts)->lock[t]));
+  }
+  PetscCall(PetscFree2((*ts)->ht, (*ts)->lock));
+  PetscCall(PetscFree(*ts));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Stashes one entry in the hash table of the calling thread, the table is locked on first use (*slot < 0) and stays
+   locked until MatSeqXAIJThreadSafeRelease_Private() so a MatSetValues() call takes the lock at most once
+*/
+PetscErrorCode MatSeqXAIJThreadSafeAdd_Private(Mat_SeqXAIJThreadSafe *ts, PetscInt *slot, PetscInt row, PetscInt col, PetscScalar value, InsertMode addv)
+{
+  PetscHashIJKey key;
+  PetscBool      missing;
+
+  PetscFunctionBegin;
+  if (*slot < 0) {
+    *slot = MatSeqXAIJThreadSafeSlot_Private(ts);
+    PetscCall(PetscSpinlockLock(&ts->lock[*slot]));
+  }
+  key.i = row;
+  key.j = col;
+  switch (addv) {
+  case INSERT_VALUES:
+    PetscCall(PetscHMapIJVQuerySet(ts->ht[*slot], key, value, &missing));
+    break;
+  case ADD_VALUES:
+    PetscCall(PetscHMapIJVQueryAdd(ts->ht[*slot], key, value, &missing));
+    break;
+  default:
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "InsertMode not supported");
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqXAIJThreadSafeRelease_Private(Mat_SeqXAIJThreadSafe *ts, PetscInt slot)
+{
+  PetscFunctionBegin;
+  if (slot >= 0) PetscCall(PetscSpinlockUnlock(&ts->lock[slot]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatSetValues() for a matrix without a nonzero structure yet, every entry goes to the hash table of the calling thread */
+PetscErrorCode MatSeqXAIJThreadSafeSetValues_Private(Mat_SeqXAIJThreadSafe *ts, PetscBool roworiented, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode addv)
+{
+  PetscInt slot = -1;
+
+  PetscFunctionBegin;
+  for (PetscInt k = 0; k < m; k++) {
+    if (im[k] < 0) continue;
+    for (PetscInt l = 0; l < n; l++) {
+      if (in[l] < 0) continue;
+      PetscCall(MatSeqXAIJThreadSafeAdd_Private(ts, &slot, im[k], in[l], v ? (roworiented ? v[l + k * n] : v[k + l * m]) : 0.0, addv));
+    }
+  }
+  PetscCall(MatSeqXAIJThreadSafeRelease_Private(ts, slot));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Moves the entries of all the per-thread hash tables into A with the serial setvalues() of its type, one call per row.
+   Must be called by a single thread, it is done at the beginning of MatAssemblyEnd().
+*/
+PetscErrorCode MatSeqXAIJThreadSafeMerge_Private(Mat A, Mat_SeqXAIJThreadSafe *ts, PetscErrorCode (*setvalues)(Mat, PetscInt, const PetscInt[], PetscInt, const PetscInt[], const PetscScalar[], InsertMode))
+{
+  PetscInt        m = A->rmap->n, nz = 0, *rowstart, *cols;
+  PetscHashIJKey *keys;
+  PetscScalar    *vals, *values;
+
+  PetscFunctionBegin;
+  for (PetscInt t = 0; t < ts->n; t++) {
+    PetscInt size;
+
+    PetscCall(PetscHMapIJVGetSize(ts->ht[t], &size));
+    nz += size;
+  }
+  if (!nz) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscInfo(A, "Merging %" PetscInt_FMT " entries set with MAT_THREAD_SAFE_SET_VALUES from %" PetscInt_FMT " hash tables\n", nz, ts->n));
+  PetscCall(PetscMalloc5(nz, &keys, nz, &vals, m + 1, &rowstart, nz, &cols, nz, &values));
+  nz = 0;
+  for (PetscInt t = 0; t < ts->n; t++) {
+    PetscCall(PetscHMapIJVGetPairs(ts->ht[t], &nz, keys, vals));
+    PetscCall(PetscHMapIJVReset(ts->ht[t]));
+  }
+  /* bucket the entries by row so each row is set with one call */
+  PetscCall(PetscArrayzero(rowstart, m + 1));
+  for (PetscInt e = 0; e < nz; e++) rowstart[keys[e].i + 1]++;
+  for (PetscInt i = 0; i < m; i++) rowstart[i + 1] += rowstart[i];
+  for (PetscInt e = 0; e < nz; e++) {
+    const PetscInt k = rowstart[keys[e].i]++;
+
+    cols[k]   = keys[e].j;
+    values[k] = vals[e];
+  }
+  for (PetscInt i = 0, start = 0; i < m; i++) {
+    const PetscInt ncols = rowstart[i] - start;
+
+    if (ncols) {
+      PetscCall(PetscSortIntWithScalarArray(ncols, cols + start, values + start));
+      PetscCall((*setvalues)(A, 1, &i, ncols, cols + start, values + start, A->insertmode));
+    }
+    start = rowstart[i];
+  }
+  PetscCall(PetscFree5(keys, vals, rowstart, cols, values));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   MatSetValues() with MAT_THREAD_SAFE_SET_VALUES, the nonzero structure is only read so entries already in it are
+   updated in place, with atomics for ADD_VALUES, and new entries are stashed until MatAssemblyEnd()
+*/
+static PetscErrorCode MatSetValues_SeqAIJ_ThreadSafe(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
+{
+  Mat_SeqAIJ *a  = (Mat_SeqAIJ *)A->data;
+  PetscInt   *ai = a->i, *ailen = a->ilen, *aj = a->j, slot = -1;
+  MatScalar  *aa = a->a;
+
+  PetscFunctionBegin;
+  for (PetscInt k = 0; k < m; k++) {
+    const PetscInt row = im[k];
+    PetscInt      *rp;
+    MatScalar     *ap;
+
+    if (row < 0) continue;
+    PetscCheck(row < A->rmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Row too large: row %" PetscInt_FMT " max %" PetscInt_FMT, row, A->rmap->n - 1);
+    rp = PetscSafePointerPlusOffset(aj, ai[row]);
+    ap = PetscSafePointerPlusOffset(aa, ai[row]);
+    for (PetscInt l = 0; l < n; l++) {
+      const PetscInt col = in[l];
+      MatScalar      value;
+      PetscInt       i;
+
+      if (col < 0) continue;
+      PetscCheck(col < A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column too large: col %" PetscInt_FMT " max %" PetscInt_FMT, col, A->cmap->n - 1);
+      value = (v && !A->structure_only) ? (a->roworiented ? v[l + k * n] : v[k + l * m]) : 0.0;
+      if (value == 0.0 && a->ignorezeroentries && is == ADD_VALUES && row != col) continue;
+      PetscCall(PetscFindInt(col, ailen[row], rp, &i));
+      if (i >= 0) {
+        if (A->structure_only) continue;
+        if (is == ADD_VALUES) MatSeqXAIJAtomicAdd_Private(ap + i, value);
+        else ap[i] = value;
+        continue;
+      }
+      if (a->nonew == 1) continue;
+      PetscCheck(a->nonew != -1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero at (%" PetscInt_FMT ",%" PetscInt_FMT ") in the matrix", row, col);
+      PetscCall(MatSeqXAIJThreadSafeAdd_Private(a->threadsafe, &slot, row, col, value, is));
+    }
+  }
+  PetscCall(MatSeqXAIJThreadSafeRelease_Private(a->threadsafe, slot));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSetThreadSafe_SeqAIJ(Mat A, PetscBool flg)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  if (flg && !a->threadsafe) PetscCall(MatSeqXAIJThreadSafeCreate_Private(&a->threadsafe));
+  if (!flg && a->threadsafe) {
+    PetscCheck(A->insertmode == NOT_SET_VALUES, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot unset MAT_THREAD_SAFE_SET_VALUES before MatAssemblyEnd()");
+    PetscCall(MatSeqXAIJThreadSafeDestroy_Private(&a->threadsafe));
+  }
+  if (A->hash_active) {
+    A->ops->setvalues = flg ? MatSetValues_Seq_Hash_ThreadSafe : MatSetValues_Seq_Hash;
+    a->cops.setvalues = flg ? MatSetValues_SeqAIJ_ThreadSafe : MatSetValues_SeqAIJ;
+  } else A->ops->setvalues = flg ? MatSetValues_SeqAIJ_ThreadSafe : MatSetValues_SeqAIJ;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatSetValues_SeqAIJ_SortedFullNoPreallocation(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
 {
   Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
@@ -1088,18 +1299,94 @@ PetscErrorCode MatView_SeqAIJ(Mat A, PetscViewer viewer)
   else if (isbinary) PetscCall(MatView_SeqAIJ_Binary(A, viewer));
   else if (isdraw) PetscCall(MatView_SeqAIJ_Draw(A, viewer));
   PetscCall(MatView_SeqAIJ_Inode(A, viewer));
+  PetscCall(MatView_SeqAIJ_SIMD(A, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Squeezes the unused preallocated space out of the rows of a SeqAIJ matrix
+
+   With one thread each row is moved down in place by the amount of empty slots before it. With OpenMP kernels the
+   rows are split into one chunk per thread. Each chunk first compacts its rows to the front of its own storage, which
+   touches no other chunk, and the compacted chunks are then moved down one after another with a single PetscArraymove()
+   each. The result is identical to moving the rows down one at a time.
+*/
+static PetscErrorCode MatSeqAIJCompactRows_Private(Mat A, PetscInt *fshift, PetscInt *rmax)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  PetscInt        m = A->rmap->n, nchunks = 1, *ai = a->i, *aj = a->j, *newai, *cstart;
+  const PetscInt *ailen = a->ilen, *imax = a->imax;
+  MatScalar      *aa    = A->structure_only ? NULL : a->a;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  nchunks = PetscMax(PetscMin(PetscNumOMPThreads, m), 1);
+#endif
+  *fshift = 0;
+  *rmax   = 0;
+  if (nchunks == 1) {
+    if (m) *rmax = ailen[0];
+    for (PetscInt i = 1; i < m; i++) {
+      *fshift += imax[i - 1] - ailen[i - 1];
+      *rmax = PetscMax(*rmax, ailen[i]);
+      if (*fshift) {
+        PetscCall(PetscArraymove(aj + ai[i] - *fshift, aj + ai[i], ailen[i]));
+        if (aa) PetscCall(PetscArraymove(aa + ai[i] - *fshift, aa + ai[i], ailen[i]));
+      }
+      ai[i] = ai[i - 1] + ailen[i - 1];
+    }
+    if (m) {
+      *fshift += imax[m - 1] - ailen[m - 1];
+      ai[m] = ai[m - 1] + ailen[m - 1];
+    }
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscMalloc2(m + 1, &newai, nchunks + 1, &cstart));
+  newai[0] = 0;
+  for (PetscInt i = 0; i < m; i++) {
+    newai[i + 1] = newai[i] + ailen[i];
+    *fshift += imax[i] - ailen[i];
+    *rmax = PetscMax(*rmax, ailen[i]);
+  }
+  if (*fshift) {
+    for (PetscInt c = 0; c <= nchunks; c++) cstart[c] = ai[(c * m) / nchunks];
+    PetscPragmaUseOMPKernels(parallel for)
+    for (PetscInt c = 0; c < nchunks; c++) {
+      const PetscInt rstart = (c * m) / nchunks, rend = ((c + 1) * m) / nchunks;
+
+      for (PetscInt i = rstart; i < rend; i++) {
+        const PetscInt dst = cstart[c] + newai[i] - newai[rstart];
+
+        if (dst == ai[i]) continue;
+        memmove(aj + dst, aj + ai[i], ailen[i] * sizeof(PetscInt));
+        if (aa) memmove(aa + dst, aa + ai[i], ailen[i] * sizeof(MatScalar));
+      }
+    }
+    for (PetscInt c = 1; c < nchunks; c++) {
+      const PetscInt rstart = (c * m) / nchunks, rend = ((c + 1) * m) / nchunks;
+
+      if (cstart[c] == newai[rstart]) continue;
+      PetscCall(PetscArraymove(aj + newai[rstart], aj + cstart[c], newai[rend] - newai[rstart]));
+      if (aa) PetscCall(PetscArraymove(aa + newai[rstart], aa + cstart[c], newai[rend] - newai[rstart]));
+    }
+  }
+  PetscCall(PetscArraycpy(ai, newai, m + 1));
+  PetscCall(PetscFree2(newai, cstart));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
 PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A, MatAssemblyType mode)
 {
   Mat_SeqAIJ *a      = (Mat_SeqAIJ *)A->data;
-  PetscInt    fshift = 0, i, *ai = a->i, *aj = a->j, *imax = a->imax;
-  PetscInt    m = A->rmap->n, *ip, N, *ailen = a->ilen, rmax = 0, n;
-  MatScalar  *aa    = a->a, *ap;
+  PetscInt    fshift = 0, *ai = a->i, *imax = a->imax;
+  PetscInt    m = A->rmap->n, *ailen = a->ilen, rmax = 0, n, nonzerorowcnt = 0, ndiagmissing = 0;
   PetscReal   ratio = 0.6;
 
   PetscFunctionBegin;
+  if (a->threadsafe) {
+    PetscCall(MatSeqXAIJThreadSafeMerge_Private(A, a->threadsafe, MatSetValues_SeqAIJ));
+    ai = a->i; /* the merge may have reallocated the matrix */
+  }
   if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(PETSC_SUCCESS);
   PetscCall(MatSeqAIJInvalidateDiagonal(A));
   if (A->was_assembled && A->ass_nonzerostate == A->nonzerostate) {
@@ -1108,46 +1395,27 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A, MatAssemblyType mode)
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
-  if (m) rmax = ailen[0]; /* determine row with most nonzeros */
-  for (i = 1; i < m; i++) {
-    /* move each row back by the amount of empty slots (fshift) before it*/
-    fshift += imax[i - 1] - ailen[i - 1];
-    rmax = PetscMax(rmax, ailen[i]);
-    if (fshift) {
-      ip = aj + ai[i];
-      ap = aa + ai[i];
-      N  = ailen[i];
-      PetscCall(PetscArraymove(ip - fshift, ip, N));
-      if (!A->structure_only) PetscCall(PetscArraymove(ap - fshift, ap, N));
-    }
-    ai[i] = ai[i - 1] + ailen[i - 1];
-  }
-  if (m) {
-    fshift += imax[m - 1] - ailen[m - 1];
-    ai[m] = ai[m - 1] + ailen[m - 1];
-  }
+  /* move each row back by the amount of empty slots (fshift) before it and determine the row with most nonzeros */
+  PetscCall(MatSeqAIJCompactRows_Private(A, &fshift, &rmax));
   /* reset ilen and imax for each row */
-  a->nonzerorowcnt = 0;
   if (A->structure_only) {
     PetscCall(PetscFree(a->imax));
     PetscCall(PetscFree(a->ilen));
   } else { /* !A->structure_only */
-    for (i = 0; i < m; i++) {
+    PetscPragmaUseOMPKernels(parallel for reduction(+:nonzerorowcnt))
+    for (PetscInt i = 0; i < m; i++) {
       ailen[i] = imax[i] = ai[i + 1] - ai[i];
-      a->nonzerorowcnt += ((ai[i + 1] - ai[i]) > 0);
+      nonzerorowcnt += ((ai[i + 1] - ai[i]) > 0);
     }
   }
-  a->nz = ai[m];
+  a->nonzerorowcnt = nonzerorowcnt;
+  a->nz            = ai[m];
   PetscCheck(!fshift || a->nounused != -1, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Unused space detected in matrix: %" PetscInt_FMT " X %" PetscInt_FMT ", %" PetscInt_FMT " unneeded", m, A->cmap->n, fshift);
   PetscCall(MatMarkDiagonal_SeqAIJ(A)); // since diagonal info is used a lot, it is helpful to set them up at the end of assembly
-  a->diagonaldense = PETSC_TRUE;
-  n                = PetscMin(A->rmap->n, A->cmap->n);
-  for (i = 0; i < n; i++) {
-    if (a->diag[i] >= ai[i + 1]) {
-      a->diagonaldense = PETSC_FALSE;
-      break;
-    }
-  }
+  n = PetscMin(A->rmap->n, A->cmap->n);
+  PetscPragmaUseOMPKernels(parallel for reduction(+:ndiagmissing))
+  for (PetscInt i = 0; i < n; i++) ndiagmissing += (a->diag[i] >= ai[i + 1]);
+  a->diagonaldense = (PetscBool)!ndiagmissing;
   PetscCall(PetscInfo(A, "Matrix size: %" PetscInt_FMT " X %" PetscInt_FMT "; storage space: %" PetscInt_FMT " unneeded,%" PetscInt_FMT " used\n", m, A->cmap->n, fshift, a->nz));
   PetscCall(PetscInfo(A, "Number of mallocs during MatSetValues() is %" PetscInt_FMT "\n", a->reallocs));
   PetscCall(PetscInfo(A, "Maximum nonzeros in any row is %" PetscInt_FMT "\n", rmax));
@@ -1226,6 +1494,7 @@ static PetscErrorCode MatReset_SeqAIJ(Mat A)
   PetscCall(PetscFree(a->ipre));
   PetscCall(PetscFree3(a->idiag, a->mdiag, a->ssor_work));
   PetscCall(PetscFree(a->solve_work));
+  PetscCall(MatSeqAIJSolveLevelsDestroy_Private(&a->solvelevels));
   PetscCall(ISDestroy(&a->icol));
   PetscCall(PetscFree(a->saved_values));
   PetscCall(PetscFree2(a->compressedrow.i, a->compressedrow.rindex));
@@ -1247,6 +1516,7 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
 {
   PetscFunctionBegin;
   PetscCall(MatReset_SeqAIJ(A));
+  PetscCall(MatSeqXAIJThreadSafeDestroy_Private(&((Mat_SeqAIJ *)A->data)->threadsafe));
   PetscCall(PetscFree(A->data));
 
   /* MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted may allocate this.
@@ -1266,6 +1536,9 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqbaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijperm_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijsell_C", NULL));
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijsingle_C", NULL));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijmkl_C", NULL));
 #endif
@@ -1313,6 +1586,7 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   /* these calls do not belong here: the subclasses Duplicate/Destroy are wrong */
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsell_seqaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijperm_seqaij_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsingle_seqaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijviennacl_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatProductSetFromOptions_seqaijviennacl_seqdense_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatProductSetFromOptions_seqaijviennacl_seqaij_C", NULL));
@@ -1359,6 +1633,9 @@ PetscErrorCode MatSetOption_SeqAIJ(Mat A, MatOption op, PetscBool flg)
   case MAT_FORM_EXPLICIT_TRANSPOSE:
     A->form_explicit_transpose = flg;
     break;
+  case MAT_THREAD_SAFE_SET_VALUES:
+    PetscCall(MatSetThreadSafe_SeqAIJ(A, flg));
+    break;
   default:
     break;
   }
@@ -1419,6 +1696,11 @@ PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A, Vec xx, Vec zz, Vec yy)
 
   PetscFunctionBegin;
   if (zz != yy) PetscCall(VecCopy(zz, yy));
+  PetscCall(MatSeqAIJLogBytes_Private(A, A->rmap->n + 2.0 * A->cmap->n));
+  if (a->simd != MAT_SEQAIJ_SIMD_NONE) {
+    PetscCall(MatMultTransposeAdd_SeqAIJ_SIMD(A, xx, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArray(yy, &y));
   PetscCall(MatSeqAIJGetArrayRead(A, &aa));
@@ -1477,10 +1759,15 @@ PetscErrorCode MatMult_SeqAIJ(Mat A, Vec xx, Vec yy)
 #endif
 
   PetscFunctionBegin;
-  if (a->inode.use && a->inode.checked) {
+  PetscCall(MatSeqAIJLogBytes_Private(A, A->cmap->n + A->rmap->n));
+  if (a->inode.use && a->inode.checked && !a->simdforced) {
     PetscCall(MatMult_SeqAIJ_Inode(A, xx, yy));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
+  if (a->simd != MAT_SEQAIJ_SIMD_NONE) {
+    PetscCall(MatMultAdd_SeqAIJ_SIMD(A, xx, NULL, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(MatSeqAIJGetArrayRead(A, &a_a));
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArray(yy, &y));
@@ -1635,10 +1922,15 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A, Vec xx, Vec yy, Vec zz)
   PetscBool          usecprow = a->compressedrow.use;
 
   PetscFunctionBegin;
-  if (a->inode.use && a->inode.checked) {
+  PetscCall(MatSeqAIJLogBytes_Private(A, A->cmap->n + 2.0 * A->rmap->n));
+  if (a->inode.use && a->inode.checked && !a->simdforced) {
     PetscCall(MatMultAdd_SeqAIJ_Inode(A, xx, yy, zz));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
+  if (a->simd != MAT_SEQAIJ_SIMD_NONE) {
+    PetscCall(MatMultAdd_SeqAIJ_SIMD(A, xx, yy, zz));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(MatSeqAIJGetArrayRead(A, &a_a));
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArrayPair(yy, zz, &y, &z));
@@ -1684,7 +1976,7 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A, Vec xx, Vec yy, Vec zz)
 PetscErrorCode MatMarkDiagonal_SeqAIJ(Mat A)
 {
   Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
-  PetscInt    i, j, m = A->rmap->n;
+  PetscInt    m = A->rmap->n;
   PetscBool   alreadySet = PETSC_TRUE;
 
   PetscFunctionBegin;
@@ -1692,7 +1984,8 @@ PetscErrorCode MatMarkDiagonal_SeqAIJ(Mat A)
     PetscCall(PetscMalloc1(m, &a->diag));
     alreadySet = PETSC_FALSE;
   }
-  for (i = 0; i < A->rmap->n; i++) {
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt i = 0; i < m; i++) {
     /* If A's diagonal is already correctly set, this fast track enables cheap and repeated MatMarkDiagonal_SeqAIJ() calls */
     if (alreadySet) {
       PetscInt pos = a->diag[i];
@@ -1700,7 +1993,7 @@ PetscErrorCode MatMarkDiagonal_SeqAIJ(Mat A)
     }
 
     a->diag[i] = a->i[i + 1];
-    for (j = a->i[i]; j < a->i[i + 1]; j++) {
+    for (PetscInt j = a->i[i]; j < a->i[i + 1]; j++) {
       if (a->j[j] == i) {
         a->diag[i] = j;
         break;
@@ -1878,7 +2171,7 @@ static PetscErrorCode MatInvertVariableBlockDiagonal_SeqAIJ(Mat A, PetscInt nblo
 /*
    Negative shift indicates do not generate an error if there is a zero diagonal, just invert it anyways
 */
-static PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat A, PetscScalar omega, PetscScalar fshift)
+PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat A, PetscScalar omega, PetscScalar fshift)
 {
   Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data;
   PetscInt         i, *diag, m = A->rmap->n;
@@ -4315,8 +4608,14 @@ PetscErrorCode MatMatMultSymbolic_SeqDense_SeqAIJ(Mat A, Mat B, PetscReal fill,
    MATSEQAIJ - MATSEQAIJ = "seqaij" - A matrix type to be used for sequential sparse matrices,
    based on compressed sparse row format.
 
-   Options Database Key:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+   Options Database Keys:
++ -mat_type seqaij                         - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+. -mat_seqaij_simd <none,auto,avx2,avx512> - use gather-based SIMD kernels for `MatMult()`, `MatMultAdd()` and `MatMultTranspose()`,
+                                             selected at runtime from the instruction sets supported by the CPU (default none)
+. -mat_seqaij_solve_levels                 - for the `MATSOLVERPETSC` LU and ILU factors, solve the triangular systems in `MatSolve()` by levels,
+                                             the independent rows (or I-nodes) of a level are solved with OpenMP threads (default false)
+- -mat_seqaij_factor_levels                - compute the `MATSOLVERPETSC` LU and ILU numeric factorizations by the same levels, the rows (or I-nodes)
+                                             of a level are factored with OpenMP threads, instead of the I-node factorization (default false)
 
    Level: beginner
 
@@ -4328,6 +4627,20 @@ PetscErrorCode MatMatMultSymbolic_SeqDense_SeqAIJ(Mat A, Mat B, PetscReal fill,
     `MatSetOptions`(,`MAT_STRUCTURE_ONLY`,`PETSC_TRUE`) may be called for this matrix type. In this no
     space is allocated for the nonzero entries and any entries passed with `MatSetValues()` are ignored
 
+    With `-mat_seqaij_simd auto` the I-node kernels are still used for matrices with I-nodes, naming the instruction
+    set explicitly uses the SIMD kernels for all matrices. The kernel in use is shown by `MatView()` with `PETSC_VIEWER_ASCII_INFO`
+    and its time appears under the MatMultAVX2 or MatMultAVX512 event of `-log_view`.
+
+    The levels of `-mat_seqaij_solve_levels` and `-mat_seqaij_factor_levels` depend only on the nonzero structure of the factor,
+    they are computed at the first `MatLUFactorNumeric()` after each symbolic factorization and reused by the later ones. The
+    options are read with the options prefix of the factored matrix, for example `-sub_mat_seqaij_solve_levels` for the blocks
+    of `PCBJACOBI`. Threads are only used when PETSc is configured with `--with-openmp-kernels`.
+
+    The factorization by levels replaces the I-node numeric factorization: the rows of an I-node are factored one after the
+    other by the same thread, without the I-node kernels; it is not a supernodal factorization with dense blocks. It does not
+    handle the shifts of `MatFactorShiftType` or zero pivots, in these cases the factorization is computed without levels, which
+    is reported with `-info`.
+
   Developer Note:
     It would be nice if all matrix formats supported passing `NULL` in for the numerical values
 
@@ -4349,7 +4662,7 @@ M*/
   Level: beginner
 
    Note:
-   Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJMKL`, `MATAIJCRL`, and also automatically switches over to use inodes when
+   Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJSINGLE`, `MATAIJMKL`, `MATAIJCRL`, and also automatically switches over to use inodes when
    enough exist.
 
 .seealso: [](ch_matrices), `Mat`, `MatCreateAIJ()`, `MatCreateSeqAIJ()`, `MATSEQAIJ`, `MATMPIAIJ`, `MATSELL`, `MATSEQSELL`, `MATMPISELL`
@@ -4903,6 +5216,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqbaij_C", MatConvert_SeqAIJ_SeqBAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijperm_C", MatConvert_SeqAIJ_SeqAIJPERM));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijsell_C", MatConvert_SeqAIJ_SeqAIJSELL));
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijsingle_C", MatConvert_SeqAIJ_SeqAIJSingle));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijmkl_C", MatConvert_SeqAIJ_SeqAIJMKL));
 #endif
@@ -4947,6 +5263,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetPreallocationCOO_C", MatSetPreallocationCOO_SeqAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetValuesCOO_C", MatSetValuesCOO_SeqAIJ));
   PetscCall(MatCreate_SeqAIJ_Inode(B));
+  PetscCall(MatCreate_SeqAIJ_SIMD(B));
   PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
   PetscCall(MatSeqAIJSetTypeFromOptions(B)); /* this allows changing the matrix subtype to say MATSEQAIJPERM */
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -5022,6 +5339,8 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C, Mat A, MatDuplicateOption cpva
     c->idiag              = NULL;
     c->ssor_work          = NULL;
     c->keepnonzeropattern = a->keepnonzeropattern;
+    c->simd               = a->simd;
+    c->simdforced         = a->simdforced;
 
     c->rmax  = a->rmax;
     c->nz    = a->nz;
@@ -5554,6 +5873,9 @@ PetscErrorCode MatSeqAIJRegisterAll(void)
   PetscCall(MatSeqAIJRegister(MATSEQAIJCRL, MatConvert_SeqAIJ_SeqAIJCRL));
   PetscCall(MatSeqAIJRegister(MATSEQAIJPERM, MatConvert_SeqAIJ_SeqAIJPERM));
   PetscCall(MatSeqAIJRegister(MATSEQAIJSELL, MatConvert_SeqAIJ_SeqAIJSELL));
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(MatSeqAIJRegister(MATSEQAIJSINGLE, MatConvert_SeqAIJ_SeqAIJSingle));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(MatSeqAIJRegister(MATSEQAIJMKL, MatConvert_SeqAIJ_SeqAIJMKL));
 #endif
@@ -145,11 +145,106 @@ PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat, Mat, const MatF
 PETSC_INTERN PetscErrorCode MatSeqAIJGetArray_SeqAIJ(Mat, PetscScalar **);
 PETSC_INTERN PetscErrorCode MatSeqAIJRestoreArray_SeqAIJ(Mat, PetscScalar **);
 
+/* SIMD instruction set used by the MatMult() family of kernels of SeqAIJ, selected at runtime with -mat_seqaij_simd */
+typedef enum {
+  MAT_SEQAIJ_SIMD_NONE,
+  MAT_SEQAIJ_SIMD_AVX2,
+  MAT_SEQAIJ_SIMD_AVX512
+} MatSeqAIJSIMDType;
+PETSC_INTERN const char *const MatSeqAIJSIMDTypes[];
+
+/* the SIMD kernels are compiled with function level target attributes, so the build flags need not enable AVX */
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__x86_64__) && defined(__GNUC__) && !defined(__NVCOMPILER) && !defined(__PGI) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
+  #define PETSC_SEQAIJ_SIMD_DISPATCH
+#endif
+
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_SIMD(Mat);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_SIMD(Mat, PetscViewer);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_SIMD(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ_SIMD(Mat, Vec, Vec);
+
+/* MatSetValues() with MAT_THREAD_SAFE_SET_VALUES, shared by SeqAIJ and SeqBAIJ. Entries that are not in the nonzero
+   structure are collected in one hash table per thread and merged into the matrix during MatAssemblyEnd() */
+typedef struct {
+  PetscInt       n;    /* number of hash tables */
+  PetscHMapIJV  *ht;   /* point entries not yet in the nonzero structure */
+  PetscSpinlock *lock; /* guards ht[] when there are more threads than hash tables */
+} Mat_SeqXAIJThreadSafe;
+
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeCreate_Private(Mat_SeqXAIJThreadSafe **);
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeDestroy_Private(Mat_SeqXAIJThreadSafe **);
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeAdd_Private(Mat_SeqXAIJThreadSafe *, PetscInt *, PetscInt, PetscInt, PetscScalar, InsertMode);
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeRelease_Private(Mat_SeqXAIJThreadSafe *, PetscInt);
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeSetValues_Private(Mat_SeqXAIJThreadSafe *, PetscBool, PetscInt, const PetscInt[], PetscInt, const PetscInt[], const PetscScalar[], InsertMode);
+PETSC_INTERN PetscErrorCode MatSeqXAIJThreadSafeMerge_Private(Mat, Mat_SeqXAIJThreadSafe *, PetscErrorCode (*)(Mat, PetscInt, const PetscInt[], PetscInt, const PetscInt[], const PetscScalar[], InsertMode));
+
+/* concurrent MatSetValues() needs a thread safe PETSc and one of the atomic additions of MatSeqXAIJAtomicAdd_Private() */
+#if defined(PETSC_HAVE_THREADSAFETY) && (defined(_OPENMP) || (defined(__GNUC__) && !defined(PETSC_USE_REAL___FLOAT128)))
+  #define PETSC_HAVE_MATSEQXAIJ_THREADSAFE 1
+#endif
+
+/* adds v to *a such that concurrent additions to the same entry from several threads are not lost */
+static inline void MatSeqXAIJAtomicAdd_Private(MatScalar *a, PetscScalar v)
+{
+  PetscReal *r = (PetscReal *)a;
+#if defined(PETSC_USE_COMPLEX)
+  const PetscReal w[2] = {PetscRealPart(v), PetscImaginaryPart(v)};
+#else
+  const PetscReal w[1] = {v};
+#endif
+
+  for (size_t k = 0; k < PETSC_STATIC_ARRAY_LENGTH(w); k++) {
+#if defined(_OPENMP)
+    PetscPragmaOMP(atomic update)
+    r[k] += w[k];
+#elif defined(PETSC_HAVE_THREADSAFETY) && defined(__GNUC__) && !defined(PETSC_USE_REAL___FLOAT128)
+    PetscReal old = r[k], sum;
+
+    do {
+      sum = old + w[k];
+    } while (!__atomic_compare_exchange(r + k, &old, &sum, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+    r[k] += w[k];
+#endif
+  }
+}
+
+/* level scheduling of the triangular solves, and of the numeric factorization, with a SeqAIJ LU or ILU factor. The units are the rows
+   of the factor, or its I-nodes, and the units in one level of L (or of U) only depend on units of earlier levels, so they can be
+   solved, or factored, concurrently */
+typedef struct {
+  PetscBool inodes;      /* the units are the I-nodes of the factor */
+  PetscInt  nlevels[2];  /* number of levels of L and U */
+  PetscInt *levelptr[2]; /* the units of level k are units[levelptr[k]], ..., units[levelptr[k+1]-1] */
+  PetscInt *units[2];    /* units ordered by level */
+} Mat_SeqAIJSolveLevels;
+
+PETSC_INTERN PetscErrorCode MatSeqAIJFactorSetSolveLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJFactorSetNumericLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJSolveLevelsDestroy_Private(Mat_SeqAIJSolveLevels **);
+
+/* single precision values of a SeqAIJ LU or ILU factor, composed with the factor as "MatSeqAIJSingleFactor" and used by MatSolve_SeqAIJSingle().
+   They are computed by the factorization with -pc_factor_mat_single_precision, or copied from the factor of a MATSEQAIJSINGLE matrix */
+typedef struct {
+  float    *a;       /* values of the factor, in the layout of the values of the factor */
+  PetscInt  nz;      /* allocated length of a */
+  PetscBool natural; /* the row and column orderings are the identity */
+  PetscErrorCode (*lufactornumeric)(Mat, Mat, const MatFactorInfo *);
+} Mat_SeqAIJSingleFactor;
+
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleFactorGet_Private(Mat, Mat_SeqAIJSingleFactor **);
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleFactorGetArray_Private(Mat, float **);
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJSingle(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatSolveTranspose_SeqAIJSingle(Mat, Vec, Vec);
+
 typedef struct {
   SEQAIJHEADER(MatScalar);
   Mat_SeqAIJ_Inode inode;
   MatScalar       *saved_values; /* location for stashing nonzero values of matrix */
 
+  MatSeqAIJSIMDType simd;       /* SIMD kernels used by MatMult(), MatMultAdd() and MatMultTranspose() */
+  PetscBool         simdforced; /* the SIMD kernels were explicitly requested and take precedence over the I-node kernels */
+
   PetscScalar *idiag, *mdiag, *ssor_work; /* inverse of diagonal entries, diagonal values and workspace for Eisenstat trick */
   PetscBool    idiagvalid;                /* current idiag[] and mdiag[] are valid */
   PetscScalar *ibdiag;                    /* inverses of block diagonals */
@@ -158,9 +253,11 @@ typedef struct {
   PetscScalar  fshift, omega;             /* last used omega and fshift */
 
   /* MatSetValues() via hash related fields */
-  PetscHMapIJV   ht;
-  PetscInt      *dnz;
-  struct _MatOps cops;
+  PetscHMapIJV           ht;
+  PetscInt              *dnz;
+  struct _MatOps         cops;
+  Mat_SeqXAIJThreadSafe *threadsafe;  /* set with MAT_THREAD_SAFE_SET_VALUES */
+  Mat_SeqAIJSolveLevels *solvelevels; /* level scheduled MatSolve() of a factor, see -mat_seqaij_solve_levels */
 } Mat_SeqAIJ;
 
 typedef struct {
@@ -225,6 +322,17 @@ static inline PetscErrorCode MatSeqXAIJFreeAIJ(Mat AA, MatScalar **a, PetscInt *
   if (A->free_ij) PetscCall(PetscShmgetDeallocateArray((void **)i));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+/*
+  Logs the memory traffic of a product or a triangular solve with a SeqAIJ matrix: the values, column indices, and row offsets
+  are read once and nvec vector entries are read or written
+*/
+static inline PetscErrorCode MatSeqAIJLogBytes_Private(Mat A, PetscLogDouble nvec)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  return PetscLogBytes(a->nz * (sizeof(MatScalar) + sizeof(PetscInt)) + (A->rmap->n + 1.0) * sizeof(PetscInt) + nvec * sizeof(PetscScalar));
+}
 /*
     Allocates larger a, i, and j arrays for the XAIJ (AIJ, BAIJ, and SBAIJ) matrix types
     This is a macro because it takes the datatype as an argument which can be either a Mat or a MatScalar
@@ -326,6 +434,7 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat, Vec, PetscReal, MatSORType, PetscReal, PetscInt, PetscInt, Vec);
+PETSC_INTERN PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat, PetscScalar, PetscScalar);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Inode(Mat, Vec, PetscReal, MatSORType, PetscReal, PetscInt, PetscInt, Vec);
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat, MatOption, PetscBool);
@@ -453,6 +562,7 @@ PETSC_INTERN PetscErrorCode MatConvert_AIJ_ScaLAPACK(Mat, MatType, MatReuse, Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat, MatType, MatReuse, Mat *);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat, PetscReal, IS, IS);
@@ -2,6 +2,9 @@
 #include <../src/mat/impls/sbaij/seq/sbaij.h>
 #include <petscbt.h>
 #include <../src/mat/utils/freespace.h>
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  #include <omp.h>
+#endif
 
 /*
       Computes an ordering to get most of the large numerical values in the lower triangular part of the matrix
@@ -285,6 +288,29 @@ static PetscErrorCode MatLUFactorSymbolic_SeqAIJ_inplace(Mat B, Mat A, IS isrow,
 }
 #endif
 
+static PetscErrorCode MatSeqAIJFactorSetSinglePrecision_Private(Mat, const MatFactorInfo *);
+
+/* frees the structure of a previous symbolic factorization into B, its I-nodes are checked again */
+static PetscErrorCode MatSeqAIJFactorResetStructure_Private(Mat B)
+{
+  Mat_SeqAIJ *b = (Mat_SeqAIJ *)B->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqXAIJFreeAIJ(B, &b->a, &b->j, &b->i));
+  PetscCall(PetscFree(b->diag));
+  PetscCall(PetscFree(b->imax));
+  PetscCall(PetscFree(b->ilen));
+  PetscCall(PetscFree(b->solve_work));
+  PetscCall(ISDestroy(&b->row));
+  PetscCall(ISDestroy(&b->col));
+  PetscCall(ISDestroy(&b->icol));
+  PetscCall(MatSeqAIJSolveLevelsDestroy_Private(&b->solvelevels));
+  PetscCall(PetscFree(b->inode.size_csr));
+  b->inode.node_count = 0;
+  b->inode.checked    = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B, Mat A, IS isrow, IS iscol, const MatFactorInfo *info)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data, *b;
@@ -303,6 +329,8 @@ PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B, Mat A, IS isrow, IS iscol, cons
   PetscCheck(A->rmap->N == A->cmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "matrix must be square");
   PetscCall(MatMissingDiagonal(A, &missing, &i));
   PetscCheck(!missing, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Matrix is missing diagonal entry %" PetscInt_FMT, i);
+  /* the I-nodes and solve levels of a previous symbolic factorization may be for another nonzero structure */
+  PetscCall(MatSeqAIJFactorResetStructure_Private(B));
 
   PetscCall(ISInvertPermutation(iscol, PETSC_DECIDE, &isicol));
   PetscCall(ISGetIndices(isrow, &r));
@@ -425,6 +453,8 @@ PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B, Mat A, IS isrow, IS iscol, cons
   B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ;
   if (a->inode.size_csr) B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   PetscCall(MatSeqAIJCheckInode_FactorLU(B));
+  PetscCall(MatSeqAIJFactorSetNumericLevels_Private(B));
+  PetscCall(MatSeqAIJFactorSetSinglePrecision_Private(B, info));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -449,178 +479,402 @@ PetscErrorCode MatFactorDumpMatrix(Mat A)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B, Mat A, const MatFactorInfo *info)
+/* the solves of a factor computed by MatLUFactorNumeric_SeqAIJ() or MatLUFactorNumeric_SeqAIJ_Levels() */
+static PetscErrorCode MatLUFactorNumericSetOps_SeqAIJ_Private(Mat C)
 {
-  Mat              C = B;
-  Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)C->data;
-  IS               isrow = b->row, isicol = b->icol;
-  const PetscInt  *r, *ic, *ics;
-  const PetscInt   n = A->rmap->n, *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j, *bdiag = b->diag;
-  PetscInt         i, j, k, nz, nzL, row, *pj;
-  const PetscInt  *ajtmp, *bjtmp;
-  MatScalar       *rtmp, *pc, multiplier, *pv;
-  const MatScalar *aa, *v;
-  MatScalar       *ba;
-  PetscBool        row_identity, col_identity;
-  FactorShiftCtx   sctx;
-  const PetscInt  *ddiag;
-  PetscReal        rs;
-  MatScalar        d;
+  Mat_SeqAIJ *b = (Mat_SeqAIJ *)C->data;
+  PetscBool   row_identity, col_identity;
 
   PetscFunctionBegin;
-  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
-  PetscCall(MatSeqAIJGetArrayWrite(B, &ba));
-  /* MatPivotSetUp(): initialize shift context sctx */
-  PetscCall(PetscMemzero(&sctx, sizeof(FactorShiftCtx)));
+  PetscCall(ISIdentity(b->row, &row_identity));
+  PetscCall(ISIdentity(b->icol, &col_identity));
+  if (b->inode.size_csr) {
+    C->ops->solve = MatSolve_SeqAIJ_Inode;
+  } else if (row_identity && col_identity) {
+    C->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
+  } else {
+    C->ops->solve = MatSolve_SeqAIJ;
+  }
+  PetscCall(MatSeqAIJFactorSetSolveLevels_Private(C));
+  C->ops->solveadd          = MatSolveAdd_SeqAIJ;
+  C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
+  C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
+  C->ops->matsolve          = MatMatSolve_SeqAIJ;
+  C->ops->matsolvetranspose = MatMatSolveTranspose_SeqAIJ;
+  C->assembled              = PETSC_TRUE;
+  C->preallocated           = PETSC_TRUE;
 
-  if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) { /* set sctx.shift_top=max{rs} */
-    ddiag          = a->diag;
-    sctx.shift_top = info->zeropivot;
-    for (i = 0; i < n; i++) {
-      /* calculate sum(|aij|)-RealPart(aii), amt of shift needed for this row */
-      d  = (aa)[ddiag[i]];
-      rs = -PetscAbsScalar(d) - PetscRealPart(d);
-      v  = aa + ai[i];
-      nz = ai[i + 1] - ai[i];
-      for (j = 0; j < nz; j++) rs += PetscAbsScalar(v[j]);
-      if (rs > sctx.shift_top) sctx.shift_top = rs;
+  PetscCall(PetscLogFlops(C->cmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* defines MatLUFactorNumericKernel_SeqAIJ() and MatLUFactorNumericKernel_SeqAIJSingle() */
+#define TYPE         SeqAIJ
+#define TYPE_SCALAR  MatScalar
+#define TYPE_FROM(v) (v)
+#define TYPE_ABS(v)  PetscAbsScalar(v)
+#include "../src/mat/impls/aij/seq/aijfactnumeric.h"
+#undef TYPE
+#undef TYPE_SCALAR
+#undef TYPE_FROM
+#undef TYPE_ABS
+#define TYPE         SeqAIJSingle
+#define TYPE_SCALAR  float
+#define TYPE_FROM(v) ((float)PetscRealPart(v))
+#define TYPE_ABS(v)  PetscAbsReal((PetscReal)(v))
+#include "../src/mat/impls/aij/seq/aijfactnumeric.h"
+#undef TYPE
+#undef TYPE_SCALAR
+#undef TYPE_FROM
+#undef TYPE_ABS
+
+/* MatShiftView(A,info,&sctx) */
+static PetscErrorCode MatLUFactorNumericShiftView_SeqAIJ_Private(Mat A, const MatFactorInfo *info, const FactorShiftCtx *sctx)
+{
+  PetscFunctionBegin;
+  if (sctx->nshift) {
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) {
+      PetscCall(PetscInfo(A, "number of shift_pd tries %" PetscInt_FMT ", shift_amount %g, diagonal shifted up by %e fraction top_value %e\n", sctx->nshift, (double)sctx->shift_amount, (double)sctx->shift_fraction, (double)sctx->shift_top));
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_NONZERO) {
+      PetscCall(PetscInfo(A, "number of shift_nz tries %" PetscInt_FMT ", shift_amount %g\n", sctx->nshift, (double)sctx->shift_amount));
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_INBLOCKS) {
+      PetscCall(PetscInfo(A, "number of shift_inblocks applied %" PetscInt_FMT ", each shift_amount %g\n", sctx->nshift, (double)info->shiftamount));
     }
-    sctx.shift_top *= 1.1;
-    sctx.nshift_max = 5;
-    sctx.shift_lo   = 0.;
-    sctx.shift_hi   = 1.;
   }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-  PetscCall(ISGetIndices(isrow, &r));
-  PetscCall(ISGetIndices(isicol, &ic));
-  PetscCall(PetscMalloc1(n + 1, &rtmp));
-  ics = ic;
+PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B, Mat A, const MatFactorInfo *info)
+{
+  MatScalar     *ba;
+  FactorShiftCtx sctx;
 
-  do {
-    sctx.newshift = PETSC_FALSE;
-    for (i = 0; i < n; i++) {
-      /* zero rtmp */
-      /* L part */
-      nz    = bi[i + 1] - bi[i];
-      bjtmp = bj + bi[i];
-      for (j = 0; j < nz; j++) rtmp[bjtmp[j]] = 0.0;
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJGetArrayWrite(B, &ba));
+  PetscCall(MatLUFactorNumericKernel_SeqAIJ(B, A, info, ba, &sctx));
+  PetscCall(MatSeqAIJRestoreArrayWrite(B, &ba));
+  PetscCall(MatLUFactorNumericSetOps_SeqAIJ_Private(B));
+  PetscCall(MatLUFactorNumericShiftView_SeqAIJ_Private(A, info, &sctx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-      /* U part */
-      nz    = bdiag[i] - bdiag[i + 1];
-      bjtmp = bj + bdiag[i + 1] + 1;
-      for (j = 0; j < nz; j++) rtmp[bjtmp[j]] = 0.0;
+static PetscErrorCode MatSeqAIJSingleFactorDestroy_Private(void **ptr)
+{
+  Mat_SeqAIJSingleFactor *fs = (Mat_SeqAIJSingleFactor *)*ptr;
 
-      /* load in initial (unfactored row) */
-      nz    = ai[r[i] + 1] - ai[r[i]];
-      ajtmp = aj + ai[r[i]];
-      v     = aa + ai[r[i]];
-      for (j = 0; j < nz; j++) rtmp[ics[ajtmp[j]]] = v[j];
-      /* ZeropivotApply() */
-      rtmp[i] += sctx.shift_amount; /* shift the diagonal of the matrix */
+  PetscFunctionBegin;
+  PetscCall(PetscFree(fs->a));
+  PetscCall(PetscFree(fs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-      /* elimination */
-      bjtmp = bj + bi[i];
-      row   = *bjtmp++;
-      nzL   = bi[i + 1] - bi[i];
-      for (k = 0; k < nzL; k++) {
-        pc = rtmp + row;
-        if (*pc != 0.0) {
-          pv         = ba + bdiag[row];
-          multiplier = *pc * (*pv);
-          *pc        = multiplier;
+/* gets the single precision values composed with the factor B, creating them if needed */
+PetscErrorCode MatSeqAIJSingleFactorGet_Private(Mat B, Mat_SeqAIJSingleFactor **fs)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscObjectContainerQuery((PetscObject)B, "MatSeqAIJSingleFactor", fs));
+  if (!*fs) {
+    PetscCall(PetscNew(fs));
+    PetscCall(PetscObjectContainerCompose((PetscObject)B, "MatSeqAIJSingleFactor", *fs, MatSeqAIJSingleFactorDestroy_Private));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-          pj = b->j + bdiag[row + 1] + 1; /* beginning of U(row,:) */
-          pv = ba + bdiag[row + 1] + 1;
-          nz = bdiag[row] - bdiag[row + 1] - 1; /* num of entries in U(row,:) excluding diag */
+/* gets an array for the single precision values of the factor B, of the length of the values of B, after its symbolic factorization */
+PetscErrorCode MatSeqAIJSingleFactorGetArray_Private(Mat B, float **a)
+{
+  Mat_SeqAIJ             *b = (Mat_SeqAIJ *)B->data;
+  Mat_SeqAIJSingleFactor *fs;
+  PetscBool               row_identity, col_identity;
+  PetscInt                nz;
 
-          for (j = 0; j < nz; j++) rtmp[pj[j]] -= multiplier * pv[j];
-          PetscCall(PetscLogFlops(1 + 2.0 * nz));
-        }
-        row = *bjtmp++;
-      }
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleFactorGet_Private(B, &fs));
+  /* the factor is stored as L by rows followed by U by rows in reverse order, ending with the diagonal of row 0 */
+  nz = B->rmap->n ? b->diag[0] + 1 : 0;
+  if (fs->nz < nz) {
+    PetscCall(PetscFree(fs->a));
+    PetscCall(PetscMalloc1(nz, &fs->a));
+    fs->nz = nz;
+  }
+  PetscCall(ISIdentity(b->row, &row_identity));
+  PetscCall(ISIdentity(b->col, &col_identity));
+  fs->natural = (PetscBool)(row_identity && col_identity);
+  *a          = fs->a;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-      /* finished row so stick it into b->a */
-      rs = 0.0;
-      /* L part */
-      pv = ba + bi[i];
-      pj = b->j + bi[i];
-      nz = bi[i + 1] - bi[i];
-      for (j = 0; j < nz; j++) {
-        pv[j] = rtmp[pj[j]];
-        rs += PetscAbsScalar(pv[j]);
-      }
+/* logs the memory traffic of a triangular solve with the single precision values of the factor, see MatSeqAIJLogBytes_Private() */
+static PetscErrorCode MatSeqAIJSingleFactorLogBytes_Private(Mat A, PetscLogDouble nvec)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
 
-      /* U part */
-      pv = ba + bdiag[i + 1] + 1;
-      pj = b->j + bdiag[i + 1] + 1;
-      nz = bdiag[i] - bdiag[i + 1] - 1;
-      for (j = 0; j < nz; j++) {
-        pv[j] = rtmp[pj[j]];
-        rs += PetscAbsScalar(pv[j]);
-      }
+  PetscFunctionBegin;
+  PetscCall(PetscLogBytes(a->nz * (sizeof(float) + sizeof(PetscInt)) + (A->rmap->n + 1.0) * sizeof(PetscInt) + nvec * sizeof(PetscScalar)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-      sctx.rs = rs;
-      sctx.pv = rtmp[i];
-      PetscCall(MatPivotCheck(B, A, info, &sctx, i));
-      if (sctx.newshift) break; /* break for-loop */
-      rtmp[i] = sctx.pv;        /* sctx.pv might be updated in the case of MAT_SHIFT_INBLOCKS */
+/*
+   Triangular solves with the single precision values fa of the factor, see MatSeqAIJSingleFactorGetArray_Private(): the values are read
+   in single precision and the solution is accumulated in PetscScalar. x = y + inv(A) b, or x = inv(A) b if y is NULL, the permutations
+   r and c are NULL for the natural ordering
+*/
+static PetscErrorCode MatSolveKernel_SeqAIJSingle(Mat A, const float *fa, const PetscInt *r, const PetscInt *c, const PetscScalar *b, const PetscScalar *y, PetscScalar *x)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  PetscInt        i, n = A->rmap->n, nz;
+  const PetscInt *ai = a->i, *aj = a->j, *adiag = a->diag, *vi;
+  PetscScalar    *tmp = (r || y) ? a->solve_work : x, sum;
+  const float    *v;
 
-      /* Mark diagonal and invert diagonal for simpler triangular solves */
-      pv  = ba + bdiag[i];
-      *pv = 1.0 / rtmp[i];
+  PetscFunctionBegin;
+  /* forward solve the lower triangular */
+  v  = fa;
+  vi = aj;
+  for (i = 0; i < n; i++) {
+    nz  = ai[i + 1] - ai[i];
+    sum = b[r ? r[i] : i];
+    for (PetscInt k = 0; k < nz; k++) sum -= (PetscScalar)v[k] * tmp[vi[k]];
+    tmp[i] = sum;
+    v += nz;
+    vi += nz;
+  }
 
-    } /* endof for (i=0; i<n; i++) { */
+  /* backward solve the upper triangular */
+  for (i = n - 1; i >= 0; i--) {
+    v   = fa + adiag[i + 1] + 1;
+    vi  = aj + adiag[i + 1] + 1;
+    nz  = adiag[i] - adiag[i + 1] - 1;
+    sum = tmp[i];
+    for (PetscInt k = 0; k < nz; k++) sum -= (PetscScalar)v[k] * tmp[vi[k]];
+    tmp[i] = sum * (PetscScalar)v[nz]; /* v[nz] = fa[adiag[i]] */
+    if (tmp != x) {
+      const PetscInt ci = c ? c[i] : i;
 
-    /* MatPivotRefine() */
-    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE && !sctx.newshift && sctx.shift_fraction > 0 && sctx.nshift < sctx.nshift_max) {
-      /*
-       * if no shift in this attempt & shifting & started shifting & can refine,
-       * then try lower shift
-       */
-      sctx.shift_hi       = sctx.shift_fraction;
-      sctx.shift_fraction = (sctx.shift_hi + sctx.shift_lo) / 2.;
-      sctx.shift_amount   = sctx.shift_fraction * sctx.shift_top;
-      sctx.newshift       = PETSC_TRUE;
-      sctx.nshift++;
+      x[ci] = y ? y[ci] + tmp[i] : tmp[i];
     }
-  } while (sctx.newshift);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
-  PetscCall(MatSeqAIJRestoreArrayWrite(B, &ba));
+/* x = y + inv(A^T) b, or x = inv(A^T) b if y is NULL */
+static PetscErrorCode MatSolveTransposeKernel_SeqAIJSingle(Mat A, const float *fa, const PetscInt *r, const PetscInt *c, const PetscScalar *b, const PetscScalar *y, PetscScalar *x)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  PetscInt        i, n = A->rmap->n, nz;
+  const PetscInt *ai = a->i, *aj = a->j, *adiag = a->diag, *vi;
+  PetscScalar    *tmp = a->solve_work, s1;
+  const float    *v;
 
-  PetscCall(PetscFree(rtmp));
-  PetscCall(ISRestoreIndices(isicol, &ic));
-  PetscCall(ISRestoreIndices(isrow, &r));
+  PetscFunctionBegin;
+  /* copy the b into temp work space according to permutation */
+  for (i = 0; i < n; i++) tmp[i] = b[c[i]];
 
-  PetscCall(ISIdentity(isrow, &row_identity));
-  PetscCall(ISIdentity(isicol, &col_identity));
-  if (b->inode.size_csr) {
-    C->ops->solve = MatSolve_SeqAIJ_Inode;
-  } else if (row_identity && col_identity) {
-    C->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
-  } else {
-    C->ops->solve = MatSolve_SeqAIJ;
+  /* forward solve the U^T */
+  for (i = 0; i < n; i++) {
+    v  = fa + adiag[i + 1] + 1;
+    vi = aj + adiag[i + 1] + 1;
+    nz = adiag[i] - adiag[i + 1] - 1;
+    s1 = tmp[i] * (PetscScalar)v[nz]; /* multiply by inverse of diagonal entry */
+    for (PetscInt k = 0; k < nz; k++) tmp[vi[k]] -= s1 * (PetscScalar)v[k];
+    tmp[i] = s1;
   }
-  C->ops->solveadd          = MatSolveAdd_SeqAIJ;
-  C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
-  C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
-  C->ops->matsolve          = MatMatSolve_SeqAIJ;
-  C->ops->matsolvetranspose = MatMatSolveTranspose_SeqAIJ;
-  C->assembled              = PETSC_TRUE;
-  C->preallocated           = PETSC_TRUE;
 
-  PetscCall(PetscLogFlops(C->cmap->n));
+  /* backward solve the L^T */
+  for (i = n - 1; i >= 0; i--) {
+    v  = fa + ai[i];
+    vi = aj + ai[i];
+    nz = ai[i + 1] - ai[i];
+    s1 = tmp[i];
+    for (PetscInt k = 0; k < nz; k++) tmp[vi[k]] -= s1 * (PetscScalar)v[k];
+  }
 
-  /* MatShiftView(A,info,&sctx) */
-  if (sctx.nshift) {
-    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) {
-      PetscCall(PetscInfo(A, "number of shift_pd tries %" PetscInt_FMT ", shift_amount %g, diagonal shifted up by %e fraction top_value %e\n", sctx.nshift, (double)sctx.shift_amount, (double)sctx.shift_fraction, (double)sctx.shift_top));
-    } else if (info->shifttype == (PetscReal)MAT_SHIFT_NONZERO) {
-      PetscCall(PetscInfo(A, "number of shift_nz tries %" PetscInt_FMT ", shift_amount %g\n", sctx.nshift, (double)sctx.shift_amount));
-    } else if (info->shifttype == (PetscReal)MAT_SHIFT_INBLOCKS) {
-      PetscCall(PetscInfo(A, "number of shift_inblocks applied %" PetscInt_FMT ", each shift_amount %g\n", sctx.nshift, (double)info->shiftamount));
-    }
+  /* copy tmp into x according to permutation */
+  for (i = 0; i < n; i++) x[r[i]] = y ? y[r[i]] + tmp[i] : tmp[i];
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSolveAdd_SeqAIJSingle(Mat A, Vec bb, Vec yy, Vec xx)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingleFactor *fs;
+  const PetscInt         *r = NULL, *c = NULL;
+  PetscScalar            *x;
+  const PetscScalar      *b, *y = NULL;
+
+  PetscFunctionBegin;
+  if (!A->rmap->n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectContainerQuery((PetscObject)A, "MatSeqAIJSingleFactor", &fs));
+  PetscCall(VecGetArrayRead(bb, &b));
+  if (yy == xx) PetscCall(VecGetArray(xx, &x));
+  else {
+    if (yy) PetscCall(VecGetArrayRead(yy, &y));
+    PetscCall(VecGetArrayWrite(xx, &x));
+  }
+  if (!fs->natural) {
+    PetscCall(ISGetIndices(a->row, &r));
+    PetscCall(ISGetIndices(a->col, &c));
+  }
+  PetscCall(MatSolveKernel_SeqAIJSingle(A, fs->a, r, c, b, yy == xx ? x : y, x));
+  if (!fs->natural) {
+    PetscCall(ISRestoreIndices(a->row, &r));
+    PetscCall(ISRestoreIndices(a->col, &c));
+  }
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  if (yy == xx) PetscCall(VecRestoreArray(xx, &x));
+  else {
+    if (yy) PetscCall(VecRestoreArrayRead(yy, &y));
+    PetscCall(VecRestoreArrayWrite(xx, &x));
+  }
+  PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n + (yy ? A->cmap->n : 0)));
+  PetscCall(MatSeqAIJSingleFactorLogBytes_Private(A, (yy ? 5.0 : 4.0) * A->rmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSolve_SeqAIJSingle(Mat A, Vec bb, Vec xx)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSolveAdd_SeqAIJSingle(A, bb, NULL, xx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSolveTransposeAdd_SeqAIJSingle(Mat A, Vec bb, Vec yy, Vec xx)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingleFactor *fs;
+  const PetscInt         *r, *c;
+  PetscScalar            *x;
+  const PetscScalar      *b, *y = NULL;
+
+  PetscFunctionBegin;
+  if (!A->rmap->n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectContainerQuery((PetscObject)A, "MatSeqAIJSingleFactor", &fs));
+  PetscCall(VecGetArrayRead(bb, &b));
+  if (yy == xx) PetscCall(VecGetArray(xx, &x));
+  else {
+    if (yy) PetscCall(VecGetArrayRead(yy, &y));
+    PetscCall(VecGetArrayWrite(xx, &x));
+  }
+  PetscCall(ISGetIndices(a->row, &r));
+  PetscCall(ISGetIndices(a->col, &c));
+  PetscCall(MatSolveTransposeKernel_SeqAIJSingle(A, fs->a, r, c, b, yy == xx ? x : y, x));
+  PetscCall(ISRestoreIndices(a->row, &r));
+  PetscCall(ISRestoreIndices(a->col, &c));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  if (yy == xx) PetscCall(VecRestoreArray(xx, &x));
+  else {
+    if (yy) PetscCall(VecRestoreArrayRead(yy, &y));
+    PetscCall(VecRestoreArrayWrite(xx, &x));
+  }
+  PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n + (yy ? A->cmap->n : 0)));
+  PetscCall(MatSeqAIJSingleFactorLogBytes_Private(A, (yy ? 5.0 : 4.0) * A->rmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSolveTranspose_SeqAIJSingle(Mat A, Vec bb, Vec xx)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSolveTransposeAdd_SeqAIJSingle(A, bb, NULL, xx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMatSolve_SeqAIJSingle_Private(Mat A, Mat B, Mat X, PetscBool trans)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingleFactor *fs;
+  PetscInt                n = A->rmap->n, ldb, ldx;
+  const PetscInt         *r = NULL, *c = NULL;
+  PetscScalar            *x;
+  const PetscScalar      *b;
+  PetscBool               isdense;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectTypeCompare((PetscObject)B, MATSEQDENSE, &isdense));
+  PetscCheck(isdense, PETSC_COMM_SELF, PETSC_ERR_ARG_INCOMP, "B matrix must be a SeqDense matrix");
+  if (X != B) {
+    PetscCall(PetscObjectTypeCompare((PetscObject)X, MATSEQDENSE, &isdense));
+    PetscCheck(isdense, PETSC_COMM_SELF, PETSC_ERR_ARG_INCOMP, "X matrix must be a SeqDense matrix");
+  }
+  PetscCall(PetscObjectContainerQuery((PetscObject)A, "MatSeqAIJSingleFactor", &fs));
+  PetscCall(MatDenseGetArrayRead(B, &b));
+  PetscCall(MatDenseGetLDA(B, &ldb));
+  PetscCall(MatDenseGetArray(X, &x));
+  PetscCall(MatDenseGetLDA(X, &ldx));
+  if (trans || !fs->natural) {
+    PetscCall(ISGetIndices(a->row, &r));
+    PetscCall(ISGetIndices(a->col, &c));
+  }
+  for (PetscInt k = 0; k < B->cmap->n; k++) {
+    if (trans) PetscCall(MatSolveTransposeKernel_SeqAIJSingle(A, fs->a, r, c, b + k * ldb, NULL, x + k * ldx));
+    else PetscCall(MatSolveKernel_SeqAIJSingle(A, fs->a, r, c, b + k * ldb, NULL, x + k * ldx));
+    PetscCall(MatSeqAIJSingleFactorLogBytes_Private(A, 4.0 * n));
+  }
+  if (r) {
+    PetscCall(ISRestoreIndices(a->row, &r));
+    PetscCall(ISRestoreIndices(a->col, &c));
+  }
+  PetscCall(MatDenseRestoreArrayRead(B, &b));
+  PetscCall(MatDenseRestoreArray(X, &x));
+  PetscCall(PetscLogFlops(B->cmap->n * (2.0 * a->nz - n)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMatSolve_SeqAIJSingle(Mat A, Mat B, Mat X)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMatSolve_SeqAIJSingle_Private(A, B, X, PETSC_FALSE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMatSolveTranspose_SeqAIJSingle(Mat A, Mat B, Mat X)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMatSolve_SeqAIJSingle_Private(A, B, X, PETSC_TRUE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   The numeric LU, or ILU, factorization selected by MatFactorInfo.singleprecision (-pc_factor_mat_single_precision). The elimination
+   of MatLUFactorNumeric_SeqAIJ() is done in single precision and only the single precision values of the factor are kept, see Mat_SeqAIJSingleFactor:
+   the double precision values allocated by the symbolic factorization are freed, which halves the memory of the values of the factor.
+   The factor is meant to precondition an outer KSPRICHARDSON or KSPFGMRES whose residuals are computed in double precision
+*/
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_SinglePrecision(Mat B, Mat A, const MatFactorInfo *info)
+{
+  Mat_SeqAIJ    *b = (Mat_SeqAIJ *)B->data;
+  float         *ba;
+  FactorShiftCtx sctx;
+
+  PetscFunctionBegin;
+  /* after a (new) symbolic factorization free the double precision values of the factor, only the single precision ones are used */
+  if (b->a) {
+    PetscCall(MatXAIJDeallocatea(B, &b->a));
+    b->a = NULL;
   }
+  PetscCall(MatSeqAIJSingleFactorGetArray_Private(B, &ba));
+  PetscCall(MatLUFactorNumericKernel_SeqAIJSingle(B, A, info, ba, &sctx));
+
+  B->ops->solve             = MatSolve_SeqAIJSingle;
+  B->ops->solveadd          = MatSolveAdd_SeqAIJSingle;
+  B->ops->solvetranspose    = MatSolveTranspose_SeqAIJSingle;
+  B->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJSingle;
+  B->ops->matsolve          = MatMatSolve_SeqAIJSingle;
+  B->ops->matsolvetranspose = MatMatSolveTranspose_SeqAIJSingle;
+  B->assembled              = PETSC_TRUE;
+  B->preallocated           = PETSC_TRUE;
+  PetscCall(PetscLogFlops(B->cmap->n));
+  PetscCall(MatLUFactorNumericShiftView_SeqAIJ_Private(A, info, &sctx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* called at the end of the SeqAIJ LU and ILU symbolic factorizations, after the numeric factorization routine has been selected */
+static PetscErrorCode MatSeqAIJFactorSetSinglePrecision_Private(Mat B, const MatFactorInfo *info)
+{
+  PetscFunctionBegin;
+  if (!info->singleprecision) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCheck(!PetscDefined(USE_COMPLEX), PETSC_COMM_SELF, PETSC_ERR_SUP, "Single precision SeqAIJ factors are not available with complex scalars");
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_SinglePrecision;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1738,7 +1992,9 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ilu0(Mat fact, Mat A, IS isrow, IS is
   fact->info.fill_ratio_given  = info->fill;
   fact->info.fill_ratio_needed = 1.0;
   fact->ops->lufactornumeric   = MatLUFactorNumeric_SeqAIJ;
+  if (a->inode.size_csr) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   PetscCall(MatSeqAIJCheckInode_FactorLU(fact));
+  PetscCall(MatSeqAIJFactorSetNumericLevels_Private(fact));
 
   b       = (Mat_SeqAIJ *)fact->data;
   b->row  = isrow;
@@ -1771,6 +2027,8 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact, Mat A, IS isrow, IS iscol,
   PetscCheck(A->rmap->n == A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Must be square matrix, rows %" PetscInt_FMT " columns %" PetscInt_FMT, A->rmap->n, A->cmap->n);
   PetscCall(MatMissingDiagonal(A, &missing, &i));
   PetscCheck(!missing, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Matrix is missing diagonal entry %" PetscInt_FMT, i);
+  /* the I-nodes and solve levels of a previous symbolic factorization may be for another nonzero structure */
+  PetscCall(MatSeqAIJFactorResetStructure_Private(fact));
 
   levels = (PetscInt)info->levels;
   PetscCall(ISIdentity(isrow, &row_identity));
@@ -1778,7 +2036,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact, Mat A, IS isrow, IS iscol,
   if (!levels && row_identity && col_identity) {
     /* special case: ilu(0) with natural ordering */
     PetscCall(MatILUFactorSymbolic_SeqAIJ_ilu0(fact, A, isrow, iscol, info));
-    if (a->inode.size_csr) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
+    PetscCall(MatSeqAIJFactorSetSinglePrecision_Private(fact, info));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
@@ -1911,6 +2169,8 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact, Mat A, IS isrow, IS iscol,
   fact->ops->lufactornumeric   = MatLUFactorNumeric_SeqAIJ;
   if (a->inode.size_csr) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   PetscCall(MatSeqAIJCheckInode_FactorLU(fact));
+  PetscCall(MatSeqAIJFactorSetNumericLevels_Private(fact));
+  PetscCall(MatSeqAIJFactorSetSinglePrecision_Private(fact, info));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -3223,6 +3483,7 @@ PetscErrorCode MatSolve_SeqAIJ_NaturalOrdering(Mat A, Vec bb, Vec xx)
   }
 
   PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n));
+  PetscCall(MatSeqAIJLogBytes_Private(A, 4.0 * A->rmap->n));
   PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
   PetscCall(VecRestoreArrayRead(bb, &b));
   PetscCall(VecRestoreArrayWrite(xx, &x));
@@ -3281,6 +3542,291 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A, Vec bb, Vec xx)
   PetscCall(VecRestoreArrayRead(bb, &b));
   PetscCall(VecRestoreArrayWrite(xx, &x));
   PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n));
+  PetscCall(MatSeqAIJLogBytes_Private(A, 4.0 * A->rmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJSolveLevelsDestroy_Private(Mat_SeqAIJSolveLevels **sl)
+{
+  PetscFunctionBegin;
+  if (!*sl) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt t = 0; t < 2; t++) PetscCall(PetscFree2((*sl)->levelptr[t], (*sl)->units[t]));
+  PetscCall(PetscFree(*sl));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Computes the levels of the units (rows or I-nodes) of L in the forward order and of U in the backward order. A unit is one level
+   after the latest unit it depends on; the entries coupling rows of the same I-node are handled when the I-node is solved
+*/
+static PetscErrorCode MatSeqAIJSolveLevelsSetUp_Private(Mat A)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ *)A->data;
+  const PetscInt         n = A->rmap->n, *ai = a->i, *aj = a->j, *adiag = a->diag;
+  PetscInt               nunits, *start, *unit, *level, *next;
+  Mat_SeqAIJSolveLevels *sl;
+
+  PetscFunctionBegin;
+  if (a->solvelevels) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscNew(&sl));
+  sl->inodes = a->inode.size_csr ? PETSC_TRUE : PETSC_FALSE;
+  nunits     = sl->inodes ? a->inode.node_count : n;
+  PetscCall(PetscMalloc4(nunits + 1, &start, n, &unit, nunits, &level, nunits + 1, &next));
+  for (PetscInt u = 0; u <= nunits; u++) start[u] = sl->inodes ? a->inode.size_csr[u] : u;
+  for (PetscInt u = 0; u < nunits; u++) {
+    for (PetscInt i = start[u]; i < start[u + 1]; i++) unit[i] = u;
+  }
+  for (PetscInt t = 0; t < 2; t++) {
+    PetscInt nlevels = 0;
+
+    for (PetscInt k = 0; k < nunits; k++) {
+      const PetscInt u   = t ? nunits - 1 - k : k;
+      PetscInt       lev = 0;
+
+      for (PetscInt i = start[u]; i < start[u + 1]; i++) {
+        const PetscInt *vi = t ? aj + adiag[i + 1] + 1 : aj + ai[i];
+        const PetscInt  nz = t ? adiag[i] - adiag[i + 1] - 1 : ai[i + 1] - ai[i];
+
+        for (PetscInt j = 0; j < nz; j++) {
+          const PetscInt v = unit[vi[j]];
+
+          if (v != u) lev = PetscMax(lev, level[v] + 1);
+        }
+      }
+      level[u] = lev;
+      nlevels  = PetscMax(nlevels, lev + 1);
+    }
+    /* bucket the units by level, in the order they are solved by MatSolve_SeqAIJ() */
+    sl->nlevels[t] = nlevels;
+    PetscCall(PetscMalloc2(nlevels + 1, &sl->levelptr[t], nunits, &sl->units[t]));
+    PetscCall(PetscArrayzero(next, nlevels + 1));
+    for (PetscInt u = 0; u < nunits; u++) next[level[u] + 1]++;
+    for (PetscInt k = 0; k < nlevels; k++) next[k + 1] += next[k];
+    PetscCall(PetscArraycpy(sl->levelptr[t], next, nlevels + 1));
+    for (PetscInt k = 0; k < nunits; k++) {
+      const PetscInt u = t ? nunits - 1 - k : k;
+
+      sl->units[t][next[level[u]]++] = u;
+    }
+  }
+  PetscCall(PetscFree4(start, unit, level, next));
+  PetscCall(PetscInfo(A, "%" PetscInt_FMT " %s in %" PetscInt_FMT " levels of L and %" PetscInt_FMT " levels of U\n", nunits, sl->inodes ? "I-nodes" : "rows", sl->nlevels[0], sl->nlevels[1]));
+  a->solvelevels = sl;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the units of one level are solved concurrently, the rows of an I-node one after the other */
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A, Vec bb, Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ *)A->data;
+  const PetscInt         n = A->rmap->n, *ai = a->i, *aj = a->j, *adiag = a->diag;
+  const PetscInt        *r = NULL, *c = NULL, *start;
+  Mat_SeqAIJSolveLevels *sl;
+  PetscBool              row_identity, col_identity;
+  PetscScalar           *x, *tmp;
+  const PetscScalar     *b;
+  const MatScalar       *aa;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  sl    = a->solvelevels;
+  start = sl->inodes ? a->inode.size_csr : NULL;
+
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(VecGetArrayRead(bb, &b));
+  PetscCall(VecGetArrayWrite(xx, &x));
+  PetscCall(ISIdentity(a->row, &row_identity));
+  PetscCall(ISIdentity(a->col, &col_identity));
+  if (row_identity && col_identity) tmp = x;
+  else {
+    tmp = a->solve_work;
+    PetscCall(ISGetIndices(a->row, &r));
+    PetscCall(ISGetIndices(a->col, &c));
+  }
+
+  /* forward solve the lower triangular */
+  for (PetscInt k = 0; k < sl->nlevels[0]; k++) {
+    const PetscInt *units = sl->units[0] + sl->levelptr[0][k], nunits = sl->levelptr[0][k + 1] - sl->levelptr[0][k];
+
+    PetscPragmaUseOMPKernels(parallel for)
+    for (PetscInt p = 0; p < nunits; p++) {
+      const PetscInt u = units[p], rstart = start ? start[u] : u, rend = start ? start[u + 1] : u + 1;
+
+      for (PetscInt i = rstart; i < rend; i++) {
+        const PetscInt   nz  = ai[i + 1] - ai[i];
+        const PetscInt  *vi  = aj + ai[i];
+        const MatScalar *v   = aa + ai[i];
+        PetscScalar      sum = b[r ? r[i] : i];
+
+        PetscSparseDenseMinusDot(sum, tmp, v, vi, nz);
+        tmp[i] = sum;
+      }
+    }
+  }
+
+  /* backward solve the upper triangular */
+  for (PetscInt k = 0; k < sl->nlevels[1]; k++) {
+    const PetscInt *units = sl->units[1] + sl->levelptr[1][k], nunits = sl->levelptr[1][k + 1] - sl->levelptr[1][k];
+
+    PetscPragmaUseOMPKernels(parallel for)
+    for (PetscInt p = 0; p < nunits; p++) {
+      const PetscInt u = units[p], rstart = start ? start[u] : u, rend = start ? start[u + 1] : u + 1;
+
+      for (PetscInt i = rend - 1; i >= rstart; i--) {
+        const PetscInt   nz  = adiag[i] - adiag[i + 1] - 1;
+        const PetscInt  *vi  = aj + adiag[i + 1] + 1;
+        const MatScalar *v   = aa + adiag[i + 1] + 1;
+        PetscScalar      sum = tmp[i];
+
+        PetscSparseDenseMinusDot(sum, tmp, v, vi, nz);
+        tmp[i] = sum * v[nz]; /* v[nz] = aa[adiag[i]] */
+        if (c) x[c[i]] = tmp[i];
+      }
+    }
+  }
+
+  if (r) PetscCall(ISRestoreIndices(a->row, &r));
+  if (c) PetscCall(ISRestoreIndices(a->col, &c));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscCall(VecRestoreArrayWrite(xx, &x));
+  PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n));
+  PetscCall(MatSeqAIJLogBytes_Private(A, 4.0 * A->rmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Called at the end of the numeric LU and ILU factorizations, after the default MatSolve() has been selected. The levels only
+   depend on the nonzero structure of the factor so they are computed at the first numeric factorization and then reused
+*/
+PetscErrorCode MatSeqAIJFactorSetSolveLevels_Private(Mat B)
+{
+  PetscBool flg = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscOptionsGetBool(((PetscObject)B)->options, ((PetscObject)B)->prefix, "-mat_seqaij_solve_levels", &flg, NULL));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(MatSeqAIJSolveLevelsSetUp_Private(B));
+  B->ops->solve = MatSolve_SeqAIJ_Levels;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Numeric LU and ILU factorization by the levels of L of the factor. A row of the factor only reads the U rows of the columns of its
+   L part, which are in earlier levels or earlier rows of its own I-node, so the units of a level are factored concurrently, each thread
+   with its own dense work row. The levels are computed at the first numeric factorization after the symbolic
+   one and shared with -mat_seqaij_solve_levels.
+
+   This is level scheduling of the rows, and of the I-nodes, of the factor, not a supernodal factorization with dense blocks.
+
+   Only MAT_SHIFT_NONE is handled here; the other shifts may restart the factorization and, like a zero pivot, are left to
+   the sequential MatLUFactorNumeric_SeqAIJ(), which is reported with PetscInfo()
+*/
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_Levels(Mat B, Mat A, const MatFactorInfo *info)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)B->data;
+  const PetscInt         n = A->rmap->n, *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j, *bdiag = b->diag, *start;
+  const PetscInt        *r, *ic;
+  const MatScalar       *aa;
+  MatScalar             *ba, *work;
+  Mat_SeqAIJSolveLevels *sl;
+  PetscInt               nthreads  = 1;
+  int                    zeropivot = 0; /* an int for the OpenMP reduction */
+  PetscLogDouble         flops     = 0.0;
+
+  PetscFunctionBegin;
+  if (info->shifttype != (PetscReal)MAT_SHIFT_NONE) {
+    PetscCall(PetscInfo(A, "Factoring sequentially since the factorization by levels does not handle the shift type %s\n", MatFactorShiftTypes[(int)info->shifttype]));
+    PetscCall(MatLUFactorNumeric_SeqAIJ(B, A, info));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(MatSeqAIJSolveLevelsSetUp_Private(B));
+  sl    = b->solvelevels;
+  start = sl->inodes ? b->inode.size_csr : NULL;
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  nthreads = (PetscInt)omp_get_max_threads();
+#endif
+  PetscCall(PetscMalloc1(nthreads * (n + 1), &work));
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(MatSeqAIJGetArrayWrite(B, &ba));
+  PetscCall(ISGetIndices(b->row, &r));
+  PetscCall(ISGetIndices(b->icol, &ic));
+
+  for (PetscInt k = 0; k < sl->nlevels[0]; k++) {
+    const PetscInt *units = sl->units[0] + sl->levelptr[0][k], nunits = sl->levelptr[0][k + 1] - sl->levelptr[0][k];
+
+    PetscPragmaUseOMPKernels(parallel for reduction(+:flops) reduction(||:zeropivot))
+    for (PetscInt p = 0; p < nunits; p++) {
+      const PetscInt u    = units[p], rstart = start ? start[u] : u, rend = start ? start[u + 1] : u + 1;
+      MatScalar     *rtmp = work;
+
+#if defined(PETSC_USE_OPENMP_KERNELS)
+      rtmp += omp_get_thread_num() * (n + 1);
+#endif
+      for (PetscInt i = rstart; i < rend; i++) {
+        const PetscInt   nzL = bi[i + 1] - bi[i], nzU = bdiag[i] - bdiag[i + 1] - 1, *pjL = bj + bi[i], *pjU = bj + bdiag[i + 1] + 1;
+        const PetscInt   nza = ai[r[i] + 1] - ai[r[i]], *ajtmp = aj + ai[r[i]];
+        const MatScalar *v   = aa + ai[r[i]];
+        MatScalar       *pvL = ba + bi[i], *pvU = ba + bdiag[i + 1] + 1;
+
+        /* zero the pattern of the row, including its diagonal, and load the unfactored row */
+        for (PetscInt j = 0; j < nzL; j++) rtmp[pjL[j]] = 0.0;
+        for (PetscInt j = 0; j <= nzU; j++) rtmp[pjU[j]] = 0.0;
+        for (PetscInt j = 0; j < nza; j++) rtmp[ic[ajtmp[j]]] = v[j];
+
+        /* elimination */
+        for (PetscInt l = 0; l < nzL; l++) {
+          const PetscInt row = pjL[l];
+
+          if (rtmp[row] != 0.0) {
+            const MatScalar  multiplier = rtmp[row] * ba[bdiag[row]];
+            const PetscInt   nz         = bdiag[row] - bdiag[row + 1] - 1, *pj = bj + bdiag[row + 1] + 1;
+            const MatScalar *pv         = ba + bdiag[row + 1] + 1;
+
+            rtmp[row] = multiplier;
+            for (PetscInt j = 0; j < nz; j++) rtmp[pj[j]] -= multiplier * pv[j];
+            flops += 1 + 2.0 * nz;
+          }
+        }
+
+        /* finished row so stick it into b->a, with the inverse of the diagonal for simpler triangular solves */
+        for (PetscInt j = 0; j < nzL; j++) pvL[j] = rtmp[pjL[j]];
+        for (PetscInt j = 0; j < nzU; j++) pvU[j] = rtmp[pjU[j]];
+        if (PetscAbsScalar(rtmp[i]) <= info->zeropivot && !PetscIsNanScalar(rtmp[i])) zeropivot = 1;
+        ba[bdiag[i]] = 1.0 / rtmp[i];
+      }
+    }
+  }
+
+  PetscCall(ISRestoreIndices(b->icol, &ic));
+  PetscCall(ISRestoreIndices(b->row, &r));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(MatSeqAIJRestoreArrayWrite(B, &ba));
+  PetscCall(PetscFree(work));
+  if (zeropivot) {
+    /* the sequential factorization reports the zero pivot, or sets the factor error, exactly as without levels */
+    PetscCall(PetscInfo(A, "Zero pivot in the factorization by levels, refactoring sequentially\n"));
+    PetscCall(MatLUFactorNumeric_SeqAIJ(B, A, info));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscLogFlops(flops));
+  PetscCall(MatLUFactorNumericSetOps_SeqAIJ_Private(B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   called at the end of the symbolic LU and ILU factorizations, after the default numeric factorization has been selected. The
+   factorization by levels replaces the I-node one, MatLUFactorNumeric_SeqAIJ_Inode(), the I-nodes are then only its units of work
+*/
+PetscErrorCode MatSeqAIJFactorSetNumericLevels_Private(Mat B)
+{
+  PetscBool flg = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscOptionsGetBool(((PetscObject)B)->options, ((PetscObject)B)->prefix, "-mat_seqaij_factor_levels", &flg, NULL));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  if (B->ops->lufactornumeric == MatLUFactorNumeric_SeqAIJ_Inode) PetscCall(PetscInfo(B, "Factoring by levels instead of the I-node numeric factorization\n"));
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Levels;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -3617,6 +4163,7 @@ static PetscErrorCode MatILUDTFactorNumeric_SeqAIJ(Mat fact, Mat A, const MatFac
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  PetscCall(MatSeqAIJFactorSetSolveLevels_Private(C));
   C->ops->solveadd          = NULL;
   C->ops->solvetranspose    = NULL;
   C->ops->solvetransposeadd = NULL;
@@ -0,0 +1,144 @@
+/*
+   used by the SeqAIJ LU numeric factorizations to reduce code duplication; the elimination of the rows of A into the
+   structure of the factor B built by MatLUFactorSymbolic_SeqAIJ() or MatILUFactorSymbolic_SeqAIJ(), with the values
+   of the factor stored in ba
+
+     define TYPE            to SeqAIJ, or to SeqAIJSingle for the factors stored in single precision
+            TYPE_SCALAR     to the type of the values of the factor, MatScalar or float
+            TYPE_FROM(v)    to convert a MatScalar or PetscScalar v to TYPE_SCALAR
+            TYPE_ABS(v)     to the absolute value of a TYPE_SCALAR v
+*/
+static PetscErrorCode PetscConcat(MatLUFactorNumericKernel_, TYPE)(Mat B, Mat A, const MatFactorInfo *info, TYPE_SCALAR *ba, FactorShiftCtx *sctx)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)B->data;
+  IS               isrow = b->row, isicol = b->icol;
+  const PetscInt  *r, *ic;
+  const PetscInt   n = A->rmap->n, *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j, *bdiag = b->diag;
+  PetscInt         i, j, k, nz, nzL, row;
+  const PetscInt  *ajtmp, *bjtmp, *pj;
+  TYPE_SCALAR     *rtmp, *pc, multiplier, *pv;
+  const MatScalar *aa, *v;
+  PetscReal        rs;
+  MatScalar        d;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  /* MatPivotSetUp(): initialize shift context sctx */
+  PetscCall(PetscMemzero(sctx, sizeof(FactorShiftCtx)));
+
+  if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) { /* set sctx.shift_top=max{rs} */
+    sctx->shift_top = info->zeropivot;
+    for (i = 0; i < n; i++) {
+      /* calculate sum(|aij|)-RealPart(aii), amt of shift needed for this row */
+      d  = aa[a->diag[i]];
+      rs = -PetscAbsScalar(d) - PetscRealPart(d);
+      v  = aa + ai[i];
+      nz = ai[i + 1] - ai[i];
+      for (j = 0; j < nz; j++) rs += PetscAbsScalar(v[j]);
+      if (rs > sctx->shift_top) sctx->shift_top = rs;
+    }
+    sctx->shift_top *= 1.1;
+    sctx->nshift_max = 5;
+    sctx->shift_lo   = 0.;
+    sctx->shift_hi   = 1.;
+  }
+
+  PetscCall(ISGetIndices(isrow, &r));
+  PetscCall(ISGetIndices(isicol, &ic));
+  PetscCall(PetscMalloc1(n + 1, &rtmp));
+
+  do {
+    sctx->newshift = PETSC_FALSE;
+    for (i = 0; i < n; i++) {
+      /* zero rtmp */
+      /* L part */
+      nz    = bi[i + 1] - bi[i];
+      bjtmp = bj + bi[i];
+      for (j = 0; j < nz; j++) rtmp[bjtmp[j]] = 0.0;
+
+      /* U part */
+      nz    = bdiag[i] - bdiag[i + 1];
+      bjtmp = bj + bdiag[i + 1] + 1;
+      for (j = 0; j < nz; j++) rtmp[bjtmp[j]] = 0.0;
+
+      /* load in initial (unfactored row) */
+      nz    = ai[r[i] + 1] - ai[r[i]];
+      ajtmp = aj + ai[r[i]];
+      v     = aa + ai[r[i]];
+      for (j = 0; j < nz; j++) rtmp[ic[ajtmp[j]]] = TYPE_FROM(v[j]);
+      /* ZeropivotApply() */
+      rtmp[i] += sctx->shift_amount; /* shift the diagonal of the matrix */
+
+      /* elimination */
+      bjtmp = bj + bi[i];
+      row   = *bjtmp++;
+      nzL   = bi[i + 1] - bi[i];
+      for (k = 0; k < nzL; k++) {
+        pc = rtmp + row;
+        if (*pc != 0.0) {
+          pv         = ba + bdiag[row];
+          multiplier = *pc * (*pv);
+          *pc        = multiplier;
+
+          pj = bj + bdiag[row + 1] + 1; /* beginning of U(row,:) */
+          pv = ba + bdiag[row + 1] + 1;
+          nz = bdiag[row] - bdiag[row + 1] - 1; /* num of entries in U(row,:) excluding diag */
+
+          for (j = 0; j < nz; j++) rtmp[pj[j]] -= multiplier * pv[j];
+          PetscCall(PetscLogFlops(1 + 2.0 * nz));
+        }
+        row = *bjtmp++;
+      }
+
+      /* finished row so stick it into ba */
+      rs = 0.0;
+      /* L part */
+      pv = ba + bi[i];
+      pj = bj + bi[i];
+      nz = bi[i + 1] - bi[i];
+      for (j = 0; j < nz; j++) {
+        pv[j] = rtmp[pj[j]];
+        rs += TYPE_ABS(pv[j]);
+      }
+
+      /* U part */
+      pv = ba + bdiag[i + 1] + 1;
+      pj = bj + bdiag[i + 1] + 1;
+      nz = bdiag[i] - bdiag[i + 1] - 1;
+      for (j = 0; j < nz; j++) {
+        pv[j] = rtmp[pj[j]];
+        rs += TYPE_ABS(pv[j]);
+      }
+
+      sctx->rs = rs;
+      sctx->pv = rtmp[i];
+      PetscCall(MatPivotCheck(B, A, info, sctx, i));
+      if (sctx->newshift) break;     /* break for-loop */
+      rtmp[i] = TYPE_FROM(sctx->pv); /* sctx.pv might be updated in the case of MAT_SHIFT_INBLOCKS */
+
+      /* Mark diagonal and invert diagonal for simpler triangular solves */
+      pv  = ba + bdiag[i];
+      *pv = 1.0 / rtmp[i];
+
+    } /* endof for (i=0; i<n; i++) { */
+
+    /* MatPivotRefine() */
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE && !sctx->newshift && sctx->shift_fraction > 0 && sctx->nshift < sctx->nshift_max) {
+      /*
+       * if no shift in this attempt & shifting & started shifting & can refine,
+       * then try lower shift
+       */
+      sctx->shift_hi       = sctx->shift_fraction;
+      sctx->shift_fraction = (sctx->shift_hi + sctx->shift_lo) / 2.;
+      sctx->shift_amount   = sctx->shift_fraction * sctx->shift_top;
+      sctx->newshift       = PETSC_TRUE;
+      sctx->nshift++;
+    }
+  } while (sctx->newshift);
+
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(PetscFree(rtmp));
+  PetscCall(ISRestoreIndices(isicol, &ic));
+  PetscCall(ISRestoreIndices(isrow, &r));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
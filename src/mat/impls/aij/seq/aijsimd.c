@@ -0,0 +1,295 @@
+/*
+  Gather-based AVX2 and AVX-512 kernels for MatMult(), MatMultAdd() and MatMultTranspose() of MATSEQAIJ.
+
+  The kernels are compiled with function level target attributes and selected at runtime from the
+  instruction sets the CPU reports, so PETSc does not need to be compiled with -mavx2 or -mavx512f to use them.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+const char *const MatSeqAIJSIMDTypes[] = {"none", "avx2", "avx512", "MatSeqAIJSIMDType", "MAT_SEQAIJ_SIMD_", NULL};
+
+#if defined(PETSC_SEQAIJ_SIMD_DISPATCH)
+  #include <immintrin.h>
+
+  #define PETSC_SEQAIJ_TARGET_AVX2   __attribute__((target("avx2,fma")))
+  #define PETSC_SEQAIJ_TARGET_AVX512 __attribute__((target("avx2,fma,avx512f,avx512vl")))
+
+  #if defined(PETSC_USE_64BIT_INDICES)
+    #define MatSeqAIJGather4_AVX2(x, idx)            _mm256_i64gather_pd((x), _mm256_loadu_si256((const __m256i *)(idx)), 8)
+    #define MatSeqAIJIndex8_AVX512                   __m512i
+    #define MatSeqAIJLoadIndex8_AVX512(idx)          _mm512_loadu_si512((const void *)(idx))
+    #define MatSeqAIJMaskLoadIndex8_AVX512(k, idx)   _mm512_maskz_loadu_epi64((k), (const void *)(idx))
+    #define MatSeqAIJGather8_AVX512(x, vidx)         _mm512_i64gather_pd((vidx), (x), 8)
+    #define MatSeqAIJMaskGather8_AVX512(k, x, vidx)  _mm512_mask_i64gather_pd(_mm512_setzero_pd(), (k), (vidx), (x), 8)
+    #define MatSeqAIJScatter8_AVX512(y, vidx, v)     _mm512_i64scatter_pd((y), (vidx), (v), 8)
+    #define MatSeqAIJMaskScatter8_AVX512(y, k, vidx, v) _mm512_mask_i64scatter_pd((y), (k), (vidx), (v), 8)
+  #else
+    #define MatSeqAIJGather4_AVX2(x, idx)            _mm256_i32gather_pd((x), _mm_loadu_si128((const __m128i *)(idx)), 8)
+    #define MatSeqAIJIndex8_AVX512                   __m256i
+    #define MatSeqAIJLoadIndex8_AVX512(idx)          _mm256_loadu_si256((const __m256i *)(idx))
+    #define MatSeqAIJMaskLoadIndex8_AVX512(k, idx)   _mm256_maskz_loadu_epi32((k), (const void *)(idx))
+    #define MatSeqAIJGather8_AVX512(x, vidx)         _mm512_i32gather_pd((vidx), (x), 8)
+    #define MatSeqAIJMaskGather8_AVX512(k, x, vidx)  _mm512_mask_i32gather_pd(_mm512_setzero_pd(), (k), (vidx), (x), 8)
+    #define MatSeqAIJScatter8_AVX512(y, vidx, v)     _mm512_i32scatter_pd((y), (vidx), (v), 8)
+    #define MatSeqAIJMaskScatter8_AVX512(y, k, vidx, v) _mm512_mask_i32scatter_pd((y), (k), (vidx), (v), 8)
+  #endif
+
+static PetscBool MatSeqAIJSIMDSupported_Private(MatSeqAIJSIMDType simd)
+{
+  __builtin_cpu_init();
+  switch (simd) {
+  case MAT_SEQAIJ_SIMD_AVX2:
+    return (PetscBool)(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+  case MAT_SEQAIJ_SIMD_AVX512:
+    return (PetscBool)(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"));
+  default:
+    return PETSC_TRUE;
+  }
+}
+
+static inline PETSC_SEQAIJ_TARGET_AVX2 PetscScalar PetscSparseDensePlusDot_AVX2(const PetscScalar *x, const MatScalar *aa, const PetscInt *aj, PetscInt n)
+{
+  __m256d     s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+  __m128d     lo;
+  PetscScalar sum;
+  PetscInt    j = 0;
+
+  /* two independent accumulators hide the latency of the gathers */
+  for (; j + 8 <= n; j += 8) {
+    s0 = _mm256_fmadd_pd(_mm256_loadu_pd(aa + j), MatSeqAIJGather4_AVX2(x, aj + j), s0);
+    s1 = _mm256_fmadd_pd(_mm256_loadu_pd(aa + j + 4), MatSeqAIJGather4_AVX2(x, aj + j + 4), s1);
+  }
+  if (j + 4 <= n) {
+    s0 = _mm256_fmadd_pd(_mm256_loadu_pd(aa + j), MatSeqAIJGather4_AVX2(x, aj + j), s0);
+    j += 4;
+  }
+  s0  = _mm256_add_pd(s0, s1);
+  lo  = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+  sum = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+  for (; j < n; j++) sum += aa[j] * x[aj[j]];
+  return sum;
+}
+
+static inline PETSC_SEQAIJ_TARGET_AVX512 PetscScalar PetscSparseDensePlusDot_AVX512(const PetscScalar *x, const MatScalar *aa, const PetscInt *aj, PetscInt n)
+{
+  __m512d  s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+  PetscInt j  = 0;
+
+  for (; j + 16 <= n; j += 16) {
+    s0 = _mm512_fmadd_pd(_mm512_loadu_pd(aa + j), MatSeqAIJGather8_AVX512(x, MatSeqAIJLoadIndex8_AVX512(aj + j)), s0);
+    s1 = _mm512_fmadd_pd(_mm512_loadu_pd(aa + j + 8), MatSeqAIJGather8_AVX512(x, MatSeqAIJLoadIndex8_AVX512(aj + j + 8)), s1);
+  }
+  if (j + 8 <= n) {
+    s0 = _mm512_fmadd_pd(_mm512_loadu_pd(aa + j), MatSeqAIJGather8_AVX512(x, MatSeqAIJLoadIndex8_AVX512(aj + j)), s0);
+    j += 8;
+  }
+  if (j < n) { /* masked remainder, the masked off lanes are neither loaded nor gathered */
+    const __mmask8 k = (__mmask8)(0xff >> (8 - (n - j)));
+
+    s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, aa + j), MatSeqAIJMaskGather8_AVX512(k, x, MatSeqAIJMaskLoadIndex8_AVX512(k, aj + j)), s1);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+}
+
+/* z[r] = y[r] + A[r,:] x for the (possibly compressed) rows r; y may be NULL, in which case it is taken as zero */
+static PETSC_SEQAIJ_TARGET_AVX2 void MatMultAddKernel_SeqAIJ_AVX2(PetscInt m, const PetscInt *ii, const PetscInt *ridx, const PetscInt *aj, const MatScalar *aa, const PetscScalar *x, const PetscScalar *y, PetscScalar *z)
+{
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt r = ridx ? ridx[i] : i;
+
+    z[r] = (y ? y[r] : 0.0) + PetscSparseDensePlusDot_AVX2(x, aa + ii[i], aj + ii[i], ii[i + 1] - ii[i]);
+  }
+}
+
+static PETSC_SEQAIJ_TARGET_AVX512 void MatMultAddKernel_SeqAIJ_AVX512(PetscInt m, const PetscInt *ii, const PetscInt *ridx, const PetscInt *aj, const MatScalar *aa, const PetscScalar *x, const PetscScalar *y, PetscScalar *z)
+{
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt r = ridx ? ridx[i] : i;
+
+    z[r] = (y ? y[r] : 0.0) + PetscSparseDensePlusDot_AVX512(x, aa + ii[i], aj + ii[i], ii[i + 1] - ii[i]);
+  }
+}
+
+/* y += A^T x; AVX2 has no scatter so the products are formed in registers and added one by one */
+static PETSC_SEQAIJ_TARGET_AVX2 void MatMultTransposeAddKernel_SeqAIJ_AVX2(PetscInt m, const PetscInt *ii, const PetscInt *ridx, const PetscInt *aj, const MatScalar *aa, const PetscScalar *x, PetscScalar *y)
+{
+  PetscScalar t[4];
+
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt    n     = ii[i + 1] - ii[i];
+    const PetscInt   *idx   = aj + ii[i];
+    const MatScalar  *v     = aa + ii[i];
+    const PetscScalar alpha = x[ridx ? ridx[i] : i];
+    const __m256d     valpha = _mm256_set1_pd(alpha);
+    PetscInt          j      = 0;
+
+    for (; j + 4 <= n; j += 4) {
+      _mm256_storeu_pd(t, _mm256_mul_pd(valpha, _mm256_loadu_pd(v + j)));
+      y[idx[j]] += t[0];
+      y[idx[j + 1]] += t[1];
+      y[idx[j + 2]] += t[2];
+      y[idx[j + 3]] += t[3];
+    }
+    for (; j < n; j++) y[idx[j]] += alpha * v[j];
+  }
+}
+
+/* y += A^T x; the column indices of a row are distinct so the scatter of each 8-wide chunk has no conflicts */
+static PETSC_SEQAIJ_TARGET_AVX512 void MatMultTransposeAddKernel_SeqAIJ_AVX512(PetscInt m, const PetscInt *ii, const PetscInt *ridx, const PetscInt *aj, const MatScalar *aa, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt   n      = ii[i + 1] - ii[i];
+    const PetscInt  *idx    = aj + ii[i];
+    const MatScalar *v      = aa + ii[i];
+    const __m512d    valpha = _mm512_set1_pd(x[ridx ? ridx[i] : i]);
+    PetscInt         j      = 0;
+
+    for (; j + 8 <= n; j += 8) {
+      const MatSeqAIJIndex8_AVX512 vidx = MatSeqAIJLoadIndex8_AVX512(idx + j);
+
+      MatSeqAIJScatter8_AVX512(y, vidx, _mm512_fmadd_pd(valpha, _mm512_loadu_pd(v + j), MatSeqAIJGather8_AVX512(y, vidx)));
+    }
+    if (j < n) {
+      const __mmask8               k    = (__mmask8)(0xff >> (8 - (n - j)));
+      const MatSeqAIJIndex8_AVX512 vidx = MatSeqAIJMaskLoadIndex8_AVX512(k, idx + j);
+
+      MatSeqAIJMaskScatter8_AVX512(y, k, vidx, _mm512_fmadd_pd(valpha, _mm512_maskz_loadu_pd(k, v + j), MatSeqAIJMaskGather8_AVX512(k, y, vidx)));
+    }
+  }
+}
+#endif
+
+/*
+   MatMultAdd_SeqAIJ_SIMD - computes zz = yy + A xx with the SIMD kernel selected for A; if yy is NULL computes zz = A xx
+*/
+PetscErrorCode MatMultAdd_SeqAIJ_SIMD(Mat A, Vec xx, Vec yy, Vec zz)
+{
+#if defined(PETSC_SEQAIJ_SIMD_DISPATCH)
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y = NULL, *z;
+  const MatScalar   *aa;
+  const PetscInt    *ii = a->i, *ridx = NULL;
+  PetscInt           m     = A->rmap->n;
+  PetscLogEvent      event = a->simd == MAT_SEQAIJ_SIMD_AVX512 ? MAT_MultAVX512 : MAT_MultAVX2;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(event, A, xx, zz, 0));
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(VecGetArrayRead(xx, &x));
+  if (yy) PetscCall(VecGetArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecGetArray(zz, &z));
+  if (a->compressedrow.use) {
+    if (!yy) PetscCall(PetscArrayzero(z, m));
+    else if (zz != yy) PetscCall(PetscArraycpy(z, y, m));
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (a->simd == MAT_SEQAIJ_SIMD_AVX512) MatMultAddKernel_SeqAIJ_AVX512(m, ii, ridx, a->j, aa, x, y, z);
+  else MatMultAddKernel_SeqAIJ_AVX2(m, ii, ridx, a->j, aa, x, y, z);
+  PetscCall(PetscLogFlops(yy ? 2.0 * a->nz : 2.0 * a->nz - a->nonzerorowcnt));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  if (yy) PetscCall(VecRestoreArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecRestoreArray(zz, &z));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(PetscLogEventEnd(event, A, xx, zz, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+#else
+  PetscFunctionBegin;
+  SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "SIMD MatMult() kernels are not available in this build");
+#endif
+}
+
+/*
+   MatMultTransposeAdd_SeqAIJ_SIMD - computes yy += A^T xx with the SIMD kernel selected for A
+*/
+PetscErrorCode MatMultTransposeAdd_SeqAIJ_SIMD(Mat A, Vec xx, Vec yy)
+{
+#if defined(PETSC_SEQAIJ_SIMD_DISPATCH)
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y;
+  const MatScalar   *aa;
+  const PetscInt    *ii = a->i, *ridx = NULL;
+  PetscInt           m     = A->rmap->n;
+  PetscLogEvent      event = a->simd == MAT_SEQAIJ_SIMD_AVX512 ? MAT_MultAVX512 : MAT_MultAVX2;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(event, A, xx, yy, 0));
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArray(yy, &y));
+  if (a->compressedrow.use) {
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (a->simd == MAT_SEQAIJ_SIMD_AVX512) MatMultTransposeAddKernel_SeqAIJ_AVX512(m, ii, ridx, a->j, aa, x, y);
+  else MatMultTransposeAddKernel_SeqAIJ_AVX2(m, ii, ridx, a->j, aa, x, y);
+  PetscCall(PetscLogFlops(2.0 * a->nz));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArray(yy, &y));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(PetscLogEventEnd(event, A, xx, yy, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+#else
+  PetscFunctionBegin;
+  SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "SIMD MatMultTranspose() kernels are not available in this build");
+#endif
+}
+
+PetscErrorCode MatView_SeqAIJ_SIMD(Mat A, PetscViewer viewer)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ *)A->data;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  if (a->simd == MAT_SEQAIJ_SIMD_NONE) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) {
+    PetscCall(PetscViewerGetFormat(viewer, &format));
+    if (format == PETSC_VIEWER_ASCII_INFO_DETAIL || format == PETSC_VIEWER_ASCII_INFO) PetscCall(PetscViewerASCIIPrintf(viewer, "using %s SIMD kernels for MatMult()%s\n", MatSeqAIJSIMDTypes[a->simd], a->simdforced ? "" : " when I-nodes are not used"));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   MatCreate_SeqAIJ_SIMD - processes -mat_seqaij_simd for a new MATSEQAIJ matrix
+
+   With auto the widest instruction set supported by the CPU is used, but the I-node kernels keep precedence
+   for matrices with I-nodes; naming an instruction set explicitly uses it for all matrices.
+*/
+PetscErrorCode MatCreate_SeqAIJ_SIMD(Mat B)
+{
+  Mat_SeqAIJ        *b         = (Mat_SeqAIJ *)B->data;
+  const char *const  choices[] = {"none", "auto", "avx2", "avx512"};
+  PetscInt           choice    = 0;
+
+  PetscFunctionBegin;
+  b->simd       = MAT_SEQAIJ_SIMD_NONE;
+  b->simdforced = PETSC_FALSE;
+  PetscOptionsBegin(PetscObjectComm((PetscObject)B), ((PetscObject)B)->prefix, "Options for SEQAIJ matrix", "Mat");
+  PetscCall(PetscOptionsEList("-mat_seqaij_simd", "SIMD instruction set used by the MatMult() kernels", "MATSEQAIJ", choices, PETSC_STATIC_ARRAY_LENGTH(choices), choices[choice], &choice, NULL));
+  PetscOptionsEnd();
+  if (!choice) PetscFunctionReturn(PETSC_SUCCESS);
+#if defined(PETSC_SEQAIJ_SIMD_DISPATCH)
+  if (choice == 1) {
+    if (MatSeqAIJSIMDSupported_Private(MAT_SEQAIJ_SIMD_AVX512)) b->simd = MAT_SEQAIJ_SIMD_AVX512;
+    else if (MatSeqAIJSIMDSupported_Private(MAT_SEQAIJ_SIMD_AVX2)) b->simd = MAT_SEQAIJ_SIMD_AVX2;
+  } else {
+    b->simd       = choice == 2 ? MAT_SEQAIJ_SIMD_AVX2 : MAT_SEQAIJ_SIMD_AVX512;
+    b->simdforced = PETSC_TRUE;
+    PetscCheck(MatSeqAIJSIMDSupported_Private(b->simd), PETSC_COMM_SELF, PETSC_ERR_SUP, "The CPU does not support the %s instructions requested with -mat_seqaij_simd", choices[choice]);
+  }
+  if (b->simd) PetscCall(PetscInfo(B, "Using %s SIMD kernels for MatMult()\n", MatSeqAIJSIMDTypes[b->simd]));
+  else PetscCall(PetscInfo(B, "The CPU supports none of the SIMD kernels for MatMult()\n"));
+#else
+  PetscCheck(choice == 1, PETSC_COMM_SELF, PETSC_ERR_SUP, "SIMD kernels requested with -mat_seqaij_simd %s are not available in this build", choices[choice]);
+  PetscCall(PetscInfo(B, "SIMD kernels for MatMult() are not available in this build\n"));
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,555 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class, but keeps a single precision "shadow" copy
+  of the matrix values (and optionally 16-bit column index deltas), in addition to the double
+  precision values, that is used by the products and MatSOR(). All arithmetic is still done in
+  double precision.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat, MatFactorType, Mat *);
+
+typedef struct {
+  float           *a;                /* single precision copy of the values */
+  unsigned short  *jd;               /* jd[k] = j[k] - j[k-1] inside a row (0 for the first entry), NULL if not compressed */
+  PetscInt        *jfirst;           /* first column of each row, used together with jd */
+  PetscInt         nz;               /* allocated length of a and jd */
+  PetscBool        compress_indices; /* try to store the column indices as 16-bit deltas */
+  PetscBool        eager_shadow;
+  PetscBool        built;
+  PetscObjectState state; /* State of the matrix when shadow copy was last constructed. */
+} Mat_SeqAIJSingle;
+
+static PetscErrorCode MatSeqAIJSingleFree_Private(Mat_SeqAIJSingle *aijsingle)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree(aijsingle->a));
+  PetscCall(PetscFree2(aijsingle->jd, aijsingle->jfirst));
+  aijsingle->nz    = 0;
+  aijsingle->built = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  /* This routine is only called to convert a MATSEQAIJSINGLE to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  Mat               B         = *newmat;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+  B->ops->sor              = MatSOR_SeqAIJ;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijsingle_seqaij_C", NULL));
+
+  if (reuse == MAT_INITIAL_MATRIX) aijsingle = (Mat_SeqAIJSingle *)B->spptr;
+
+  /* Clean up the Mat_SeqAIJSingle data structure. */
+  PetscCall(MatSeqAIJSingleFree_Private(aijsingle));
+  PetscCall(PetscFree(B->spptr));
+
+  /* Change the type of B to MATSEQAIJ. */
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
+
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJSingle matrix will not have an spptr pointer. */
+  if (aijsingle) {
+    PetscCall(MatSeqAIJSingleFree_Private(aijsingle));
+    PetscCall(PetscFree(A->spptr));
+  }
+  PetscCall(PetscObjectChangeTypeName((PetscObject)A, MATSEQAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsingle_seqaij_C", NULL));
+  PetscCall(MatDestroy_SeqAIJ(A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Build or update the single precision shadow copy if and only if needed.
+ * We track the ObjectState to determine when this needs to be done. */
+static PetscErrorCode MatSeqAIJSingleBuildShadow_Private(Mat A)
+{
+  Mat_SeqAIJ       *a         = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+  PetscInt          m = A->rmap->n, nz = a->i[m], i, k;
+  const PetscInt   *ai = a->i, *aj = a->j;
+  const MatScalar  *aa;
+  PetscObjectState  state;
+  PetscBool         fits = aijsingle->compress_indices;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (aijsingle->built && aijsingle->state == state) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscLogEventBegin(MAT_Convert, A, 0, 0, 0));
+  if (aijsingle->nz < nz || (fits && !aijsingle->jd)) {
+    PetscCall(MatSeqAIJSingleFree_Private(aijsingle));
+    PetscCall(PetscMalloc1(nz, &aijsingle->a));
+    if (fits) PetscCall(PetscMalloc2(nz, &aijsingle->jd, m, &aijsingle->jfirst));
+    aijsingle->nz = nz;
+  }
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  for (k = 0; k < nz; k++) aijsingle->a[k] = (float)PetscRealPart(aa[k]);
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+
+  /* the deltas can only be stored if the columns of every row are increasing with gaps below 2^16 */
+  for (i = 0; fits && i < m; i++) {
+    aijsingle->jfirst[i] = ai[i] < ai[i + 1] ? aj[ai[i]] : 0;
+    if (ai[i] < ai[i + 1]) aijsingle->jd[ai[i]] = 0;
+    for (k = ai[i] + 1; k < ai[i + 1]; k++) {
+      PetscInt d = aj[k] - aj[k - 1];
+
+      if (d < 0 || d > USHRT_MAX) {
+        fits = PETSC_FALSE;
+        break;
+      }
+      aijsingle->jd[k] = (unsigned short)d;
+    }
+  }
+  if (aijsingle->compress_indices && !fits) {
+    PetscCall(PetscInfo(A, "Column indices cannot be stored as 16-bit deltas, using the full indices\n"));
+    PetscCall(PetscFree2(aijsingle->jd, aijsingle->jfirst));
+  }
+  PetscCall(PetscLogEventEnd(MAT_Convert, A, 0, 0, 0));
+
+  /* Record the ObjectState so that we can tell when the shadow copy needs updating */
+  PetscCall(PetscObjectStateGet((PetscObject)A, &aijsingle->state));
+  aijsingle->built = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Sum of v[k] x[col(k)] for start <= k < end; with compressed indices col0 is the column of entry start - 1,
+   or the first column of the row when start is the first entry of the row */
+static inline PetscScalar MatSeqAIJSingleDot_Private(const Mat_SeqAIJSingle *aijsingle, const PetscInt *aj, PetscInt start, PetscInt end, PetscInt col0, const PetscScalar *x)
+{
+  const float *v   = aijsingle->a;
+  PetscScalar  sum = 0.0;
+
+  if (aijsingle->jd) {
+    for (PetscInt k = start; k < end; k++) {
+      col0 += aijsingle->jd[k];
+      sum += (PetscScalar)v[k] * x[col0];
+    }
+  } else {
+    for (PetscInt k = start; k < end; k++) sum += (PetscScalar)v[k] * x[aj[k]];
+  }
+  return sum;
+}
+
+#define MatSeqAIJSingleRowStart(aijsingle, i) ((aijsingle)->jd ? (aijsingle)->jfirst[i] : 0)
+
+static PetscErrorCode MatDuplicate_SeqAIJSingle(Mat A, MatDuplicateOption op, Mat *M)
+{
+  Mat_SeqAIJSingle *aijsingle;
+  Mat_SeqAIJSingle *aijsingle_dest;
+
+  PetscFunctionBegin;
+  PetscCall(MatDuplicate_SeqAIJ(A, op, M));
+  aijsingle      = (Mat_SeqAIJSingle *)A->spptr;
+  aijsingle_dest = (Mat_SeqAIJSingle *)(*M)->spptr;
+  PetscCall(PetscArraycpy(aijsingle_dest, aijsingle, 1));
+  /* We don't duplicate the shadow copy -- that will be constructed as needed. */
+  aijsingle_dest->a      = NULL;
+  aijsingle_dest->jd     = NULL;
+  aijsingle_dest->jfirst = NULL;
+  aijsingle_dest->nz     = 0;
+  aijsingle_dest->built  = PETSC_FALSE;
+  if (aijsingle->eager_shadow) PetscCall(MatSeqAIJSingleBuildShadow_Private(*M));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A, MatAssemblyType mode)
+{
+  Mat_SeqAIJ       *a         = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(PETSC_SUCCESS);
+
+  /* The inode routines work on the double precision values, so disable them */
+  a->inode.use = PETSC_FALSE;
+  PetscCall(MatAssemblyEnd_SeqAIJ(A, mode));
+  if (aijsingle->eager_shadow) PetscCall(MatSeqAIJSingleBuildShadow_Private(A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* zz = yy + A xx, yy may be NULL */
+static PetscErrorCode MatMultAdd_SeqAIJSingle_Private(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqAIJ        *a         = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+  const PetscInt    *ai = a->i, *aj = a->j, m = A->rmap->n;
+  const PetscScalar *x;
+  PetscScalar       *y = NULL, *z;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleBuildShadow_Private(A));
+  PetscCall(VecGetArrayRead(xx, &x));
+  if (yy) PetscCall(VecGetArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecGetArrayWrite(zz, &z));
+  for (PetscInt i = 0; i < m; i++) {
+    PetscScalar sum = MatSeqAIJSingleDot_Private(aijsingle, aj, ai[i], ai[i + 1], MatSeqAIJSingleRowStart(aijsingle, i), x);
+
+    z[i] = y ? y[i] + sum : sum;
+  }
+  PetscCall(PetscLogFlops(yy ? 2.0 * a->nz : 2.0 * a->nz - a->nonzerorowcnt));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  if (yy) PetscCall(VecRestoreArrayPair(yy, zz, &y, &z));
+  else PetscCall(VecRestoreArrayWrite(zz, &z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMult_SeqAIJSingle(Mat A, Vec xx, Vec yy)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultAdd_SeqAIJSingle_Private(A, xx, NULL, yy));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultAdd_SeqAIJSingle_Private(A, xx, yy, zz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultTransposeAdd_SeqAIJSingle(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqAIJ        *a         = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+  const PetscInt    *ai = a->i, *aj = a->j, m = A->rmap->n;
+  const float       *v;
+  const PetscScalar *x;
+  PetscScalar       *z;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleBuildShadow_Private(A));
+  if (yy) {
+    if (zz != yy) PetscCall(VecCopy(yy, zz));
+  } else PetscCall(VecSet(zz, 0.0));
+  v = aijsingle->a;
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArray(zz, &z));
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscScalar alpha = x[i];
+
+    if (aijsingle->jd) {
+      PetscInt col = aijsingle->jfirst[i];
+
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+        col += aijsingle->jd[k];
+        z[col] += (PetscScalar)v[k] * alpha;
+      }
+    } else {
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++) z[aj[k]] += (PetscScalar)v[k] * alpha;
+    }
+  }
+  PetscCall(PetscLogFlops(2.0 * a->nz));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArray(zz, &z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultTranspose_SeqAIJSingle(Mat A, Vec xx, Vec yy)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultTransposeAdd_SeqAIJSingle(A, xx, NULL, yy));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Same sweeps as MatSOR_SeqAIJ() with the off-diagonal entries taken from the single precision copy;
+   the (inverted) diagonal is kept in double precision. Eisenstat and SOR_APPLY_UPPER use MatSOR_SeqAIJ().
+*/
+static PetscErrorCode MatSOR_SeqAIJSingle(Mat A, Vec bb, PetscReal omega, MatSORType flag, PetscReal fshift, PetscInt its, PetscInt lits, Vec xx)
+{
+  Mat_SeqAIJ        *a         = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle *)A->spptr;
+  PetscScalar       *x, sum, *t;
+  const MatScalar   *idiag;
+  const PetscScalar *b, *xb;
+  PetscInt           m = A->rmap->n, i;
+  const PetscInt    *ai = a->i, *aj = a->j, *diag;
+
+  PetscFunctionBegin;
+  if (flag == SOR_APPLY_UPPER || flag & SOR_EISENSTAT) {
+    PetscCall(MatSOR_SeqAIJ(A, bb, omega, flag, fshift, its, lits, xx));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCheck(flag != SOR_APPLY_LOWER, PETSC_COMM_SELF, PETSC_ERR_SUP, "SOR_APPLY_LOWER is not implemented");
+  its = its * lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) PetscCall(MatInvertDiagonal_SeqAIJ(A, omega, fshift));
+  a->fshift = fshift;
+  a->omega  = omega;
+  PetscCall(MatSeqAIJSingleBuildShadow_Private(A));
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+
+  PetscCall(VecGetArray(xx, &x));
+  PetscCall(VecGetArrayRead(bb, &b));
+  /* the column of the diagonal entry of row i is i, which is where the deltas of the upper triangular part start from */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i = 0; i < m; i++) {
+        sum  = b[i] - MatSeqAIJSingleDot_Private(aijsingle, aj, ai[i], diag[i], MatSeqAIJSingleRowStart(aijsingle, i), x);
+        t[i] = sum;
+        x[i] = sum * idiag[i];
+      }
+      xb = t;
+      PetscCall(PetscLogFlops(a->nz));
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i = m - 1; i >= 0; i--) {
+        sum = xb[i] - MatSeqAIJSingleDot_Private(aijsingle, aj, diag[i] + 1, ai[i + 1], i, x);
+        if (xb == b) {
+          x[i] = sum * idiag[i];
+        } else {
+          x[i] = (1 - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+        }
+      }
+      PetscCall(PetscLogFlops(a->nz)); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i = 0; i < m; i++) {
+        sum  = b[i] - MatSeqAIJSingleDot_Private(aijsingle, aj, ai[i], diag[i], MatSeqAIJSingleRowStart(aijsingle, i), x);
+        t[i] = sum; /* save application of the lower-triangular part */
+        sum -= MatSeqAIJSingleDot_Private(aijsingle, aj, diag[i] + 1, ai[i + 1], i, x);
+        x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+      }
+      xb = t;
+      PetscCall(PetscLogFlops(2.0 * a->nz));
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i = m - 1; i >= 0; i--) {
+        if (xb == b) {
+          /* whole matrix (no checkpointing available), skipping the single precision diagonal entry */
+          sum = b[i] - MatSeqAIJSingleDot_Private(aijsingle, aj, ai[i], diag[i], MatSeqAIJSingleRowStart(aijsingle, i), x);
+          sum -= MatSeqAIJSingleDot_Private(aijsingle, aj, diag[i] + 1, ai[i + 1], i, x);
+          x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          sum  = xb[i] - MatSeqAIJSingleDot_Private(aijsingle, aj, diag[i] + 1, ai[i + 1], i, x);
+          x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        PetscCall(PetscLogFlops(2.0 * a->nz));
+      } else {
+        PetscCall(PetscLogFlops(a->nz)); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  PetscCall(VecRestoreArray(xx, &x));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Factors of MATSEQAIJSINGLE matrices are ordinary MATSEQAIJ factors computed in double precision;
+   after each numeric factorization the factor values are copied to single precision and MatSolve()
+   uses that copy, see Mat_SeqAIJSingleFactor. Factors in the old (in place) storage, and factors with other solves such
+   as the level scheduled one of -mat_seqaij_solve_levels, keep their double precision solves and report it with -info.
+*/
+static PetscErrorCode MatLUFactorNumeric_SeqAIJSingle(Mat B, Mat A, const MatFactorInfo *info)
+{
+  Mat_SeqAIJSingleFactor *fs;
+  PetscInt                nz;
+  float                  *fa;
+  const MatScalar        *ba;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleFactorGet_Private(B, &fs));
+  PetscCall((*fs->lufactornumeric)(B, A, info));
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  if (B->ops->solve == MatSolve_SeqAIJSingle) PetscFunctionReturn(PETSC_SUCCESS); /* factored in single precision, -pc_factor_mat_single_precision */
+  if (B->ops->solve != MatSolve_SeqAIJ && B->ops->solve != MatSolve_SeqAIJ_NaturalOrdering && B->ops->solve != MatSolve_SeqAIJ_Inode) {
+    PetscCall(PetscInfo(B, "Keeping the double precision values of the factor, its MatSolve() has no single precision version\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  PetscCall(MatSeqAIJSingleFactorGetArray_Private(B, &fa));
+  nz = B->rmap->n ? ((Mat_SeqAIJ *)B->data)->diag[0] + 1 : 0;
+  PetscCall(MatSeqAIJGetArrayRead(B, &ba));
+  for (PetscInt k = 0; k < nz; k++) fa[k] = (float)PetscRealPart(ba[k]);
+  PetscCall(MatSeqAIJRestoreArrayRead(B, &ba));
+  B->ops->solve = MatSolve_SeqAIJSingle;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Called after the symbolic factorization has selected the numeric factorization routine */
+static PetscErrorCode MatSeqAIJSingleFactorSetUp_Private(Mat B)
+{
+  Mat_SeqAIJSingleFactor *fs;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleFactorGet_Private(B, &fs));
+  fs->lufactornumeric     = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_SeqAIJSingle(Mat B, Mat A, IS isrow, IS iscol, const MatFactorInfo *info)
+{
+  PetscFunctionBegin;
+  PetscCall(MatLUFactorSymbolic_SeqAIJ(B, A, isrow, iscol, info));
+  PetscCall(MatSeqAIJSingleFactorSetUp_Private(B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJSingle(Mat B, Mat A, IS isrow, IS iscol, const MatFactorInfo *info)
+{
+  PetscFunctionBegin;
+  PetscCall(MatILUFactorSymbolic_SeqAIJ(B, A, isrow, iscol, info));
+  PetscCall(MatSeqAIJSingleFactorSetUp_Private(B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijsingle_petsc(Mat A, MatFactorType ftype, Mat *B)
+{
+  PetscFunctionBegin;
+  PetscCall(MatGetFactor_seqaij_petsc(A, ftype, B));
+  if (ftype == MAT_FACTOR_LU) (*B)->ops->lufactorsymbolic = MatLUFactorSymbolic_SeqAIJSingle;
+  if (ftype == MAT_FACTOR_ILU) (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJSingle;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a
+ * SeqAIJSingle matrix.  This routine is called by the MatCreate_SeqAIJSingle()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJSingle one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat               B = *newmat;
+  Mat_SeqAIJ       *b;
+  Mat_SeqAIJSingle *aijsingle;
+  PetscBool         sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, type, &sametype));
+  if (sametype) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscNew(&aijsingle));
+  b        = (Mat_SeqAIJ *)B->data;
+  B->spptr = (void *)aijsingle;
+
+  /* Disable use of the inode routines so that the AIJSINGLE ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJSingle as well, but the assembly end may not be called, so set it here, too. */
+  b->inode.use = PETSC_FALSE;
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJSingle;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy     = MatDestroy_SeqAIJSingle;
+
+  /* Parse command line options. */
+  PetscOptionsBegin(PetscObjectComm((PetscObject)A), ((PetscObject)A)->prefix, "AIJSINGLE Options", "Mat");
+  PetscCall(PetscOptionsBool("-mat_aijsingle_eager_shadow", "Eager Shadowing", "None", aijsingle->eager_shadow, &aijsingle->eager_shadow, NULL));
+  PetscCall(PetscOptionsBool("-mat_aijsingle_compress_indices", "Store the column indices as 16-bit deltas", "None", aijsingle->compress_indices, &aijsingle->compress_indices, NULL));
+  PetscOptionsEnd();
+
+  /* If A has already been assembled and eager shadowing is specified, build the shadow copy. */
+  if (A->assembled && aijsingle->eager_shadow) PetscCall(MatSeqAIJSingleBuildShadow_Private(B));
+
+  B->ops->mult             = MatMult_SeqAIJSingle;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJSingle;
+  B->ops->multadd          = MatMultAdd_SeqAIJSingle;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJSingle;
+  B->ops->sor              = MatSOR_SeqAIJSingle;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijsingle_seqaij_C", MatConvert_SeqAIJSingle_SeqAIJ));
+
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJSINGLE));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@C
+  MatCreateSeqAIJSingle - Creates a sparse matrix of type `MATSEQAIJSINGLE`.
+
+  Collective
+
+  Input Parameters:
++ comm - MPI communicator, set to `PETSC_COMM_SELF`
+. m    - number of rows
+. n    - number of columns
+. nz   - number of nonzeros per row (same for all rows)
+- nnz  - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or `NULL`
+
+  Output Parameter:
+. A - the matrix
+
+  Options Database Keys:
++ -mat_aijsingle_eager_shadow     - Construct the single precision copy upon matrix assembly; default is to take a "lazy" approach,
+                                    performing this step the first time the matrix is applied
+- -mat_aijsingle_compress_indices - Also store the column indices as 16-bit differences between consecutive columns of a row,
+                                    if all the differences fit
+
+  Level: intermediate
+
+  Notes:
+  This type inherits from AIJ and is largely identical, but keeps a single precision "shadow" copy of the
+  matrix values that is used by `MatMult()`, `MatMultTranspose()`, `MatMultAdd()`, `MatMultTransposeAdd()`
+  and `MatSOR()`. The products are accumulated and the vectors are kept in double precision, only the
+  matrix entries are rounded. `MatSOR()` uses the double precision diagonal.
+
+  The double precision values are kept as well, for the other operations and the factorizations, so the
+  matrix uses 4 more bytes per nonzero than a `MATSEQAIJ` matrix (and 2 more with `-mat_aijsingle_compress_indices`),
+  it does not save memory.
+
+  LU and ILU factors of a `MATSEQAIJSINGLE` matrix obtained with `MATSOLVERPETSC` are computed in double
+  precision and then stored in single precision for `MatSolve()`. Cholesky and ICC factors are computed,
+  stored and applied in double precision.
+
+  Since the operator is only accurate to single precision this type is meant for the matrix used to build
+  preconditioners, for example the `Pmat` of `KSPSetOperators()`, the smoothers of `PCMG` or the blocks of
+  `PCBJACOBI`, while the Krylov method is applied to the double precision `MATAIJ` operator.
+
+  If `nnz` is given then `nz` is ignored
+
+  Because `MATSEQAIJSINGLE` is a subtype of `MATSEQAIJ`, the option `-mat_seqaij_type seqaijsingle` can be used to make
+  sequential `MATSEQAIJ` matrices default to being instances of `MATSEQAIJSINGLE`.
+
+.seealso: [](ch_matrices), `Mat`, `MatCreate()`, `MatCreateMPIAIJSingle()`, `MatSetValues()`, `MATSEQAIJSELL`
+@*/
+PetscErrorCode MatCreateSeqAIJSingle(MPI_Comm comm, PetscInt m, PetscInt n, PetscInt nz, const PetscInt nnz[], Mat *A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatCreate(comm, A));
+  PetscCall(MatSetSizes(*A, m, n, m, n));
+  PetscCall(MatSetType(*A, MATSEQAIJSINGLE));
+  PetscCall(MatSeqAIJSetPreallocation_SeqAIJ(*A, nz, nnz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSetType(A, MATSEQAIJ));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(A, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
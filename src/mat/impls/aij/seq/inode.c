@@ -1956,6 +1956,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat B, Mat A, const MatFactorInfo
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  PetscCall(MatSeqAIJFactorSetSolveLevels_Private(C));
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -2799,6 +2800,7 @@ PetscErrorCode MatSolve_SeqAIJ_Inode(Mat A, Vec bb, Vec xx)
   PetscCall(VecRestoreArrayRead(bb, &b));
   PetscCall(VecRestoreArrayWrite(xx, &x));
   PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n));
+  PetscCall(MatSeqAIJLogBytes_Private(A, 4.0 * A->rmap->n));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -4323,11 +4325,14 @@ static PetscErrorCode MatSeqAIJ_Inode_ResetOps(Mat A)
 PetscErrorCode MatSeqAIJCheckInode(Mat A)
 {
   Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
-  PetscInt        i, j, m, nzx, nzy, *ns, node_count, blk_size;
-  PetscBool       flag;
-  const PetscInt *idx, *idy, *ii;
+  PetscInt        i, j, m, *ns, node_count, blk_size;
+  PetscBool      *same, threaded = PETSC_FALSE;
+  const PetscInt *idx, *ii;
 
   PetscFunctionBegin;
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  threaded = (PetscBool)(PetscNumOMPThreads > 1);
+#endif
   if (!a->inode.use) {
     PetscCall(MatSeqAIJ_Inode_ResetOps(A));
     PetscCall(PetscFree(a->inode.size_csr));
@@ -4340,11 +4345,15 @@ PetscErrorCode MatSeqAIJCheckInode(Mat A)
   ns    = a->inode.size_csr;
   ns[0] = 0;
 
-  i          = 0;
   node_count = 0;
   idx        = a->j;
   ii         = a->i;
-  if (idx) {
+  if (idx && !threaded) {
+    const PetscInt *idy;
+    PetscInt        nzx, nzy;
+    PetscBool       flag;
+
+    i = 0;
     while (i < m) {            /* For each row */
       nzx = ii[i + 1] - ii[i]; /* Number of nonzeros */
       /* Limits the number of elements in a node to 'a->inode.limit' */
@@ -4360,6 +4369,24 @@ PetscErrorCode MatSeqAIJCheckInode(Mat A)
       idx += blk_size * nzx;
       i = j;
     }
+  } else if (idx) {
+    /* with OpenMP kernels first compare each row with the previous one, which is independent for all rows */
+    PetscCall(PetscMalloc1(m, &same));
+    if (m) same[0] = PETSC_FALSE;
+    PetscPragmaUseOMPKernels(parallel for)
+    for (PetscInt r = 1; r < m; r++) {
+      const PetscInt nz = ii[r + 1] - ii[r];
+
+      same[r] = (PetscBool)(nz == ii[r] - ii[r - 1]);
+      for (PetscInt k = 0; k < nz && same[r]; k++) same[r] = (PetscBool)(idx[ii[r] + k] == idx[ii[r - 1] + k]);
+    }
+    /* then group consecutive identical rows, limiting the number of rows in a node to 'a->inode.limit' */
+    for (i = 0; i < m; i = j) {
+      for (j = i + 1, blk_size = 1; j < m && blk_size < a->inode.limit && same[j]; ++j) blk_size++;
+      ns[node_count + 1] = ns[node_count] + blk_size;
+      node_count++;
+    }
+    PetscCall(PetscFree(same));
   }
   /* If not enough inodes found,, do not use inode version of the routines */
   if (!m || !idx || node_count > .8 * m) {
@@ -1485,26 +1485,95 @@ PetscErrorCode MatTransposeMatMultNumeric_SeqAIJ_SeqAIJ(Mat A, Mat B, Mat C)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* product data of MatMatMultSymbolic_SeqAIJ_SeqDense(), the work array of MatMatMultNumericAdd_SeqAIJ_SeqDense() kept between numeric products */
+typedef struct {
+  PetscScalar *work;
+  PetscInt     nwork;
+} MatMatMult_SeqAIJ_SeqDense;
+
+static PetscErrorCode MatDestroy_SeqAIJ_SeqDense_MatMatMult(void *data)
+{
+  MatMatMult_SeqAIJ_SeqDense *mm = (MatMatMult_SeqAIJ_SeqDense *)data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(mm->work));
+  PetscCall(PetscFree(mm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqDense(Mat A, Mat B, PetscReal fill, Mat C)
 {
+  MatMatMult_SeqAIJ_SeqDense *mm;
+
   PetscFunctionBegin;
   PetscCall(MatMatMultSymbolic_SeqDense_SeqDense(A, B, 0.0, C));
   C->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqDense;
+  /* C is not always the result of a MatProduct, for example in MatRARt() */
+  if (C->product && !C->product->data) {
+    PetscCall(PetscNew(&mm));
+    C->product->data    = mm;
+    C->product->destroy = MatDestroy_SeqAIJ_SeqDense_MatMatMult;
+  }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PETSC_INTERN PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A, Mat B, Mat C, const PetscBool add)
+/*
+   C(:,col:col+K) (+)= A B(:,col:col+K) for a block of K columns of B packed by rows in bp[], so that the K
+   products of each nonzero of A are done with contiguous loads and each row of A is traversed once per block
+*/
+#define MatMatMultKernel_SeqAIJ_SeqDense(K) \
+  static void MatMatMultKernel_SeqAIJ_SeqDense_##K(PetscInt am, const PetscInt *ai, const PetscInt *aj, const PetscScalar *av, const PetscScalar *bp, PetscScalar *c, PetscInt clda, PetscBool add) \
+  { \
+    for (PetscInt i = 0; i < am; i++) { \
+      PetscScalar r[K]; \
+\
+      for (PetscInt k = 0; k < K; k++) r[k] = 0.0; \
+      for (PetscInt j = ai[i]; j < ai[i + 1]; j++) { \
+        const PetscScalar  aa = av[j]; \
+        const PetscScalar *b  = bp + aj[j] * K; \
+\
+        PetscPragmaSIMD \
+        for (PetscInt k = 0; k < K; k++) r[k] += aa * b[k]; \
+      } \
+      if (add) { \
+        for (PetscInt k = 0; k < K; k++) c[i + k * clda] += r[k]; \
+      } else { \
+        for (PetscInt k = 0; k < K; k++) c[i + k * clda] = r[k]; \
+      } \
+    } \
+  }
+
+MatMatMultKernel_SeqAIJ_SeqDense(1)
+MatMatMultKernel_SeqAIJ_SeqDense(2)
+MatMatMultKernel_SeqAIJ_SeqDense(3)
+MatMatMultKernel_SeqAIJ_SeqDense(4)
+MatMatMultKernel_SeqAIJ_SeqDense(8)
+MatMatMultKernel_SeqAIJ_SeqDense(16)
+MatMatMultKernel_SeqAIJ_SeqDense(32)
+
+/*
+   C (+)= A B. The work array *work of size *nwork holds the packed blocks of columns of B, it is enlarged as needed and kept by the
+   caller between products; with NULL work and nwork a work array is allocated for this call only
+*/
+PETSC_INTERN PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A, Mat B, Mat C, PetscScalar **work, PetscInt *nwork, const PetscBool add)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
-  PetscScalar       *c, r1, r2, r3, r4, *c1, *c2, *c3, *c4;
-  const PetscScalar *aa, *b, *b1, *b2, *b3, *b4, *av;
-  const PetscInt    *aj;
-  PetscInt           cm = C->rmap->n, cn = B->cmap->n, bm, am = A->rmap->n;
-  PetscInt           clda;
-  PetscInt           am4, bm4, col, i, j, n;
+  PetscScalar       *c, *bp = NULL;
+  const PetscScalar *b, *av;
+  PetscInt           cm = C->rmap->n, cn = B->cmap->n, bm, am = A->rmap->n, an = A->cmap->n;
+  PetscInt           clda, col, kb, nbp;
 
   PetscFunctionBegin;
   if (!cm || !cn) PetscFunctionReturn(PETSC_SUCCESS);
+  nbp = an * PetscMin(cn, 32);
+  if (work) {
+    if (*nwork < nbp) {
+      PetscCall(PetscFree(*work));
+      PetscCall(PetscMalloc1(nbp, work));
+      *nwork = nbp;
+    }
+    bp = *work;
+  } else PetscCall(PetscMalloc1(nbp, &bp));
   PetscCall(MatSeqAIJGetArrayRead(A, &av));
   if (add) {
     PetscCall(MatDenseGetArray(C, &c));
@@ -1514,114 +1583,40 @@ PETSC_INTERN PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A, Mat B, M
   PetscCall(MatDenseGetArrayRead(B, &b));
   PetscCall(MatDenseGetLDA(B, &bm));
   PetscCall(MatDenseGetLDA(C, &clda));
-  am4 = 4 * clda;
-  bm4 = 4 * bm;
-  if (b) {
-    b1 = b;
-    b2 = b1 + bm;
-    b3 = b2 + bm;
-    b4 = b3 + bm;
-  } else b1 = b2 = b3 = b4 = NULL;
-  c1 = c;
-  c2 = c1 + clda;
-  c3 = c2 + clda;
-  c4 = c3 + clda;
-  for (col = 0; col < (cn / 4) * 4; col += 4) { /* over columns of C */
-    for (i = 0; i < am; i++) {                  /* over rows of A in those columns */
-      r1 = r2 = r3 = r4 = 0.0;
-      n                 = a->i[i + 1] - a->i[i];
-      aj                = PetscSafePointerPlusOffset(a->j, a->i[i]);
-      aa                = PetscSafePointerPlusOffset(av, a->i[i]);
-      for (j = 0; j < n; j++) {
-        const PetscScalar aatmp = aa[j];
-        const PetscInt    ajtmp = aj[j];
-        r1 += aatmp * b1[ajtmp];
-        r2 += aatmp * b2[ajtmp];
-        r3 += aatmp * b3[ajtmp];
-        r4 += aatmp * b4[ajtmp];
-      }
-      if (add) {
-        c1[i] += r1;
-        c2[i] += r2;
-        c3[i] += r3;
-        c4[i] += r4;
-      } else {
-        c1[i] = r1;
-        c2[i] = r2;
-        c3[i] = r3;
-        c4[i] = r4;
-      }
-    }
-    if (b) {
-      b1 += bm4;
-      b2 += bm4;
-      b3 += bm4;
-      b4 += bm4;
-    }
-    c1 += am4;
-    c2 += am4;
-    c3 += am4;
-    c4 += am4;
-  }
-  /* process remaining columns */
-  if (col != cn) {
+  /* process the columns of C in blocks of 32, 16, 8, 4 and then the 1 to 3 remaining ones */
+  for (col = 0; col < cn; col += kb) {
     PetscInt rc = cn - col;
 
-    if (rc == 1) {
-      for (i = 0; i < am; i++) {
-        r1 = 0.0;
-        n  = a->i[i + 1] - a->i[i];
-        aj = PetscSafePointerPlusOffset(a->j, a->i[i]);
-        aa = PetscSafePointerPlusOffset(av, a->i[i]);
-        for (j = 0; j < n; j++) r1 += aa[j] * b1[aj[j]];
-        if (add) c1[i] += r1;
-        else c1[i] = r1;
-      }
-    } else if (rc == 2) {
-      for (i = 0; i < am; i++) {
-        r1 = r2 = 0.0;
-        n       = a->i[i + 1] - a->i[i];
-        aj      = PetscSafePointerPlusOffset(a->j, a->i[i]);
-        aa      = PetscSafePointerPlusOffset(av, a->i[i]);
-        for (j = 0; j < n; j++) {
-          const PetscScalar aatmp = aa[j];
-          const PetscInt    ajtmp = aj[j];
-          r1 += aatmp * b1[ajtmp];
-          r2 += aatmp * b2[ajtmp];
-        }
-        if (add) {
-          c1[i] += r1;
-          c2[i] += r2;
-        } else {
-          c1[i] = r1;
-          c2[i] = r2;
-        }
-      }
-    } else {
-      for (i = 0; i < am; i++) {
-        r1 = r2 = r3 = 0.0;
-        n            = a->i[i + 1] - a->i[i];
-        aj           = PetscSafePointerPlusOffset(a->j, a->i[i]);
-        aa           = PetscSafePointerPlusOffset(av, a->i[i]);
-        for (j = 0; j < n; j++) {
-          const PetscScalar aatmp = aa[j];
-          const PetscInt    ajtmp = aj[j];
-          r1 += aatmp * b1[ajtmp];
-          r2 += aatmp * b2[ajtmp];
-          r3 += aatmp * b3[ajtmp];
-        }
-        if (add) {
-          c1[i] += r1;
-          c2[i] += r2;
-          c3[i] += r3;
-        } else {
-          c1[i] = r1;
-          c2[i] = r2;
-          c3[i] = r3;
-        }
-      }
+    kb = rc >= 32 ? 32 : (rc >= 16 ? 16 : (rc >= 8 ? 8 : (rc >= 4 ? 4 : rc)));
+    for (PetscInt k = 0; k < kb; k++) {
+      const PetscScalar *bk = PetscSafePointerPlusOffset(b, (col + k) * bm);
+
+      for (PetscInt j = 0; j < an; j++) bp[j * kb + k] = bk[j];
+    }
+    switch (kb) {
+    case 32:
+      MatMatMultKernel_SeqAIJ_SeqDense_32(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    case 16:
+      MatMatMultKernel_SeqAIJ_SeqDense_16(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    case 8:
+      MatMatMultKernel_SeqAIJ_SeqDense_8(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    case 4:
+      MatMatMultKernel_SeqAIJ_SeqDense_4(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    case 3:
+      MatMatMultKernel_SeqAIJ_SeqDense_3(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    case 2:
+      MatMatMultKernel_SeqAIJ_SeqDense_2(am, a->i, a->j, av, bp, c + col * clda, clda, add);
+      break;
+    default:
+      MatMatMultKernel_SeqAIJ_SeqDense_1(am, a->i, a->j, av, bp, c + col * clda, clda, add);
     }
   }
+  if (!work) PetscCall(PetscFree(bp));
   PetscCall(PetscLogFlops(cn * (2.0 * a->nz)));
   if (add) {
     PetscCall(MatDenseRestoreArray(C, &c));
@@ -1640,7 +1635,11 @@ PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqDense(Mat A, Mat B, Mat C)
   PetscCheck(A->rmap->n == C->rmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Number rows in C %" PetscInt_FMT " not equal rows in A %" PetscInt_FMT, C->rmap->n, A->rmap->n);
   PetscCheck(B->cmap->n == C->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Number columns in B %" PetscInt_FMT " not equal columns in C %" PetscInt_FMT, B->cmap->n, C->cmap->n);
 
-  PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(A, B, C, PETSC_FALSE));
+  if (C->product && C->product->destroy == MatDestroy_SeqAIJ_SeqDense_MatMatMult) {
+    MatMatMult_SeqAIJ_SeqDense *mm = (MatMatMult_SeqAIJ_SeqDense *)C->product->data;
+
+    PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(A, B, C, &mm->work, &mm->nwork, PETSC_FALSE));
+  } else PetscCall(MatMatMultNumericAdd_SeqAIJ_SeqDense(A, B, C, NULL, NULL, PETSC_FALSE));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -46,10 +46,13 @@ static PetscErrorCode MatCopyHashToXAIJ_Seq_Hash(Mat A, Mat B)
   }
   if (A == B) PetscCall(PetscHMapIJVDestroy(&a->ht));
 
+  /* the entries are set by a single thread, so skip the per-thread hash tables of MAT_THREAD_SAFE_SET_VALUES */
+  if (A == B && a->threadsafe) A->ops->setvalues = PetscConcat(MatSetValues_Seq, TYPE);
   for (PetscInt i = 0, start = 0; i < m; i++) {
     PetscCall(MatSetValues(B, 1, &i, a->dnz[i], PetscSafePointerPlusOffset(cols, start), PetscSafePointerPlusOffset(values, start), B->insertmode));
     start += a->dnz[i];
   }
+  if (A == B && a->threadsafe) A->ops->setvalues = a->cops.setvalues;
   PetscCall(PetscFree3(cols, rowstarts, values));
   if (A == B) PetscCall(PetscFree(a->dnz));
 #if defined(TYPE_BS_ON)
@@ -69,7 +72,16 @@ static PetscErrorCode MatCopyHashToXAIJ_Seq_Hash(Mat A, Mat B)
 */
 static PetscErrorCode MatAssemblyEnd_Seq_Hash(Mat A, MatAssemblyType type)
 {
+  PetscConcat(Mat_Seq, TYPE) *a = (PetscConcat(Mat_Seq, TYPE) *)A->data;
+
   PetscFunctionBegin;
+  if (a->threadsafe) {
+#if defined(TYPE_BS_ON)
+    if (A->rmap->bs > 1) PetscCall(MatSeqXAIJThreadSafeMerge_Private(A, a->threadsafe, MatSetValues_Seq_Hash_BS));
+    else
+#endif
+      PetscCall(MatSeqXAIJThreadSafeMerge_Private(A, a->threadsafe, MatSetValues_Seq_Hash));
+  }
   PetscCall(MatCopyHashToXAIJ(A, A));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -95,6 +107,15 @@ static PetscErrorCode MatDestroy_Seq_Hash(Mat A)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode MatSetValues_Seq_Hash_ThreadSafe(Mat A, PetscInt m, const PetscInt *rows, PetscInt n, const PetscInt *cols, const PetscScalar *values, InsertMode addv)
+{
+  PetscConcat(Mat_Seq, TYPE) *a = (PetscConcat(Mat_Seq, TYPE) *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqXAIJThreadSafeSetValues_Private(a->threadsafe, a->roworiented, m, rows, n, cols, values, addv));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatZeroEntries_Seq_Hash(Mat A)
 {
   PetscFunctionBegin;
@@ -142,11 +163,11 @@ static PetscErrorCode MatSetUp_Seq_Hash(Mat A)
   A->ops->zeroentries    = MatZeroEntries_Seq_Hash;
   A->ops->setrandom      = MatSetRandom_Seq_Hash;
   A->ops->copyhashtoxaij = MatCopyHashToXAIJ_Seq_Hash;
+  if (a->threadsafe) A->ops->setvalues = MatSetValues_Seq_Hash_ThreadSafe;
 #if defined(TYPE_BS_ON)
-  if (bs > 1) A->ops->setvalues = MatSetValues_Seq_Hash_BS;
-  else
+  else if (bs > 1) A->ops->setvalues = MatSetValues_Seq_Hash_BS;
 #endif
-    A->ops->setvalues = MatSetValues_Seq_Hash;
+  else A->ops->setvalues = MatSetValues_Seq_Hash;
   A->ops->setvaluesblocked = NULL;
 
   A->preallocated = PETSC_TRUE;
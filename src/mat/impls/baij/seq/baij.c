@@ -1563,6 +1563,7 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
     PetscCall(PetscFree(a->bdnz));
     A->hash_active = PETSC_FALSE;
   }
+  PetscCall(MatSeqXAIJThreadSafeDestroy_Private(&a->threadsafe));
   PetscCall(PetscLogObjectState((PetscObject)A, "Rows=%" PetscInt_FMT ", Cols=%" PetscInt_FMT ", NZ=%" PetscInt_FMT, A->rmap->N, A->cmap->n, a->nz));
   PetscCall(MatSeqXAIJFreeAIJ(A, &a->a, &a->j, &a->i));
   PetscCall(ISDestroy(&a->row));
@@ -1602,6 +1603,76 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   MatSetValues() with MAT_THREAD_SAFE_SET_VALUES, the nonzero structure is only read so entries already in it are
+   updated in place, with atomics for ADD_VALUES, and new entries are stashed until MatAssemblyEnd()
+*/
+static PetscErrorCode MatSetValues_SeqBAIJ_ThreadSafe(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
+{
+  Mat_SeqBAIJ *a  = (Mat_SeqBAIJ *)A->data;
+  PetscInt    *ai = a->i, *ailen = a->ilen, *aj = a->j, bs = A->rmap->bs, bs2 = a->bs2, slot = -1;
+  MatScalar   *aa = a->a;
+
+  PetscFunctionBegin;
+  for (PetscInt k = 0; k < m; k++) {
+    const PetscInt row = im[k];
+    PetscInt       brow, *rp;
+    MatScalar     *ap;
+
+    if (row < 0) continue;
+    PetscCheck(row < A->rmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Row too large: row %" PetscInt_FMT " max %" PetscInt_FMT, row, A->rmap->N - 1);
+    brow = row / bs;
+    rp   = PetscSafePointerPlusOffset(aj, ai[brow]);
+    ap   = PetscSafePointerPlusOffset(aa, bs2 * ai[brow]);
+    for (PetscInt l = 0; l < n; l++) {
+      const PetscInt col = in[l];
+      MatScalar      value, *bap;
+      PetscInt       i;
+
+      if (col < 0) continue;
+      PetscCheck(col < A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column too large: col %" PetscInt_FMT " max %" PetscInt_FMT, col, A->cmap->n - 1);
+      value = (v && !A->structure_only) ? (a->roworiented ? v[l + k * n] : v[k + l * m]) : 0.0;
+      if (value == 0.0 && a->ignorezeroentries && is == ADD_VALUES && row != col) continue;
+      PetscCall(PetscFindInt(col / bs, ailen[brow], rp, &i));
+      if (i >= 0) {
+        if (A->structure_only) continue;
+        bap = ap + bs2 * i + bs * (col % bs) + row % bs;
+        if (is == ADD_VALUES) MatSeqXAIJAtomicAdd_Private(bap, value);
+        else *bap = value;
+        continue;
+      }
+      if (a->nonew == 1) continue;
+      PetscCheck(a->nonew != -1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero (%" PetscInt_FMT ", %" PetscInt_FMT ") in the matrix", row, col);
+      PetscCall(MatSeqXAIJThreadSafeAdd_Private(a->threadsafe, &slot, row, col, value, is));
+    }
+  }
+  PetscCall(MatSeqXAIJThreadSafeRelease_Private(a->threadsafe, slot));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatSetValuesBlocked() falls back to MatSetValues() when the matrix has no setvaluesblocked() */
+static PetscErrorCode MatSetThreadSafe_SeqBAIJ(Mat A, PetscBool flg)
+{
+  Mat_SeqBAIJ *a = (Mat_SeqBAIJ *)A->data;
+
+  PetscFunctionBegin;
+  if (flg && !a->threadsafe) PetscCall(MatSeqXAIJThreadSafeCreate_Private(&a->threadsafe));
+  if (!flg && a->threadsafe) {
+    PetscCheck(A->insertmode == NOT_SET_VALUES, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot unset MAT_THREAD_SAFE_SET_VALUES before MatAssemblyEnd()");
+    PetscCall(MatSeqXAIJThreadSafeDestroy_Private(&a->threadsafe));
+  }
+  if (A->hash_active) {
+    if (flg) A->ops->setvalues = MatSetValues_Seq_Hash_ThreadSafe;
+    else A->ops->setvalues = A->rmap->bs > 1 ? MatSetValues_Seq_Hash_BS : MatSetValues_Seq_Hash;
+    a->cops.setvalues        = flg ? MatSetValues_SeqBAIJ_ThreadSafe : MatSetValues_SeqBAIJ;
+    a->cops.setvaluesblocked = flg ? NULL : MatSetValuesBlocked_SeqBAIJ;
+  } else {
+    A->ops->setvalues        = flg ? MatSetValues_SeqBAIJ_ThreadSafe : MatSetValues_SeqBAIJ;
+    A->ops->setvaluesblocked = flg ? NULL : MatSetValuesBlocked_SeqBAIJ;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatSetOption_SeqBAIJ(Mat A, MatOption op, PetscBool flg)
 {
   Mat_SeqBAIJ *a = (Mat_SeqBAIJ *)A->data;
@@ -1626,6 +1697,12 @@ static PetscErrorCode MatSetOption_SeqBAIJ(Mat A, MatOption op, PetscBool flg)
   case MAT_UNUSED_NONZERO_LOCATION_ERR:
     a->nounused = (flg ? -1 : 0);
     break;
+  case MAT_IGNORE_ZERO_ENTRIES:
+    a->ignorezeroentries = flg;
+    break;
+  case MAT_THREAD_SAFE_SET_VALUES:
+    PetscCall(MatSetThreadSafe_SeqBAIJ(A, flg));
+    break;
   default:
     break;
   }
@@ -2240,6 +2317,13 @@ PetscErrorCode MatAssemblyEnd_SeqBAIJ(Mat A, MatAssemblyType mode)
   PetscReal    ratio = 0.6;
 
   PetscFunctionBegin;
+  if (a->threadsafe) {
+    PetscCall(MatSeqXAIJThreadSafeMerge_Private(A, a->threadsafe, MatSetValues_SeqBAIJ));
+    /* the merge may have reallocated the matrix */
+    ai = a->i;
+    aj = a->j;
+    aa = a->a;
+  }
   if (mode == MAT_FLUSH_ASSEMBLY || (A->was_assembled && A->ass_nonzerostate == A->nonzerostate)) PetscFunctionReturn(PETSC_SUCCESS);
 
   if (m) rmax = ailen[0];
@@ -2495,6 +2579,7 @@ PetscErrorCode MatSetValues_SeqBAIJ(Mat A, PetscInt m, const PetscInt im[], Pets
         } else {
           value = v[k + l * m];
         }
+        if (value == 0.0 && a->ignorezeroentries && is == ADD_VALUES && row != col) continue;
       }
       if (col <= lastcol) low = 0;
       else high = nrow;
@@ -29,11 +29,12 @@
   MatScalar *idiag;      /* inverse of block diagonal  */ \
   PetscBool  idiagvalid; /* if above has correct/current values */ \
   /* MatSetValues() via hash related fields */ \
-  PetscHMapIJV   ht; \
-  PetscInt      *dnz; \
-  PetscHSetIJ    bht; \
-  PetscInt      *bdnz; \
-  struct _MatOps cops
+  PetscHMapIJV           ht; \
+  PetscInt              *dnz; \
+  PetscHSetIJ            bht; \
+  PetscInt              *bdnz; \
+  struct _MatOps         cops; \
+  Mat_SeqXAIJThreadSafe *threadsafe /* set with MAT_THREAD_SAFE_SET_VALUES */
 
 typedef struct {
   SEQAIJHEADER(MatScalar);
@@ -3,7 +3,7 @@
 */
 #include <petsc/private/matimpl.h>
 
-const char *MatOptions_Shifted[] = {"UNUSED_NONZERO_LOCATION_ERR", "ROW_ORIENTED", "NOT_A_VALID_OPTION", "SYMMETRIC", "STRUCTURALLY_SYMMETRIC", "FORCE_DIAGONAL_ENTRIES", "IGNORE_OFF_PROC_ENTRIES", "USE_HASH_TABLE", "KEEP_NONZERO_PATTERN", "IGNORE_ZERO_ENTRIES", "USE_INODES", "HERMITIAN", "SYMMETRY_ETERNAL", "NEW_NONZERO_LOCATION_ERR", "IGNORE_LOWER_TRIANGULAR", "ERROR_LOWER_TRIANGULAR", "GETROW_UPPERTRIANGULAR", "SPD", "NO_OFF_PROC_ZERO_ROWS", "NO_OFF_PROC_ENTRIES", "NEW_NONZERO_LOCATIONS", "NEW_NONZERO_ALLOCATION_ERR", "SUBSET_OFF_PROC_ENTRIES", "SUBMAT_SINGLEIS", "STRUCTURE_ONLY", "SORTED_FULL", "FORM_EXPLICIT_TRANSPOSE", "STRUCTURAL_SYMMETRY_ETERNAL", "SPD_ETERNAL", "MatOption", "MAT_", NULL};
+const char *MatOptions_Shifted[] = {"UNUSED_NONZERO_LOCATION_ERR", "ROW_ORIENTED", "NOT_A_VALID_OPTION", "SYMMETRIC", "STRUCTURALLY_SYMMETRIC", "FORCE_DIAGONAL_ENTRIES", "IGNORE_OFF_PROC_ENTRIES", "USE_HASH_TABLE", "KEEP_NONZERO_PATTERN", "IGNORE_ZERO_ENTRIES", "USE_INODES", "HERMITIAN", "SYMMETRY_ETERNAL", "NEW_NONZERO_LOCATION_ERR", "IGNORE_LOWER_TRIANGULAR", "ERROR_LOWER_TRIANGULAR", "GETROW_UPPERTRIANGULAR", "SPD", "NO_OFF_PROC_ZERO_ROWS", "NO_OFF_PROC_ENTRIES", "NEW_NONZERO_LOCATIONS", "NEW_NONZERO_ALLOCATION_ERR", "SUBSET_OFF_PROC_ENTRIES", "SUBMAT_SINGLEIS", "STRUCTURE_ONLY", "SORTED_FULL", "FORM_EXPLICIT_TRANSPOSE", "STRUCTURAL_SYMMETRY_ETERNAL", "SPD_ETERNAL", "THREAD_SAFE_SET_VALUES", "MatOption", "MAT_", NULL};
 const char *const *MatOptions                  = MatOptions_Shifted + 2;
 const char *const  MatFactorShiftTypes[]       = {"NONE", "NONZERO", "POSITIVE_DEFINITE", "INBLOCKS", "MatFactorShiftType", "PC_FACTOR_", NULL};
 const char *const  MatStructures[]             = {"DIFFERENT", "SUBSET", "SAME", "UNKNOWN", "MatStructure", "MAT_STRUCTURE_", NULL};
@@ -120,6 +120,9 @@ PETSC_INTERN PetscErrorCode MatSolverTypeRegister_Htool(void);
 #endif
 
 PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat, MatFactorType, Mat *);
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijsingle_petsc(Mat, MatFactorType, Mat *);
+#endif
 PETSC_INTERN PetscErrorCode MatGetFactor_seqbaij_petsc(Mat, MatFactorType, Mat *);
 PETSC_INTERN PetscErrorCode MatGetFactor_seqsbaij_petsc(Mat, MatFactorType, Mat *);
 PETSC_INTERN PetscErrorCode MatGetFactor_seqdense_petsc(Mat, MatFactorType, Mat *);
@@ -175,6 +178,7 @@ PetscErrorCode MatInitializePackage(void)
   /* Register Events */
   PetscCall(PetscLogEventRegister("MatMult", MAT_CLASSID, &MAT_Mult));
   PetscCall(PetscLogEventRegister("MatMultAdd", MAT_CLASSID, &MAT_MultAdd));
+  PetscCall(PetscLogEventRegister("MatMatrixPowers", MAT_CLASSID, &MAT_MatrixPowers));
   PetscCall(PetscLogEventRegister("MatMultTranspose", MAT_CLASSID, &MAT_MultTranspose));
   PetscCall(PetscLogEventRegister("MatMultHermitian", MAT_CLASSID, &MAT_MultHermitianTranspose));
   PetscCall(PetscLogEventRegister("MatMultTrAdd", MAT_CLASSID, &MAT_MultTransposeAdd));
@@ -287,10 +291,15 @@ PetscErrorCode MatInitializePackage(void)
   PetscCall(PetscLogEventRegister("MatH2OpusOrth", MAT_CLASSID, &MAT_H2Opus_Orthog));
   PetscCall(PetscLogEventRegister("MatH2OpusLR", MAT_CLASSID, &MAT_H2Opus_LR));
 
+  PetscCall(PetscLogEventRegister("MatMultAVX2", MAT_CLASSID, &MAT_MultAVX2));
+  PetscCall(PetscLogEventRegister("MatMultAVX512", MAT_CLASSID, &MAT_MultAVX512));
+
   /* Mark non-collective events */
   PetscCall(PetscLogEventSetCollective(MAT_SetValues, PETSC_FALSE));
   PetscCall(PetscLogEventSetCollective(MAT_SetValuesBatch, PETSC_FALSE));
   PetscCall(PetscLogEventSetCollective(MAT_GetRow, PETSC_FALSE));
+  PetscCall(PetscLogEventSetCollective(MAT_MultAVX2, PETSC_FALSE));
+  PetscCall(PetscLogEventSetCollective(MAT_MultAVX512, PETSC_FALSE));
   /* Turn off high traffic events by default */
   PetscCall(PetscLogEventSetActiveAll(MAT_SetValues, PETSC_FALSE));
   PetscCall(PetscLogEventSetActiveAll(MAT_GetValues, PETSC_FALSE));
@@ -322,7 +331,15 @@ PetscErrorCode MatInitializePackage(void)
     if (pkg) PetscCall(PetscLogEventExcludeClass(MAT_NULLSPACE_CLASSID));
   }
 
-  /* Register the PETSc built in factorization based solvers */
+  /* Register the PETSc built in factorization based solvers, MATSEQAIJSINGLE before MATSEQAIJ since for a given solver type
+     MatSolverTypeGet() takes the first handler registered for the matrix type or one of its base types */
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJSINGLE, MAT_FACTOR_LU, MatGetFactor_seqaijsingle_petsc));
+  PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJSINGLE, MAT_FACTOR_CHOLESKY, MatGetFactor_seqaijsingle_petsc));
+  PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJSINGLE, MAT_FACTOR_ILU, MatGetFactor_seqaijsingle_petsc));
+  PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJSINGLE, MAT_FACTOR_ICC, MatGetFactor_seqaijsingle_petsc));
+#endif
+
   PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJ, MAT_FACTOR_LU, MatGetFactor_seqaij_petsc));
   PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJ, MAT_FACTOR_CHOLESKY, MatGetFactor_seqaij_petsc));
   PetscCall(MatSolverTypeRegister(MATSOLVERPETSC, MATSEQAIJ, MAT_FACTOR_ILU, MatGetFactor_seqaij_petsc));
@@ -40,6 +40,11 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSELL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSELL(Mat);
 
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSingle(Mat);
+#endif
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -154,6 +159,12 @@ PetscErrorCode MatRegisterAll(void)
   PetscCall(MatRegister(MATMPIAIJSELL, MatCreate_MPIAIJSELL));
   PetscCall(MatRegister(MATSEQAIJSELL, MatCreate_SeqAIJSELL));
 
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  PetscCall(MatRegisterRootName(MATAIJSINGLE, MATSEQAIJSINGLE, MATMPIAIJSINGLE));
+  PetscCall(MatRegister(MATMPIAIJSINGLE, MatCreate_MPIAIJSingle));
+  PetscCall(MatRegister(MATSEQAIJSINGLE, MatCreate_SeqAIJSingle));
+#endif
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(MatRegisterRootName(MATAIJMKL, MATSEQAIJMKL, MATMPIAIJMKL));
   PetscCall(MatRegister(MATMPIAIJMKL, MatCreate_MPIAIJMKL));
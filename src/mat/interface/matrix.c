@@ -14,7 +14,7 @@ PetscClassId MAT_COLORING_CLASSID;
 PetscClassId MAT_FDCOLORING_CLASSID;
 PetscClassId MAT_TRANSPOSECOLORING_CLASSID;
 
-PetscLogEvent MAT_Mult, MAT_MultAdd, MAT_MultTranspose;
+PetscLogEvent MAT_Mult, MAT_MultAdd, MAT_MultTranspose, MAT_MatrixPowers;
 PetscLogEvent MAT_MultTransposeAdd, MAT_Solve, MAT_Solves, MAT_SolveAdd, MAT_SolveTranspose, MAT_MatSolve, MAT_MatTrSolve;
 PetscLogEvent MAT_SolveTransposeAdd, MAT_SOR, MAT_ForwardSolve, MAT_BackwardSolve, MAT_LUFactor, MAT_LUFactorSymbolic;
 PetscLogEvent MAT_LUFactorNumeric, MAT_CholeskyFactor, MAT_CholeskyFactorSymbolic, MAT_CholeskyFactorNumeric, MAT_ILUFactor;
@@ -45,6 +45,7 @@ PetscLogEvent MAT_Merge, MAT_Residual, MAT_SetRandom;
 PetscLogEvent MAT_FactorFactS, MAT_FactorInvS;
 PetscLogEvent MATCOLORING_Apply, MATCOLORING_Comm, MATCOLORING_Local, MATCOLORING_ISCreate, MATCOLORING_SetUp, MATCOLORING_Weights;
 PetscLogEvent MAT_H2Opus_Build, MAT_H2Opus_Compress, MAT_H2Opus_Orthog, MAT_H2Opus_LR;
+PetscLogEvent MAT_MultAVX2, MAT_MultAVX512;
 
 const char *const MatFactorTypes[] = {"NONE", "LU", "CHOLESKY", "ILU", "ICC", "ILUDT", "QR", "MatFactorType", "MAT_FACTOR_", NULL};
 
@@ -1504,10 +1505,32 @@ PetscErrorCode MatDestroy(Mat *A)
   PetscCall(MatDestroy(&(*A)->schur));
   PetscCall(PetscLayoutDestroy(&(*A)->rmap));
   PetscCall(PetscLayoutDestroy(&(*A)->cmap));
+  if ((*A)->threadsafe_setvalues) PetscCall(PetscSpinlockDestroy(&(*A)->setvalues_lock));
   PetscCall(PetscHeaderDestroy(A));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Records the InsertMode of the values being set and marks the matrix as no longer assembled. With MAT_THREAD_SAFE_SET_VALUES
+   several threads may do this concurrently so the update is done under setvalues_lock
+*/
+static inline PetscErrorCode MatSetValuesSetState_Private(Mat mat, InsertMode addv)
+{
+  InsertMode insertmode;
+
+  PetscFunctionBegin;
+  if (mat->threadsafe_setvalues) PetscCall(PetscSpinlockLock(&mat->setvalues_lock));
+  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
+  insertmode = mat->insertmode;
+  if (mat->assembled) {
+    mat->was_assembled = PETSC_TRUE;
+    mat->assembled     = PETSC_FALSE;
+  }
+  if (mat->threadsafe_setvalues) PetscCall(PetscSpinlockUnlock(&mat->setvalues_lock));
+  PetscCheck(insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 // PetscClangLinter pragma disable: -fdoc-section-header-unknown
 /*@
   MatSetValues - Inserts or adds a block of values into a matrix.
@@ -1571,8 +1594,7 @@ PetscErrorCode MatSetValues(Mat mat, PetscInt m, const PetscInt idxm[], PetscInt
   PetscAssertPointer(idxn, 5);
   MatCheckPreallocated(mat, 1);
 
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
-  else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  PetscCall(MatSetValuesSetState_Private(mat, addv));
 
   if (PetscDefined(USE_DEBUG)) {
     PetscInt i, j;
@@ -1594,10 +1616,6 @@ PetscErrorCode MatSetValues(Mat mat, PetscInt m, const PetscInt idxm[], PetscInt
     for (i = 0; i < n; i++) PetscCheck(idxn[i] < mat->cmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Cannot insert in column %" PetscInt_FMT ", maximum is %" PetscInt_FMT, idxn[i], mat->cmap->N - 1);
   }
 
-  if (mat->assembled) {
-    mat->was_assembled = PETSC_TRUE;
-    mat->assembled     = PETSC_FALSE;
-  }
   PetscCall(PetscLogEventBegin(MAT_SetValues, mat, 0, 0, 0));
   PetscUseTypeMethod(mat, setvalues, m, idxm, n, idxn, v, addv);
   PetscCall(PetscLogEventEnd(MAT_SetValues, mat, 0, 0, 0));
@@ -2093,8 +2111,7 @@ PetscErrorCode MatSetValuesBlocked(Mat mat, PetscInt m, const PetscInt idxm[], P
   PetscAssertPointer(idxm, 3);
   PetscAssertPointer(idxn, 5);
   MatCheckPreallocated(mat, 1);
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
-  else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  PetscCall(MatSetValuesSetState_Private(mat, addv));
   if (PetscDefined(USE_DEBUG)) {
     PetscCheck(!mat->factortype, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
     PetscCheck(mat->ops->setvaluesblocked || mat->ops->setvalues, PETSC_COMM_SELF, PETSC_ERR_SUP, "Mat type %s", ((PetscObject)mat)->type_name);
@@ -2107,10 +2124,6 @@ PetscErrorCode MatSetValuesBlocked(Mat mat, PetscInt m, const PetscInt idxm[], P
     for (i = 0; i < n; i++)
       PetscCheck(idxn[i] * cbs < N, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column block %" PetscInt_FMT " contains an index %" PetscInt_FMT "*%" PetscInt_FMT " greater than column length %" PetscInt_FMT, i, idxn[i], cbs, N);
   }
-  if (mat->assembled) {
-    mat->was_assembled = PETSC_TRUE;
-    mat->assembled     = PETSC_FALSE;
-  }
   PetscCall(PetscLogEventBegin(MAT_SetValues, mat, 0, 0, 0));
   if (mat->ops->setvaluesblocked) {
     PetscUseTypeMethod(mat, setvaluesblocked, m, idxm, n, idxn, v, addv);
@@ -2476,17 +2489,12 @@ PetscErrorCode MatSetValuesLocal(Mat mat, PetscInt nrow, const PetscInt irow[],
   if (!nrow || !ncol) PetscFunctionReturn(PETSC_SUCCESS); /* no values to insert */
   PetscAssertPointer(irow, 3);
   PetscAssertPointer(icol, 5);
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
-  else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  PetscCall(MatSetValuesSetState_Private(mat, addv));
   if (PetscDefined(USE_DEBUG)) {
     PetscCheck(!mat->factortype, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
     PetscCheck(mat->ops->setvalueslocal || mat->ops->setvalues, PETSC_COMM_SELF, PETSC_ERR_SUP, "Mat type %s", ((PetscObject)mat)->type_name);
   }
 
-  if (mat->assembled) {
-    mat->was_assembled = PETSC_TRUE;
-    mat->assembled     = PETSC_FALSE;
-  }
   PetscCall(PetscLogEventBegin(MAT_SetValues, mat, 0, 0, 0));
   if (mat->ops->setvalueslocal) PetscUseTypeMethod(mat, setvalueslocal, nrow, irow, ncol, icol, y, addv);
   else {
@@ -2565,17 +2573,12 @@ PetscErrorCode MatSetValuesBlockedLocal(Mat mat, PetscInt nrow, const PetscInt i
   if (!nrow || !ncol) PetscFunctionReturn(PETSC_SUCCESS); /* no values to insert */
   PetscAssertPointer(irow, 3);
   PetscAssertPointer(icol, 5);
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
-  else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  PetscCall(MatSetValuesSetState_Private(mat, addv));
   if (PetscDefined(USE_DEBUG)) {
     PetscCheck(!mat->factortype, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
     PetscCheck(mat->ops->setvaluesblockedlocal || mat->ops->setvaluesblocked || mat->ops->setvalueslocal || mat->ops->setvalues, PETSC_COMM_SELF, PETSC_ERR_SUP, "Mat type %s", ((PetscObject)mat)->type_name);
   }
 
-  if (mat->assembled) {
-    mat->was_assembled = PETSC_TRUE;
-    mat->assembled     = PETSC_FALSE;
-  }
   if (PetscUnlikelyDebug(mat->rmap->mapping)) { /* Condition on the mapping existing, because MatSetValuesBlockedLocal_IS does not require it to be set. */
     PetscInt irbs, rbs;
     PetscCall(MatGetBlockSizes(mat, &rbs, NULL));
@@ -2704,6 +2707,89 @@ PetscErrorCode MatMult(Mat mat, Vec x, Vec y)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* y[j + 1] = gamma_j (D A y[j] - alpha_j y[j] - delta_j y[j - 1]) with one MatMult() per power */
+static PetscErrorCode MatMatrixPowers_Default(Mat mat, PetscInt k, Vec D, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], Vec y[])
+{
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < k; j++) {
+    PetscScalar g = gamma ? gamma[j] : 1.0, a = alpha ? alpha[j] : 0.0, d = j && delta ? delta[j] : 0.0;
+
+    PetscCall(MatMult(mat, y[j], y[j + 1]));
+    if (D) PetscCall(VecPointwiseMult(y[j + 1], D, y[j + 1]));
+    if (d != 0.0) PetscCall(VecAXPBYPCZ(y[j + 1], -g * a, -g * d, g, y[j], y[j - 1]));
+    else if (a != 0.0 || g != 1.0) PetscCall(VecAXPBY(y[j + 1], -g * a, g, y[j]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  MatMatrixPowers - Computes the Krylov basis $[x, Ax, \ldots, A^k x]$, or a basis of the same space generated by a three-term recurrence
+  with a diagonally scaled matrix
+
+  Neighbor-wise Collective
+
+  Input Parameters:
++ mat   - the square matrix
+. k     - the number of powers
+. D     - optional diagonal scaling, the recurrence uses $DA$ instead of $A$, pass `NULL` for none
+. gamma - optional scaling coefficients, of length `k`, pass `NULL` for all ones
+. alpha - optional shifts, of length `k`, pass `NULL` for all zeros
+. delta - optional coefficients of the previous vectors, of length `k`, `delta[0]` is not used, pass `NULL` for all zeros
+- x     - the starting vector
+
+  Output Parameter:
+. y - array of `k + 1` vectors, `y[0]` is a copy of `x` and $y_{j+1} = \gamma_j ((DA - \alpha_j I) y_j - \delta_j y_{j-1})$
+
+  Level: advanced
+
+  Notes:
+  Without the optional arguments this computes the monomial basis $y_j = A^j x$, which quickly becomes ill-conditioned; the Newton basis,
+  with the Ritz values as shifts, or the Chebyshev basis are the usual alternatives used by s-step Krylov methods and polynomial smoothers.
+
+  For `MATMPIAIJ` this is a matrix-powers kernel: the first call collects the rows of `mat` within distance `k` of the rows owned by
+  each MPI process, using `MatIncreaseOverlap()` and `MatCreateSubMatrices()`, and builds a `PetscSF` for the values of `x` on those rows.
+  Each call then needs a single message exchange and computes the entries of the intermediate vectors near the process boundary
+  redundantly, instead of exchanging ghost values for each of the `k` products. The extra rows are refreshed when the values of `mat` change
+  and rebuilt when its nonzero structure changes. Other matrix types call `MatMult()` `k` times.
+
+  The diagonal `D` is communicated only when it has changed since the previous call.
+
+.seealso: [](ch_matrices), `Mat`, `MatMult()`, `MatIncreaseOverlap()`, `KSPCHEBYSHEV`, `KSPSGMRES`, `KSPSCG`
+@*/
+PetscErrorCode MatMatrixPowers(Mat mat, PetscInt k, Vec D, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], Vec x, Vec y[])
+{
+  PetscErrorCode (*f)(Mat, PetscInt, Vec, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec, Vec[]);
+  PetscBool congruent;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat, MAT_CLASSID, 1);
+  PetscValidType(mat, 1);
+  PetscValidLogicalCollectiveInt(mat, k, 2);
+  if (D) PetscValidHeaderSpecific(D, VEC_CLASSID, 3);
+  PetscValidHeaderSpecific(x, VEC_CLASSID, 7);
+  VecCheckAssembled(x);
+  PetscAssertPointer(y, 8);
+  for (PetscInt j = 0; j <= k; j++) PetscValidHeaderSpecific(y[j], VEC_CLASSID, 8);
+  PetscCheck(k >= 0, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_OUTOFRANGE, "Number of powers %" PetscInt_FMT " must be nonnegative", k);
+  PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
+  PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
+  PetscCall(MatHasCongruentLayouts(mat, &congruent));
+  PetscCheck(congruent, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_SIZ, "Matrix powers need a square matrix with the same row and column layouts");
+  PetscCheck(mat->cmap->n == x->map->n, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Mat mat,Vec x: local dim %" PetscInt_FMT " %" PetscInt_FMT, mat->cmap->n, x->map->n);
+  for (PetscInt j = 1; j <= k; j++) PetscCheck(y[j] != x, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_IDN, "x and y[%" PetscInt_FMT "] must be different vectors", j);
+  MatCheckPreallocated(mat, 1);
+
+  PetscCall(VecCopy(x, y[0]));
+  if (!k) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscLogEventBegin(MAT_MatrixPowers, mat, x, 0, 0));
+  PetscCall(PetscObjectQueryFunction((PetscObject)mat, "MatMatrixPowers_C", &f));
+  if (f) PetscCall((*f)(mat, k, D, gamma, alpha, delta, x, y));
+  else PetscCall(MatMatrixPowers_Default(mat, k, D, gamma, alpha, delta, y));
+  PetscCall(PetscLogEventEnd(MAT_MatrixPowers, mat, x, 0, 0));
+  for (PetscInt j = 1; j <= k; j++) PetscCall(PetscObjectStateIncrease((PetscObject)y[j]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatMultTranspose - Computes matrix transpose times a vector $y = A^T * x$.
 
@@ -3100,6 +3186,22 @@ PetscErrorCode MatGetInfo_External(Mat A, MatInfoType flag, MatInfo *info)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* MatFactorInfo.singleprecision is only implemented by the PETSc LU and ILU factorizations of MATSEQAIJ, which are not in-place */
+static PetscErrorCode MatFactorCheckSinglePrecision_Private(Mat fact, const MatFactorInfo *info)
+{
+  MatSolverType stype;
+  PetscBool     isaij, ispetsc;
+
+  PetscFunctionBegin;
+  if (!info->singleprecision) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCheck(fact->factortype, PetscObjectComm((PetscObject)fact), PETSC_ERR_SUP, "Single precision factors are not available with in-place factorizations");
+  PetscCall(PetscObjectTypeCompare((PetscObject)fact, MATSEQAIJ, &isaij));
+  PetscCall(MatFactorGetSolverType(fact, &stype));
+  PetscCall(PetscStrcmp(stype, MATSOLVERPETSC, &ispetsc));
+  PetscCheck(isaij && ispetsc && (fact->factortype == MAT_FACTOR_LU || fact->factortype == MAT_FACTOR_ILU), PetscObjectComm((PetscObject)fact), PETSC_ERR_SUP, "Single precision factors are only available with the %s LU and ILU factorizations of %s matrices, not with the %s %s factorization of %s matrices", MATSOLVERPETSC, MATSEQAIJ, stype, MatFactorTypes[fact->factortype], ((PetscObject)fact)->type_name);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatLUFactor - Performs in-place LU factorization of matrix.
 
@@ -3152,6 +3254,7 @@ PetscErrorCode MatLUFactor(Mat mat, IS row, IS col, const MatFactorInfo *info)
     PetscCall(MatFactorInfoInitialize(&tinfo));
     info = &tinfo;
   }
+  PetscCall(MatFactorCheckSinglePrecision_Private(mat, info));
 
   PetscCall(PetscLogEventBegin(MAT_LUFactor, mat, row, col, 0));
   PetscUseTypeMethod(mat, lufactor, row, col, info);
@@ -3205,6 +3308,7 @@ PetscErrorCode MatILUFactor(Mat mat, IS row, IS col, const MatFactorInfo *info)
   PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
   PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
   MatCheckPreallocated(mat, 1);
+  PetscCall(MatFactorCheckSinglePrecision_Private(mat, info));
 
   PetscCall(PetscLogEventBegin(MAT_ILUFactor, mat, row, col, 0));
   PetscUseTypeMethod(mat, ilufactor, row, col, info);
@@ -3263,6 +3367,7 @@ PetscErrorCode MatLUFactorSymbolic(Mat fact, Mat mat, IS row, IS col, const MatF
     PetscCall(MatFactorInfoInitialize(&tinfo));
     info = &tinfo;
   }
+  PetscCall(MatFactorCheckSinglePrecision_Private(fact, info));
 
   if (!fact->trivialsymbolic) PetscCall(PetscLogEventBegin(MAT_LUFactorSymbolic, mat, row, col, 0));
   PetscUseTypeMethod(fact, lufactorsymbolic, mat, row, col, info);
@@ -3370,6 +3475,7 @@ PetscErrorCode MatCholeskyFactor(Mat mat, IS perm, const MatFactorInfo *info)
     PetscCall(MatFactorInfoInitialize(&tinfo));
     info = &tinfo;
   }
+  PetscCall(MatFactorCheckSinglePrecision_Private(mat, info));
 
   PetscCall(PetscLogEventBegin(MAT_CholeskyFactor, mat, perm, 0, 0));
   PetscUseTypeMethod(mat, choleskyfactor, perm, info);
@@ -3430,6 +3536,7 @@ PetscErrorCode MatCholeskyFactorSymbolic(Mat fact, Mat mat, IS perm, const MatFa
     PetscCall(MatFactorInfoInitialize(&tinfo));
     info = &tinfo;
   }
+  PetscCall(MatFactorCheckSinglePrecision_Private(fact, info));
 
   if (!fact->trivialsymbolic) PetscCall(PetscLogEventBegin(MAT_CholeskyFactorSymbolic, mat, perm, 0, 0));
   PetscUseTypeMethod(fact, choleskyfactorsymbolic, mat, perm, info);
@@ -3531,6 +3638,7 @@ PetscErrorCode MatQRFactor(Mat mat, IS col, const MatFactorInfo *info)
   PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
   PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
   MatCheckPreallocated(mat, 1);
+  if (info) PetscCall(MatFactorCheckSinglePrecision_Private(mat, info));
   PetscCall(PetscLogEventBegin(MAT_QRFactor, mat, col, 0, 0));
   PetscUseMethod(mat, "MatQRFactor_C", (Mat, IS, const MatFactorInfo *), (mat, col, info));
   PetscCall(PetscLogEventEnd(MAT_QRFactor, mat, col, 0, 0));
@@ -3585,6 +3693,7 @@ PetscErrorCode MatQRFactorSymbolic(Mat fact, Mat mat, IS col, const MatFactorInf
     PetscCall(MatFactorInfoInitialize(&tinfo));
     info = &tinfo;
   }
+  PetscCall(MatFactorCheckSinglePrecision_Private(fact, info));
 
   if (!fact->trivialsymbolic) PetscCall(PetscLogEventBegin(MAT_QRFactorSymbolic, fact, mat, col, 0));
   PetscUseMethod(fact, "MatQRFactorSymbolic_C", (Mat, Mat, IS, const MatFactorInfo *), (fact, mat, col, info));
@@ -5779,6 +5888,10 @@ static PetscInt MatAssemblyEnd_InUse = 0;
 + mat  - the matrix
 - type - type of assembly, either `MAT_FLUSH_ASSEMBLY` or `MAT_FINAL_ASSEMBLY`
 
+  Options Database Key:
+. -matstash_persistent - record the communication of the cached off-process values in the first assembly and replay it with persistent
+                         MPI requests in later assemblies, see the notes below
+
   Level: beginner
 
   Notes:
@@ -5797,7 +5910,13 @@ static PetscInt MatAssemblyEnd_InUse = 0;
   out by assembly. If you intend to use that extra space on a subsequent assembly, be sure to insert explicit zeros
   before `MAT_FINAL_ASSEMBLY` so the space is not compressed out.
 
-.seealso: [](ch_matrices), `Mat`, `MatAssemblyEnd()`, `MatSetValues()`, `MatAssembled()`
+  With `-matstash_persistent` the later assemblies that cache exactly the same off-process entries, in the same order and with the same
+  `InsertMode`, as the first assembly, as is typical of repeated finite element assembly, combine the values in place and
+  exchange them without sorting the cached entries or discovering the communicating processes again. If any process caches
+  different entries, all the processes fall back to the usual exchange and record that assembly instead. Unlike
+  `MAT_SUBSET_OFF_PROC_ENTRIES`, which requires the receiving processes to be a subset of those of the first assembly, this is never an error.
+
+.seealso: [](ch_matrices), `Mat`, `MatAssemblyEnd()`, `MatSetValues()`, `MatAssembled()`, `MAT_SUBSET_OFF_PROC_ENTRIES`
 @*/
 PetscErrorCode MatAssemblyBegin(Mat mat, MatAssemblyType type)
 {
@@ -6019,7 +6138,7 @@ PetscErrorCode MatAssemblyEnd(Mat mat, MatAssemblyType type)
   `MAT_KEEP_NONZERO_PATTERN` indicates when `MatZeroRows()` is called the zeroed entries
   are kept in the nonzero structure. This flag is not used for `MatZeroRowsColumns()`
 
-  `MAT_IGNORE_ZERO_ENTRIES` - for `MATAIJ` and `MATIS` matrices this will stop zero values from creating
+  `MAT_IGNORE_ZERO_ENTRIES` - for `MATAIJ`, `MATSEQBAIJ` and `MATIS` matrices this will stop zero values from creating
   a zero location in the matrix
 
   `MAT_USE_INODES` - indicates using inode version of the code - works with `MATAIJ` matrix types
@@ -6034,6 +6153,13 @@ PetscErrorCode MatAssemblyEnd(Mat mat, MatAssemblyType type)
   single call to `MatSetValues()`, preallocation is perfect, row-oriented, `INSERT_VALUES` is used. Common
   with finite difference schemes with non-periodic boundary conditions.
 
+  `MAT_THREAD_SAFE_SET_VALUES` - `MatSetValues()` may be called concurrently from several threads on a `MATSEQAIJ` or `MATSEQBAIJ`
+  matrix, for example in a threaded finite element assembly. Values for locations already in the nonzero structure are
+  added with atomic updates, all other entries are collected in a hash table per thread and merged into the matrix in
+  `MatAssemblyEnd()`, so the first assembly is done entirely in the hash tables. All threads must use the same `InsertMode`.
+  Requires PETSc be configured with `--with-threadsafety`, and with OpenMP or a compiler with GNU atomic builtins for the atomic
+  updates, otherwise setting the option generates an error. With OpenMP each thread uses its own hash table.
+
   Developer Note:
   `MAT_SYMMETRY_ETERNAL`, `MAT_STRUCTURAL_SYMMETRY_ETERNAL`, and `MAT_SPD_ETERNAL` are used by `MatAssemblyEnd()` and in other
   places where otherwise the value of `MAT_SYMMETRIC`, `MAT_STRUCTURALLY_SYMMETRIC` or `MAT_SPD` would need to be changed back
@@ -6121,6 +6247,11 @@ PetscErrorCode MatSetOption(Mat mat, MatOption op, PetscBool flg)
   case MAT_SORTED_FULL:
     mat->sortedfull = flg;
     break;
+  case MAT_THREAD_SAFE_SET_VALUES:
+    if (flg && !mat->threadsafe_setvalues) PetscCall(PetscSpinlockCreate(&mat->setvalues_lock));
+    if (!flg && mat->threadsafe_setvalues) PetscCall(PetscSpinlockDestroy(&mat->setvalues_lock));
+    mat->threadsafe_setvalues = flg;
+    break;
   default:
     break;
   }
@@ -7106,6 +7237,7 @@ PetscErrorCode MatILUFactorSymbolic(Mat fact, Mat mat, IS row, IS col, const Mat
   PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
   PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
   MatCheckPreallocated(mat, 2);
+  PetscCall(MatFactorCheckSinglePrecision_Private(fact, info));
 
   if (!fact->trivialsymbolic) PetscCall(PetscLogEventBegin(MAT_ILUFactorSymbolic, mat, row, col, 0));
   PetscUseTypeMethod(fact, ilufactorsymbolic, mat, row, col, info);
@@ -7157,6 +7289,7 @@ PetscErrorCode MatICCFactorSymbolic(Mat fact, Mat mat, IS perm, const MatFactorI
   PetscCheck(info->fill >= 1.0, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_OUTOFRANGE, "Expected fill less than 1.0 %g", (double)info->fill);
   PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
   MatCheckPreallocated(mat, 2);
+  PetscCall(MatFactorCheckSinglePrecision_Private(fact, info));
 
   if (!fact->trivialsymbolic) PetscCall(PetscLogEventBegin(MAT_ICCFactorSymbolic, mat, perm, 0, 0));
   PetscUseTypeMethod(fact, iccfactorsymbolic, mat, perm, info);
@@ -9171,6 +9304,7 @@ PetscErrorCode MatICCFactor(Mat mat, IS row, const MatFactorInfo *info)
   PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
   PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
   MatCheckPreallocated(mat, 1);
+  PetscCall(MatFactorCheckSinglePrecision_Private(mat, info));
   PetscUseTypeMethod(mat, iccfactor, row, info);
   PetscCall(PetscObjectStateIncrease((PetscObject)mat));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -0,0 +1,195 @@
+static char help[] = "Tests the SIMD MatMult() kernels of MATSEQAIJ against MATSEQDENSE and the scalar MATSEQAIJ kernels,\n\
+and the threaded MatAssemblyEnd() of MATSEQAIJ against the serial one.\n\n";
+
+#include <petscmat.h>
+#include <petsc/private/petscimpl.h> /* for PetscNumOMPThreads */
+
+/* Fills a matrix with rows of random lengths; with sparse rows, most rows are empty so the compressed row format is used */
+static PetscErrorCode FillMatrix(Mat A, PetscRandom rand, PetscInt m, PetscInt n, PetscBool sparserows, PetscBool inodes)
+{
+  PetscInt    *cols;
+  PetscScalar *vals;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscMalloc2(n, &cols, n, &vals));
+  for (PetscInt i = 0; i < m; i++) {
+    PetscReal r;
+    PetscInt  nc = 0;
+
+    PetscCall(PetscRandomGetValueReal(rand, &r));
+    if (sparserows && r < 0.7) continue;
+    /* consecutive pairs of rows share their nonzero pattern to form I-nodes */
+    if (!inodes || i % 2 == 0) PetscCall(PetscRandomGetValueReal(rand, &r));
+    for (PetscInt j = 0; j < n; j++) {
+      if ((j * 7919 + (inodes ? i / 2 : i) * 104729) % 23 < (PetscInt)(r * 23)) cols[nc++] = j;
+    }
+    for (PetscInt j = 0; j < nc; j++) PetscCall(PetscRandomGetValue(rand, &vals[j]));
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, vals, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(PetscFree2(cols, vals));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Assembles the same matrix with one and with several threads, which changes how MatAssemblyEnd() removes the unused
+   preallocated space and detects the I-nodes when PETSc is configured with OpenMP kernels, and compares the results
+*/
+static PetscErrorCode CheckThreadedAssembly(PetscRandom rand, PetscInt m, PetscInt n, PetscBool sparserows, PetscBool inodes)
+{
+  Mat       A[2];
+  PetscInt  node_count[2];
+  PetscInt *sizes[2];
+  PetscBool flg;
+#if defined(PETSC_HAVE_OPENMP)
+  const PetscInt nthreads = PetscNumOMPThreads;
+#endif
+
+  PetscFunctionBeginUser;
+  for (PetscInt k = 0; k < 2; k++) {
+#if defined(PETSC_HAVE_OPENMP)
+    PetscNumOMPThreads = k ? 3 : 1;
+#endif
+    PetscCall(PetscRandomSetSeed(rand, 0x12345678));
+    PetscCall(PetscRandomSeed(rand));
+    PetscCall(MatCreate(PETSC_COMM_SELF, &A[k]));
+    PetscCall(MatSetSizes(A[k], m, n, m, n));
+    PetscCall(MatSetType(A[k], MATSEQAIJ));
+    PetscCall(MatSeqAIJSetPreallocation(A[k], n, NULL));
+    PetscCall(FillMatrix(A[k], rand, m, n, sparserows, inodes));
+    PetscCall(MatInodeGetInodeSizes(A[k], &node_count[k], &sizes[k], NULL));
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  PetscNumOMPThreads = nthreads;
+#endif
+  PetscCall(MatEqual(A[0], A[1], &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "The threaded assembly differs from the serial one");
+  PetscCheck(!sizes[0] == !sizes[1], PETSC_COMM_SELF, PETSC_ERR_PLIB, "I-nodes are used by only one of the assemblies");
+  if (sizes[0]) {
+    PetscCheck(node_count[0] == node_count[1], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong number of I-nodes %" PetscInt_FMT " != %" PetscInt_FMT, node_count[1], node_count[0]);
+    PetscCall(PetscArraycmp(sizes[0], sizes[1], node_count[0] + 1, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong I-node sizes");
+  }
+  PetscCall(MatDestroy(&A[0]));
+  PetscCall(MatDestroy(&A[1]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* whether the CPU has the instruction set requested with -mat_seqaij_simd, the test does nothing when it does not */
+static PetscErrorCode CPUSupportsSIMD(PetscBool *supported)
+{
+  char      simd[16] = "none";
+  PetscBool avx2, avx512;
+
+  PetscFunctionBeginUser;
+  *supported = PETSC_TRUE;
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-mat_seqaij_simd", simd, sizeof(simd), NULL));
+  PetscCall(PetscStrcmp(simd, "avx2", &avx2));
+  PetscCall(PetscStrcmp(simd, "avx512", &avx512));
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if (avx2) *supported = (PetscBool)(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+  if (avx512) *supported = (PetscBool)(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"));
+#else
+  if (avx2 || avx512) *supported = PETSC_FALSE;
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  PetscRandom rand;
+  PetscInt    m = 53, n = 71;
+  PetscBool   inodes = PETSC_FALSE, assembly = PETSC_FALSE, supported;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(CPUSupportsSIMD(&supported));
+  if (!supported) {
+    PetscCall(PetscInfo(NULL, "Skipping the test, the CPU does not support the requested SIMD kernels\n"));
+    PetscCall(PetscFinalize());
+    return 0;
+  }
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-inodes", &inodes, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-assembly", &assembly, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_SELF, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  if (assembly) {
+    PetscCall(CheckThreadedAssembly(rand, m, n, PETSC_FALSE, inodes));
+    PetscCall(CheckThreadedAssembly(rand, m, n, PETSC_TRUE, inodes));
+  }
+  for (PetscInt k = 0; k < 2; k++) {
+    Mat       A, D, S;
+    PetscBool flg;
+
+    PetscCall(MatCreate(PETSC_COMM_SELF, &A));
+    PetscCall(MatSetSizes(A, m, n, m, n));
+    PetscCall(MatSetType(A, MATSEQAIJ));
+    PetscCall(MatSetFromOptions(A));
+    PetscCall(MatSeqAIJSetPreallocation(A, n, NULL));
+    PetscCall(FillMatrix(A, rand, m, n, (PetscBool)(k == 1), inodes));
+    PetscCall(MatConvert(A, MATSEQDENSE, MAT_INITIAL_MATRIX, &D));
+    /* the same matrix with the scalar kernels, its prefix keeps it from reading -mat_seqaij_simd */
+    PetscCall(MatCreate(PETSC_COMM_SELF, &S));
+    PetscCall(MatSetOptionsPrefix(S, "scalar_"));
+    PetscCall(MatSetSizes(S, m, n, m, n));
+    PetscCall(MatSetType(S, MATSEQAIJ));
+    PetscCall(MatSeqAIJSetPreallocation(S, n, NULL));
+    PetscCall(MatAssemblyBegin(S, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(S, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatCopy(A, S, DIFFERENT_NONZERO_PATTERN));
+
+    PetscCall(MatMultEqual(A, D, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMult()");
+    PetscCall(MatMultAddEqual(A, D, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMultAdd()");
+    PetscCall(MatMultTransposeEqual(A, D, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMultTranspose()");
+    PetscCall(MatMultTransposeAddEqual(A, D, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMultTransposeAdd()");
+    PetscCall(MatMultEqual(A, S, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMult() compared to the scalar kernel");
+    PetscCall(MatMultAddEqual(A, S, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMultAdd() compared to the scalar kernel");
+    PetscCall(MatMultTransposeEqual(A, S, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatMultTranspose() compared to the scalar kernel");
+    PetscCall(MatDestroy(&A));
+    PetscCall(MatDestroy(&D));
+    PetscCall(MatDestroy(&S));
+  }
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  testset:
+    requires: !complex double
+    output_file: output/empty.out
+    test:
+      suffix: none
+    test:
+      suffix: auto
+      args: -mat_seqaij_simd auto -m 211 -n 197
+    test:
+      suffix: auto_inodes
+      args: -mat_seqaij_simd auto -inodes
+    test:
+      suffix: forced
+      requires: defined(PETSC_HAVE_IMMINTRIN_H)
+      args: -mat_no_inode -mat_seqaij_simd {{none avx2 avx512}} -inodes {{0 1}} -m 211 -n 197
+    test:
+      suffix: forced_inodes
+      requires: defined(PETSC_HAVE_IMMINTRIN_H)
+      args: -mat_seqaij_simd {{avx2 avx512}} -inodes
+
+  test:
+    suffix: assembly
+    output_file: output/empty.out
+    args: -assembly -inodes {{0 1}} -m 211 -n 197
+
+TEST*/
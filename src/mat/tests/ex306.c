@@ -0,0 +1,171 @@
+static char help[] = "Tests MATAIJSINGLE against MATAIJ for MatMult(), MatSOR() and MatSolve().\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckRelative(Vec x, Vec y, PetscReal tol, const char *op)
+{
+  PetscReal nrm, err;
+  Vec       w;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecDuplicate(x, &w));
+  PetscCall(VecWAXPY(w, -1.0, x, y));
+  PetscCall(VecNorm(w, NORM_2, &err));
+  PetscCall(VecNorm(x, NORM_2, &nrm));
+  PetscCheck(err <= tol * nrm, PetscObjectComm((PetscObject)x), PETSC_ERR_PLIB, "Error in %s: relative difference %g", op, (double)(err / nrm));
+  PetscCall(VecDestroy(&w));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat             A, S;
+  Vec             x, y, z, ys, b;
+  PetscRandom     rand;
+  PetscInt        n = 20, Istart, Iend;
+  PetscMPIInt     size;
+  const PetscReal tol = 1.e-5;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &size));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+
+  /* five point Laplacian with perturbed off-diagonal entries that are not exactly representable in single precision */
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n * n, n * n));
+  PetscCall(MatSetType(A, MATAIJ));
+  PetscCall(MatSeqAIJSetPreallocation(A, 5, NULL));
+  PetscCall(MatMPIAIJSetPreallocation(A, 5, NULL, 2, NULL));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    PetscInt    i = row / n, j = row - i * n, cols[4], nc = 0;
+    PetscScalar vals[4], d = 4.0;
+    PetscReal   r;
+
+    if (i > 0) cols[nc++] = row - n;
+    if (i < n - 1) cols[nc++] = row + n;
+    if (j > 0) cols[nc++] = row - 1;
+    if (j < n - 1) cols[nc++] = row + 1;
+    for (PetscInt k = 0; k < nc; k++) {
+      PetscCall(PetscRandomGetValueReal(rand, &r));
+      vals[k] = -1.0 - 0.1 * r / 3.0;
+      d -= vals[k] + 1.0;
+    }
+    PetscCall(MatSetValues(A, 1, &row, nc, cols, vals, INSERT_VALUES));
+    PetscCall(MatSetValues(A, 1, &row, 1, &row, &d, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatConvert(A, MATAIJSINGLE, MAT_INITIAL_MATRIX, &S));
+
+  PetscCall(MatCreateVecs(A, &x, &y));
+  PetscCall(VecDuplicate(y, &ys));
+  PetscCall(VecDuplicate(y, &z));
+  PetscCall(VecDuplicate(y, &b));
+  PetscCall(VecSetRandom(x, rand));
+  PetscCall(VecSetRandom(z, rand));
+
+  PetscCall(MatMult(A, x, y));
+  PetscCall(MatMult(S, x, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatMult()"));
+  PetscCall(MatMultAdd(A, x, z, y));
+  PetscCall(MatMultAdd(S, x, z, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatMultAdd()"));
+  PetscCall(MatMultTranspose(A, x, y));
+  PetscCall(MatMultTranspose(S, x, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatMultTranspose()"));
+  PetscCall(MatMultTransposeAdd(A, x, z, y));
+  PetscCall(MatMultTransposeAdd(S, x, z, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatMultTransposeAdd()"));
+
+  /* the values are changed after the single precision copy was made */
+  PetscCall(MatScale(A, 2.0));
+  PetscCall(MatScale(S, 2.0));
+  PetscCall(MatShift(A, 1.0));
+  PetscCall(MatShift(S, 1.0));
+  PetscCall(MatMult(A, x, y));
+  PetscCall(MatMult(S, x, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatMult() after MatScale()"));
+
+  PetscCall(VecCopy(z, b));
+  PetscCall(MatSOR(A, b, 1.0, (MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS), 0.0, 2, 1, y));
+  PetscCall(MatSOR(S, b, 1.0, (MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS), 0.0, 2, 1, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatSOR() symmetric"));
+  PetscCall(MatSOR(A, b, 1.2, SOR_LOCAL_FORWARD_SWEEP, 0.0, 1, 2, y));
+  PetscCall(MatSOR(S, b, 1.2, SOR_LOCAL_FORWARD_SWEEP, 0.0, 1, 2, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatSOR() forward"));
+  PetscCall(MatSOR(A, b, 1.2, SOR_LOCAL_BACKWARD_SWEEP, 0.0, 1, 2, y));
+  PetscCall(MatSOR(S, b, 1.2, SOR_LOCAL_BACKWARD_SWEEP, 0.0, 1, 2, ys));
+  PetscCall(CheckRelative(y, ys, tol, "MatSOR() backward"));
+
+  if (size == 1) {
+    const MatFactorType ftypes[] = {MAT_FACTOR_LU, MAT_FACTOR_ILU};
+
+    for (PetscInt k = 0; k < 2; k++) {
+      Mat           F;
+      IS            rowperm, colperm;
+      MatFactorInfo info;
+
+      PetscCall(MatFactorInfoInitialize(&info));
+      info.fill = 1.0;
+      PetscCall(MatGetOrdering(S, k == 0 ? MATORDERINGND : MATORDERINGNATURAL, &rowperm, &colperm));
+      PetscCall(MatGetFactor(S, MATSOLVERPETSC, ftypes[k], &F));
+      if (k == 0) PetscCall(MatLUFactorSymbolic(F, S, rowperm, colperm, &info));
+      else PetscCall(MatILUFactorSymbolic(F, S, rowperm, colperm, &info));
+      PetscCall(MatLUFactorNumeric(F, S, &info));
+      /* refactor to check the single precision copy of the factor is updated */
+      PetscCall(MatLUFactorNumeric(F, S, &info));
+      PetscCall(MatSolve(F, b, ys));
+      if (k == 0) {
+        PetscCall(MatMult(A, ys, y));
+        PetscCall(CheckRelative(b, y, 10 * tol, "MatSolve() LU"));
+      } else {
+        Mat Fd;
+
+        PetscCall(MatGetFactor(A, MATSOLVERPETSC, ftypes[k], &Fd));
+        PetscCall(MatILUFactorSymbolic(Fd, A, rowperm, colperm, &info));
+        PetscCall(MatLUFactorNumeric(Fd, A, &info));
+        PetscCall(MatSolve(Fd, b, y));
+        PetscCall(CheckRelative(y, ys, tol, "MatSolve() ILU"));
+        PetscCall(MatDestroy(&Fd));
+      }
+      PetscCall(ISDestroy(&rowperm));
+      PetscCall(ISDestroy(&colperm));
+      PetscCall(MatDestroy(&F));
+    }
+  }
+
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&ys));
+  PetscCall(VecDestroy(&z));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(MatDestroy(&S));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  testset:
+    requires: !complex double
+    output_file: output/empty.out
+    nsize: {{1 2}}
+    test:
+      suffix: 1
+    test:
+      suffix: compress
+      args: -mat_aijsingle_compress_indices -mat_aijsingle_eager_shadow
+
+  test:
+    suffix: solve_levels
+    requires: !complex double
+    args: -mat_seqaij_solve_levels -info :mat
+    filter: grep -c "Keeping the double precision"
+
+TEST*/
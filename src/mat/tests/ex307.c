@@ -0,0 +1,75 @@
+static char help[] = "Tests MatMatMult() of a MATAIJ matrix with MATDENSE blocks of various widths.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc, char **args)
+{
+  Mat         A, B, Bsub, C;
+  PetscRandom rand;
+  PetscInt    m = 37, n = 43, Istart, Iend, nlocal, widths[] = {1, 2, 3, 4, 7, 8, 13, 16, 19, 32, 45, 70};
+  PetscBool   flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, m, n));
+  PetscCall(MatSetType(A, MATAIJ));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSetUp(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt i = Istart; i < Iend; i++) {
+    for (PetscInt j = 0; j < n; j++) {
+      if ((i * 31 + j * 17) % 7 < 2 || j == (i * n) / m) {
+        PetscScalar v;
+
+        PetscCall(PetscRandomGetValue(rand, &v));
+        PetscCall(MatSetValue(A, i, j, v, INSERT_VALUES));
+      }
+    }
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  /* the narrower blocks are the leading columns of the widest one */
+  PetscCall(MatGetLocalSize(A, NULL, &nlocal));
+  PetscCall(MatCreateDense(PETSC_COMM_WORLD, nlocal, PETSC_DECIDE, n, 70, NULL, &B));
+  PetscCall(MatSetRandom(B, rand));
+  for (size_t w = 0; w < PETSC_STATIC_ARRAY_LENGTH(widths); w++) {
+    PetscCall(MatDenseGetSubMatrix(B, PETSC_DECIDE, PETSC_DECIDE, 0, widths[w], &Bsub));
+    PetscCall(MatMatMult(A, Bsub, MAT_INITIAL_MATRIX, PETSC_DETERMINE, &C));
+    PetscCall(MatMatMultEqual(A, Bsub, C, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Error in MatMatMult() with %" PetscInt_FMT " columns", widths[w]);
+    /* reuse, the numeric product overwrites C */
+    PetscCall(MatScale(C, 2.0));
+    PetscCall(MatMatMult(A, Bsub, MAT_REUSE_MATRIX, PETSC_DETERMINE, &C));
+    PetscCall(MatMatMultEqual(A, Bsub, C, 5, &flg));
+    PetscCheck(flg, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Error in MatMatMult() reuse with %" PetscInt_FMT " columns", widths[w]);
+    PetscCall(MatDestroy(&C));
+    PetscCall(MatDenseRestoreSubMatrix(B, &Bsub));
+  }
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    nsize: {{1 3}}
+    output_file: output/empty.out
+
+  test:
+    suffix: empty_columns
+    nsize: 3
+    args: -n 2
+    output_file: output/empty.out
+
+TEST*/
@@ -0,0 +1,170 @@
+static char help[] = "Tests MatSetValues() with MAT_THREAD_SAFE_SET_VALUES for a finite element style assembly.\n\n";
+
+#include <petscmat.h>
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  #define ELEMENT_LOOP_PRAGMA(nthreads) PetscPragmaOMP(parallel for num_threads(nthreads))
+#else
+  #define ELEMENT_LOOP_PRAGMA(nthreads)
+#endif
+
+/* bilinear elements on an nx by ny grid of elements with bs unknowns per vertex, the elements are set by nthreads threads when possible */
+static PetscErrorCode AssembleElements(Mat A, PetscInt nx, PetscInt ny, PetscInt bs, PetscBool blocked, PetscScalar scale, InsertMode mode, PetscInt nthreads)
+{
+  PetscFunctionBeginUser;
+  ELEMENT_LOOP_PRAGMA((int)nthreads)
+  for (PetscInt e = 0; e < nx * ny; e++) {
+    const PetscInt ex = e % nx, ey = e / nx, n = 4 * bs;
+    PetscInt       vert[4], idx[4 * 8];
+    PetscScalar    ke[(4 * 8) * (4 * 8)];
+
+    vert[0] = ey * (nx + 1) + ex;
+    vert[1] = vert[0] + 1;
+    vert[2] = vert[0] + nx + 1;
+    vert[3] = vert[2] + 1;
+    for (PetscInt i = 0; i < n; i++) {
+      idx[i] = bs * vert[i / bs] + i % bs;
+      for (PetscInt j = 0; j < n; j++) ke[i * n + j] = scale * ((i == j ? 4.0 : -1.0) + 0.01 * (PetscReal)((e + i * j) % 7));
+    }
+    if (blocked) PetscCallAbort(PETSC_COMM_SELF, MatSetValuesBlocked(A, 4, vert, 4, vert, ke, mode));
+    else PetscCallAbort(PETSC_COMM_SELF, MatSetValues(A, n, idx, n, idx, ke, mode));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckEqual(Mat A, Mat B, PetscScalar scale, const char *msg)
+{
+  Mat       D;
+  PetscReal nrm, err;
+  MatInfo   ia, ib;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetInfo(A, MAT_LOCAL, &ia));
+  PetscCall(MatGetInfo(B, MAT_LOCAL, &ib));
+  PetscCheck(ia.nz_used == ib.nz_used, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong number of nonzeros %g != %g %s", ia.nz_used, ib.nz_used, msg);
+  PetscCall(MatDuplicate(B, MAT_COPY_VALUES, &D));
+  PetscCall(MatAXPY(D, -scale, A, DIFFERENT_NONZERO_PATTERN));
+  PetscCall(MatNorm(D, NORM_FROBENIUS, &err));
+  PetscCall(MatNorm(A, NORM_FROBENIUS, &nrm));
+  PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong values, relative difference %g %s", (double)(err / nrm), msg);
+  PetscCall(MatDestroy(&D));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat       A, T;
+  PetscInt  nx = 7, ny = 5, bs = 1, N, nthreads = 1;
+  PetscBool prealloc = PETSC_FALSE, blocked = PETSC_FALSE;
+  char      type[256] = MATSEQAIJ;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nx", &nx, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-ny", &ny, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-prealloc", &prealloc, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-blocked", &blocked, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-type", type, sizeof(type), NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nthreads", &nthreads, NULL));
+  PetscCheck(bs >= 1 && bs <= 8, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Block size must be between 1 and 8");
+  N = bs * (nx + 1) * (ny + 1);
+
+  /* reference matrix assembled serially */
+  PetscCall(MatCreate(PETSC_COMM_SELF, &A));
+  PetscCall(MatSetSizes(A, N, N, N, N));
+  PetscCall(MatSetBlockSize(A, bs));
+  PetscCall(MatSetType(A, type));
+  PetscCall(MatSeqAIJSetPreallocation(A, 9 * bs, NULL));
+  PetscCall(MatSeqBAIJSetPreallocation(A, bs, 9, NULL));
+  PetscCall(AssembleElements(A, nx, ny, bs, PETSC_FALSE, 1.0, ADD_VALUES, 1));
+
+  PetscCall(MatCreate(PETSC_COMM_SELF, &T));
+  PetscCall(MatSetSizes(T, N, N, N, N));
+  PetscCall(MatSetBlockSize(T, bs));
+  PetscCall(MatSetType(T, type));
+  if (prealloc) {
+    PetscCall(MatSeqAIJSetPreallocation(T, 9 * bs, NULL));
+    PetscCall(MatSeqBAIJSetPreallocation(T, bs, 9, NULL));
+    PetscCall(MatSetOption(T, MAT_THREAD_SAFE_SET_VALUES, PETSC_TRUE));
+  } else {
+    /* set before MatSetUp() so it is kept when the hash table is replaced at the first assembly */
+    PetscCall(MatSetOption(T, MAT_THREAD_SAFE_SET_VALUES, PETSC_TRUE));
+    PetscCall(MatSetUp(T));
+  }
+
+  /* the first assembly goes through the per-thread hash tables */
+  PetscCall(AssembleElements(T, nx, ny, bs, blocked, 1.0, ADD_VALUES, nthreads));
+  PetscCall(CheckEqual(A, T, 1.0, "after the first assembly"));
+
+  /* the nonzero structure is now fixed so the values are added in place */
+  PetscCall(MatZeroEntries(T));
+  PetscCall(AssembleElements(T, nx, ny, bs, blocked, 2.0, ADD_VALUES, nthreads));
+  PetscCall(CheckEqual(A, T, 2.0, "after the second assembly"));
+
+  /* a new nonzero after the first assembly is stashed and merged in MatAssemblyEnd() */
+  {
+    const PetscInt row = 0, col = N - 1;
+    PetscScalar    one = 1.0, two = 2.0;
+
+    PetscCall(MatSetOption(T, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+    PetscCall(MatSetValues(T, 1, &row, 1, &col, &two, ADD_VALUES));
+    PetscCall(MatAssemblyBegin(T, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(T, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+    PetscCall(MatSetValues(A, 1, &row, 1, &col, &one, ADD_VALUES));
+    PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+    PetscCall(CheckEqual(A, T, 2.0, "after adding a new nonzero"));
+  }
+
+  /* with MAT_IGNORE_ZERO_ENTRIES a zero added at a new location does not create a nonzero */
+  {
+    const PetscInt row = N - 1, col = 0;
+    PetscScalar    zero = 0.0;
+    MatInfo        info0, info;
+
+    PetscCall(MatGetInfo(T, MAT_LOCAL, &info0));
+    PetscCall(MatSetOption(T, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE));
+    PetscCall(MatSetValues(T, 1, &row, 1, &col, &zero, ADD_VALUES));
+    PetscCall(MatAssemblyBegin(T, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(T, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatGetInfo(T, MAT_LOCAL, &info));
+    PetscCheck(info.nz_used == info0.nz_used, PETSC_COMM_SELF, PETSC_ERR_PLIB, "A zero entry was inserted, %g nonzeros instead of %g", info.nz_used, info0.nz_used);
+  }
+  PetscCall(MatDestroy(&A));
+  PetscCall(MatDestroy(&T));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  testset:
+    requires: threadsafety
+    output_file: output/empty.out
+    args: -prealloc {{0 1}}
+    test:
+      suffix: aij
+    test:
+      suffix: baij
+      args: -type seqbaij -bs {{1 3}} -blocked {{0 1}}
+
+  testset:
+    requires: openmp threadsafety
+    output_file: output/empty.out
+    args: -nx 40 -ny 30 -nthreads 4 -prealloc {{0 1}}
+    test:
+      suffix: aij_threads
+    test:
+      suffix: baij_threads
+      args: -type seqbaij -bs {{1 3}} -blocked {{0 1}}
+
+  test:
+    suffix: unsupported
+    requires: !threadsafety
+    args: -petsc_ci_portable_error_output -error_output_stdout
+    filter: grep -E "(PETSC ERROR)" | head -n 3
+
+TEST*/
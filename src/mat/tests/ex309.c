@@ -0,0 +1,123 @@
+static char help[] = "Tests repeated finite element style assembly with off-process entries and -matstash_persistent.\n\n";
+
+#include <petscmat.h>
+
+/* bilinear elements on an nx by ny grid of elements with bs unknowns per vertex, the elements are distributed independently of the rows */
+static PetscErrorCode AssembleElements(Mat A, PetscInt nx, PetscInt ny, PetscInt bs, PetscBool blocked, PetscBool forward, PetscScalar scale)
+{
+  PetscInt nlocal = PETSC_DECIDE, nelem = nx * ny, estart;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscSplitOwnership(PetscObjectComm((PetscObject)A), &nlocal, &nelem));
+  PetscCallMPI(MPI_Scan(&nlocal, &estart, 1, MPIU_INT, MPI_SUM, PetscObjectComm((PetscObject)A)));
+  estart -= nlocal;
+  /* the elements are visited backwards, unless forward is set, so the stash is not already sorted */
+  for (PetscInt k = 0; k < nlocal; k++) {
+    const PetscInt e = forward ? estart + k : estart + nlocal - 1 - k, ex = e % nx, ey = e / nx, n = 4 * bs;
+    PetscInt       vert[4], idx[4 * 4];
+    PetscScalar    ke[(4 * 4) * (4 * 4)];
+
+    vert[0] = ey * (nx + 1) + ex;
+    vert[1] = vert[0] + 1;
+    vert[2] = vert[0] + nx + 1;
+    vert[3] = vert[2] + 1;
+    for (PetscInt i = 0; i < n; i++) {
+      idx[i] = bs * vert[i / bs] + i % bs;
+      for (PetscInt j = 0; j < n; j++) ke[i * n + j] = scale * ((i == j ? 4.0 : -1.0) + 0.01 * (PetscReal)((e + i * j) % 7));
+    }
+    if (blocked) PetscCall(MatSetValuesBlocked(A, 4, vert, 4, vert, ke, ADD_VALUES));
+    else PetscCall(MatSetValues(A, n, idx, n, idx, ke, ADD_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckEqual(Mat A, Mat B, PetscScalar scale, const char *msg)
+{
+  Mat       D;
+  PetscReal nrm, err;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatDuplicate(B, MAT_COPY_VALUES, &D));
+  PetscCall(MatAXPY(D, -scale, A, SAME_NONZERO_PATTERN));
+  PetscCall(MatNorm(D, NORM_FROBENIUS, &err));
+  PetscCall(MatNorm(A, NORM_FROBENIUS, &nrm));
+  PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PetscObjectComm((PetscObject)A), PETSC_ERR_PLIB, "Wrong values, relative difference %g %s", (double)(err / nrm), msg);
+  PetscCall(MatDestroy(&D));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateMatrix(PetscInt N, PetscInt bs, const char type[], Mat *A)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreate(PETSC_COMM_WORLD, A));
+  PetscCall(MatSetSizes(*A, PETSC_DECIDE, PETSC_DECIDE, N, N));
+  PetscCall(MatSetBlockSize(*A, bs));
+  PetscCall(MatSetType(*A, type));
+  PetscCall(MatMPIAIJSetPreallocation(*A, 9 * bs, NULL, 9 * bs, NULL));
+  PetscCall(MatMPIBAIJSetPreallocation(*A, bs, 9, NULL, 9, NULL));
+  PetscCall(MatSetOption(*A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat         A, T;
+  PetscInt    nx = 6, ny = 5, bs = 1, N;
+  PetscBool   blocked = PETSC_FALSE, change = PETSC_FALSE;
+  PetscMPIInt rank;
+  char        type[256] = MATMPIAIJ;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nx", &nx, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-ny", &ny, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-blocked", &blocked, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-change", &change, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-type", type, sizeof(type), NULL));
+  PetscCheck(bs >= 1 && bs <= 4, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Block size must be between 1 and 4");
+  N = bs * (nx + 1) * (ny + 1);
+
+  /* reference matrix assembled once */
+  PetscCall(CreateMatrix(N, bs, type, &A));
+  PetscCall(AssembleElements(A, nx, ny, bs, PETSC_FALSE, PETSC_FALSE, 1.0));
+
+  /* the first assembly records the communication, the later ones reuse it */
+  PetscCall(CreateMatrix(N, bs, type, &T));
+  PetscCall(AssembleElements(T, nx, ny, bs, blocked, PETSC_FALSE, 1.0));
+  PetscCall(CheckEqual(A, T, 1.0, "after the first assembly"));
+  /* with -change the first rank visits its elements in another order in the third assembly, so all the ranks record it again */
+  PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+  for (PetscInt it = 2; it < 5; it++) {
+    PetscCall(MatZeroEntries(T));
+    PetscCall(AssembleElements(T, nx, ny, bs, blocked, (PetscBool)(change && it == 3 && rank == 0), (PetscScalar)it));
+    PetscCall(CheckEqual(A, T, (PetscScalar)it, "after a later assembly"));
+  }
+  /* without zeroing the values are added to the assembled ones */
+  PetscCall(AssembleElements(T, nx, ny, bs, blocked, PETSC_FALSE, 1.0));
+  PetscCall(CheckEqual(A, T, 5.0, "after adding to the assembled matrix"));
+
+  PetscCall(MatDestroy(&A));
+  PetscCall(MatDestroy(&T));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  testset:
+    nsize: {{1 3}}
+    output_file: output/empty.out
+    args: -matstash_persistent
+    test:
+      suffix: aij
+    test:
+      suffix: baij
+      args: -type mpibaij -bs {{1 2}} -blocked {{0 1}}
+    test:
+      suffix: change
+      args: -change -type {{mpiaij mpibaij}}
+
+TEST*/
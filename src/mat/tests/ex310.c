@@ -0,0 +1,121 @@
+static char help[] = "Tests MatMult() and MatMultAdd() of MATMPIAIJ with MatMPIAIJSetUseSplitMult().\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckEqual(Vec x, Vec y, const char *op)
+{
+  PetscReal nrm, err;
+  Vec       w;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecDuplicate(x, &w));
+  PetscCall(VecWAXPY(w, -1.0, x, y));
+  PetscCall(VecNorm(w, NORM_INFINITY, &err));
+  PetscCall(VecNorm(x, NORM_INFINITY, &nrm));
+  PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PetscObjectComm((PetscObject)x), PETSC_ERR_PLIB, "Error in %s: difference %g", op, (double)err);
+  PetscCall(VecDestroy(&w));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckMult(Mat A, Mat S, PetscRandom rand, const char *msg)
+{
+  Vec  x, y, ys, z;
+  char op[128];
+
+  PetscFunctionBeginUser;
+  PetscCall(MatCreateVecs(A, &x, &y));
+  PetscCall(VecDuplicate(y, &ys));
+  PetscCall(VecDuplicate(y, &z));
+  PetscCall(VecSetRandom(x, rand));
+  PetscCall(VecSetRandom(z, rand));
+  PetscCall(MatMult(A, x, y));
+  PetscCall(MatMult(S, x, ys));
+  PetscCall(PetscSNPrintf(op, sizeof(op), "MatMult() %s", msg));
+  PetscCall(CheckEqual(y, ys, op));
+  PetscCall(MatMultAdd(A, x, z, y));
+  PetscCall(MatMultAdd(S, x, z, ys));
+  PetscCall(PetscSNPrintf(op, sizeof(op), "MatMultAdd() %s", msg));
+  PetscCall(CheckEqual(y, ys, op));
+  /* in place */
+  PetscCall(VecCopy(z, y));
+  PetscCall(VecCopy(z, ys));
+  PetscCall(MatMultAdd(A, x, y, y));
+  PetscCall(MatMultAdd(S, x, ys, ys));
+  PetscCall(PetscSNPrintf(op, sizeof(op), "in place MatMultAdd() %s", msg));
+  PetscCall(CheckEqual(y, ys, op));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&ys));
+  PetscCall(VecDestroy(&z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat         A, S;
+  PetscRandom rand;
+  PetscInt    n = 12, Istart, Iend;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+
+  /* five point stencil with random values, the rows next to the process boundaries have off-diagonal entries */
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n * n, n * n));
+  PetscCall(MatSetType(A, MATMPIAIJ));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatMPIAIJSetPreallocation(A, 5, NULL, 3, NULL));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    PetscInt    i = row / n, j = row - i * n, cols[5], nc = 0;
+    PetscScalar vals[5];
+
+    if (i > 0) cols[nc++] = row - n;
+    if (j > 0) cols[nc++] = row - 1;
+    cols[nc++] = row;
+    if (j < n - 1) cols[nc++] = row + 1;
+    if (i < n - 1) cols[nc++] = row + n;
+    for (PetscInt k = 0; k < nc; k++) PetscCall(PetscRandomGetValue(rand, &vals[k]));
+    PetscCall(MatSetValues(A, 1, &row, nc, cols, vals, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &S));
+  PetscCall(MatMPIAIJSetUseSplitMult(S, PETSC_TRUE));
+  PetscCall(CheckMult(A, S, rand, "after the first assembly"));
+
+  /* new nonzeros far from the diagonal change the boundary rows, the split must be recomputed */
+  PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  PetscCall(MatSetOption(S, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  for (PetscInt row = Istart; row < Iend; row += 5) {
+    PetscInt    col = (row + (n * n) / 2) % (n * n);
+    PetscScalar v   = 1.0 + row;
+
+    PetscCall(MatSetValues(A, 1, &row, 1, &col, &v, ADD_VALUES));
+    PetscCall(MatSetValues(S, 1, &row, 1, &col, &v, ADD_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyBegin(S, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(S, MAT_FINAL_ASSEMBLY));
+  PetscCall(CheckMult(A, S, rand, "after new nonzeros"));
+
+  PetscCall(MatDestroy(&A));
+  PetscCall(MatDestroy(&S));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    nsize: {{1 2 4}}
+    output_file: output/empty.out
+
+TEST*/
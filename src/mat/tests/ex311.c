@@ -0,0 +1,187 @@
+static char help[] = "Tests SeqAIJ LU and ILU factors with -mat_seqaij_solve_levels and -mat_seqaij_factor_levels.\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode SetLevels(PetscBool solve, PetscBool factor)
+{
+  PetscFunctionBeginUser;
+  PetscCall(PetscOptionsSetValue(NULL, "-mat_seqaij_solve_levels", solve ? "1" : "0"));
+  PetscCall(PetscOptionsSetValue(NULL, "-mat_seqaij_factor_levels", factor ? "1" : "0"));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* symbolic and numeric factorization of A into F, which may hold the factor of a matrix with another nonzero structure */
+static PetscErrorCode Factor(Mat A, MatFactorType ftype, MatOrderingType otype, Mat F)
+{
+  IS                 isrow, iscol;
+  MatFactorInfo      info;
+  MatFactorShiftType stype = MAT_SHIFT_NONE;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetOrdering(A, otype, &isrow, &iscol));
+  PetscCall(MatFactorInfoInitialize(&info));
+  info.fill = 1.0;
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-ilu_levels", &info.levels, NULL));
+  PetscCall(PetscOptionsGetEnum(NULL, NULL, "-shift_type", MatFactorShiftTypes, (PetscEnum *)&stype, NULL));
+  info.shifttype = (PetscReal)stype;
+  if (ftype == MAT_FACTOR_LU) PetscCall(MatLUFactorSymbolic(F, A, isrow, iscol, &info));
+  else PetscCall(MatILUFactorSymbolic(F, A, isrow, iscol, &info));
+  PetscCall(MatLUFactorNumeric(F, A, &info));
+  PetscCall(ISDestroy(&isrow));
+  PetscCall(ISDestroy(&iscol));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* five point stencil, or nine point stencil with the diagonal neighbors, with bs coupled unknowns per grid point and random values, the rows of a grid point form an I-node */
+static PetscErrorCode CreateMatrix(PetscInt n, PetscInt bs, PetscBool ninepoint, PetscRandom rand, Mat *A)
+{
+  const PetscInt N = bs * n * n;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatCreate(PETSC_COMM_SELF, A));
+  PetscCall(MatSetSizes(*A, N, N, N, N));
+  PetscCall(MatSetType(*A, MATSEQAIJ));
+  PetscCall(MatSetFromOptions(*A));
+  PetscCall(MatSeqAIJSetPreallocation(*A, 9 * bs, NULL));
+  for (PetscInt p = 0; p < n * n; p++) {
+    PetscInt i = p / n, j = p - i * n, pts[9], np = 0;
+
+    for (PetscInt di = -1; di <= 1; di++) {
+      for (PetscInt dj = -1; dj <= 1; dj++) {
+        if (i + di < 0 || i + di >= n || j + dj < 0 || j + dj >= n) continue;
+        if (!ninepoint && di && dj) continue;
+        pts[np++] = p + di * n + dj;
+      }
+    }
+    for (PetscInt k = 0; k < bs; k++) {
+      for (PetscInt q = 0; q < np; q++) {
+        for (PetscInt l = 0; l < bs; l++) {
+          PetscInt    row = bs * p + k, col = bs * pts[q] + l;
+          PetscScalar v;
+
+          PetscCall(PetscRandomGetValue(rand, &v));
+          if (row == col) v += 8.0 * bs;
+          else v = -v;
+          PetscCall(MatSetValues(*A, 1, &row, 1, &col, &v, INSERT_VALUES));
+        }
+      }
+    }
+  }
+  PetscCall(MatAssemblyBegin(*A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(*A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckSolve(Mat F, Mat G, PetscRandom rand, const char *msg)
+{
+  Vec       b, x, y;
+  PetscReal nrm, err;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatCreateVecs(F, &x, &b));
+  PetscCall(VecDuplicate(x, &y));
+  PetscCall(VecSetRandom(b, rand));
+  PetscCall(MatSolve(F, b, x));
+  PetscCall(MatSolve(G, b, y));
+  PetscCall(VecAXPY(y, -1.0, x));
+  PetscCall(VecNorm(y, NORM_INFINITY, &err));
+  PetscCall(VecNorm(x, NORM_INFINITY, &nrm));
+  PetscCheck(err <= 1000 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Error in MatSolve() %s: difference %g", msg, (double)err);
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&y));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat           A, F, G;
+  PetscRandom   rand;
+  PetscInt      n = 10, bs = 2;
+  PetscBool     ilu = PETSC_FALSE, solve_levels = PETSC_TRUE, factor_levels = PETSC_FALSE;
+  MatFactorType ftype;
+  char          otype[256] = MATORDERINGNATURAL;
+  MatFactorInfo info;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-ilu", &ilu, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-solve_levels", &solve_levels, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-factor_levels", &factor_levels, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-ordering", otype, sizeof(otype), NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_SELF, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  ftype = ilu ? MAT_FACTOR_ILU : MAT_FACTOR_LU;
+
+  PetscCall(CreateMatrix(n, bs, PETSC_FALSE, rand, &A));
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, ftype, &F));
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, ftype, &G));
+
+  PetscCall(SetLevels(PETSC_FALSE, PETSC_FALSE));
+  PetscCall(Factor(A, ftype, otype, F));
+  PetscCall(SetLevels(solve_levels, factor_levels));
+  PetscCall(Factor(A, ftype, otype, G));
+  PetscCall(CheckSolve(F, G, rand, "after the first factorization"));
+
+  /* the levels computed at the first numeric factorization are reused for new values */
+  PetscCall(MatScale(A, 2.0));
+  PetscCall(MatShift(A, 1.0));
+  PetscCall(MatFactorInfoInitialize(&info));
+  PetscCall(SetLevels(PETSC_FALSE, PETSC_FALSE));
+  PetscCall(MatLUFactorNumeric(F, A, &info));
+  PetscCall(SetLevels(solve_levels, factor_levels));
+  PetscCall(MatLUFactorNumeric(G, A, &info));
+  PetscCall(CheckSolve(F, G, rand, "after the second factorization"));
+
+  /* a new symbolic factorization of the same factors for another nonzero structure recomputes the I-nodes and levels */
+  PetscCall(MatDestroy(&A));
+  PetscCall(CreateMatrix(n, bs, PETSC_TRUE, rand, &A));
+  PetscCall(SetLevels(PETSC_FALSE, PETSC_FALSE));
+  PetscCall(Factor(A, ftype, otype, F));
+  PetscCall(SetLevels(solve_levels, factor_levels));
+  PetscCall(Factor(A, ftype, otype, G));
+  PetscCall(CheckSolve(F, G, rand, "after the factorization of another nonzero structure"));
+
+  PetscCall(MatDestroy(&A));
+  PetscCall(MatDestroy(&F));
+  PetscCall(MatDestroy(&G));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    output_file: output/empty.out
+    args: -ilu {{0 1}} -ordering {{natural nd rcm}} -bs {{1 3}}
+
+  test:
+    suffix: ilu_levels
+    output_file: output/empty.out
+    args: -ilu -ilu_levels {{1 2}} -ordering {{natural nd}}
+
+  test:
+    suffix: factor_levels
+    output_file: output/empty.out
+    args: -factor_levels -solve_levels {{0 1}} -ilu {{0 1}} -ordering {{natural nd}} -bs {{1 3}}
+
+  test:
+    suffix: factor_levels_inode
+    args: -factor_levels -ilu {{0 1}} -bs 3 -info :mat
+    filter: grep -c "instead of the I-node"
+
+  test:
+    suffix: factor_levels_shift
+    args: -factor_levels -shift_type {{nonzero positive_definite}} -info :mat
+    filter: grep -c "does not handle the shift type"
+
+  test:
+    suffix: no_inode
+    output_file: output/empty.out
+    args: -ilu {{0 1}} -ordering {{natural nd}} -mat_no_inode
+
+TEST*/
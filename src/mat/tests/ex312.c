@@ -0,0 +1,86 @@
+static char help[] = "Tests the memory traffic estimates of PetscLogBytes() used by -log_view_roofline.\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckBytes(PetscLogStage stage, const char name[], PetscLogDouble expected)
+{
+  PetscLogEvent      event;
+  PetscEventPerfInfo info;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscLogEventGetId(name, &event));
+  PetscCall(PetscLogEventGetPerfInfo(stage, event, &info));
+  PetscCheck(info.bytes == expected, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s logged %g bytes instead of %g", name, (double)info.bytes, (double)expected);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat           A;
+  Vec           x, y;
+  PetscInt      n = 100, nz;
+  PetscScalar   dot;
+  PetscReal     nrm;
+  PetscLogStage stage;
+  MatInfo       info;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscLogDefaultBegin());
+
+  /* tridiagonal matrix, the negative column index of the first row is ignored */
+  PetscCall(MatCreate(PETSC_COMM_SELF, &A));
+  PetscCall(MatSetSizes(A, n, n, n, n));
+  PetscCall(MatSetType(A, MATSEQAIJ));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSeqAIJSetPreallocation(A, 3, NULL));
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt    cols[3] = {i - 1, i, i + 1};
+    PetscScalar vals[3] = {-1.0, 2.0, -1.0};
+
+    PetscCall(MatSetValues(A, 1, &i, i < n - 1 ? 3 : 2, cols, vals, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatGetInfo(A, MAT_LOCAL, &info));
+  nz = (PetscInt)info.nz_used;
+  PetscCall(MatCreateVecs(A, &x, &y));
+  PetscCall(VecSet(x, 1.0));
+
+  PetscCall(PetscLogStageRegister("Roofline", &stage));
+  PetscCall(PetscLogStagePush(stage));
+  PetscCall(MatMult(A, x, y));
+  PetscCall(VecAXPY(y, 2.0, x));
+  PetscCall(VecDot(x, y, &dot));
+  PetscCall(VecNorm(y, NORM_2, &nrm));
+  PetscCall(PetscLogStagePop());
+
+  PetscCall(CheckBytes(stage, "MatMult", nz * (sizeof(PetscScalar) + sizeof(PetscInt)) + (n + 1.0) * sizeof(PetscInt) + 2.0 * n * sizeof(PetscScalar)));
+  PetscCall(CheckBytes(stage, "VecAXPY", 3.0 * n * sizeof(PetscScalar)));
+  PetscCall(CheckBytes(stage, "VecDot", 2.0 * n * sizeof(PetscScalar)));
+  PetscCall(CheckBytes(stage, "VecNorm", 1.0 * n * sizeof(PetscScalar)));
+
+  PetscCall(MatDestroy(&A));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&y));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    requires: defined(PETSC_USE_LOG)
+    args: -mat_no_inode {{0 1}}
+    output_file: output/empty.out
+
+  test:
+    suffix: log_view
+    requires: defined(PETSC_USE_LOG) double !complex !defined(PETSC_USE_64BIT_INDICES)
+    args: -log_view -log_view_roofline -log_view_roofline_bandwidth 10000 -log_view_roofline_flops 1000
+    filter: sed -n "/^Roofline of/,/^------/p" | grep -v "^------" | cut -c 1-28
+    output_file: output/ex312_log_view.out
+
+TEST*/
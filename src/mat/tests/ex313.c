@@ -0,0 +1,124 @@
+static char help[] = "Tests MatMatrixPowers() against repeated MatMult().\n\n";
+
+#include <petscmat.h>
+
+/* y[j + 1] = gamma_j (D A y[j] - alpha_j y[j] - delta_j y[j - 1]) with MatMult() */
+static PetscErrorCode MatrixPowersReference(Mat A, PetscInt k, Vec D, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], Vec x, Vec y[])
+{
+  PetscFunctionBeginUser;
+  PetscCall(VecCopy(x, y[0]));
+  for (PetscInt j = 0; j < k; j++) {
+    PetscCall(MatMult(A, y[j], y[j + 1]));
+    if (D) PetscCall(VecPointwiseMult(y[j + 1], D, y[j + 1]));
+    PetscCall(VecAXPY(y[j + 1], -alpha[j], y[j]));
+    if (j) PetscCall(VecAXPY(y[j + 1], -delta[j], y[j - 1]));
+    PetscCall(VecScale(y[j + 1], gamma[j]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckPowers(Mat A, PetscInt k, Vec D, const PetscScalar gamma[], const PetscScalar alpha[], const PetscScalar delta[], Vec x, Vec y[], Vec z[])
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatMatrixPowers(A, k, D, gamma, alpha, delta, x, y));
+  PetscCall(MatrixPowersReference(A, k, D, gamma, alpha, delta, x, z));
+  for (PetscInt j = 0; j <= k; j++) {
+    PetscReal err, nrm;
+
+    PetscCall(VecNorm(z[j], NORM_INFINITY, &nrm));
+    PetscCall(VecAXPY(z[j], -1.0, y[j]));
+    PetscCall(VecNorm(z[j], NORM_INFINITY, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Power %" PetscInt_FMT " of %" PetscInt_FMT " differs by %g", j, k, (double)(err / nrm));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **args)
+{
+  Mat         A;
+  Vec         x, D, *y, *z;
+  PetscInt    n = 8, k = 4, Istart, Iend;
+  PetscScalar gamma[8], alpha[8], delta[8];
+  PetscRandom rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &args, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-k", &k, NULL));
+  PetscCheck(k <= 8, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "At most 8 powers");
+
+  /* the nonsymmetric 5-point stencil on an n x n grid, with an additional coupling to the last unknown of the previous row */
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n * n, n * n));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSetUp(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    PetscInt i = row / n, j = row - i * n;
+
+    if (i > 0) PetscCall(MatSetValue(A, row, row - n, -1.0, INSERT_VALUES));
+    if (i < n - 1) PetscCall(MatSetValue(A, row, row + n, -2.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, row, row - 1, -1.0, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, row, row + 1, -0.5, INSERT_VALUES));
+    if (i > 0 && j == 0) PetscCall(MatSetValue(A, row, row - 1, 0.25, INSERT_VALUES));
+    PetscCall(MatSetValue(A, row, row, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(MatCreateVecs(A, &x, &D));
+  PetscCall(VecSetRandom(x, rand));
+  PetscCall(VecSetRandom(D, rand));
+  PetscCall(VecDuplicateVecs(x, k + 1, &y));
+  PetscCall(VecDuplicateVecs(x, k + 1, &z));
+  for (PetscInt j = 0; j < k; j++) {
+    gamma[j] = 1.0;
+    alpha[j] = 0.0;
+    delta[j] = 0.0;
+  }
+
+  /* monomial basis, then with smaller k reusing the ghost region */
+  PetscCall(CheckPowers(A, k, NULL, gamma, alpha, delta, x, y, z));
+  PetscCall(CheckPowers(A, k - 1, NULL, gamma, alpha, delta, x, y, z));
+
+  /* Chebyshev-like recurrence with a diagonal scaling */
+  for (PetscInt j = 0; j < k; j++) {
+    gamma[j] = j ? 0.5 : 0.25;
+    alpha[j] = 2.0 + 0.1 * j;
+    delta[j] = j ? 1.5 : 0.0;
+  }
+  PetscCall(CheckPowers(A, k, D, gamma, alpha, delta, x, y, z));
+
+  /* new values of the matrix and of the diagonal scaling */
+  PetscCall(MatScale(A, 0.5));
+  PetscCall(MatShift(A, 1.0));
+  PetscCall(VecScale(D, 2.0));
+  PetscCall(CheckPowers(A, k, D, gamma, alpha, delta, x, y, z));
+
+  PetscCall(VecDestroyVecs(k + 1, &y));
+  PetscCall(VecDestroyVecs(k + 1, &z));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&D));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    nsize: {{1 2 3}}
+    args: -k {{1 3 6}}
+    output_file: output/empty.out
+
+  test:
+    suffix: baij
+    nsize: 2
+    args: -mat_type baij
+    output_file: output/empty.out
+
+TEST*/
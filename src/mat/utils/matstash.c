@@ -9,6 +9,7 @@ PETSC_INTERN PetscErrorCode MatStashScatterEnd_Ref(MatStash *);
 static PetscErrorCode MatStashScatterBegin_BTS(Mat, MatStash *, PetscInt *);
 static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash *, PetscMPIInt *, PetscInt **, PetscInt **, PetscScalar **, PetscInt *);
 static PetscErrorCode MatStashScatterEnd_BTS(MatStash *);
+static PetscErrorCode MatStashPersistentDestroy_Private(MatStash *);
 #endif
 
 /*
@@ -75,6 +76,10 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm, PetscInt bs, MatStash *stas
   stash->nprocessed  = 0;
   stash->reproduce   = PETSC_FALSE;
   stash->blocktype   = MPI_DATATYPE_NULL;
+  stash->persistent  = PETSC_FALSE;
+  stash->pready      = PETSC_FALSE;
+  stash->pactive     = PETSC_FALSE;
+  stash->preqs       = NULL;
 
   PetscCall(PetscOptionsGetBool(NULL, NULL, "-matstash_reproduce", &stash->reproduce, NULL));
 #if !defined(PETSC_HAVE_MPIUNI)
@@ -85,6 +90,7 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm, PetscInt bs, MatStash *stas
     stash->ScatterGetMesg = MatStashScatterGetMesg_BTS;
     stash->ScatterEnd     = MatStashScatterEnd_BTS;
     stash->ScatterDestroy = MatStashScatterDestroy_BTS;
+    PetscCall(PetscOptionsGetBool(NULL, NULL, "-matstash_persistent", &stash->persistent, NULL));
   } else {
 #endif
     stash->ScatterBegin   = MatStashScatterBegin_Ref;
@@ -105,6 +111,9 @@ PetscErrorCode MatStashDestroy_Private(MatStash *stash)
   PetscFunctionBegin;
   PetscCall(PetscMatStashSpaceDestroy(&stash->space_head));
   if (stash->ScatterDestroy) PetscCall((*stash->ScatterDestroy)(stash));
+#if !defined(PETSC_HAVE_MPIUNI)
+  PetscCall(MatStashPersistentDestroy_Private(stash));
+#endif
   stash->space = NULL;
   PetscCall(PetscFree(stash->flg_v));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -681,10 +690,12 @@ typedef struct {
   PetscScalar vals[1]; /* Actually an array of length bs2 */
 } MatStashBlock;
 
-static PetscErrorCode MatStashSortCompress_Private(MatStash *stash, InsertMode insertmode)
+/* If map is provided, map[k] is set to the send block that the k-th stashed entry is combined into */
+static PetscErrorCode MatStashSortCompress_Private(MatStash *stash, InsertMode insertmode, PetscCount map[])
 {
   PetscMatStashSpace space;
   PetscInt           n = stash->n, bs = stash->bs, bs2 = bs * bs, cnt, *row, *col, *perm, rowstart, i;
+  PetscCount         nblocks = 0;
   PetscScalar      **valptr;
 
   PetscFunctionBegin;
@@ -712,7 +723,9 @@ static PetscErrorCode MatStashSortCompress_Private(MatStash *stash, InsertMode i
         block->row = row[rowstart];
         block->col = col[colstart];
         PetscCall(PetscArraycpy(block->vals, valptr[perm[colstart]], bs2));
+        if (map) map[perm[colstart]] = nblocks;
         for (j = colstart + 1; j < i && col[j] == col[colstart]; j++) { /* Add any extra stashed blocks at the same (row,col) */
+          if (map) map[perm[j]] = nblocks;
           if (insertmode == ADD_VALUES) {
             for (l = 0; l < bs2; l++) block->vals[l] += valptr[perm[j]][l];
           } else {
@@ -720,6 +733,7 @@ static PetscErrorCode MatStashSortCompress_Private(MatStash *stash, InsertMode i
           }
         }
         colstart = j;
+        nblocks++;
       }
       rowstart = i;
     }
@@ -815,6 +829,166 @@ static PetscErrorCode MatStashBTSRecv_Private(MPI_Comm comm, const PetscMPIInt t
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   The first assembly with -matstash_persistent records the global row and column of every stashed entry and which send block
+   it is combined into, together with the blocks exchanged with each rank. Later assemblies that stash the same entries in the same
+   order then only combine the values into the send buffer and exchange them with persistent requests, without sorting the stash
+   or the rendezvous of PetscCommBuildTwoSidedFReq(). If any rank stashes different entries, all the ranks drop the recording, see
+   MatStashPersistentMatch_Private(), and the assembly goes through the rendezvous and is recorded again.
+*/
+static PetscErrorCode MatStashPersistentRecord_Private(MatStash *stash)
+{
+  PetscMatStashSpace space;
+  PetscInt           k = 0;
+
+  PetscFunctionBegin;
+  stash->pn = stash->n;
+  PetscCall(PetscMalloc3(stash->pn, &stash->prow, stash->pn, &stash->pcol, stash->pn, &stash->pmap));
+  for (space = stash->space_head; space; space = space->next) {
+    PetscCall(PetscArraycpy(&stash->prow[k], space->idx, space->local_used));
+    PetscCall(PetscArraycpy(&stash->pcol[k], space->idy, space->local_used));
+    k += space->local_used;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Called at the end of the recorded assembly, when the received blocks have been decoded by MatStashScatterGetMesg_BTS() */
+static PetscErrorCode MatStashPersistentSetUp_Private(MatStash *stash)
+{
+  PetscInt    bs2 = PetscSqr(stash->bs);
+  PetscBool   lany, any;
+  PetscMPIInt tag, i;
+
+  PetscFunctionBegin;
+  lany = stash->nsendranks ? PETSC_TRUE : PETSC_FALSE;
+  PetscCallMPI(MPIU_Allreduce(&lany, &any, 1, MPIU_BOOL, MPI_LOR, stash->comm));
+  if (!any) { /* Nothing was communicated, record the next assembly instead */
+    PetscCall(PetscFree3(stash->prow, stash->pcol, stash->pmap));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  stash->pinsertmode = *stash->insertmode;
+  stash->pnsends     = stash->nsendranks;
+  stash->pnrecvs     = stash->nrecvranks;
+  PetscCall(PetscMalloc2(stash->pnsends + 1, &stash->psendoffset, stash->pnrecvs + 1, &stash->precvoffset));
+  stash->psendoffset[0] = 0;
+  for (i = 0; i < stash->pnsends; i++) stash->psendoffset[i + 1] = stash->psendoffset[i] + stash->sendframes[i].count;
+  stash->precvoffset[0] = 0;
+  for (i = 0; i < stash->pnrecvs; i++) stash->precvoffset[i + 1] = stash->precvoffset[i] + stash->recvframes[i].count;
+  PetscCall(PetscMalloc2(stash->precvoffset[stash->pnrecvs], &stash->precvrow, stash->precvoffset[stash->pnrecvs], &stash->precvcol));
+  PetscCall(PetscMalloc2(stash->psendoffset[stash->pnsends] * bs2, &stash->psendvals, stash->precvoffset[stash->pnrecvs] * bs2, &stash->precvvals));
+  PetscCall(PetscMalloc1(stash->pnrecvs + stash->pnsends, &stash->preqs));
+
+  PetscCall(PetscCommGetNewTag(stash->comm, &tag));
+  for (i = 0; i < stash->pnrecvs; i++) {
+    MatStashFrame *frame = &stash->recvframes[i];
+    PetscInt       off   = stash->precvoffset[i];
+
+    for (PetscInt b = 0; b < frame->count; b++) {
+      MatStashBlock *block = (MatStashBlock *)&((char *)frame->buffer)[b * stash->blocktype_size];
+
+      stash->precvrow[off + b] = block->row < 0 ? -(block->row + 1) : block->row;
+      stash->precvcol[off + b] = block->col;
+    }
+    PetscCallMPI(MPIU_Recv_init(&stash->precvvals[off * bs2], frame->count * bs2, MPIU_SCALAR, stash->recvranks[i], tag, stash->comm, &stash->preqs[i]));
+  }
+  for (i = 0; i < stash->pnsends; i++) {
+    PetscInt off = stash->psendoffset[i];
+
+    PetscCallMPI(MPIU_Send_init(&stash->psendvals[off * bs2], (stash->psendoffset[i + 1] - off) * bs2, MPIU_SCALAR, stash->sendranks[i], tag, stash->comm, &stash->preqs[stash->pnrecvs + i]));
+  }
+  stash->pready = PETSC_TRUE;
+  PetscCall(PetscInfo(NULL, "Recorded %" PetscInt_FMT " stashed entries sent in %" PetscInt_FMT " blocks to %d ranks and %" PetscInt_FMT " blocks received from %d ranks\n", stash->pn, stash->psendoffset[stash->pnsends], stash->pnsends, stash->precvoffset[stash->pnrecvs], stash->pnrecvs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Whether this rank stashed the recorded entries in the recorded order, with the recorded InsertMode */
+static PetscErrorCode MatStashPersistentMatch_Private(Mat mat, MatStash *stash, PetscBool *match)
+{
+  PetscMatStashSpace space;
+  PetscInt           k = 0;
+
+  PetscFunctionBegin;
+  *match = PETSC_FALSE;
+  if (stash->n != stash->pn) PetscFunctionReturn(PETSC_SUCCESS);
+  if ((stash->pn || stash->pnrecvs) && mat->insertmode != NOT_SET_VALUES && mat->insertmode != stash->pinsertmode) PetscFunctionReturn(PETSC_SUCCESS);
+  for (space = stash->space_head; space; space = space->next) {
+    for (PetscInt i = 0; i < space->local_used; i++, k++) {
+      if (space->idx[i] != stash->prow[k] || space->idy[i] != stash->pcol[k]) PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  *match = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatStashScatterBegin_Persistent(Mat mat, MatStash *stash)
+{
+  PetscMatStashSpace space;
+  PetscInt           bs2 = PetscSqr(stash->bs), k = 0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArrayzero(stash->psendvals, stash->psendoffset[stash->pnsends] * bs2));
+  for (space = stash->space_head; space; space = space->next) {
+    for (PetscInt i = 0; i < space->local_used; i++, k++) {
+      PetscScalar       *vals = &stash->psendvals[stash->pmap[k] * bs2];
+      const PetscScalar *v    = &space->val[i * bs2];
+
+      if (stash->pinsertmode == ADD_VALUES) {
+        for (PetscInt l = 0; l < bs2; l++) vals[l] += v[l];
+      } else {
+        PetscCall(PetscArraycpy(vals, v, bs2));
+      }
+    }
+  }
+  if (stash->pnrecvs + stash->pnsends) PetscCallMPI(MPI_Startall(stash->pnrecvs + stash->pnsends, stash->preqs));
+  stash->precvcount = 0;
+  stash->pactive    = PETSC_TRUE;
+  stash->insertmode = &mat->insertmode;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Returns all the blocks received from one rank at a time, sorted by row as they were sent */
+static PetscErrorCode MatStashScatterGetMesg_Persistent(MatStash *stash, PetscMPIInt *n, PetscInt **row, PetscInt **col, PetscScalar **val, PetscInt *flg)
+{
+  PetscFunctionBegin;
+  *flg = 0;
+  while (stash->precvcount < stash->pnrecvs) {
+    PetscMPIInt i;
+    PetscInt    off;
+
+    PetscCallMPI(MPI_Waitany(stash->pnrecvs, stash->preqs, &i, MPI_STATUS_IGNORE));
+    stash->precvcount++;
+    off = stash->precvoffset[i];
+    if (stash->precvoffset[i + 1] == off) continue;
+    if (PetscUnlikely(*stash->insertmode == NOT_SET_VALUES)) *stash->insertmode = stash->pinsertmode;
+    PetscCheck(*stash->insertmode == stash->pinsertmode, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "-matstash_persistent requires the InsertMode of the first assembly");
+    PetscCall(PetscMPIIntCast(stash->precvoffset[i + 1] - off, n));
+    *row = &stash->precvrow[off];
+    *col = &stash->precvcol[off];
+    *val = &stash->precvvals[off * PetscSqr(stash->bs)];
+    *flg = 1;
+    break;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatStashPersistentDestroy_Private(MatStash *stash)
+{
+  PetscFunctionBegin;
+  if (stash->preqs) {
+    for (PetscMPIInt i = 0; i < stash->pnrecvs + stash->pnsends; i++) PetscCallMPI(MPI_Request_free(&stash->preqs[i]));
+  }
+  PetscCall(PetscFree(stash->preqs));
+  PetscCall(PetscFree3(stash->prow, stash->pcol, stash->pmap));
+  PetscCall(PetscFree2(stash->psendoffset, stash->precvoffset));
+  PetscCall(PetscFree2(stash->precvrow, stash->precvcol));
+  PetscCall(PetscFree2(stash->psendvals, stash->precvvals));
+  stash->pnsends = 0;
+  stash->pnrecvs = 0;
+  stash->pready  = PETSC_FALSE;
+  stash->pactive = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
  * owners[] contains the ownership ranges; may be indexed by either blocks or scalars
  */
@@ -829,9 +1003,23 @@ static PetscErrorCode MatStashScatterBegin_BTS(Mat mat, MatStash *stash, PetscIn
     PetscCallMPI(MPIU_Allreduce((PetscEnum *)&mat->insertmode, (PetscEnum *)&addv, 1, MPIU_ENUM, MPI_BOR, PetscObjectComm((PetscObject)mat)));
     PetscCheck(addv != (ADD_VALUES | INSERT_VALUES), PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Some processors inserted others added");
   }
+  if (stash->pready) {
+    PetscBool match, allmatch;
+
+    PetscCall(MatStashPersistentMatch_Private(mat, stash, &match));
+    PetscCallMPI(MPIU_Allreduce(&match, &allmatch, 1, MPIU_BOOL, MPI_LAND, stash->comm));
+    if (allmatch) {
+      PetscCall(MatStashScatterBegin_Persistent(mat, stash));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    PetscCall(PetscInfo(NULL, "Off-process entries differ from the recorded assembly on %s, recording this assembly instead\n", match ? "another rank" : "this rank"));
+    PetscCall(MatStashPersistentDestroy_Private(stash));
+  }
 
   PetscCall(MatStashBlockTypeSetUp(stash));
-  PetscCall(MatStashSortCompress_Private(stash, mat->insertmode));
+  /* Only the assemblies that go through the rendezvous can be recorded, see MatStashScatterEnd_BTS() */
+  if (stash->persistent && !stash->first_assembly_done) PetscCall(MatStashPersistentRecord_Private(stash));
+  PetscCall(MatStashSortCompress_Private(stash, mat->insertmode, stash->persistent && !stash->first_assembly_done ? stash->pmap : NULL));
   PetscCall(PetscSegBufferGetSize(stash->segsendblocks, &nblocks));
   PetscCall(PetscSegBufferExtractInPlace(stash->segsendblocks, &sendblocks));
   if (stash->first_assembly_done) { /* Set up sendhdrs and sendframes for each rank that we sent before */
@@ -933,6 +1121,10 @@ static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash *stash, PetscMPIInt *n
   MatStashBlock *block;
 
   PetscFunctionBegin;
+  if (stash->pactive) {
+    PetscCall(MatStashScatterGetMesg_Persistent(stash, n, row, col, val, flg));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   *flg = 0;
   while (!stash->recvframe_active || stash->recvframe_i == stash->recvframe_count) {
     if (stash->some_i == stash->some_count) {
@@ -972,11 +1164,17 @@ static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash *stash, PetscMPIInt *n
 static PetscErrorCode MatStashScatterEnd_BTS(MatStash *stash)
 {
   PetscFunctionBegin;
-  PetscCallMPI(MPI_Waitall(stash->nsendranks, stash->sendreqs, MPI_STATUSES_IGNORE));
-  if (stash->first_assembly_done) { /* Reuse the communication contexts, so consolidate and reset segrecvblocks  */
-    PetscCall(PetscSegBufferExtractInPlace(stash->segrecvblocks, NULL));
-  } else { /* No reuse, so collect everything. */
-    PetscCall(MatStashScatterDestroy_BTS(stash));
+  if (stash->pactive) {
+    PetscCallMPI(MPI_Waitall(stash->pnrecvs + stash->pnsends, stash->preqs, MPI_STATUSES_IGNORE));
+    stash->pactive = PETSC_FALSE;
+  } else {
+    PetscCallMPI(MPI_Waitall(stash->nsendranks, stash->sendreqs, MPI_STATUSES_IGNORE));
+    if (stash->persistent && !stash->pready && !stash->use_status) PetscCall(MatStashPersistentSetUp_Private(stash));
+    if (stash->first_assembly_done) { /* Reuse the communication contexts, so consolidate and reset segrecvblocks  */
+      PetscCall(PetscSegBufferExtractInPlace(stash->segrecvblocks, NULL));
+    } else { /* No reuse, so collect everything. */
+      PetscCall(MatStashScatterDestroy_BTS(stash));
+    }
   }
 
   /* Now update nmaxold to be app 10% more than max n used, this way the
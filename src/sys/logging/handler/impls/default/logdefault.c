@@ -6,6 +6,16 @@
 #include <petscconfiginfo.h>
 #include <petscmachineinfo.h>
 #include "logdefault.h"
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #include <errno.h>
+  #include <string.h>
+  #if defined(SYS_perf_event_open)
+    #define PETSC_LOG_USE_PERF_EVENT
+  #endif
+#endif
 
 static PetscErrorCode PetscEventPerfInfoInit(PetscEventPerfInfo *eventInfo)
 {
@@ -45,6 +55,7 @@ static PetscErrorCode PetscEventPerfInfoTic_Internal(PetscEventPerfInfo *eventIn
   eventInfo->numMessages -= petsc_irecv_ct_th + petsc_isend_ct_th + petsc_recv_ct_th + petsc_send_ct_th;
   eventInfo->messageLength -= petsc_irecv_len_th + petsc_isend_len_th + petsc_recv_len_th + petsc_send_len_th;
   eventInfo->numReductions -= petsc_allreduce_ct_th + petsc_gather_ct_th + petsc_scatter_ct_th;
+  eventInfo->bytes -= petsc_TotalBytes_th;
 #if defined(PETSC_HAVE_DEVICE)
   eventInfo->CpuToGpuCount -= petsc_ctog_ct_th;
   eventInfo->GpuToCpuCount -= petsc_gtoc_ct_th;
@@ -94,6 +105,7 @@ static PetscErrorCode PetscEventPerfInfoToc_Internal(PetscEventPerfInfo *eventIn
   eventInfo->numMessages += petsc_irecv_ct_th + petsc_isend_ct_th + petsc_recv_ct_th + petsc_send_ct_th;
   eventInfo->messageLength += petsc_irecv_len_th + petsc_isend_len_th + petsc_recv_len + petsc_send_len_th;
   eventInfo->numReductions += petsc_allreduce_ct_th + petsc_gather_ct_th + petsc_scatter_ct_th;
+  eventInfo->bytes += petsc_TotalBytes_th;
 #if defined(PETSC_HAVE_DEVICE)
   eventInfo->CpuToGpuCount += petsc_ctog_ct_th;
   eventInfo->GpuToCpuCount += petsc_gtoc_ct_th;
@@ -141,6 +153,7 @@ static PetscErrorCode PetscEventPerfInfoAdd_Internal(const PetscEventPerfInfo *e
   outInfo->numMessages += eventInfo->numMessages;
   outInfo->messageLength += eventInfo->messageLength;
   outInfo->numReductions += eventInfo->numReductions;
+  outInfo->bytes += eventInfo->bytes;
 #if defined(PETSC_HAVE_DEVICE)
   outInfo->CpuToGpuCount += eventInfo->CpuToGpuCount;
   outInfo->GpuToCpuCount += eventInfo->GpuToCpuCount;
@@ -158,6 +171,64 @@ static PetscErrorCode PetscEventPerfInfoAdd_Internal(const PetscEventPerfInfo *e
 
 PETSC_LOG_RESIZABLE_ARRAY(EventPerfArray, PetscEventPerfInfo, PetscLogEvent, PetscEventPerfInfoInit, NULL, NULL)
 
+/* --- PetscEventHistogram --- */
+
+/* The durations of the calls to an event are counted in logarithmic buckets: bucket b holds the durations in
+   [2^(b + PETSC_LOG_HISTOGRAM_EMIN), 2^(b + 1 + PETSC_LOG_HISTOGRAM_EMIN)) seconds, the first and last buckets also hold the
+   shorter and the longer ones. Recording a call is a frexp() and an increment, and the memory is fixed per stage and event */
+#define PETSC_LOG_HISTOGRAM_NBINS 48
+#define PETSC_LOG_HISTOGRAM_EMIN  (-30)
+
+typedef struct {
+  PetscLogDouble count[PETSC_LOG_HISTOGRAM_NBINS]; /* The number of calls with a duration in each bucket */
+  PetscLogDouble max;                              /* The longest duration */
+} PetscEventHistogram;
+
+PETSC_LOG_RESIZABLE_ARRAY(EventHistogramArray, PetscEventHistogram, PetscLogEvent, NULL, NULL, NULL)
+
+static inline void PetscEventHistogramAdd(PetscEventHistogram *hist, PetscLogDouble time)
+{
+  int e = PETSC_LOG_HISTOGRAM_EMIN;
+
+  if (time > 0.0) (void)frexp(time, &e); /* time is in [2^(e-1), 2^e) */
+  hist->count[PetscClipInterval(e - 1 - PETSC_LOG_HISTOGRAM_EMIN, 0, PETSC_LOG_HISTOGRAM_NBINS - 1)] += 1.0;
+  hist->max = PetscMax(hist->max, time);
+}
+
+/* The q-quantile of the durations counted in count[], interpolated geometrically inside its bucket */
+static PetscErrorCode PetscEventHistogramQuantile(const PetscLogDouble count[], PetscLogDouble q, PetscLogDouble *value)
+{
+  PetscLogDouble total = 0.0, target, below = 0.0;
+  int            b;
+
+  PetscFunctionBegin;
+  for (b = 0; b < PETSC_LOG_HISTOGRAM_NBINS; b++) total += count[b];
+  target = q * total;
+  for (b = 0; b < PETSC_LOG_HISTOGRAM_NBINS - 1; b++) {
+    if (count[b] > 0.0 && below + count[b] >= target) break;
+    below += count[b];
+  }
+  *value = ldexp(pow(2.0, count[b] > 0.0 ? (target - below) / count[b] : 1.0), b + PETSC_LOG_HISTOGRAM_EMIN);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* --- PetscEventCounters --- */
+
+/* With -log_view_hardware_counters the CPU cycles, the instructions, and the last level cache references and misses of the thread
+   that created the log handler are read with perf_event_open() at the beginning and end of each event. The counters are opened as
+   one group, so they are read together with one read() */
+#define PETSC_LOG_NCOUNTERS 4
+
+static const char *const PetscLogCounterNames[PETSC_LOG_NCOUNTERS] = {"cycles", "instructions", "LLC references", "LLC misses"};
+
+typedef struct {
+  PetscLogDouble count[PETSC_LOG_NCOUNTERS]; /* The counts over all the calls to the event */
+  PetscLogDouble begin[PETSC_LOG_NCOUNTERS]; /* The counters when the current call began */
+  PetscBool      running;                    /* The current call began in this stage */
+} PetscEventCounters;
+
+PETSC_LOG_RESIZABLE_ARRAY(EventCountersArray, PetscEventCounters, PetscLogEvent, NULL, NULL, NULL)
+
 /* --- PetscClassPerf --- */
 
 typedef struct {
@@ -179,10 +250,12 @@ PETSC_LOG_RESIZABLE_ARRAY(ClassPerfArray, PetscClassPerf, PetscLogClass, PetscCl
 /* --- PetscStagePerf --- */
 
 typedef struct _PetscStagePerf {
-  PetscBool              used;     /* The stage was pushed on this processor */
-  PetscEventPerfInfo     perfInfo; /* The stage performance information */
-  PetscLogEventPerfArray eventLog; /* The event information for this stage */
-  PetscLogClassPerfArray classLog; /* The class information for this stage */
+  PetscBool                   used;     /* The stage was pushed on this processor */
+  PetscEventPerfInfo          perfInfo; /* The stage performance information */
+  PetscLogEventPerfArray      eventLog; /* The event information for this stage */
+  PetscLogClassPerfArray      classLog; /* The class information for this stage */
+  PetscLogEventHistogramArray histLog;  /* The event duration histograms for this stage, created with -log_view_histograms */
+  PetscLogEventCountersArray  countLog; /* The event hardware counters for this stage, created with -log_view_hardware_counters */
 } PetscStagePerf;
 
 static PetscErrorCode PetscStageInfoInit(PetscStagePerf *stageInfo)
@@ -200,6 +273,8 @@ static PetscErrorCode PetscStageInfoReset(PetscStagePerf *stageInfo)
   PetscFunctionBegin;
   PetscCall(PetscLogEventPerfArrayDestroy(&stageInfo->eventLog));
   PetscCall(PetscLogClassPerfArrayDestroy(&stageInfo->classLog));
+  PetscCall(PetscLogEventHistogramArrayDestroy(&stageInfo->histLog));
+  PetscCall(PetscLogEventCountersArrayDestroy(&stageInfo->countLog));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -259,8 +334,84 @@ struct _n_PetscLogHandler_Default {
   PetscHMapEvent         eventInfoMap_th;
   int                    pause_depth;
   PetscBool              use_threadsafe;
+  PetscBool              histograms;
+  PetscBool              counters;                          /* -log_view_hardware_counters */
+  int                    ncounters;                         /* The number of hardware counters that could be opened */
+  int                    counter_pos[PETSC_LOG_NCOUNTERS];  /* The position of each counter in the group read, or -1 */
+  int                    counter_fd[PETSC_LOG_NCOUNTERS];   /* The file descriptors of the opened counters, the first is the group leader */
+  PetscBool              roofline;                          /* -log_view_roofline */
+  PetscReal              roofline_bandwidth;                /* The memory bandwidth of the machine in MB/s, or 0 if unknown */
+  PetscReal              roofline_flops;                    /* The peak flop rate of the machine in Mflop/s, or 0 if unknown */
 };
 
+/* --- Hardware counters --- */
+
+static PetscErrorCode PetscLogHandlerDefaultCountersOpen(PetscLogHandler h)
+{
+  PetscLogHandler_Default def = (PetscLogHandler_Default)h->data;
+
+  PetscFunctionBegin;
+  def->ncounters = 0;
+  for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) def->counter_pos[c] = -1;
+#if defined(PETSC_LOG_USE_PERF_EVENT)
+  {
+    const unsigned long long config[PETSC_LOG_NCOUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+
+    for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) {
+      struct perf_event_attr attr;
+      int                    fd;
+
+      PetscCall(PetscMemzero(&attr, sizeof(attr)));
+      attr.size           = sizeof(attr);
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.config         = config[c];
+      attr.read_format    = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      fd                  = (int)syscall(SYS_perf_event_open, &attr, 0, -1, def->ncounters ? def->counter_fd[0] : -1, 0);
+      if (fd < 0) {
+        PetscCall(PetscInfo(h, "Could not open the %s hardware counter with perf_event_open(): %s\n", PetscLogCounterNames[c], strerror(errno)));
+        continue;
+      }
+      def->counter_fd[def->ncounters] = fd;
+      def->counter_pos[c]             = def->ncounters++;
+    }
+  }
+#else
+  PetscCall(PetscInfo(h, "Hardware counters need perf_event_open() of Linux\n"));
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerDefaultCountersClose(PetscLogHandler_Default def)
+{
+  PetscFunctionBegin;
+#if defined(PETSC_LOG_USE_PERF_EVENT)
+  for (int i = def->ncounters - 1; i >= 0; i--) close(def->counter_fd[i]);
+#endif
+  def->ncounters = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Reads the counters that could be opened, the others are zero */
+static inline PetscErrorCode PetscLogHandlerDefaultCountersRead(PetscLogHandler_Default def, PetscLogDouble values[])
+{
+  PetscFunctionBegin;
+  for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) values[c] = 0.0;
+#if defined(PETSC_LOG_USE_PERF_EVENT)
+  {
+    unsigned long long buf[1 + PETSC_LOG_NCOUNTERS]; /* The number of counters followed by their values */
+    ssize_t            n = read(def->counter_fd[0], buf, sizeof(buf));
+
+    PetscCheck(n >= (ssize_t)((1 + def->ncounters) * sizeof(buf[0])), PETSC_COMM_SELF, PETSC_ERR_SYS, "Could not read the hardware counters");
+    for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) {
+      if (def->counter_pos[c] >= 0) values[c] = (PetscLogDouble)buf[1 + def->counter_pos[c]];
+    }
+  }
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /* --- PetscLogHandler_Default --- */
 
 static PetscErrorCode PetscLogHandlerContextCreate_Default(PetscLogHandler_Default *def_p)
@@ -278,6 +429,11 @@ static PetscErrorCode PetscLogHandlerContextCreate_Default(PetscLogHandler_Defau
   PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_include_actions", &def->petsc_logActions, NULL));
   PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_include_objects", &def->petsc_logObjects, NULL));
   PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_handler_default_use_threadsafe_events", &def->use_threadsafe, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_view_histograms", &def->histograms, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_view_hardware_counters", &def->counters, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-log_view_roofline", &def->roofline, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-log_view_roofline_bandwidth", &def->roofline_bandwidth, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-log_view_roofline_flops", &def->roofline_flops, NULL));
   if (PetscDefined(HAVE_THREADSAFETY) || def->use_threadsafe) { PetscCall(PetscHMapEventCreate(&def->eventInfoMap_th)); }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -291,6 +447,7 @@ static PetscErrorCode PetscLogHandlerDestroy_Default(PetscLogHandler h)
   PetscCall(PetscLogActionArrayDestroy(&def->petsc_actions));
   PetscCall(PetscLogObjectArrayDestroy(&def->petsc_objects));
   PetscCall(PetscSpinlockDestroy(&def->lock));
+  PetscCall(PetscLogHandlerDefaultCountersClose(def));
   if (def->eventInfoMap_th) {
     PetscEventPerfInfo **array;
     PetscInt             n, off = 0;
@@ -372,6 +529,30 @@ static PetscErrorCode PetscLogHandlerDefaultGetClassPerf(PetscLogHandler handler
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode PetscLogHandlerDefaultGetEventHistogram(PetscLogHandler handler, PetscLogStage stage, PetscLogEvent event, PetscEventHistogram **hist)
+{
+  PetscStagePerf *stage_info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerDefaultGetStageInfo(handler, stage, &stage_info));
+  if (!stage_info->histLog) PetscCall(PetscLogEventHistogramArrayCreate(128, &stage_info->histLog));
+  PetscCall(PetscLogEventHistogramArrayResize(stage_info->histLog, event + 1));
+  PetscCall(PetscLogEventHistogramArrayGetRef(stage_info->histLog, event, hist));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerDefaultGetEventCounters(PetscLogHandler handler, PetscLogStage stage, PetscLogEvent event, PetscEventCounters **counters)
+{
+  PetscStagePerf *stage_info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerDefaultGetStageInfo(handler, stage, &stage_info));
+  if (!stage_info->countLog) PetscCall(PetscLogEventCountersArrayCreate(128, &stage_info->countLog));
+  PetscCall(PetscLogEventCountersArrayResize(stage_info->countLog, event + 1));
+  PetscCall(PetscLogEventCountersArrayGetRef(stage_info->countLog, event, counters));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PetscLogHandlerObjectCreate_Default(PetscLogHandler h, PetscObject obj)
 {
   PetscLogHandler_Default def = (PetscLogHandler_Default)h->data;
@@ -594,6 +775,15 @@ static PetscErrorCode PetscLogHandlerEventBegin_Default(PetscLogHandler h, Petsc
     PetscCall(PetscMallocGetMaximumUsage(&new_action.maxmem));
     PetscCall(PetscLogActionArrayPush(def->petsc_actions, new_action));
   }
+  if (def->ncounters) {
+    PetscEventCounters *counters = NULL;
+
+    PetscCall(PetscSpinlockLock(&def->lock));
+    PetscCall(PetscLogHandlerDefaultGetEventCounters(h, stage, event, &counters));
+    PetscCall(PetscLogHandlerDefaultCountersRead(def, counters->begin));
+    counters->running = PETSC_TRUE;
+    PetscCall(PetscSpinlockUnlock(&def->lock));
+  }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -601,7 +791,7 @@ static PetscErrorCode PetscLogHandlerEventEnd_Default(PetscLogHandler h, PetscLo
 {
   PetscLogHandler_Default def             = (PetscLogHandler_Default)h->data;
   PetscEventPerfInfo     *event_perf_info = NULL;
-  PetscLogDouble          time;
+  PetscLogDouble          time, values[PETSC_LOG_NCOUNTERS];
   PetscLogState           state;
   int                     stage;
   PetscLogEventInfo       event_info;
@@ -655,6 +845,7 @@ static PetscErrorCode PetscLogHandlerEventEnd_Default(PetscLogHandler h, PetscLo
   else PetscCheck(event_perf_info->depth == 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Logging event had unbalanced begin/end pairs");
 
   /* Log performance info */
+  if (def->ncounters) PetscCall(PetscLogHandlerDefaultCountersRead(def, values));
   PetscCall(PetscTime(&time));
   PetscCall(PetscEventPerfInfoToc(event_perf_info, time, PetscLogMemory, event));
   if (PetscDefined(HAVE_THREADSAFETY) || def->use_threadsafe) {
@@ -664,6 +855,25 @@ static PetscErrorCode PetscLogHandlerEventEnd_Default(PetscLogHandler h, PetscLo
     PetscCall(PetscEventPerfInfoAdd_Internal(event_perf_info, event_perf_info_global));
     PetscCall(PetscSpinlockUnlock(&def->lock));
   }
+  if (def->histograms) {
+    PetscEventHistogram *hist = NULL;
+
+    PetscCall(PetscSpinlockLock(&def->lock));
+    PetscCall(PetscLogHandlerDefaultGetEventHistogram(h, stage, event, &hist));
+    PetscEventHistogramAdd(hist, event_perf_info->timeTmp);
+    PetscCall(PetscSpinlockUnlock(&def->lock));
+  }
+  if (def->ncounters) {
+    PetscEventCounters *counters = NULL;
+
+    PetscCall(PetscSpinlockLock(&def->lock));
+    PetscCall(PetscLogHandlerDefaultGetEventCounters(h, stage, event, &counters));
+    if (counters->running) { /* the call did not begin in another stage because of PetscLogEventsPause() */
+      for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) counters->count[c] += values[c] - counters->begin[c];
+      counters->running = PETSC_FALSE;
+    }
+    PetscCall(PetscSpinlockUnlock(&def->lock));
+  }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1156,6 +1366,410 @@ static PetscErrorCode PetscLogHandlerView_Default_CSV(PetscLogHandler handler, P
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* The histogram of an event in a stage summed over comm, zero where the stage or the event is not known to a process */
+static PetscErrorCode PetscLogHandlerDefaultGetGlobalHistogram(PetscLogHandler handler, MPI_Comm comm, PetscInt stage_id, PetscInt event_id, PetscEventHistogram *hist)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscMemzero(hist, sizeof(*hist)));
+  if (stage_id >= 0 && event_id >= 0) {
+    PetscStagePerf *stage_info;
+    PetscInt        num_events;
+
+    PetscCall(PetscLogHandlerDefaultGetStageInfo(handler, stage_id, &stage_info));
+    if (stage_info->histLog) {
+      PetscCall(PetscLogEventHistogramArrayGetSize(stage_info->histLog, &num_events, NULL));
+      if (event_id < num_events) PetscCall(PetscLogEventHistogramArrayGet(stage_info->histLog, event_id, hist));
+    }
+  }
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, hist->count, PETSC_LOG_HISTOGRAM_NBINS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &hist->max, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  PetscLogHandlerView_Default_Histograms - Prints the quantiles of the durations of the calls to each event, over all the calls on all the processes
+*/
+static PetscErrorCode PetscLogHandlerView_Default_Histograms(PetscLogHandler handler, PetscViewer viewer)
+{
+  PetscInt            numStages, numEvents;
+  MPI_Comm            comm = PetscObjectComm((PetscObject)viewer);
+  PetscLogGlobalNames global_stages, global_events;
+  PetscLogState       state;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerGetState(handler, &state));
+  PetscCall(PetscLogRegistryCreateGlobalStageNames(comm, state->registry, &global_stages));
+  PetscCall(PetscLogRegistryCreateGlobalEventNames(comm, state->registry, &global_events));
+  PetscCall(PetscLogGlobalNamesGetSize(global_stages, NULL, &numStages));
+  PetscCall(PetscLogGlobalNamesGetSize(global_events, NULL, &numEvents));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Duration of the calls to each event over all processes (sec), from histograms with 2x wide bins (-log_view_histograms):\n"));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Event                  Calls     p50       p90       p99       Max\n"));
+  for (PetscInt stage = 0; stage < numStages; stage++) {
+    PetscInt    stage_id;
+    const char *stage_name;
+
+    PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_stages, stage, &stage_id));
+    PetscCall(PetscLogGlobalNamesGlobalGetName(global_stages, stage, &stage_name));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n--- Event Stage %" PetscInt_FMT ": %s\n\n", stage, stage_name));
+    for (PetscInt event = 0; event < numEvents; event++) {
+      PetscEventHistogram hist;
+      PetscLogDouble      calls = 0.0, p50, p90, p99;
+      PetscInt            event_id;
+      const char         *event_name;
+
+      PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_events, event, &event_id));
+      PetscCall(PetscLogGlobalNamesGlobalGetName(global_events, event, &event_name));
+      PetscCall(PetscLogHandlerDefaultGetGlobalHistogram(handler, comm, stage_id, event_id, &hist));
+      for (PetscInt b = 0; b < PETSC_LOG_HISTOGRAM_NBINS; b++) calls += hist.count[b];
+      if (calls == 0.0) continue;
+      PetscCall(PetscEventHistogramQuantile(hist.count, 0.50, &p50));
+      PetscCall(PetscEventHistogramQuantile(hist.count, 0.90, &p90));
+      PetscCall(PetscEventHistogramQuantile(hist.count, 0.99, &p99));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "%-16s %11.0f %9.3e %9.3e %9.3e %9.3e\n", event_name, calls, PetscMin(p50, hist.max), PetscMin(p90, hist.max), PetscMin(p99, hist.max), hist.max));
+    }
+  }
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_events));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_stages));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Which hardware counters could be opened on all the processes of comm */
+static PetscErrorCode PetscLogHandlerDefaultGetGlobalCountersOpen(PetscLogHandler handler, MPI_Comm comm, PetscMPIInt open[])
+{
+  PetscLogHandler_Default def = (PetscLogHandler_Default)handler->data;
+
+  PetscFunctionBegin;
+  for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) open[c] = def->counter_pos[c] >= 0;
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, open, PETSC_LOG_NCOUNTERS, MPI_INT, MPI_MIN, comm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* The hardware counters of an event in a stage summed over comm, zero where the stage or the event is not known to a process */
+static PetscErrorCode PetscLogHandlerDefaultGetGlobalCounters(PetscLogHandler handler, MPI_Comm comm, PetscInt stage_id, PetscInt event_id, PetscLogDouble count[])
+{
+  PetscFunctionBegin;
+  for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) count[c] = 0.0;
+  if (stage_id >= 0 && event_id >= 0) {
+    PetscStagePerf *stage_info;
+    PetscInt        num_events;
+
+    PetscCall(PetscLogHandlerDefaultGetStageInfo(handler, stage_id, &stage_info));
+    if (stage_info->countLog) {
+      PetscCall(PetscLogEventCountersArrayGetSize(stage_info->countLog, &num_events, NULL));
+      if (event_id < num_events) {
+        PetscEventCounters counters;
+
+        PetscCall(PetscLogEventCountersArrayGet(stage_info->countLog, event_id, &counters));
+        for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) count[c] = counters.count[c];
+      }
+    }
+  }
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, count, PETSC_LOG_NCOUNTERS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  PetscLogHandlerView_Default_Counters - Prints the hardware counters of each event summed over all the processes, with the instructions
+  per cycle, the last level cache miss rate, and the memory bandwidth estimated from the cache misses and the longest time on a process
+*/
+static PetscErrorCode PetscLogHandlerView_Default_Counters(PetscLogHandler handler, PetscViewer viewer)
+{
+  PetscInt            numStages, numEvents;
+  MPI_Comm            comm = PetscObjectComm((PetscObject)viewer);
+  PetscLogGlobalNames global_stages, global_events;
+  PetscLogState       state;
+  PetscMPIInt         open[PETSC_LOG_NCOUNTERS];
+  PetscBool           any = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Hardware counters of each event summed over all processes (-log_view_hardware_counters):\n"));
+  PetscCall(PetscLogHandlerDefaultGetGlobalCountersOpen(handler, comm, open));
+  for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) {
+    if (open[c]) any = PETSC_TRUE;
+    else PetscCall(PetscViewerASCIIPrintf(viewer, "  The %s counter could not be opened on all processes, see -info\n", PetscLogCounterNames[c]));
+  }
+  if (!any) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscLogHandlerGetState(handler, &state));
+  PetscCall(PetscLogRegistryCreateGlobalStageNames(comm, state->registry, &global_stages));
+  PetscCall(PetscLogRegistryCreateGlobalEventNames(comm, state->registry, &global_events));
+  PetscCall(PetscLogGlobalNamesGetSize(global_stages, NULL, &numStages));
+  PetscCall(PetscLogGlobalNamesGetSize(global_events, NULL, &numEvents));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "IPC: instructions per cycle, LLC: last level cache, GB/s: LLC misses times the %d byte cache line over the maximum time\n", PETSC_LEVEL1_DCACHE_LINESIZE));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Event                   Cycles  Instructions   IPC LLC Miss%%      GB/s\n"));
+  for (PetscInt stage = 0; stage < numStages; stage++) {
+    PetscInt    stage_id;
+    const char *stage_name;
+
+    PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_stages, stage, &stage_id));
+    PetscCall(PetscLogGlobalNamesGlobalGetName(global_stages, stage, &stage_name));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n--- Event Stage %" PetscInt_FMT ": %s\n\n", stage, stage_name));
+    for (PetscInt event = 0; event < numEvents; event++) {
+      PetscLogDouble      count[PETSC_LOG_NCOUNTERS], time = 0.0;
+      PetscEventPerfInfo *event_info;
+      PetscInt            event_id;
+      const char         *event_name;
+
+      PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_events, event, &event_id));
+      PetscCall(PetscLogGlobalNamesGlobalGetName(global_events, event, &event_name));
+      PetscCall(PetscLogHandlerDefaultGetGlobalCounters(handler, comm, stage_id, event_id, count));
+      if (event_id >= 0 && stage_id >= 0) {
+        PetscCall(PetscLogHandlerGetEventPerfInfo_Default(handler, stage_id, event_id, &event_info));
+        time = event_info->time;
+      }
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &time, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+      if (count[0] == 0.0 && count[1] == 0.0 && count[2] == 0.0 && count[3] == 0.0) continue;
+      PetscCall(PetscViewerASCIIPrintf(viewer, "%-16s", event_name));
+      if (open[0]) PetscCall(PetscViewerASCIIPrintf(viewer, " %13.6e", count[0]));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "           n/a"));
+      if (open[1]) PetscCall(PetscViewerASCIIPrintf(viewer, " %13.6e", count[1]));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "           n/a"));
+      if (open[0] && open[1] && count[0] > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, " %5.2f", count[1] / count[0]));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "   n/a"));
+      if (open[2] && open[3] && count[2] > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, " %9.2f", 100.0 * count[3] / count[2]));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "       n/a"));
+      if (open[3] && time > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, " %9.3f\n", count[3] * PETSC_LEVEL1_DCACHE_LINESIZE / (1.0e9 * time)));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "       n/a\n"));
+    }
+  }
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_events));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_stages));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  PetscLogHandlerView_Default_Roofline - Prints for each event with a memory traffic estimate (PetscLogBytes()) the arithmetic intensity,
+  the memory bandwidth and the flop rate over all processes, and their fractions of the bandwidth and of the roofline bound of the machine
+*/
+static PetscErrorCode PetscLogHandlerView_Default_Roofline(PetscLogHandler handler, PetscViewer viewer)
+{
+  PetscLogHandler_Default def = (PetscLogHandler_Default)handler->data;
+  PetscLogDouble          bandwidth = def->roofline_bandwidth, peak = def->roofline_flops;
+  PetscInt                numStages, numEvents;
+  MPI_Comm                comm = PetscObjectComm((PetscObject)viewer);
+  PetscLogGlobalNames     global_stages, global_events;
+  PetscLogState           state;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerGetState(handler, &state));
+  PetscCall(PetscLogRegistryCreateGlobalStageNames(comm, state->registry, &global_stages));
+  PetscCall(PetscLogRegistryCreateGlobalEventNames(comm, state->registry, &global_events));
+  PetscCall(PetscLogGlobalNamesGetSize(global_stages, NULL, &numStages));
+  PetscCall(PetscLogGlobalNamesGetSize(global_events, NULL, &numEvents));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Roofline of the events with an estimate of their memory traffic, over all processes (-log_view_roofline):\n"));
+  if (bandwidth > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, "  Memory bandwidth of the machine %g MB/s (-log_view_roofline_bandwidth)\n", bandwidth));
+  else PetscCall(PetscViewerASCIIPrintf(viewer, "  Set the memory bandwidth of the machine in MB/s with -log_view_roofline_bandwidth, for example from make streams\n"));
+  if (peak > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, "  Peak flop rate of the machine %g Mflop/s (-log_view_roofline_flops)\n", peak));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Flop/B: arithmetic intensity, %%BW: percent of the memory bandwidth, %%Roof: percent of min(peak flop rate, Flop/B * bandwidth)\n"));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "Event                  Bytes  Flop/B      MB/s   Mflop/s   %%BW %%Roof\n"));
+  for (PetscInt stage = 0; stage < numStages; stage++) {
+    PetscInt    stage_id;
+    const char *stage_name;
+
+    PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_stages, stage, &stage_id));
+    PetscCall(PetscLogGlobalNamesGlobalGetName(global_stages, stage, &stage_name));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n--- Event Stage %" PetscInt_FMT ": %s\n\n", stage, stage_name));
+    for (PetscInt event = 0; event < numEvents; event++) {
+      PetscEventPerfInfo *event_info;
+      PetscLogDouble      sum[2] = {0.0, 0.0}, time = 0.0, intensity, rate, flop_rate;
+      PetscInt            event_id;
+      const char         *event_name;
+
+      PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_events, event, &event_id));
+      PetscCall(PetscLogGlobalNamesGlobalGetName(global_events, event, &event_name));
+      if (event_id >= 0 && stage_id >= 0) {
+        PetscCall(PetscLogHandlerGetEventPerfInfo_Default(handler, stage_id, event_id, &event_info));
+        sum[0] = event_info->bytes;
+        sum[1] = event_info->flops;
+        time   = event_info->time;
+      }
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, sum, 2, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &time, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+      if (sum[0] == 0.0) continue;
+      intensity = sum[1] / sum[0];
+      rate      = time > 0.0 ? sum[0] / (1.0e6 * time) : 0.0;
+      flop_rate = time > 0.0 ? sum[1] / (1.0e6 * time) : 0.0;
+      PetscCall(PetscViewerASCIIPrintf(viewer, "%-16s %11.4e %7.3f %9.1f %9.1f", event_name, sum[0], intensity, rate, flop_rate));
+      if (bandwidth > 0.0) {
+        PetscLogDouble roof = intensity * bandwidth;
+
+        if (peak > 0.0) roof = PetscMin(roof, peak);
+        PetscCall(PetscViewerASCIIPrintf(viewer, " %5.0f", 100.0 * rate / bandwidth));
+        if (roof > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, " %5.0f\n", 100.0 * flop_rate / roof));
+        else PetscCall(PetscViewerASCIIPrintf(viewer, "   n/a\n"));
+      } else PetscCall(PetscViewerASCIIPrintf(viewer, "   n/a   n/a\n"));
+    }
+  }
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_events));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_stages));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* str with its quotes, backslashes and control characters escaped for a JSON string, in json[] to be freed by the caller */
+PetscErrorCode PetscLogJSONEscape_Internal(const char str[], char *json[])
+{
+  size_t len, n = 0;
+  char  *j;
+
+  PetscFunctionBegin;
+  PetscCall(PetscStrlen(str, &len));
+  PetscCall(PetscMalloc1(6 * len + 1, &j));
+  for (const char *c = str; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      j[n++] = '\\';
+      j[n++] = *c;
+    } else if ((unsigned char)*c < 0x20) {
+      PetscCall(PetscSNPrintf(j + n, 7, "\\u%04x", (unsigned int)*c));
+      n += 6;
+    } else j[n++] = *c;
+  }
+  j[n]  = 0;
+  *json = j;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogViewJSONPrintString(PetscViewer viewer, const char str[])
+{
+  char *json;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogJSONEscape_Internal(str, &json));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\"%s\"", json));
+  PetscCall(PetscFree(json));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  PetscLogHandlerView_Default_JSON - Prints the stages and events, reduced over all processes, as a JSON document.
+  The numbers use %.6g since a bare %g is given a trailing decimal point by PetscFormatConvert(), which is not valid JSON.
+  With -log_view_histograms the quantiles and the histogram of the durations of the calls to each event are included, and with
+  -log_view_hardware_counters the counters that could be opened on all processes.
+*/
+static PetscErrorCode PetscLogHandlerView_Default_JSON(PetscLogHandler handler, PetscViewer viewer)
+{
+  PetscLogHandler_Default def = (PetscLogHandler_Default)handler->data;
+  PetscLogDouble          locTotalTime, maxTime, minTime;
+  PetscInt                numStages, numEvents;
+  MPI_Comm                comm = PetscObjectComm((PetscObject)viewer);
+  PetscMPIInt             size;
+  PetscLogGlobalNames     global_stages, global_events;
+  PetscLogState           state;
+  PetscEventPerfInfo      zero_info;
+  PetscMPIInt             open[PETSC_LOG_NCOUNTERS];
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerGetState(handler, &state));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  PetscCall(PetscTime(&locTotalTime));
+  locTotalTime -= petsc_BaseTime;
+  PetscCallMPI(MPIU_Allreduce(&locTotalTime, &maxTime, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+  PetscCallMPI(MPIU_Allreduce(&locTotalTime, &minTime, 1, MPIU_PETSCLOGDOUBLE, MPI_MIN, comm));
+  if (def->counters) PetscCall(PetscLogHandlerDefaultGetGlobalCountersOpen(handler, comm, open));
+  PetscCall(PetscLogRegistryCreateGlobalStageNames(comm, state->registry, &global_stages));
+  PetscCall(PetscLogRegistryCreateGlobalEventNames(comm, state->registry, &global_events));
+  PetscCall(PetscLogGlobalNamesGetSize(global_stages, NULL, &numStages));
+  PetscCall(PetscLogGlobalNamesGetSize(global_events, NULL, &numEvents));
+  PetscCall(PetscMemzero(&zero_info, sizeof(zero_info)));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "{\n"));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "  \"size\": %d,\n", size));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "  \"time_max\": %.6g,\n", maxTime));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "  \"time_min\": %.6g,\n", minTime));
+  if (def->histograms) PetscCall(PetscViewerASCIIPrintf(viewer, "  \"histogram_bins\": {\"count\": %d, \"lower_bound\": %.6g, \"ratio\": 2},\n", PETSC_LOG_HISTOGRAM_NBINS, ldexp(1.0, PETSC_LOG_HISTOGRAM_EMIN)));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "  \"stages\": ["));
+  for (PetscInt stage = 0; stage < numStages; stage++) {
+    PetscEventPerfInfo *stage_perf_info = &zero_info;
+    PetscLogDouble      stage_time[2], stage_sum[4];
+    PetscInt            stage_id;
+    const char         *stage_name;
+    PetscBool           first = PETSC_TRUE;
+
+    PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_stages, stage, &stage_id));
+    PetscCall(PetscLogGlobalNamesGlobalGetName(global_stages, stage, &stage_name));
+    if (stage_id >= 0) {
+      PetscStagePerf *stage_info;
+      PetscCall(PetscLogHandlerDefaultGetStageInfo(handler, stage_id, &stage_info));
+      stage_perf_info = &stage_info->perfInfo;
+    }
+    stage_time[0] = stage_perf_info->time;
+    stage_time[1] = -stage_perf_info->time;
+    stage_sum[0]  = stage_perf_info->flops;
+    stage_sum[1]  = stage_perf_info->numMessages;
+    stage_sum[2]  = stage_perf_info->messageLength;
+    stage_sum[3]  = stage_perf_info->numReductions;
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, stage_time, 2, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, stage_sum, 4, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "%s\n    {\n      \"name\": ", stage ? "," : ""));
+    PetscCall(PetscLogViewJSONPrintString(viewer, stage_name));
+    PetscCall(PetscViewerASCIIPrintf(viewer, ",\n      \"time_max\": %.6g, \"time_min\": %.6g, \"flop\": %.6g, \"messages\": %.6g, \"message_length\": %.6g, \"reductions\": %.6g,\n", stage_time[0], -stage_time[1], stage_sum[0], stage_sum[1], stage_sum[2], stage_sum[3] / size));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "      \"events\": ["));
+    for (PetscInt event = 0; event < numEvents; event++) {
+      PetscEventPerfInfo *eventInfo = &zero_info;
+      PetscLogDouble      ev_max[3], ev_sum[7];
+      PetscInt            event_id;
+      const char         *event_name;
+
+      PetscCall(PetscLogGlobalNamesGlobalGetLocal(global_events, event, &event_id));
+      PetscCall(PetscLogGlobalNamesGlobalGetName(global_events, event, &event_name));
+      if (event_id >= 0 && stage_id >= 0) PetscCall(PetscLogHandlerGetEventPerfInfo_Default(handler, stage_id, event_id, &eventInfo));
+      ev_max[0] = eventInfo->count;
+      ev_max[1] = eventInfo->time;
+      ev_max[2] = -eventInfo->time;
+      ev_sum[0] = eventInfo->count;
+      ev_sum[1] = eventInfo->time;
+      ev_sum[2] = eventInfo->flops;
+      ev_sum[3] = eventInfo->numMessages;
+      ev_sum[4] = eventInfo->messageLength;
+      ev_sum[5] = eventInfo->numReductions;
+      ev_sum[6] = eventInfo->bytes;
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, ev_max, 3, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, ev_sum, 7, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+      if (ev_sum[0] == 0.0) continue;
+      PetscCall(PetscViewerASCIIPrintf(viewer, "%s\n        {\"name\": ", first ? "" : ","));
+      first = PETSC_FALSE;
+      PetscCall(PetscLogViewJSONPrintString(viewer, event_name));
+      PetscCall(PetscViewerASCIIPrintf(viewer, ", \"count_max\": %.6g, \"count\": %.6g, \"time_max\": %.6g, \"time_min\": %.6g, \"time\": %.6g, \"flop\": %.6g, \"messages\": %.6g, \"message_length\": %.6g, \"reductions\": %.6g", ev_max[0], ev_sum[0], ev_max[1], -ev_max[2], ev_sum[1], ev_sum[2], ev_sum[3], ev_sum[4], ev_sum[5] / size));
+      if (ev_sum[6] > 0.0) PetscCall(PetscViewerASCIIPrintf(viewer, ", \"bytes\": %.6g", ev_sum[6]));
+      if (def->histograms) {
+        PetscEventHistogram hist;
+        PetscLogDouble      p50, p90, p99;
+        PetscBool           first_bin = PETSC_TRUE;
+
+        PetscCall(PetscLogHandlerDefaultGetGlobalHistogram(handler, comm, stage_id, event_id, &hist));
+        PetscCall(PetscEventHistogramQuantile(hist.count, 0.50, &p50));
+        PetscCall(PetscEventHistogramQuantile(hist.count, 0.90, &p90));
+        PetscCall(PetscEventHistogramQuantile(hist.count, 0.99, &p99));
+        PetscCall(PetscViewerASCIIPrintf(viewer, ",\n         \"duration_p50\": %.6g, \"duration_p90\": %.6g, \"duration_p99\": %.6g, \"duration_max\": %.6g, \"histogram\": [", PetscMin(p50, hist.max), PetscMin(p90, hist.max), PetscMin(p99, hist.max), hist.max));
+        for (PetscInt b = 0; b < PETSC_LOG_HISTOGRAM_NBINS; b++) {
+          if (hist.count[b] == 0.0) continue;
+          PetscCall(PetscViewerASCIIPrintf(viewer, "%s[%.6g, %.6g]", first_bin ? "" : ", ", ldexp(1.0, (int)b + PETSC_LOG_HISTOGRAM_EMIN), hist.count[b]));
+          first_bin = PETSC_FALSE;
+        }
+        PetscCall(PetscViewerASCIIPrintf(viewer, "]"));
+      }
+      if (def->counters) {
+        static const char *const keys[PETSC_LOG_NCOUNTERS] = {"cycles", "instructions", "llc_references", "llc_misses"};
+        PetscLogDouble           count[PETSC_LOG_NCOUNTERS];
+
+        PetscCall(PetscLogHandlerDefaultGetGlobalCounters(handler, comm, stage_id, event_id, count));
+        for (int c = 0; c < PETSC_LOG_NCOUNTERS; c++) {
+          if (open[c]) PetscCall(PetscViewerASCIIPrintf(viewer, ", \"%s\": %.17g", keys[c], count[c]));
+        }
+      }
+      PetscCall(PetscViewerASCIIPrintf(viewer, "}"));
+    }
+    PetscCall(PetscViewerASCIIPrintf(viewer, "%s]\n    }", first ? "" : "\n      "));
+  }
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\n  ]\n}\n"));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_events));
+  PetscCall(PetscLogGlobalNamesDestroy(&global_stages));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PetscLogViewWarnSync(PetscViewer viewer)
 {
   PetscFunctionBegin;
@@ -1694,6 +2308,18 @@ static PetscErrorCode PetscLogHandlerView_Default_Info(PetscLogHandler handler,
       }
     }
   }
+  if (def->histograms) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+    PetscCall(PetscLogHandlerView_Default_Histograms(handler, viewer));
+  }
+  if (def->counters) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+    PetscCall(PetscLogHandlerView_Default_Counters(handler, viewer));
+  }
+  if (def->roofline) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+    PetscCall(PetscLogHandlerView_Default_Roofline(handler, viewer));
+  }
 
   /* Memory usage and object creation */
   PetscCall(PetscViewerASCIIPrintf(viewer, "------------------------------------------------------------------------------------------------------------------------"));
@@ -1842,6 +2468,8 @@ static PetscErrorCode PetscLogHandlerView_Default(PetscLogHandler handler, Petsc
     PetscCall(PetscLogHandlerView_Default_Detailed(handler, viewer));
   } else if (format == PETSC_VIEWER_ASCII_CSV) {
     PetscCall(PetscLogHandlerView_Default_CSV(handler, viewer));
+  } else if (format == PETSC_VIEWER_ASCII_JSON) {
+    PetscCall(PetscLogHandlerView_Default_JSON(handler, viewer));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -1853,7 +2481,26 @@ static PetscErrorCode PetscLogHandlerView_Default(PetscLogHandler handler, Petsc
 
   Options Database Keys:
 + -log_include_actions - include a growing list of actions (event beginnings and endings, object creations and destructions) in `PetscLogDump()` (`PetscLogActions()`).
-- -log_include_objects - include a growing list of object creations and destructions in `PetscLogDump()` (`PetscLogObjects()`).
+. -log_include_objects - include a growing list of object creations and destructions in `PetscLogDump()` (`PetscLogObjects()`).
+. -log_view_histograms - keep a histogram of the duration of the calls to each event in each stage, and add the median, 90th and 99th percentiles to `PetscLogView()`
+. -log_view_hardware_counters - count the CPU cycles, instructions, and last level cache references and misses of each event with Linux `perf_event_open()`, and add them to `PetscLogView()`
+. -log_view_roofline - add to `PetscLogView()` the memory bandwidth and the arithmetic intensity of the events that estimate their memory traffic with `PetscLogBytes()`
+. -log_view_roofline_bandwidth <MB/s> - the memory bandwidth of the machine for all the processes, for example measured with `make streams`
+- -log_view_roofline_flops <Mflop/s> - the peak flop rate of the machine for all the processes, the roofline bound is then the minimum of this rate and the arithmetic intensity times the bandwidth
+
+  Notes:
+  The histograms have logarithmic bins, each twice as wide as the previous one, so recording a call costs a few operations and
+  the reported percentiles are interpolated within a bin.
+
+  The hardware counters count the user space work of the thread that created the log handler, not of other threads such as OpenMP threads,
+  and reading them costs a system call at the beginning and the end of each event. `PetscLogView()` prints the instructions per cycle,
+  the last level cache miss rate, and the memory bandwidth estimated from the last level cache misses. The counters that the kernel
+  does not provide, for instance in virtual machines or with a restrictive `/proc/sys/kernel/perf_event_paranoid`, are reported as
+  not available, `-info` gives the reason.
+
+  The memory traffic of an event is the sum of the estimates of `PetscLogBytes()` of the kernels it calls, currently the basic
+  sequential vector operations and the products and triangular solves of `MATSEQAIJ`. An event that moves close to the memory
+  bandwidth of the machine cannot run faster without reducing its memory traffic.
 
   Level: developer
 
@@ -1864,6 +2511,7 @@ PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Default(PetscLogHandler handle
 {
   PetscFunctionBegin;
   PetscCall(PetscLogHandlerContextCreate_Default((PetscLogHandler_Default *)&handler->data));
+  if (((PetscLogHandler_Default)handler->data)->counters) PetscCall(PetscLogHandlerDefaultCountersOpen(handler));
   handler->ops->destroy       = PetscLogHandlerDestroy_Default;
   handler->ops->eventbegin    = PetscLogHandlerEventBegin_Default;
   handler->ops->eventend      = PetscLogHandlerEventEnd_Default;
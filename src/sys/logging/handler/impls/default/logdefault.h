@@ -4,3 +4,4 @@
 #include <petsc/private/logimpl.h>        /*I "petscsys.h" I*/
 
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Default(PetscLogHandler);
+PETSC_INTERN PetscErrorCode PetscLogJSONEscape_Internal(const char[], char *[]);
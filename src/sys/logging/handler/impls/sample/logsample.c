@@ -0,0 +1,280 @@
+#include <petscviewer.h>
+#include <petsc/private/logimpl.h> /*I "petscsys.h" I*/
+#include <petsc/private/loghandlerimpl.h>
+#if defined(PETSC_HAVE_SYS_TIME_H)
+  #include <sys/time.h>
+#endif
+#include <signal.h>
+#if defined(PETSC_HAVE_PTHREAD)
+  #include <pthread.h>
+#endif
+
+#if defined(PETSC_HAVE_STRUCT_SIGACTION) && defined(PETSC_HAVE_SYS_TIME_H) && defined(ITIMER_PROF) && defined(SIGPROF)
+  #define PETSC_LOG_SAMPLE_HAVE_TIMER
+#endif
+
+/* The deepest event nesting recorded in a sample, deeper events are counted in their ancestor at this depth */
+#define PETSC_LOG_SAMPLE_MAX_DEPTH 32
+/* The number of distinct call paths that can be recorded, a power of two, the samples of further paths are dropped */
+#define PETSC_LOG_SAMPLE_MAX_PATHS 4096
+
+typedef struct {
+  size_t count; /* The number of samples taken with this call path, 0 if the entry is free */
+  int    stage;
+  int    depth;
+  int    events[PETSC_LOG_SAMPLE_MAX_DEPTH];
+} PetscLogSamplePath;
+
+/* The event stack is only written by the handler callbacks, on the thread that started the timer, and only read by the signal
+   handler. SIGPROF may be delivered to any thread of the process, the signal handler forwards it to the thread that started the
+   timer, so the stack is only read while that thread is interrupted: an event is stored before the depth is increased and the
+   depth is decreased before the event is forgotten */
+typedef struct _n_PetscLogHandler_Sample *PetscLogHandler_Sample;
+struct _n_PetscLogHandler_Sample {
+  volatile int          stage;
+  volatile int          depth;
+  volatile int          events[PETSC_LOG_SAMPLE_MAX_DEPTH];
+  volatile sig_atomic_t paused;   /* Set while the table is read */
+  PetscLogSamplePath   *paths;    /* Open addressing hash table of the call paths */
+  size_t                nsamples; /* All the samples taken */
+  size_t                ndropped; /* The samples of call paths that did not fit in the table */
+  PetscInt              interval; /* Microseconds of CPU time between samples */
+  PetscBool             running;
+#if defined(PETSC_LOG_SAMPLE_HAVE_TIMER)
+  struct sigaction oldaction;
+#endif
+#if defined(PETSC_HAVE_PTHREAD)
+  pthread_t thread; /* The thread that started the timer and logs the events */
+#endif
+};
+
+/* There is a single profiling timer per process so at most one sampling handler can be running */
+static PetscLogHandler_Sample PetscLogSampleRunning = NULL;
+
+#if defined(PETSC_LOG_SAMPLE_HAVE_TIMER)
+/* Only async-signal-safe work: no allocation, no locks, no PETSc error handling */
+static void PetscLogSampleSignalHandler(int sig)
+{
+  PetscLogHandler_Sample sample = PetscLogSampleRunning;
+  int                    stage, depth, events[PETSC_LOG_SAMPLE_MAX_DEPTH];
+  unsigned int           hash = 2166136261u;
+
+  (void)sig;
+  if (!sample || sample->paused) return;
+  #if defined(PETSC_HAVE_PTHREAD)
+  /* pthread_self() and pthread_kill() are async-signal-safe, the sample is taken when the signal reaches the logging thread */
+  if (!pthread_equal(pthread_self(), sample->thread)) {
+    (void)pthread_kill(sample->thread, SIGPROF);
+    return;
+  }
+  #endif
+  sample->nsamples++;
+  stage = sample->stage;
+  depth = PetscMin(sample->depth, PETSC_LOG_SAMPLE_MAX_DEPTH);
+  hash  = (hash ^ (unsigned int)stage) * 16777619u;
+  for (int d = 0; d < depth; d++) {
+    events[d] = sample->events[d];
+    hash      = (hash ^ (unsigned int)events[d]) * 16777619u;
+  }
+  for (int probe = 0; probe < PETSC_LOG_SAMPLE_MAX_PATHS; probe++) {
+    PetscLogSamplePath *path = &sample->paths[(hash + (unsigned int)probe) & (PETSC_LOG_SAMPLE_MAX_PATHS - 1)];
+    PetscBool           same = PETSC_TRUE;
+
+    if (!path->count) {
+      path->stage = stage;
+      path->depth = depth;
+      for (int d = 0; d < depth; d++) path->events[d] = events[d];
+      path->count = 1;
+      return;
+    }
+    if (path->stage != stage || path->depth != depth) continue;
+    for (int d = 0; d < depth && same; d++) same = path->events[d] == events[d] ? PETSC_TRUE : PETSC_FALSE;
+    if (same) {
+      path->count++;
+      return;
+    }
+  }
+  sample->ndropped++;
+}
+#endif
+
+static PetscErrorCode PetscLogHandlerSampleSetTimer(PetscLogHandler h, PetscBool run)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+
+  PetscFunctionBegin;
+  if (run == sample->running) PetscFunctionReturn(PETSC_SUCCESS);
+#if defined(PETSC_LOG_SAMPLE_HAVE_TIMER)
+  {
+    struct itimerval timer;
+
+    PetscCall(PetscMemzero(&timer, sizeof(timer)));
+    if (run) {
+      struct sigaction action;
+
+      PetscCheck(!PetscLogSampleRunning, PetscObjectComm((PetscObject)h), PETSC_ERR_ARG_WRONGSTATE, "Only one %s log handler can be running", PETSCLOGHANDLERSAMPLE);
+  #if defined(PETSC_HAVE_PTHREAD)
+      sample->thread = pthread_self();
+  #endif
+      PetscLogSampleRunning = sample;
+      PetscCall(PetscMemzero(&action, sizeof(action)));
+      action.sa_handler = PetscLogSampleSignalHandler;
+      action.sa_flags   = SA_RESTART;
+      sigemptyset(&action.sa_mask);
+      PetscCheck(!sigaction(SIGPROF, &action, &sample->oldaction), PETSC_COMM_SELF, PETSC_ERR_SYS, "Unable to install the SIGPROF handler");
+      timer.it_interval.tv_sec  = (time_t)(sample->interval / 1000000);
+      timer.it_interval.tv_usec = (suseconds_t)(sample->interval % 1000000);
+      timer.it_value            = timer.it_interval;
+      PetscCheck(!setitimer(ITIMER_PROF, &timer, NULL), PETSC_COMM_SELF, PETSC_ERR_SYS, "Unable to start the profiling timer");
+    } else {
+      PetscCheck(!setitimer(ITIMER_PROF, &timer, NULL), PETSC_COMM_SELF, PETSC_ERR_SYS, "Unable to stop the profiling timer");
+      PetscCheck(!sigaction(SIGPROF, &sample->oldaction, NULL), PETSC_COMM_SELF, PETSC_ERR_SYS, "Unable to restore the SIGPROF handler");
+      PetscLogSampleRunning = NULL;
+    }
+  }
+#else
+  SETERRQ(PetscObjectComm((PetscObject)h), PETSC_ERR_SUP_SYS, "The %s log handler needs setitimer() and sigaction()", PETSCLOGHANDLERSAMPLE);
+#endif
+  sample->running = run;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerEventBegin_Sample(PetscLogHandler h, PetscLogEvent event, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+
+  PetscFunctionBegin;
+  if (sample->depth < PETSC_LOG_SAMPLE_MAX_DEPTH) sample->events[sample->depth] = event;
+  sample->depth++;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerEventEnd_Sample(PetscLogHandler h, PetscLogEvent event, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+
+  PetscFunctionBegin;
+  if (sample->depth > 0) sample->depth--;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerStagePush_Sample(PetscLogHandler h, PetscLogStage new_stage)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+
+  PetscFunctionBegin;
+  sample->stage = new_stage;
+  /* PetscLogHandlerStart() pushes the current stages once the state is set */
+  if (!sample->running) PetscCall(PetscLogHandlerSampleSetTimer(h, PETSC_TRUE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerStagePop_Sample(PetscLogHandler h, PetscLogStage old_stage)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+  PetscLogState          state;
+  PetscLogStage          stage;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerGetState(h, &state));
+  PetscCall(PetscLogStateGetCurrentStage(state, &stage));
+  sample->stage = stage;
+  /* no stage is left when the handler is stopped */
+  if (stage < 0) PetscCall(PetscLogHandlerSampleSetTimer(h, PETSC_FALSE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Each process prints its call paths in the folded stack format, "stage;event;...;event count", which tools such as
+   flamegraph.pl and speedscope merge across the processes */
+static PetscErrorCode PetscLogHandlerView_Sample(PetscLogHandler h, PetscViewer viewer)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+  PetscLogState          state;
+  PetscBool              isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCheck(isascii, PetscObjectComm((PetscObject)viewer), PETSC_ERR_SUP, "Can only view the %s log handler to ASCII", PETSCLOGHANDLERSAMPLE);
+  PetscCall(PetscLogHandlerGetState(h, &state));
+  sample->paused = 1;
+  PetscCall(PetscInfo(h, "%zu samples taken every %" PetscInt_FMT " microseconds, %zu dropped\n", sample->nsamples, sample->interval, sample->ndropped));
+  PetscCall(PetscViewerASCIIPushSynchronized(viewer));
+  for (PetscInt p = 0; p < PETSC_LOG_SAMPLE_MAX_PATHS; p++) {
+    const PetscLogSamplePath *path = &sample->paths[p];
+    PetscLogStageInfo         stage_info;
+
+    if (!path->count) continue;
+    if (path->stage >= 0) PetscCall(PetscLogStateStageGetInfo(state, path->stage, &stage_info));
+    PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%s", path->stage >= 0 ? stage_info.name : "Main Stage"));
+    for (int d = 0; d < path->depth; d++) {
+      PetscLogEventInfo event_info;
+
+      PetscCall(PetscLogStateEventGetInfo(state, path->events[d], &event_info));
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, ";%s", event_info.name));
+    }
+    PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " %zu\n", path->count));
+  }
+  PetscCall(PetscViewerFlush(viewer));
+  PetscCall(PetscViewerASCIIPopSynchronized(viewer));
+  sample->paused = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerDestroy_Sample(PetscLogHandler h)
+{
+  PetscLogHandler_Sample sample = (PetscLogHandler_Sample)h->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogHandlerSampleSetTimer(h, PETSC_FALSE));
+  PetscCall(PetscFree(sample->paths));
+  PetscCall(PetscFree(h->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+  PETSCLOGHANDLERSAMPLE - PETSCLOGHANDLERSAMPLE = "sample" -  A `PetscLogHandler` that periodically samples the stack of
+  the active events instead of timing each of them. A log handler of this type is created and started by `PetscLogSampleBegin()`.
+
+  Options Database Key:
+. -log_sample_interval <microseconds> - CPU time between two samples, default 1000, rounded up to the resolution of the system timer
+
+  Level: developer
+
+  Notes:
+  `PetscLogEventBegin()` and `PetscLogEventEnd()` only push and pop the event on a small stack, so the cost per event is
+  negligible even for events called in inner loops.  A `SIGPROF` timer counts the CPU time of the process and, at each
+  interval, the signal handler adds one to the count of the current call path: the stage and the nested events.
+  The counts are thus proportional to the CPU time spent in each call path, time waiting in blocking calls is not counted.
+  The events must be logged from the thread that started the handler; the CPU time of other threads of the process, for
+  example OpenMP threads, is counted in the call path of that thread, since the signals they receive are forwarded to it.
+
+  `PetscLogHandlerView()` prints the call paths of each process in the folded stack format, one line per path with its number
+  of samples, which can be turned into a flame graph with https://github.com/brendangregg/FlameGraph or https://www.speedscope.app
+
+  At most 4096 distinct call paths of at most 32 nested events are recorded per process.
+
+  This handler needs `setitimer()` and `sigaction()` and cannot be used with other code that uses `SIGPROF`, such as `gprof`.
+
+.seealso: [](ch_profiling), `PetscLogHandler`, `PetscLogSampleBegin()`, `PetscLogSampleDump()`
+M*/
+
+PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Sample(PetscLogHandler handler)
+{
+  PetscLogHandler_Sample sample;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&sample));
+  PetscCall(PetscCalloc1(PETSC_LOG_SAMPLE_MAX_PATHS, &sample->paths));
+  sample->stage    = -1;
+  sample->interval = 1000;
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-log_sample_interval", &sample->interval, NULL));
+  PetscCheck(sample->interval > 0, PetscObjectComm((PetscObject)handler), PETSC_ERR_ARG_OUTOFRANGE, "The sampling interval must be positive, not %" PetscInt_FMT, sample->interval);
+  handler->data            = (void *)sample;
+  handler->ops->eventbegin = PetscLogHandlerEventBegin_Sample;
+  handler->ops->eventend   = PetscLogHandlerEventEnd_Sample;
+  handler->ops->stagepush  = PetscLogHandlerStagePush_Sample;
+  handler->ops->stagepop   = PetscLogHandlerStagePop_Sample;
+  handler->ops->view       = PetscLogHandlerView_Sample;
+  handler->ops->destroy    = PetscLogHandlerDestroy_Sample;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,222 @@
+#include <petscviewer.h>
+#include <petsc/private/logimpl.h> /*I "petscsys.h" I*/
+#include <petsc/private/loghandlerimpl.h>
+#include "../default/logdefault.h"
+
+/* The deepest event nesting that is recorded, deeper events are ignored */
+#define PETSC_LOG_TIMELINE_MAX_DEPTH 128
+
+typedef struct {
+  PetscLogDouble time, flops, messages, messageLength, reductions;
+} PetscLogTimelineCounters;
+
+typedef struct {
+  PetscLogTimelineCounters begin, end; /* The counters when the event began and ended */
+  PetscLogEvent            event;
+  PetscLogStage            stage;
+  PetscBool                sync; /* The time waited in the barrier of PetscLogEventSync() before the event */
+} PetscLogTimelineRecord;
+
+typedef struct _n_PetscLogHandler_Timeline *PetscLogHandler_Timeline;
+struct _n_PetscLogHandler_Timeline {
+  PetscLogTimelineRecord  *records;  /* Ring buffer of the completed events, the oldest ones are overwritten */
+  PetscInt                 capacity; /* The size of the ring buffer */
+  PetscInt64               nrecords; /* The number of records written, including the overwritten ones */
+  PetscLogTimelineCounters stack[PETSC_LOG_TIMELINE_MAX_DEPTH];
+  PetscInt                 depth;
+  PetscLogDouble           start; /* The local time at the barrier in PetscLogHandlerCreate_Timeline() */
+};
+
+static inline void PetscLogTimelineGetCounters(PetscLogTimelineCounters *c)
+{
+  c->flops         = petsc_TotalFlops;
+  c->messages      = petsc_irecv_ct + petsc_isend_ct + petsc_recv_ct + petsc_send_ct;
+  c->messageLength = petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
+  c->reductions    = petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+}
+
+static inline PetscLogTimelineRecord *PetscLogTimelineNewRecord(PetscLogHandler_Timeline tl)
+{
+  return &tl->records[tl->nrecords++ % tl->capacity];
+}
+
+static PetscErrorCode PetscLogHandlerEventBegin_Timeline(PetscLogHandler h, PetscLogEvent event, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscLogHandler_Timeline tl = (PetscLogHandler_Timeline)h->data;
+
+  PetscFunctionBegin;
+  if (tl->depth < PETSC_LOG_TIMELINE_MAX_DEPTH) {
+    PetscLogTimelineCounters *c = &tl->stack[tl->depth];
+
+    PetscLogTimelineGetCounters(c);
+    PetscCall(PetscTime(&c->time));
+  }
+  tl->depth++;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerEventEnd_Timeline(PetscLogHandler h, PetscLogEvent event, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscLogHandler_Timeline tl = (PetscLogHandler_Timeline)h->data;
+
+  PetscFunctionBegin;
+  if (!tl->depth) PetscFunctionReturn(PETSC_SUCCESS);
+  tl->depth--;
+  if (tl->depth < PETSC_LOG_TIMELINE_MAX_DEPTH) {
+    PetscLogTimelineRecord *r = PetscLogTimelineNewRecord(tl);
+    PetscLogState           state;
+
+    PetscCall(PetscTime(&r->end.time));
+    PetscLogTimelineGetCounters(&r->end);
+    PetscCall(PetscLogHandlerGetState(h, &state));
+    PetscCall(PetscLogStateGetCurrentStage(state, &r->stage));
+    r->begin = tl->stack[tl->depth];
+    r->event = event;
+    r->sync  = PETSC_FALSE;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* With -log_sync the barrier before collective events is timed, it shows the load imbalance on the timeline */
+static PetscErrorCode PetscLogHandlerEventSync_Timeline(PetscLogHandler h, PetscLogEvent event, MPI_Comm comm)
+{
+  PetscLogHandler_Timeline tl = (PetscLogHandler_Timeline)h->data;
+  PetscLogState            state;
+  PetscLogEventInfo        event_info;
+  PetscLogTimelineRecord  *r;
+
+  PetscFunctionBegin;
+  if (!PetscLogSyncOn || comm == MPI_COMM_NULL) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscLogHandlerGetState(h, &state));
+  PetscCall(PetscLogStateEventGetInfo(state, event, &event_info));
+  if (!event_info.collective) PetscFunctionReturn(PETSC_SUCCESS);
+  r = PetscLogTimelineNewRecord(tl);
+  PetscLogTimelineGetCounters(&r->begin);
+  PetscCall(PetscTime(&r->begin.time));
+  PetscCallMPI(MPI_Barrier(comm));
+  PetscCall(PetscTime(&r->end.time));
+  PetscLogTimelineGetCounters(&r->end);
+  PetscCall(PetscLogStateGetCurrentStage(state, &r->stage));
+  r->event = event;
+  r->sync  = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Each process writes its own records with the pid of its rank. The local clocks are mapped to the clock of rank 0 with the times of
+  two barriers, in PetscLogHandlerCreate_Timeline() and here, which corrects both their offset and their drift
+*/
+static PetscErrorCode PetscLogHandlerView_Timeline(PetscLogHandler h, PetscViewer viewer)
+{
+  PetscLogHandler_Timeline tl   = (PetscLogHandler_Timeline)h->data;
+  MPI_Comm                 comm = PetscObjectComm((PetscObject)viewer);
+  PetscLogDouble           end, duration, duration0, scale;
+  PetscInt64               first, nrecords, ndropped;
+  PetscMPIInt              rank, size;
+  PetscLogState            state;
+  PetscBool                isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCheck(isascii, comm, PETSC_ERR_SUP, "Can only view the %s log handler to ASCII", PETSCLOGHANDLERTIMELINE);
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  PetscCall(PetscLogHandlerGetState(h, &state));
+  PetscCallMPI(MPI_Barrier(comm));
+  PetscCall(PetscTime(&end));
+  duration = duration0 = end - tl->start;
+  PetscCallMPI(MPI_Bcast(&duration0, 1, MPIU_PETSCLOGDOUBLE, 0, comm));
+  scale    = duration > 0.0 ? 1.0e6 * duration0 / duration : 1.0e6; /* microseconds on the clock of rank 0 */
+  nrecords = PetscMin(tl->nrecords, (PetscInt64)tl->capacity);
+  first    = tl->nrecords - nrecords;
+  ndropped = first;
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &ndropped, 1, MPIU_INT64, MPI_SUM, comm));
+  if (ndropped) PetscCall(PetscInfo(h, "%" PetscInt64_FMT " records were overwritten, increase -log_timeline_buffer to keep them\n", ndropped));
+
+  PetscCall(PetscViewerASCIIPrintf(viewer, "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"size\": %d, \"overwritten_records\": %" PetscInt64_FMT "}, \"traceEvents\": [\n", size, ndropped));
+  PetscCall(PetscViewerASCIIPushSynchronized(viewer));
+  PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%s{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"rank %d\"}}", rank ? ",\n" : "", rank, rank));
+  PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, ",\n{\"name\": \"process_sort_index\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"sort_index\": %d}}", rank, rank));
+  for (PetscInt64 i = first; i < tl->nrecords; i++) {
+    const PetscLogTimelineRecord *r = &tl->records[i % tl->capacity];
+    PetscLogEventInfo             event_info;
+    PetscLogStageInfo             stage_info;
+    PetscLogDouble                ts  = (r->begin.time - tl->start) * scale;
+    PetscLogDouble                dur = (r->end.time - r->begin.time) * scale;
+    char                         *name, *cat;
+
+    PetscCall(PetscLogStateEventGetInfo(state, r->event, &event_info));
+    PetscCall(PetscLogJSONEscape_Internal(event_info.name, &name));
+    if (r->sync) {
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, ",\n{\"name\": \"MPI wait: %s\", \"cat\": \"sync\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f}", name, rank, ts, dur));
+      PetscCall(PetscFree(name));
+      continue;
+    }
+    if (r->stage >= 0) PetscCall(PetscLogStateStageGetInfo(state, r->stage, &stage_info));
+    PetscCall(PetscLogJSONEscape_Internal(r->stage >= 0 ? stage_info.name : "Main Stage", &cat));
+    PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"flop\": %.17g, \"messages\": %.17g, \"message_length\": %.17g, \"reductions\": %.17g}}", name, cat, rank, ts, dur,
+                                                 r->end.flops - r->begin.flops, r->end.messages - r->begin.messages, r->end.messageLength - r->begin.messageLength, r->end.reductions - r->begin.reductions));
+    PetscCall(PetscFree(name));
+    PetscCall(PetscFree(cat));
+    PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, ",\n{\"name\": \"counters\", \"ph\": \"C\", \"pid\": %d, \"ts\": %.3f, \"args\": {\"flop\": %.17g, \"messages\": %.17g}}", rank, ts + dur, r->end.flops, r->end.messages));
+  }
+  PetscCall(PetscViewerFlush(viewer));
+  PetscCall(PetscViewerASCIIPopSynchronized(viewer));
+  PetscCall(PetscViewerASCIIPrintf(viewer, "\n]}\n"));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscLogHandlerDestroy_Timeline(PetscLogHandler h)
+{
+  PetscLogHandler_Timeline tl = (PetscLogHandler_Timeline)h->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(tl->records));
+  PetscCall(PetscFree(h->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+  PETSCLOGHANDLERTIMELINE - PETSCLOGHANDLERTIMELINE = "timeline" -  A `PetscLogHandler` that records the beginning and end
+  of every event on each process and writes them as a Chrome trace-event JSON file, which can be opened in https://ui.perfetto.dev
+  or chrome://tracing. A log handler of this type is created and started by `PetscLogTimelineBegin()`.
+
+  Options Database Key:
+. -log_timeline_buffer <n> - the number of events kept on each process, default 65536
+
+  Level: developer
+
+  Notes:
+  Each process is shown as a separate timeline, the events are labeled with their stage and the flop, messages, message length, and
+  reductions counted during the event, and the cumulative flop and message counts are shown as counters.
+
+  The events are kept in a ring buffer so only the last ones are written for long runs.
+
+  With `-log_sync` the time waiting in a barrier before each collective event (`PetscLogEventSync()`) is shown as an "MPI wait" event,
+  which shows the load imbalance between the processes.
+
+  The clocks of the processes are aligned with two barriers, when the handler is created and when it is viewed.
+
+.seealso: [](ch_profiling), `PetscLogHandler`, `PetscLogTimelineBegin()`, `PetscLogTimelineDump()`
+M*/
+
+PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Timeline(PetscLogHandler handler)
+{
+  PetscLogHandler_Timeline tl;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&tl));
+  tl->capacity = 65536;
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-log_timeline_buffer", &tl->capacity, NULL));
+  PetscCheck(tl->capacity > 0, PetscObjectComm((PetscObject)handler), PETSC_ERR_ARG_OUTOFRANGE, "The timeline buffer size must be positive, not %" PetscInt_FMT, tl->capacity);
+  PetscCall(PetscMalloc1(tl->capacity, &tl->records));
+  PetscCallMPI(MPI_Barrier(PetscObjectComm((PetscObject)handler)));
+  PetscCall(PetscTime(&tl->start));
+  handler->data            = (void *)tl;
+  handler->ops->eventbegin = PetscLogHandlerEventBegin_Timeline;
+  handler->ops->eventend   = PetscLogHandlerEventEnd_Timeline;
+  handler->ops->eventsync  = PetscLogHandlerEventSync_Timeline;
+  handler->ops->view       = PetscLogHandlerView_Timeline;
+  handler->ops->destroy    = PetscLogHandlerDestroy_Timeline;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -10,6 +10,8 @@ PetscBool         PetscLogHandlerPackageInitialized = PETSC_FALSE;
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Default(PetscLogHandler);
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Nested(PetscLogHandler);
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Trace(PetscLogHandler);
+PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Sample(PetscLogHandler);
+PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Timeline(PetscLogHandler);
 #if PetscDefined(HAVE_MPE)
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_MPE(PetscLogHandler);
 #endif
@@ -29,6 +31,8 @@ static PetscErrorCode PetscLogHandlerRegisterAll(void)
   PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERDEFAULT, PetscLogHandlerCreate_Default));
   PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERNESTED, PetscLogHandlerCreate_Nested));
   PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERTRACE, PetscLogHandlerCreate_Trace));
+  PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERSAMPLE, PetscLogHandlerCreate_Sample));
+  PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERTIMELINE, PetscLogHandlerCreate_Timeline));
 #if PetscDefined(HAVE_MPE)
   PetscCall(PetscLogHandlerRegister(PETSCLOGHANDLERMPE, PetscLogHandlerCreate_MPE));
 #endif
@@ -40,6 +40,7 @@ PetscInt PetscLogGetTid(void)
 /* Global counters */
 PetscLogDouble petsc_BaseTime        = 0.0;
 PetscLogDouble petsc_TotalFlops      = 0.0; /* The number of flops */
+PetscLogDouble petsc_TotalBytes      = 0.0; /* The estimated memory traffic in bytes */
 PetscLogDouble petsc_send_ct         = 0.0; /* The number of sends */
 PetscLogDouble petsc_recv_ct         = 0.0; /* The number of receives */
 PetscLogDouble petsc_send_len        = 0.0; /* The total length of all sent messages */
@@ -58,6 +59,7 @@ PetscLogDouble petsc_scatter_ct      = 0.0; /* The number of scatters and scatte
 
 /* Thread Local storage */
 PETSC_TLS PetscLogDouble petsc_TotalFlops_th      = 0.0;
+PETSC_TLS PetscLogDouble petsc_TotalBytes_th      = 0.0;
 PETSC_TLS PetscLogDouble petsc_send_ct_th         = 0.0;
 PETSC_TLS PetscLogDouble petsc_recv_ct_th         = 0.0;
 PETSC_TLS PetscLogDouble petsc_send_len_th        = 0.0;
@@ -506,6 +508,57 @@ PetscErrorCode PetscLogTraceBegin(FILE *file)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PetscLogSampleBegin - Begins sampling the stack of active events with a profiling timer, see `PETSCLOGHANDLERSAMPLE`.
+
+  Logically Collective on `PETSC_COMM_WORLD`
+
+  Options Database Keys:
++ -log_sample [filename]              - Begins `PetscLogSampleBegin()` and calls `PetscLogSampleDump()` in `PetscFinalize()`
+- -log_sample_interval <microseconds> - CPU time between two samples, default 1000
+
+  Level: intermediate
+
+  Notes:
+  Unlike the other log handlers, the cost of `PetscLogEventBegin()` and `PetscLogEventEnd()` does not depend on the
+  work done per event, so it can be left on for production runs that call events in inner loops.
+
+  The result is a count of samples for each call path (stage and nested events) that is proportional to the CPU time spent in it,
+  it contains no flop, message, or memory information.
+
+.seealso: [](ch_profiling), `PetscLogSampleDump()`, `PetscLogDefaultBegin()`, `PetscLogNestedBegin()`
+@*/
+PetscErrorCode PetscLogSampleBegin(void)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscLogTypeBegin(PETSCLOGHANDLERSAMPLE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscLogTimelineBegin - Begins recording the beginning and end of every event on each process, see `PETSCLOGHANDLERTIMELINE`.
+
+  Collective on `PETSC_COMM_WORLD`
+
+  Options Database Keys:
++ -log_timeline [filename]   - Begins `PetscLogTimelineBegin()` and calls `PetscLogTimelineDump()` in `PetscFinalize()`
+. -log_timeline_buffer <n>   - the number of events kept on each process, default 65536
+- -log_sync                  - also record the time waiting for the other processes before each collective event
+
+  Level: intermediate
+
+  Note:
+  The timeline shows when each process is in each event, which shows the load imbalance that the summaries of `PetscLogView()` hide.
+
+.seealso: [](ch_profiling), `PetscLogTimelineDump()`, `PetscLogDefaultBegin()`, `PetscLogTraceBegin()`
+@*/
+PetscErrorCode PetscLogTimelineBegin(void)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscLogTypeBegin(PETSCLOGHANDLERTIMELINE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PETSC_INTERN PetscErrorCode PetscLogHandlerCreate_Nested(MPI_Comm, PetscLogHandler *);
 
 /*@
@@ -1932,6 +1985,63 @@ PetscErrorCode PetscLogDump(const char sname[])
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PetscLogSampleDump - Writes the call paths sampled since `PetscLogSampleBegin()` in the folded stack format
+
+  Collective on `PETSC_COMM_WORLD`
+
+  Input Parameter:
+. sname - the name of the output file, or `NULL` for stdout
+
+  Level: intermediate
+
+  Note:
+  Each process writes its own lines, "stage;event;...;event count", where `count` is the number of samples taken with this call path.
+  Flame graph tools, such as https://github.com/brendangregg/FlameGraph, merge identical call paths, so the output file can be used directly.
+
+.seealso: [](ch_profiling), `PetscLogSampleBegin()`, `PETSCLOGHANDLERSAMPLE`
+@*/
+PetscErrorCode PetscLogSampleDump(const char sname[])
+{
+  PetscLogHandler handler;
+  PetscViewer     viewer;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogGetHandler(PETSCLOGHANDLERSAMPLE, &handler));
+  PetscCall(PetscViewerASCIIOpen(PETSC_COMM_WORLD, sname ? sname : "stdout", &viewer));
+  PetscCall(PetscLogHandlerView(handler, viewer));
+  PetscCall(PetscViewerDestroy(&viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscLogTimelineDump - Writes the events recorded since `PetscLogTimelineBegin()` as a Chrome trace-event JSON file
+
+  Collective on `PETSC_COMM_WORLD`
+
+  Input Parameter:
+. sname - the name of the output file, or `NULL` for stdout
+
+  Level: intermediate
+
+  Note:
+  The file can be opened in https://ui.perfetto.dev or chrome://tracing, each MPI process is shown as a separate process.
+
+.seealso: [](ch_profiling), `PetscLogTimelineBegin()`, `PETSCLOGHANDLERTIMELINE`
+@*/
+PetscErrorCode PetscLogTimelineDump(const char sname[])
+{
+  PetscLogHandler handler;
+  PetscViewer     viewer;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogGetHandler(PETSCLOGHANDLERTIMELINE, &handler));
+  PetscCall(PetscViewerASCIIOpen(PETSC_COMM_WORLD, sname ? sname : "stdout", &viewer));
+  PetscCall(PetscLogHandlerView(handler, viewer));
+  PetscCall(PetscViewerDestroy(&viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PetscLogMPEDump - Dumps the MPE logging info to file for later use with Jumpshot.
 
@@ -1980,7 +2090,11 @@ PetscErrorCode PetscLogMPEDump(const char sname[])
 . -log_view :filename.py:ascii_info_detail - Saves logging information from each process as a Python file
 . -log_view :filename.xml:ascii_xml        - Saves a summary of the logging information in a nested format (see below for how to view it)
 . -log_view :filename.txt:ascii_flamegraph - Saves logging information in a format suitable for visualising as a Flame Graph (see below for how to view it)
+. -log_view :filename.json:ascii_json      - Saves a summary of the logging information reduced over all processes as a JSON document
 . -log_view_memory                         - Also display memory usage in each event
+. -log_view_histograms                     - Also display the median, 90th and 99th percentile durations of the calls to each event, see `PETSCLOGHANDLERDEFAULT`
+. -log_view_hardware_counters              - Also display the cycles, instructions, and cache misses of each event measured with Linux `perf_event_open()`, see `PETSCLOGHANDLERDEFAULT`
+. -log_view_roofline                       - Also display the memory bandwidth and arithmetic intensity of the events that estimate their memory traffic with `PetscLogBytes()`, see `PETSCLOGHANDLERDEFAULT`
 . -log_view_gpu_time                       - Also display time in each event for GPU kernels (Note this may slow the computation)
 . -log_all                                 - Saves a file Log.rank for each MPI rank with details of each step of the computation
 - -log_trace [filename]                    - Displays a trace of what each process is doing
@@ -2522,6 +2636,7 @@ PETSC_INTERN PetscErrorCode PetscLogFinalize(void)
     petsc_TotalFlops         = 0.0;
     petsc_BaseTime           = 0.0;
     petsc_TotalFlops         = 0.0;
+    petsc_TotalBytes         = 0.0;
     petsc_send_ct            = 0.0;
     petsc_recv_ct            = 0.0;
     petsc_send_len           = 0.0;
@@ -2538,6 +2653,7 @@ PETSC_INTERN PetscErrorCode PetscLogFinalize(void)
     petsc_gather_ct          = 0.0;
     petsc_scatter_ct         = 0.0;
     petsc_TotalFlops_th      = 0.0;
+    petsc_TotalBytes_th      = 0.0;
     petsc_send_ct_th         = 0.0;
     petsc_recv_ct_th         = 0.0;
     petsc_send_len_th        = 0.0;
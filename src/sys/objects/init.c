@@ -501,7 +501,7 @@ PETSC_INTERN PetscErrorCode PetscOptionsCheckInitial_Private(const char help[])
     }
 
     if (ci_log) {
-      static const char *LogOptions[] = {"-log_view", "-log_mpe", "-log_perfstubs", "-log_nvtx", "-log", "-log_all"};
+      static const char *LogOptions[] = {"-log_view", "-log_mpe", "-log_perfstubs", "-log_nvtx", "-log_sample", "-log_timeline", "-log", "-log_all"};
 
       for (size_t i = 0; i < PETSC_STATIC_ARRAY_LENGTH(LogOptions); i++) {
         PetscCall(PetscOptionsHasName(NULL, NULL, LogOptions[i], &flg1));
@@ -555,6 +555,11 @@ PETSC_INTERN PetscErrorCode PetscOptionsCheckInitial_Private(const char help[])
       PetscCall(PetscLogTraceBegin(file));
     }
 
+    PetscCall(PetscOptionsHasName(NULL, NULL, "-log_sample", &flg1));
+    if (flg1) PetscCall(PetscLogSampleBegin());
+    PetscCall(PetscOptionsHasName(NULL, NULL, "-log_timeline", &flg1));
+    if (flg1) PetscCall(PetscLogTimelineBegin());
+
     PetscCall(PetscOptionsCreateViewers(comm, NULL, NULL, "-log_view", &n_max, NULL, format, NULL));
     if (n_max > 0) {
       PetscBool any_nested  = PETSC_FALSE;
@@ -622,6 +627,8 @@ PETSC_INTERN PetscErrorCode PetscOptionsCheckInitial_Private(const char help[])
     PetscCall((*PetscHelpPrintf)(comm, " -get_total_flops: total flops over all processors\n"));
     PetscCall((*PetscHelpPrintf)(comm, " -log_view [:filename:[format]]: logging objects and events\n"));
     PetscCall((*PetscHelpPrintf)(comm, " -log_trace [filename]: prints trace of all PETSc calls\n"));
+    PetscCall((*PetscHelpPrintf)(comm, " -log_sample [filename]: samples the stack of PETSc events and prints it for flame graphs\n"));
+    PetscCall((*PetscHelpPrintf)(comm, " -log_timeline [filename]: saves the events of each process as a Chrome trace-event JSON file\n"));
     PetscCall((*PetscHelpPrintf)(comm, " -log_exclude <list,of,classnames>: exclude given classes from logging\n"));
   #if defined(PETSC_HAVE_DEVICE)
     PetscCall((*PetscHelpPrintf)(comm, " -log_view_gpu_time: log the GPU time for each and event\n"));
@@ -1287,11 +1287,16 @@ PETSC_INTERN PetscErrorCode PetscInitialize_Common(const char *prog, const char
 . -log_view [:filename:format][,[:filename:format]...] - Prints summary of flop and timing information to screen or file, see `PetscLogView()` (up to 4 viewers)
 . -log_view_memory                                     - Includes in the summary from -log_view the memory used in each event, see `PetscLogView()`.
 . -log_view_gpu_time                                   - Includes in the summary from -log_view the time used in each GPU kernel, see `PetscLogView().
+. -log_view_histograms                                 - Includes in the summary from -log_view the percentiles of the duration of the calls to each event, see `PetscLogView()`.
+. -log_view_hardware_counters                          - Includes in the summary from -log_view the hardware counters of each event measured with Linux `perf_event_open()`, see `PetscLogView()`.
+. -log_view_roofline                                   - Includes in the summary from -log_view the memory bandwidth and arithmetic intensity of each event, see `PetscLogView()`.
 . -log_exclude: <vec,mat,pc,ksp,snes>                  - excludes subset of object classes from logging
 . -log [filename]                                      - Logs profiling information in a dump file, see `PetscLogDump()`.
 . -log_all [filename]                                  - Same as `-log`.
 . -log_mpe [filename]                                  - Creates a logfile viewable by the utility Jumpshot (in MPICH distribution)
 . -log_perfstubs                                       - Starts a log handler with the perfstubs interface (which is used by TAU)
+. -log_timeline [filename]                             - Saves the beginning and end of the events of each process as a Chrome trace-event JSON file, see `PetscLogTimelineBegin()`
+. -log_sample [filename]                               - Samples the stack of active events with a profiling timer and prints the call paths in the folded stack format of flame graphs, see `PetscLogSampleBegin()`
 . -log_nvtx                                            - Starts an nvtx log handler for use with Nsight
 . -viewfromoptions on,off                              - Enable or disable `XXXSetFromOptions()` calls, for applications with many small solves turn this off
 . -get_total_flops                                     - Returns total flops done by all processors
@@ -1551,6 +1556,12 @@ PetscErrorCode PetscFinalize(void)
     PetscCall(PetscOptionsPushCreateViewerOff(PETSC_FALSE));
     PetscCall(PetscLogViewFromOptions());
     PetscCall(PetscOptionsPopCreateViewerOff());
+    mname[0] = 0;
+    PetscCall(PetscOptionsGetString(NULL, NULL, "-log_sample", mname, sizeof(mname), &flg1));
+    if (flg1) PetscCall(PetscLogSampleDump(mname[0] ? mname : NULL));
+    mname[0] = 0;
+    PetscCall(PetscOptionsGetString(NULL, NULL, "-log_timeline", mname, sizeof(mname), &flg1));
+    if (flg1) PetscCall(PetscLogTimelineDump(mname[0] ? mname : NULL));
     //  It should be turned on with PetscLogGpuTime() and never turned off except in this place
     PetscLogGpuTimeFlag = PETSC_FALSE;
 
@@ -248,4 +248,26 @@ int main(int argc, char **argv)
     temporaries: default.log flamegraph.log
     args: -log_view :flamegraph.log:ascii_flamegraph,:default.log
 
+  # percentiles of the durations: only the number of calls is reproducible
+  test:
+    suffix: 13
+    nsize: 2
+    requires: defined(PETSC_USE_LOG)
+    args: -log_view -log_view_histograms
+    filter: sed -n "/^Duration of the calls/,/^Object Type/p" | grep "\\(Event[123]\\|Event Stage\\)" | cut -c1-28
+
+  test:
+    suffix: 14
+    nsize: 2
+    requires: defined(PETSC_USE_LOG)
+    args: -log_view ::ascii_json -log_view_histograms
+    filter: grep -o -e "name.: .[A-Za-z0-9 ]*" -e "count.: [0-9]*" -e "[[][0-9.e-]*, [0-9]*[]]"
+
+  # the hardware counters are not available on all machines, only the section is checked
+  test:
+    suffix: 15
+    requires: defined(PETSC_USE_LOG)
+    args: -log_view -log_view_hardware_counters
+    filter: grep "^Hardware counters of"
+
  TEST*/
@@ -0,0 +1,68 @@
+static char help[] = "Tests the sampling log handler with -log_sample.\n\n";
+
+#include <petscsys.h>
+
+/* keeps the CPU busy so the profiling timer runs */
+static PetscErrorCode Work(PetscLogDouble seconds)
+{
+  PetscLogDouble start, now;
+
+  PetscFunctionBegin;
+  PetscCall(PetscTime(&start));
+  do {
+    PetscCall(PetscTime(&now));
+  } while (now - start < seconds);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CallEvents(PetscLogEvent outer, PetscLogEvent inner)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(outer, NULL, NULL, NULL, NULL));
+  PetscCall(Work(0.1));
+  for (PetscInt i = 0; i < 1000; i++) {
+    PetscCall(PetscLogEventBegin(inner, NULL, NULL, NULL, NULL));
+    PetscCall(Work(0.0001));
+    PetscCall(PetscLogEventEnd(inner, NULL, NULL, NULL, NULL));
+  }
+  PetscCall(PetscLogEventEnd(outer, NULL, NULL, NULL, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  PetscLogStage stage;
+  PetscLogEvent outer, inner;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscLogEventRegister("OuterEvent", 0, &outer));
+  PetscCall(PetscLogEventRegister("InnerEvent", 0, &inner));
+  PetscCall(PetscLogStageRegister("Sampled Stage", &stage));
+  PetscCall(CallEvents(outer, inner));
+  PetscCall(PetscLogStagePush(stage));
+  PetscCall(CallEvents(outer, inner));
+  PetscCall(PetscLogStagePop());
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  # the counts depend on the timer, only the call paths with events are reproducible
+  test:
+    suffix: 1
+    nsize: {{1 2}}
+    requires: defined(PETSC_USE_LOG) !windows_compilers
+    args: -log_sample -log_sample_interval 500
+    filter: grep Event | sed -e "s/ [0-9]*$//" | sort -u
+
+  test:
+    suffix: 2
+    requires: defined(PETSC_USE_LOG) !windows_compilers
+    output_file: output/ex82_1.out
+    args: -log_sample sample.txt -log_view
+    temporaries: sample.txt
+    filter: cat sample.txt | grep Event | sed -e "s/ [0-9]*$//" | sort -u
+
+TEST*/
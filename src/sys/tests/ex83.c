@@ -0,0 +1,66 @@
+static char help[] = "Tests the timeline log handler with -log_timeline.\n\n";
+
+#include <petscsys.h>
+
+int main(int argc, char **argv)
+{
+  PetscLogStage stage;
+  PetscLogEvent outer, inner, quoted;
+  PetscMPIInt   rank;
+  PetscReal     sum    = 0.0;
+  PetscBool     quotes = PETSC_FALSE;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-quotes", &quotes, NULL));
+  PetscCall(PetscLogEventRegister("OuterEvent", 0, &outer));
+  PetscCall(PetscLogEventRegister("InnerEvent", 0, &inner));
+  PetscCall(PetscLogEventSetCollective(outer, PETSC_TRUE));
+  PetscCall(PetscLogStageRegister("Timeline Stage", &stage));
+  PetscCall(PetscLogStagePush(stage));
+  for (PetscInt i = 0; i < 2; i++) {
+    PetscCall(PetscLogEventSync(outer, PETSC_COMM_WORLD));
+    PetscCall(PetscLogEventBegin(outer, NULL, NULL, NULL, NULL));
+    PetscCall(PetscLogEventBegin(inner, NULL, NULL, NULL, NULL));
+    PetscCall(PetscLogFlops(10.0 * (rank + 1)));
+    PetscCall(PetscLogEventEnd(inner, NULL, NULL, NULL, NULL));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &sum, 1, MPIU_REAL, MPIU_SUM, PETSC_COMM_WORLD));
+    PetscCall(PetscLogEventEnd(outer, NULL, NULL, NULL, NULL));
+  }
+  PetscCall(PetscLogStagePop());
+  /* the names are escaped in the JSON file */
+  if (quotes) {
+    PetscCall(PetscLogEventRegister("Quoted \"Event\" \\", 0, &quoted));
+    PetscCall(PetscLogEventBegin(quoted, NULL, NULL, NULL, NULL));
+    PetscCall(PetscLogEventEnd(quoted, NULL, NULL, NULL, NULL));
+  }
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  # the times are not reproducible, only the events with their counts are compared
+  test:
+    suffix: 1
+    nsize: 2
+    requires: defined(PETSC_USE_LOG)
+    args: -log_timeline -log_sync
+    filter: grep -o -e "name.: .[A-Za-z: ]*Event., .cat.: .[a-zA-Z ]*., .ph.: .X., .pid.: [0-9]" -e "flop.: [0-9]*, .messages.: [0-9]*, .message_length.: [0-9]*, .reductions.: [0-9]*"
+
+  test:
+    suffix: 2
+    nsize: 2
+    requires: defined(PETSC_USE_LOG)
+    args: -log_timeline timeline.json -log_sync -log_timeline_buffer 3
+    temporaries: timeline.json
+    filter: cat timeline.json | grep -o -e "name.: .[A-Za-z: ]*Event., .cat.: .[a-zA-Z ]*., .ph.: .X., .pid.: [0-9]" -e "flop.: [0-9]*, .messages.: [0-9]*, .message_length.: [0-9]*, .reductions.: [0-9]*"
+
+  test:
+    suffix: quotes
+    requires: defined(PETSC_USE_LOG)
+    args: -log_timeline -quotes
+    filter: grep -o -e "name.: .Quoted[^,]*"
+
+TEST*/
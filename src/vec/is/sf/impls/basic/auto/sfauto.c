@@ -0,0 +1,415 @@
+#include <../src/vec/is/sf/impls/basic/sfpack.h>
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+#include <petsc/private/hashtable.h>
+#include <petsctime.h>
+
+/*
+   SFAuto times a few PetscSFBcast() and PetscSFReduce() on its graph with each candidate type at setup, and does its
+   operations with the fastest one. PETSCSFBASIC is timed on the SF itself, and the others on a copy of the graph, which is
+   kept for the chosen type. The choice is cached by a signature of the graph on all ranks, so SFs with the same graph, such
+   as those of the vectors of a DM, are only timed once.
+*/
+
+#define PETSCSF_AUTO_MAX_TYPES 8
+
+typedef struct {
+  SFBASICHEADER;
+  char           types[PETSCSF_AUTO_MAX_TYPES][32]; /* The candidate types */
+  PetscInt       ntypes;
+  PetscInt       ntrials;                           /* Number of pairs of PetscSFBcast() and PetscSFReduce() timed for each candidate */
+  PetscLogDouble times[PETSCSF_AUTO_MAX_TYPES];     /* Maximum over the ranks of the time of the trials of each candidate */
+  PetscInt       best;                              /* The chosen candidate, -1 if there is no communication between ranks */
+  PetscBool      cached;                            /* Was the choice taken from the cache? */
+  PetscSF        bestsf;                            /* SF of the chosen type, or NULL if it is PETSCSFBASIC */
+} PetscSF_Auto;
+
+/* The choices of previous setups, with the signature of their graph and candidates */
+typedef struct _n_PetscSFAutoCache *PetscSFAutoCache;
+struct _n_PetscSFAutoCache {
+  PetscInt64       key;
+  char             type[32];
+  PetscSFAutoCache next;
+};
+static PetscSFAutoCache PetscSFAutoCacheList = NULL;
+
+/*===================================================================================*/
+/*              Internal utility routines                                            */
+/*===================================================================================*/
+
+static PetscErrorCode PetscSFAutoCacheDestroy(void)
+{
+  PetscSFAutoCache entry = PetscSFAutoCacheList, next;
+
+  PetscFunctionBegin;
+  for (; entry; entry = next) {
+    next = entry->next;
+    PetscCall(PetscFree(entry));
+  }
+  PetscSFAutoCacheList = NULL;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static inline PetscHash64_t PetscSFAutoHash(PetscHash64_t h, PetscInt64 v)
+{
+  return PetscHash_UInt64_64(h ^ ((PetscHash64_t)v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+/* Signature of the graph of sf, the candidates and the number of trials, the same on all ranks. Collective */
+static PetscErrorCode PetscSFAutoGetKey(PetscSF sf, PetscInt64 *key)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+  MPI_Comm      comm;
+  PetscMPIInt   rank, size;
+  PetscHash64_t h = 0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectGetComm((PetscObject)sf, &comm));
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  h = PetscSFAutoHash(h, rank);
+  h = PetscSFAutoHash(h, size);
+  h = PetscSFAutoHash(h, sf->nroots);
+  h = PetscSFAutoHash(h, sf->nranks);
+  for (PetscMPIInt i = 0; i < sf->nranks; i++) {
+    h = PetscSFAutoHash(h, sf->ranks[i]);
+    h = PetscSFAutoHash(h, sf->roffset[i + 1] - sf->roffset[i]);
+  }
+  h = PetscSFAutoHash(h, sfa->ntrials);
+  for (PetscInt t = 0; t < sfa->ntypes; t++) {
+    for (const char *c = sfa->types[t]; *c; c++) h = PetscSFAutoHash(h, *c);
+    h = PetscSFAutoHash(h, 0);
+  }
+  *key = (PetscInt64)h;
+  PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, key, 1, MPIU_INT64, MPI_BXOR, comm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Set up an SF of the candidate type on the graph of sf, or return NULL for PETSCSFBASIC, which is sf itself. Collective */
+static PetscErrorCode PetscSFAutoCreateSF(PetscSF sf, const char *type, PetscSF *newsf)
+{
+  PetscBool          isbasic, onbasic;
+  PetscInt           nroots, nleaves;
+  const PetscInt    *ilocal;
+  const PetscSFNode *iremote;
+
+  PetscFunctionBegin;
+  *newsf = NULL;
+  PetscCall(PetscStrcmp(type, PETSCSFBASIC, &isbasic));
+  if (isbasic) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscSFGetGraph(sf, &nroots, &nleaves, &ilocal, &iremote));
+  PetscCall(PetscSFCreate(PetscObjectComm((PetscObject)sf), newsf));
+  PetscCall(PetscSFSetType(*newsf, type));
+  PetscCall(PetscObjectTypeCompareAny((PetscObject)*newsf, &onbasic, PETSCSFSHMEM, PETSCSFHIERARCHICAL, ""));
+  if (onbasic) PetscCall(PetscSFBasicCopyOptions_Private(sf, *newsf));
+  PetscCall(PetscSFSetGraph(*newsf, nroots, nleaves, (PetscInt *)ilocal, PETSC_COPY_VALUES, (PetscSFNode *)iremote, PETSC_COPY_VALUES));
+  PetscCall(PetscSFSetUp(*newsf));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* One trial, on tsf or, if it is NULL, with the PETSCSFBASIC routines on sf since sf is being set up */
+static PetscErrorCode PetscSFAutoTrial(PetscSF sf, PetscSF tsf, PetscScalar *rootdata, PetscScalar *leafdata)
+{
+  PetscFunctionBegin;
+  if (tsf) {
+    PetscCall(PetscSFBcastBegin(tsf, MPIU_SCALAR, rootdata, leafdata, MPI_REPLACE));
+    PetscCall(PetscSFBcastEnd(tsf, MPIU_SCALAR, rootdata, leafdata, MPI_REPLACE));
+    PetscCall(PetscSFReduceBegin(tsf, MPIU_SCALAR, leafdata, rootdata, MPI_SUM));
+    PetscCall(PetscSFReduceEnd(tsf, MPIU_SCALAR, leafdata, rootdata, MPI_SUM));
+  } else {
+    PetscCall(PetscSFBcastBegin_Basic(sf, MPIU_SCALAR, PETSC_MEMTYPE_HOST, rootdata, PETSC_MEMTYPE_HOST, leafdata, MPI_REPLACE));
+    PetscCall(PetscSFBcastEnd_Basic(sf, MPIU_SCALAR, rootdata, leafdata, MPI_REPLACE));
+    PetscCall(PetscSFReduceBegin_Basic(sf, MPIU_SCALAR, PETSC_MEMTYPE_HOST, leafdata, PETSC_MEMTYPE_HOST, rootdata, MPI_SUM));
+    PetscCall(PetscSFReduceEnd_Basic(sf, MPIU_SCALAR, leafdata, rootdata, MPI_SUM));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Time the trials on tsf, the maximum over the ranks. Collective */
+static PetscErrorCode PetscSFAutoTime(PetscSF sf, PetscSF tsf, PetscLogDouble *time)
+{
+  PetscSF_Auto  *sfa = (PetscSF_Auto *)sf->data;
+  MPI_Comm       comm;
+  PetscInt       minleaf, maxleaf;
+  PetscScalar   *rootdata, *leafdata;
+  PetscLogDouble t0, t1;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectGetComm((PetscObject)sf, &comm));
+  PetscCall(PetscSFGetLeafRange(sf, &minleaf, &maxleaf));
+  PetscCall(PetscCalloc2(sf->nroots, &rootdata, maxleaf + 1, &leafdata));
+  /* The first trial also sets up the communication of the type */
+  PetscCall(PetscSFAutoTrial(sf, tsf, rootdata, leafdata));
+  PetscCallMPI(MPI_Barrier(comm));
+  PetscCall(PetscTime(&t0));
+  for (PetscInt k = 0; k < sfa->ntrials; k++) PetscCall(PetscSFAutoTrial(sf, tsf, rootdata, leafdata));
+  PetscCall(PetscTime(&t1));
+  *time = t1 - t0;
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, time, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm));
+  PetscCall(PetscFree2(rootdata, leafdata));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Did the operation on rootdata and leafdata go through the PETSCSFBASIC routines on sf itself? */
+static PetscErrorCode PetscSFAutoUsedBasic(PetscSF sf, MPI_Datatype unit, const void *rootdata, const void *leafdata, PetscBool *used)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+
+  PetscFunctionBegin;
+  *used = PETSC_FALSE;
+  for (PetscSFLink link = sfa->inuse; link; link = link->next) {
+    PetscBool match;
+
+    PetscCall(MPIPetsc_Type_compare(unit, link->unit, &match));
+    if (match && rootdata == link->rootdata && leafdata == link->leafdata) {
+      *used = PETSC_TRUE;
+      break;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*===================================================================================*/
+/*              Implementations of SF public APIs                                    */
+/*===================================================================================*/
+static PetscErrorCode PetscSFSetUp_Auto(PetscSF sf)
+{
+  PetscSF_Auto    *sfa = (PetscSF_Auto *)sf->data;
+  PetscSFAutoCache entry;
+  PetscInt64       key;
+  PetscMPIInt      found, remote;
+
+  PetscFunctionBegin;
+  /* SFAuto inherits from Basic, which is a candidate and is used for what the chosen type is not */
+  PetscCall(PetscSFSetUp_Basic(sf));
+  /* Without communication between ranks all the types do the same local scatter, so there is nothing to time */
+  remote = (sfa->nrootreqs || sf->nleafreqs) ? 1 : 0;
+  PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, &remote, 1, MPI_INT, MPI_MAX, PetscObjectComm((PetscObject)sf)));
+  if (!remote) {
+    sfa->best   = -1;
+    sfa->cached = PETSC_FALSE;
+    PetscCall(PetscInfo(sf, "No communication between ranks, using PetscSF type basic\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFAutoGetKey(sf, &key));
+  for (entry = PetscSFAutoCacheList; entry; entry = entry->next)
+    if (entry->key == key) break;
+  found = entry ? 1 : 0;
+  PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, PetscObjectComm((PetscObject)sf)));
+
+  sfa->best   = 0;
+  sfa->cached = found ? PETSC_TRUE : PETSC_FALSE;
+  if (found) {
+    for (PetscInt t = 0; t < sfa->ntypes; t++) {
+      PetscBool match;
+
+      PetscCall(PetscStrcmp(sfa->types[t], entry->type, &match));
+      if (match) sfa->best = t;
+      sfa->times[t] = -1.0;
+    }
+    PetscCall(PetscSFAutoCreateSF(sf, sfa->types[sfa->best], &sfa->bestsf));
+  } else {
+    PetscSF bestsf = NULL;
+
+    /* sfa->bestsf stays NULL until the end, so that the operations on sf go through the PETSCSFBASIC routines */
+    for (PetscInt t = 0; t < sfa->ntypes; t++) {
+      PetscSF tsf;
+
+      PetscCall(PetscSFAutoCreateSF(sf, sfa->types[t], &tsf));
+      PetscCall(PetscSFAutoTime(sf, tsf, &sfa->times[t]));
+      if (!t || sfa->times[t] < sfa->times[sfa->best]) {
+        PetscCall(PetscSFDestroy(&bestsf));
+        sfa->best = t;
+        bestsf    = tsf;
+      } else PetscCall(PetscSFDestroy(&tsf));
+    }
+    sfa->bestsf = bestsf;
+    if (!entry) {
+      if (!PetscSFAutoCacheList) PetscCall(PetscRegisterFinalize(PetscSFAutoCacheDestroy));
+      PetscCall(PetscNew(&entry));
+      entry->key           = key;
+      entry->next          = PetscSFAutoCacheList;
+      PetscSFAutoCacheList = entry;
+    }
+    PetscCall(PetscStrncpy(entry->type, sfa->types[sfa->best], sizeof(entry->type)));
+  }
+  PetscCall(PetscInfo(sf, "Chose PetscSF type %s%s\n", sfa->types[sfa->best], sfa->cached ? " from the cache" : ""));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReset_Auto(PetscSF sf)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFDestroy(&sfa->bestsf));
+  PetscCall(PetscSFReset_Basic(sf)); /* Common part */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFDestroy_Auto(PetscSF sf)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscSFReset_Auto(sf));
+  PetscCall(PetscFree(sf->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Auto(PetscSF sf, PetscOptionItems PetscOptionsObject)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+  char         *types[PETSCSF_AUTO_MAX_TYPES];
+  PetscInt      ntypes = PETSCSF_AUTO_MAX_TYPES;
+  PetscBool     set;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFSetFromOptions_Basic(sf, PetscOptionsObject));
+  PetscOptionsHeadBegin(PetscOptionsObject, "PetscSF Auto options");
+  PetscCall(PetscOptionsStringArray("-sf_auto_types", "Candidate PetscSF types", "PetscSFSetFromOptions", types, &ntypes, &set));
+  if (set) {
+    PetscBool isauto = PETSC_FALSE;
+
+    /* validate all the candidates before keeping them, and free the strings before reporting an error */
+    for (PetscInt t = 0; t < ntypes && !isauto; t++) PetscCall(PetscStrcmp(types[t], PETSCSFAUTO, &isauto));
+    if (ntypes > 0 && !isauto) {
+      for (PetscInt t = 0; t < ntypes; t++) PetscCall(PetscStrncpy(sfa->types[t], types[t], sizeof(sfa->types[t])));
+      sfa->ntypes = ntypes;
+    }
+    for (PetscInt t = 0; t < ntypes; t++) PetscCall(PetscFree(types[t]));
+    PetscCheck(ntypes > 0, PetscObjectComm((PetscObject)sf), PETSC_ERR_ARG_WRONG, "Give at least one candidate type");
+    PetscCheck(!isauto, PetscObjectComm((PetscObject)sf), PETSC_ERR_ARG_WRONG, "%s can not be a candidate of itself", PETSCSFAUTO);
+  }
+  PetscCall(PetscOptionsInt("-sf_auto_trials", "Number of PetscSFBcast() and PetscSFReduce() timed with each candidate", "PetscSFSetFromOptions", sfa->ntrials, &sfa->ntrials, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFView_Auto(PetscSF sf, PetscViewer viewer)
+{
+  PetscSF_Auto     *sfa = (PetscSF_Auto *)sf->data;
+  PetscBool         isascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFView_Basic(sf, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCall(PetscViewerGetFormat(viewer, &format));
+  if (isascii && format != PETSC_VIEWER_ASCII_MATLAB && sf->setupcalled) {
+    if (sfa->best < 0) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  No communication between ranks, candidates not timed\n"));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  Autotuned type %s among %" PetscInt_FMT " candidates%s\n", sfa->types[sfa->best], sfa->ntypes, sfa->cached ? ", from the cache" : ""));
+    if (!sfa->cached && format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+      for (PetscInt t = 0; t < sfa->ntypes; t++) PetscCall(PetscViewerASCIIPrintf(viewer, "    %s: %g seconds for %" PetscInt_FMT " PetscSFBcast() and PetscSFReduce()\n", sfa->types[t], sfa->times[t], sfa->ntrials));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Auto(PetscSF sf, MPI_Datatype unit, PetscMemType rootmtype, const void *rootdata, PetscMemType leafmtype, void *leafdata, MPI_Op op)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+
+  PetscFunctionBegin;
+  if (sfa->bestsf && PetscMemTypeHost(rootmtype) && PetscMemTypeHost(leafmtype)) PetscCall(PetscSFBcastWithMemTypeBegin(sfa->bestsf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+  else PetscCall(PetscSFBcastBegin_Basic(sf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Auto(PetscSF sf, MPI_Datatype unit, const void *rootdata, void *leafdata, MPI_Op op)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+  PetscBool     usedbasic;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFAutoUsedBasic(sf, unit, rootdata, leafdata, &usedbasic));
+  if (usedbasic) PetscCall(PetscSFBcastEnd_Basic(sf, unit, rootdata, leafdata, op));
+  else PetscCall(PetscSFBcastEnd(sfa->bestsf, unit, rootdata, leafdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Auto(PetscSF sf, MPI_Datatype unit, PetscMemType leafmtype, const void *leafdata, PetscMemType rootmtype, void *rootdata, MPI_Op op)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+
+  PetscFunctionBegin;
+  if (sfa->bestsf && PetscMemTypeHost(rootmtype) && PetscMemTypeHost(leafmtype)) PetscCall(PetscSFReduceWithMemTypeBegin(sfa->bestsf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+  else PetscCall(PetscSFReduceBegin_Basic(sf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Auto(PetscSF sf, MPI_Datatype unit, const void *leafdata, void *rootdata, MPI_Op op)
+{
+  PetscSF_Auto *sfa = (PetscSF_Auto *)sf->data;
+  PetscBool     usedbasic;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFAutoUsedBasic(sf, unit, rootdata, leafdata, &usedbasic));
+  if (usedbasic) PetscCall(PetscSFReduceEnd_Basic(sf, unit, leafdata, rootdata, op));
+  else PetscCall(PetscSFReduceEnd(sfa->bestsf, unit, leafdata, rootdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PETSCSFAUTO - A `PetscSFType` that times its communication with several other types at setup and uses the fastest
+
+   Options Database Keys:
++  -sf_type auto                  - use this type
+.  -sf_auto_types <t1,t2,...>     - the candidate types, by default `PETSCSFBASIC`, `PETSCSFNEIGHBOR`, `PETSCSFWINDOW` and
+                                    `PETSCSFSHMEM` when MPI provides them
+-  -sf_auto_trials <n>            - number of pairs of `PetscSFBcastBegin()` and `PetscSFReduceBegin()` timed with each candidate (default 5)
+
+   Level: intermediate
+
+   Notes:
+   `PetscSFSetUp()` sets up each candidate on the graph, times the trials on `PetscScalar` data, and keeps the candidate
+   with the smallest time over all ranks. The choice is cached by a signature of the graph, the candidates and the number
+   of trials, so setting up another `PETSCSFAUTO` with the same graph on the same ranks uses the cached choice without
+   timing again. `PetscSFView()` shows the choice, and the time of each candidate with `PETSC_VIEWER_ASCII_INFO_DETAIL`.
+
+   The timings are only as good as the state of the machine during setup, and a choice made on the first setup persists
+   for the lifetime of the program. `PetscSFFetchAndOpBegin()` and data in device memory go through `PETSCSFBASIC`.
+   The `-sf_basic_` options, such as `-sf_basic_compress_size`, apply to `PETSCSFBASIC` and to the candidates built on it.
+   `PETSCSFALLTOALL` and the other types for graphs set with `PetscSFSetGraphWithPattern()` can not be candidates.
+
+.seealso: `PetscSF`, `PetscSFType`, `PetscSFSetType()`, `PETSCSFBASIC`, `PETSCSFNEIGHBOR`, `PETSCSFWINDOW`, `PETSCSFSHMEM`
+M*/
+PETSC_INTERN PetscErrorCode PetscSFCreate_Auto(PetscSF sf)
+{
+  PetscSF_Auto *dat;
+
+  PetscFunctionBegin;
+  sf->ops->CreateEmbeddedRootSF = PetscSFCreateEmbeddedRootSF_Basic;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Basic;
+  sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
+  sf->ops->SetCommunicationOps  = PetscSFSetCommunicationOps_Basic;
+
+  sf->ops->SetUp          = PetscSFSetUp_Auto;
+  sf->ops->Reset          = PetscSFReset_Auto;
+  sf->ops->Destroy        = PetscSFDestroy_Auto;
+  sf->ops->SetFromOptions = PetscSFSetFromOptions_Auto;
+  sf->ops->View           = PetscSFView_Auto;
+  sf->ops->BcastBegin     = PetscSFBcastBegin_Auto;
+  sf->ops->BcastEnd       = PetscSFBcastEnd_Auto;
+  sf->ops->ReduceBegin    = PetscSFReduceBegin_Auto;
+  sf->ops->ReduceEnd      = PetscSFReduceEnd_Auto;
+
+  sf->persistent = PETSC_TRUE; // the PETSCSFBASIC routines use persistent send/recv
+  sf->collective = PETSC_TRUE;
+
+  PetscCall(PetscNew(&dat));
+  PetscCall(PetscStrncpy(dat->types[dat->ntypes++], PETSCSFBASIC, sizeof(dat->types[0])));
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+  PetscCall(PetscStrncpy(dat->types[dat->ntypes++], PETSCSFNEIGHBOR, sizeof(dat->types[0])));
+#endif
+#if defined(PETSC_HAVE_MPI_WIN_CREATE)
+  PetscCall(PetscStrncpy(dat->types[dat->ntypes++], PETSCSFWINDOW, sizeof(dat->types[0])));
+#endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscCall(PetscStrncpy(dat->types[dat->ntypes++], PETSCSFSHMEM, sizeof(dat->types[0])));
+#endif
+  dat->ntrials = 5;
+  sf->data     = (void *)dat;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,599 @@
+#include <../src/vec/is/sf/impls/basic/sfpack.h>
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+
+/*
+   SFHierarchical sends the data of all the edges between two nodes in a single message between the leaders (the first
+   ranks) of the nodes. The leader of a node gathers the root data its node sends to each other node into one slot per edge
+   of its send buffer, the leaders exchange these blocks of slots, and each leader scatters the slots of its receive buffer
+   to the leaves of its node. The gathers and scatters, and the edges within a node, go through PETSCSFSHMEM, and the
+   messages between the leaders through PETSCSFBASIC. The slots between two nodes are sorted by root rank and leaf rank on
+   both leaders, so they agree on the order of the edges without exchanging it.
+*/
+
+typedef enum {
+  PETSCSF_HIERARCHICAL_AUTO,
+  PETSCSF_HIERARCHICAL_FLAT,
+  PETSCSF_HIERARCHICAL_NODE
+} PetscSFHierarchicalMode;
+static const char *const PetscSFHierarchicalModes[] = {"AUTO", "FLAT", "NODE", "PetscSFHierarchicalMode", "PETSCSF_HIERARCHICAL_", NULL};
+
+/* Buffers of the node leaders for an operation in progress */
+typedef struct _n_PetscSFHierBuf *PetscSFHierBuf;
+struct _n_PetscSFHierBuf {
+  MPI_Datatype   unit;                 /* Not owned */
+  const void    *rootdata, *leafdata;  /* The operation using the buffers */
+  PetscBool      inuse;
+  size_t         sendbytes, recvbytes; /* Allocated sizes of sendbuf[] and recvbuf[] */
+  char          *sendbuf, *recvbuf;    /* The slots of my node to other nodes, and of other nodes to my node */
+  PetscSFHierBuf next;
+};
+
+typedef struct {
+  SFBASICHEADER;
+  PetscSFHierarchicalMode mode;
+  PetscInt                msgsize;      /* In auto mode, aggregate if the messages between nodes have fewer entries than this on average */
+  PetscMPIInt             nodesize;     /* If positive, take groups of nodesize consecutive ranks as nodes instead of the shared-memory nodes */
+  PetscBool               hierarchical; /* Are the edges between nodes aggregated through the node leaders? */
+  PetscInt                stats[3];     /* Over all ranks: messages between nodes without and with aggregation, and edges between nodes */
+  PetscSF                 localsf;      /* Edges within my node */
+  PetscSF                 gathersf;     /* Roots of my node to the slots of the send buffer of my leader */
+  PetscSF                 leadersf;     /* Slots of the send buffers of the leaders to the slots of their receive buffers */
+  PetscSF                 scattersf;    /* Slots of the receive buffer of my leader to leaves of my node */
+  PetscInt                nsendslots, nrecvslots;
+  PetscSFHierBuf          bufs;
+} PetscSF_Hierarchical;
+
+/* The edges between a root rank and a leaf rank on different nodes */
+typedef struct {
+  PetscInt node;               /* Leader of the node of the other rank */
+  PetscInt rootrank, leafrank;
+  PetscInt n;                  /* Number of edges */
+  PetscInt id;                 /* Position in the blocks gathered by the leader */
+  PetscInt start;              /* First slot of the block in the buffer of the leader */
+} PetscSFHierBlock;
+
+#define PETSCSF_HIER_BLOCK_INTS ((PetscMPIInt)(sizeof(PetscSFHierBlock) / sizeof(PetscInt)))
+
+/*===================================================================================*/
+/*              Internal utility routines                                            */
+/*===================================================================================*/
+
+static int PetscSFHierBlockCompare(const void *a, const void *b, PETSC_UNUSED void *ctx)
+{
+  const PetscSFHierBlock *x = (const PetscSFHierBlock *)a, *y = (const PetscSFHierBlock *)b;
+
+  if (x->node != y->node) return x->node < y->node ? -1 : 1;
+  if (x->rootrank != y->rootrank) return x->rootrank < y->rootrank ? -1 : 1;
+  if (x->leafrank != y->leafrank) return x->leafrank < y->leafrank ? -1 : 1;
+  return 0;
+}
+
+/* Gather the n entries of mine[] of each rank of nodecomm on its rank 0, which gets in counts[] and displs[] where the
+   entries of each rank are in all[]
+*/
+static PetscErrorCode PetscSFHierarchicalGather(MPI_Comm nodecomm, PetscMPIInt n, MPI_Datatype dtype, size_t unitbytes, const void *mine, PetscMPIInt **counts, PetscMPIInt **displs, void *all)
+{
+  PetscMPIInt noderank, nodesize;
+
+  PetscFunctionBegin;
+  *counts       = NULL;
+  *displs       = NULL;
+  *(void **)all = NULL;
+  PetscCallMPI(MPI_Comm_rank(nodecomm, &noderank));
+  PetscCallMPI(MPI_Comm_size(nodecomm, &nodesize));
+  if (!noderank) PetscCall(PetscMalloc2(nodesize, counts, nodesize + 1, displs));
+  PetscCallMPI(MPI_Gather(&n, 1, MPI_INT, *counts, 1, MPI_INT, 0, nodecomm));
+  if (!noderank) {
+    (*displs)[0] = 0;
+    for (PetscMPIInt i = 0; i < nodesize; i++) PetscCall(PetscMPIIntCast((PetscInt)(*displs)[i] + (*counts)[i], &(*displs)[i + 1]));
+    PetscCall(PetscMalloc((size_t)(*displs)[nodesize] * unitbytes, all));
+  }
+  PetscCallMPI(MPI_Gatherv(mine, n, dtype, *(void **)all, *counts, *displs, dtype, 0, nodecomm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Sort the blocks gathered by a leader and give them consecutive slots. Return the number of slots, and the number of other
+   nodes with the leader of each, the first slot of its blocks and their number of slots
+*/
+static PetscErrorCode PetscSFHierarchicalSortBlocks(PetscInt nblocks, PetscSFHierBlock *blocks, PetscInt *nslots, PetscMPIInt *nnodes, PetscMPIInt **nodes, PetscInt **nodeslots)
+{
+  PetscMPIInt n = 0;
+
+  PetscFunctionBegin;
+  for (PetscInt b = 0; b < nblocks; b++) blocks[b].id = b;
+  if (nblocks > 1) PetscCall(PetscTimSort(nblocks, blocks, sizeof(PetscSFHierBlock), PetscSFHierBlockCompare, NULL));
+  *nslots = 0;
+  for (PetscInt b = 0; b < nblocks; b++) {
+    if (!b || blocks[b].node != blocks[b - 1].node) n++;
+    blocks[b].start = *nslots;
+    *nslots += blocks[b].n;
+  }
+  *nnodes = n;
+  PetscCall(PetscMalloc2(n, nodes, 2 * n, nodeslots));
+  for (PetscInt b = 0, i = -1; b < nblocks; b++) {
+    if (!b || blocks[b].node != blocks[b - 1].node) {
+      i++;
+      PetscCall(PetscMPIIntCast(blocks[b].node, &(*nodes)[i]));
+      (*nodeslots)[2 * i]     = blocks[b].start;
+      (*nodeslots)[2 * i + 1] = 0;
+    }
+    (*nodeslots)[2 * i + 1] += blocks[b].n;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Create one of the inner SFs with the options of sf, taking ownership of ilocal and remote: with PETSCSFSHMEM the intra-node graphs
+   (localsf for the edges within my node, gathersf from the roots of my node to the send slots of my leader, scattersf from the
+   receive slots of my leader to the leaves of my node), and with PETSCSFBASIC the inter-node graph leadersf between the slots of
+   the leaders */
+static PetscErrorCode PetscSFHierarchicalCreateSF(PetscSF sf, PetscSFType type, PetscInt nroots, PetscInt nleaves, PetscInt *ilocal, PetscSFNode *remote, PetscSF *newsf)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscSFCreate(PetscObjectComm((PetscObject)sf), newsf));
+  PetscCall(PetscSFSetType(*newsf, type));
+  PetscCall(PetscSFBasicCopyOptions_Private(sf, *newsf));
+  PetscCall(PetscSFSetGraph(*newsf, nroots, nleaves, ilocal, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER));
+  PetscCall(PetscSFSetUp(*newsf));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Build the SFs moving the data of the edges between nodes through the node leaders, given the blocks of my leaves connected
+   to other nodes and, on the leader, the sorted blocks of the leaves of its node with the nodes they get data from. Collective
+*/
+static PetscErrorCode PetscSFHierarchicalSetUpNodes(PetscSF sf, MPI_Comm nodecomm, PetscMPIInt leader, const PetscMPIInt *leaders, MPI_Datatype blocktype, PetscMPIInt nlb, const PetscSFHierBlock *lblocks, PetscInt nglb, const PetscSFHierBlock *glblocks, const PetscMPIInt *lcounts, const PetscMPIInt *ldispls, PetscMPIInt nsrc, const PetscMPIInt *srcnodes, const PetscInt *srcslots)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  MPI_Comm              comm;
+  PetscMPIInt           rank, noderank, nodesize, nrb = 0, nrl, *rcounts, *rdispls, ndst = 0, *dstnodes = NULL, nfrom, *fromranks;
+  PetscSFHierBlock     *rblocks, *grblocks;
+  PetscInt              ngrb = 0, nrlocs = 0, *rlocs, *grlocs, *locoff, *dstslots = NULL, *fromslots, *slotoff, *myoff, nleaves = 0, *ilocal;
+  PetscSFNode          *remote;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectGetComm((PetscObject)sf, &comm));
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCallMPI(MPI_Comm_rank(nodecomm, &noderank));
+  PetscCallMPI(MPI_Comm_size(nodecomm, &nodesize));
+
+  /* My roots connected to leaves on other nodes, and their locations */
+  for (PetscMPIInt i = 0; i < hsf->niranks; i++) {
+    if (leaders[hsf->iranks[i]] == leader) continue;
+    nrb++;
+    nrlocs += hsf->ioffset[i + 1] - hsf->ioffset[i];
+  }
+  PetscCall(PetscMPIIntCast(nrlocs, &nrl));
+  PetscCall(PetscMalloc1(nrb, &rblocks));
+  PetscCall(PetscMalloc1(nrlocs, &rlocs));
+  nrlocs = 0;
+  for (PetscMPIInt i = 0, b = 0; i < hsf->niranks; i++) {
+    PetscInt n = hsf->ioffset[i + 1] - hsf->ioffset[i];
+
+    if (leaders[hsf->iranks[i]] == leader) continue;
+    rblocks[b].node     = leaders[hsf->iranks[i]];
+    rblocks[b].rootrank = rank;
+    rblocks[b].leafrank = hsf->iranks[i];
+    rblocks[b].n        = n;
+    rblocks[b].id       = -1;
+    rblocks[b].start    = -1;
+    PetscCall(PetscArraycpy(rlocs + nrlocs, hsf->irootloc + hsf->ioffset[i], n));
+    nrlocs += n;
+    b++;
+  }
+  PetscCall(PetscSFHierarchicalGather(nodecomm, nrb, blocktype, sizeof(PetscSFHierBlock), rblocks, &rcounts, &rdispls, &grblocks));
+  if (!noderank) ngrb = rdispls[nodesize];
+  PetscCall(PetscFree2(rcounts, rdispls));
+  PetscCall(PetscSFHierarchicalGather(nodecomm, nrl, MPIU_INT, sizeof(PetscInt), rlocs, &rcounts, &rdispls, &grlocs));
+  PetscCall(PetscFree2(rcounts, rdispls));
+  PetscCall(PetscFree(rblocks));
+  PetscCall(PetscFree(rlocs));
+
+  /* The leader gives the roots of its node connected to other nodes consecutive slots in its send buffer */
+  PetscCall(PetscMalloc1(ngrb, &locoff));
+  for (PetscInt b = 0, l = 0; b < ngrb; b++) {
+    locoff[b] = l;
+    l += grblocks[b].n;
+  }
+  if (!noderank) PetscCall(PetscSFHierarchicalSortBlocks(ngrb, grblocks, &hsf->nsendslots, &ndst, &dstnodes, &dstslots));
+  PetscCall(PetscMalloc1(hsf->nsendslots, &remote));
+  for (PetscInt b = 0; b < ngrb; b++) {
+    for (PetscInt k = 0; k < grblocks[b].n; k++) {
+      remote[grblocks[b].start + k].rank  = grblocks[b].rootrank;
+      remote[grblocks[b].start + k].index = grlocs[locoff[grblocks[b].id] + k];
+    }
+  }
+  PetscCall(PetscSFHierarchicalCreateSF(sf, PETSCSFSHMEM, sf->nroots, hsf->nsendslots, NULL, remote, &hsf->gathersf));
+  PetscCall(PetscFree(locoff));
+  PetscCall(PetscFree(grblocks));
+  PetscCall(PetscFree(grlocs));
+
+  /* Each leader tells the leaders it sends to where their slots start in its send buffer */
+  PetscCall(PetscCommBuildTwoSided(comm, 2, MPIU_INT, ndst, dstnodes, dstslots, &nfrom, &fromranks, &fromslots));
+  PetscCheck(nfrom == nsrc, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Node leader gets data from %d nodes but expects %d", nfrom, nsrc);
+  PetscCall(PetscMalloc1(hsf->nrecvslots, &remote));
+  for (PetscMPIInt i = 0; i < nsrc; i++) {
+    PetscMPIInt j;
+
+    for (j = 0; j < nfrom; j++)
+      if (fromranks[j] == srcnodes[i]) break;
+    PetscCheck(j < nfrom && fromslots[2 * j + 1] == srcslots[2 * i + 1], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Node leader %d does not send the %" PetscInt_FMT " slots expected", srcnodes[i], srcslots[2 * i + 1]);
+    for (PetscInt k = 0; k < srcslots[2 * i + 1]; k++) {
+      remote[srcslots[2 * i] + k].rank  = srcnodes[i];
+      remote[srcslots[2 * i] + k].index = fromslots[2 * j] + k;
+    }
+  }
+  PetscCall(PetscSFHierarchicalCreateSF(sf, PETSCSFBASIC, hsf->nsendslots, hsf->nrecvslots, NULL, remote, &hsf->leadersf));
+  PetscCall(PetscFree2(dstnodes, dstslots));
+  PetscCall(PetscFree(fromranks));
+  PetscCall(PetscFree(fromslots));
+
+  /* The leader tells the ranks of its node where the slots of their leaves are in its receive buffer */
+  PetscCall(PetscMalloc1(nglb, &slotoff));
+  for (PetscInt b = 0; b < nglb; b++) slotoff[glblocks[b].id] = glblocks[b].start;
+  PetscCall(PetscMalloc1(nlb, &myoff));
+  PetscCallMPI(MPI_Scatterv(slotoff, lcounts, ldispls, MPIU_INT, myoff, nlb, MPIU_INT, 0, nodecomm));
+  for (PetscMPIInt b = 0; b < nlb; b++) nleaves += lblocks[b].n;
+  PetscCall(PetscMalloc1(nleaves, &ilocal));
+  PetscCall(PetscMalloc1(nleaves, &remote));
+  nleaves = 0;
+  for (PetscMPIInt i = 0, b = 0; i < sf->nranks; i++) {
+    if (leaders[sf->ranks[i]] == leader) continue;
+    for (PetscInt k = sf->roffset[i]; k < sf->roffset[i + 1]; k++, nleaves++) {
+      ilocal[nleaves]       = sf->rmine[k];
+      remote[nleaves].rank  = leader;
+      remote[nleaves].index = myoff[b] + k - sf->roffset[i];
+    }
+    b++;
+  }
+  PetscCall(PetscSFHierarchicalCreateSF(sf, PETSCSFSHMEM, hsf->nrecvslots, nleaves, ilocal, remote, &hsf->scattersf));
+  PetscCall(PetscFree(slotoff));
+  PetscCall(PetscFree(myoff));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Get free buffers of the leader for an operation on rootdata and leafdata */
+static PetscErrorCode PetscSFHierarchicalGetBuf(PetscSF sf, MPI_Datatype unit, const void *rootdata, const void *leafdata, PetscSFHierBuf *mybuf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf;
+  MPI_Aint              lb, extent;
+
+  PetscFunctionBegin;
+  PetscCallMPI(MPI_Type_get_extent(unit, &lb, &extent));
+  PetscCheck(lb == 0, PETSC_COMM_SELF, PETSC_ERR_SUP, "Datatype with nonzero lower bound %ld", (long)lb);
+  for (buf = hsf->bufs; buf; buf = buf->next)
+    if (!buf->inuse) break;
+  if (!buf) {
+    PetscCall(PetscNew(&buf));
+    buf->next = hsf->bufs;
+    hsf->bufs = buf;
+  }
+  if (buf->sendbytes < (size_t)(hsf->nsendslots * extent)) {
+    PetscCall(PetscFree(buf->sendbuf));
+    buf->sendbytes = (size_t)(hsf->nsendslots * extent);
+    PetscCall(PetscMalloc(buf->sendbytes, &buf->sendbuf));
+  }
+  if (buf->recvbytes < (size_t)(hsf->nrecvslots * extent)) {
+    PetscCall(PetscFree(buf->recvbuf));
+    buf->recvbytes = (size_t)(hsf->nrecvslots * extent);
+    PetscCall(PetscMalloc(buf->recvbytes, &buf->recvbuf));
+  }
+  buf->unit     = unit;
+  buf->rootdata = rootdata;
+  buf->leafdata = leafdata;
+  buf->inuse    = PETSC_TRUE;
+  *mybuf        = buf;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Find the buffers of the operation on rootdata and leafdata, or NULL if it went through the PETSCSFBASIC routines */
+static PetscErrorCode PetscSFHierarchicalFindBuf(PetscSF sf, MPI_Datatype unit, const void *rootdata, const void *leafdata, PetscSFHierBuf *mybuf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+
+  PetscFunctionBegin;
+  *mybuf = NULL;
+  for (PetscSFHierBuf buf = hsf->bufs; buf; buf = buf->next) {
+    PetscBool match;
+
+    if (!buf->inuse || buf->rootdata != rootdata || buf->leafdata != leafdata) continue;
+    PetscCall(MPIPetsc_Type_compare(unit, buf->unit, &match));
+    if (match) {
+      *mybuf = buf;
+      break;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*===================================================================================*/
+/*              Implementations of SF public APIs                                    */
+/*===================================================================================*/
+static PetscErrorCode PetscSFSetUp_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  MPI_Comm              comm, nodecomm;
+  MPI_Datatype          blocktype;
+  PetscShmComm          pshmcomm;
+  PetscMPIInt           rank, size, noderank, nodesize, leader, *leaders, nlb = 0, *lcounts, *ldispls, nsrc = 0, *srcnodes = NULL;
+  PetscSFHierBlock     *lblocks, *glblocks;
+  PetscInt              nglb = 0, nlocal = 0, *srcslots = NULL, *ilocal;
+  PetscSFNode          *remote;
+
+  PetscFunctionBegin;
+  /* SFHierarchical inherits from Basic, whose routines on the whole graph are used when the edges are not aggregated */
+  PetscCall(PetscSFSetUp_Basic(sf));
+  PetscCall(PetscObjectGetComm((PetscObject)sf, &comm));
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  if (hsf->nodesize > 0) PetscCallMPI(MPI_Comm_split(comm, rank / hsf->nodesize, rank, &nodecomm));
+  else {
+    PetscCall(PetscShmCommGet(comm, &pshmcomm));
+    PetscCall(PetscShmCommGetMpiShmComm(pshmcomm, &nodecomm));
+  }
+  PetscCallMPI(MPI_Comm_rank(nodecomm, &noderank));
+  PetscCallMPI(MPI_Comm_size(nodecomm, &nodesize));
+  leader = rank;
+  PetscCallMPI(MPI_Bcast(&leader, 1, MPI_INT, 0, nodecomm));
+  PetscCall(PetscMalloc1(size, &leaders));
+  PetscCallMPI(MPI_Allgather(&leader, 1, MPI_INT, leaders, 1, MPI_INT, comm));
+
+  /* My leaves connected to roots on other nodes */
+  for (PetscMPIInt i = 0; i < sf->nranks; i++) {
+    if (leaders[sf->ranks[i]] == leader) nlocal += sf->roffset[i + 1] - sf->roffset[i];
+    else nlb++;
+  }
+  PetscCall(PetscArrayzero(hsf->stats, 3));
+  PetscCall(PetscMalloc1(nlb, &lblocks));
+  for (PetscMPIInt i = 0, b = 0; i < sf->nranks; i++) {
+    if (leaders[sf->ranks[i]] == leader) continue;
+    lblocks[b].node     = leaders[sf->ranks[i]];
+    lblocks[b].rootrank = sf->ranks[i];
+    lblocks[b].leafrank = rank;
+    lblocks[b].n        = sf->roffset[i + 1] - sf->roffset[i];
+    lblocks[b].id       = -1;
+    lblocks[b].start    = -1;
+    hsf->stats[2] += lblocks[b].n;
+    b++;
+  }
+  hsf->stats[0] = nlb;
+
+  /* The leader gives the leaves of its node connected to other nodes consecutive slots in its receive buffer, and counts the
+     nodes they get data from, which is the number of messages it receives with aggregation */
+  PetscCallMPI(MPI_Type_contiguous(PETSCSF_HIER_BLOCK_INTS, MPIU_INT, &blocktype));
+  PetscCallMPI(MPI_Type_commit(&blocktype));
+  PetscCall(PetscSFHierarchicalGather(nodecomm, nlb, blocktype, sizeof(PetscSFHierBlock), lblocks, &lcounts, &ldispls, &glblocks));
+  hsf->nsendslots = 0;
+  hsf->nrecvslots = 0;
+  if (!noderank) {
+    nglb = ldispls[nodesize];
+    PetscCall(PetscSFHierarchicalSortBlocks(nglb, glblocks, &hsf->nrecvslots, &nsrc, &srcnodes, &srcslots));
+    hsf->stats[1] = nsrc;
+  }
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, hsf->stats, 3, MPIU_INT, MPI_SUM, comm));
+
+  /* In auto mode, aggregate if it saves messages and the messages between nodes are small on average */
+  if (!hsf->stats[2] || hsf->mode == PETSCSF_HIERARCHICAL_FLAT) hsf->hierarchical = PETSC_FALSE;
+  else if (hsf->mode == PETSCSF_HIERARCHICAL_NODE) hsf->hierarchical = PETSC_TRUE;
+  else hsf->hierarchical = (hsf->stats[1] < hsf->stats[0] && hsf->stats[2] < hsf->msgsize * hsf->stats[0]) ? PETSC_TRUE : PETSC_FALSE;
+
+  if (hsf->hierarchical) {
+    PetscCall(PetscSFHierarchicalSetUpNodes(sf, nodecomm, leader, leaders, blocktype, nlb, lblocks, nglb, glblocks, lcounts, ldispls, nsrc, srcnodes, srcslots));
+    /* The edges within my node */
+    PetscCall(PetscMalloc1(nlocal, &ilocal));
+    PetscCall(PetscMalloc1(nlocal, &remote));
+    nlocal = 0;
+    for (PetscMPIInt i = 0; i < sf->nranks; i++) {
+      if (leaders[sf->ranks[i]] != leader) continue;
+      for (PetscInt k = sf->roffset[i]; k < sf->roffset[i + 1]; k++, nlocal++) {
+        ilocal[nlocal]       = sf->rmine[k];
+        remote[nlocal].rank  = sf->ranks[i];
+        remote[nlocal].index = sf->rremote[k];
+      }
+    }
+    PetscCall(PetscSFHierarchicalCreateSF(sf, PETSCSFSHMEM, sf->nroots, nlocal, ilocal, remote, &hsf->localsf));
+  }
+  PetscCall(PetscFree(leaders));
+  PetscCall(PetscFree(lblocks));
+  PetscCall(PetscFree(glblocks));
+  PetscCall(PetscFree2(lcounts, ldispls));
+  PetscCall(PetscFree2(srcnodes, srcslots));
+  PetscCallMPI(MPI_Type_free(&blocktype));
+  if (hsf->nodesize > 0) PetscCallMPI(MPI_Comm_free(&nodecomm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReset_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf = hsf->bufs, next;
+
+  PetscFunctionBegin;
+  for (; buf; buf = next) {
+    PetscCheck(!buf->inuse, PetscObjectComm((PetscObject)sf), PETSC_ERR_ARG_WRONGSTATE, "Outstanding operation has not been completed");
+    next = buf->next;
+    PetscCall(PetscFree(buf->sendbuf));
+    PetscCall(PetscFree(buf->recvbuf));
+    PetscCall(PetscFree(buf));
+  }
+  hsf->bufs = NULL;
+  PetscCall(PetscSFDestroy(&hsf->localsf));
+  PetscCall(PetscSFDestroy(&hsf->gathersf));
+  PetscCall(PetscSFDestroy(&hsf->leadersf));
+  PetscCall(PetscSFDestroy(&hsf->scattersf));
+  hsf->hierarchical = PETSC_FALSE;
+  PetscCall(PetscSFReset_Basic(sf)); /* Common part */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFDestroy_Hierarchical(PetscSF sf)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscSFReset_Hierarchical(sf));
+  PetscCall(PetscFree(sf->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Hierarchical(PetscSF sf, PetscOptionItems PetscOptionsObject)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFSetFromOptions_Basic(sf, PetscOptionsObject));
+  PetscOptionsHeadBegin(PetscOptionsObject, "PetscSF Hierarchical options");
+  PetscCall(PetscOptionsEnum("-sf_hierarchical_mode", "Send the data between nodes directly (flat), through the node leaders (node), or choose at setup (auto)", "PetscSFSetFromOptions", PetscSFHierarchicalModes, (PetscEnum)hsf->mode, (PetscEnum *)&hsf->mode, NULL));
+  PetscCall(PetscOptionsInt("-sf_hierarchical_msg_size", "In auto mode, aggregate if the messages between nodes have fewer entries than this on average", "PetscSFSetFromOptions", hsf->msgsize, &hsf->msgsize, NULL));
+  PetscCall(PetscOptionsMPIInt("-sf_hierarchical_node_size", "Take groups of this many consecutive ranks as nodes, for testing", "PetscSFSetFromOptions", hsf->nodesize, &hsf->nodesize, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFView_Hierarchical(PetscSF sf, PetscViewer viewer)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscBool             isascii;
+  PetscViewerFormat     format;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFView_Basic(sf, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCall(PetscViewerGetFormat(viewer, &format));
+  if (isascii && format != PETSC_VIEWER_ASCII_MATLAB && sf->setupcalled) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  Mode %s, edges between nodes %s\n", PetscSFHierarchicalModes[hsf->mode], hsf->hierarchical ? "aggregated through the node leaders" : "sent directly"));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  Messages between nodes %" PetscInt_FMT " direct, %" PetscInt_FMT " aggregated, for %" PetscInt_FMT " edges\n", hsf->stats[0], hsf->stats[1], hsf->stats[2]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Hierarchical(PetscSF sf, MPI_Datatype unit, PetscMemType rootmtype, const void *rootdata, PetscMemType leafmtype, void *leafdata, MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf;
+
+  PetscFunctionBegin;
+  if (!hsf->hierarchical || !PetscMemTypeHost(rootmtype) || !PetscMemTypeHost(leafmtype)) {
+    PetscCall(PetscSFBcastBegin_Basic(sf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFHierarchicalGetBuf(sf, unit, rootdata, leafdata, &buf));
+  PetscCall(PetscSFBcastWithMemTypeBegin(hsf->localsf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+  PetscCall(PetscSFBcastWithMemTypeBegin(hsf->gathersf, unit, rootmtype, rootdata, PETSC_MEMTYPE_HOST, buf->sendbuf, MPI_REPLACE));
+  PetscCall(PetscSFBcastEnd(hsf->gathersf, unit, rootdata, buf->sendbuf, MPI_REPLACE));
+  PetscCall(PetscSFBcastWithMemTypeBegin(hsf->leadersf, unit, PETSC_MEMTYPE_HOST, buf->sendbuf, PETSC_MEMTYPE_HOST, buf->recvbuf, MPI_REPLACE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Hierarchical(PetscSF sf, MPI_Datatype unit, const void *rootdata, void *leafdata, MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFHierarchicalFindBuf(sf, unit, rootdata, leafdata, &buf));
+  if (!buf) {
+    PetscCall(PetscSFBcastEnd_Basic(sf, unit, rootdata, leafdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFBcastEnd(hsf->leadersf, unit, buf->sendbuf, buf->recvbuf, MPI_REPLACE));
+  PetscCall(PetscSFBcastEnd(hsf->localsf, unit, rootdata, leafdata, op));
+  PetscCall(PetscSFBcastWithMemTypeBegin(hsf->scattersf, unit, PETSC_MEMTYPE_HOST, buf->recvbuf, PETSC_MEMTYPE_HOST, leafdata, op));
+  PetscCall(PetscSFBcastEnd(hsf->scattersf, unit, buf->recvbuf, leafdata, op));
+  buf->inuse = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Hierarchical(PetscSF sf, MPI_Datatype unit, PetscMemType leafmtype, const void *leafdata, PetscMemType rootmtype, void *rootdata, MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf;
+
+  PetscFunctionBegin;
+  if (!hsf->hierarchical || !PetscMemTypeHost(rootmtype) || !PetscMemTypeHost(leafmtype)) {
+    PetscCall(PetscSFReduceBegin_Basic(sf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFHierarchicalGetBuf(sf, unit, rootdata, leafdata, &buf));
+  PetscCall(PetscSFReduceWithMemTypeBegin(hsf->localsf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+  PetscCall(PetscSFReduceWithMemTypeBegin(hsf->scattersf, unit, leafmtype, leafdata, PETSC_MEMTYPE_HOST, buf->recvbuf, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(hsf->scattersf, unit, leafdata, buf->recvbuf, MPI_REPLACE));
+  PetscCall(PetscSFReduceWithMemTypeBegin(hsf->leadersf, unit, PETSC_MEMTYPE_HOST, buf->recvbuf, PETSC_MEMTYPE_HOST, buf->sendbuf, MPI_REPLACE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Hierarchical(PetscSF sf, MPI_Datatype unit, const void *leafdata, void *rootdata, MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical *)sf->data;
+  PetscSFHierBuf        buf;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFHierarchicalFindBuf(sf, unit, rootdata, leafdata, &buf));
+  if (!buf) {
+    PetscCall(PetscSFReduceEnd_Basic(sf, unit, leafdata, rootdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFReduceEnd(hsf->leadersf, unit, buf->recvbuf, buf->sendbuf, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(hsf->localsf, unit, leafdata, rootdata, op));
+  PetscCall(PetscSFReduceWithMemTypeBegin(hsf->gathersf, unit, PETSC_MEMTYPE_HOST, buf->sendbuf, PETSC_MEMTYPE_HOST, rootdata, op));
+  PetscCall(PetscSFReduceEnd(hsf->gathersf, unit, buf->sendbuf, rootdata, op));
+  buf->inuse = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PETSCSFHIERARCHICAL - A `PetscSFType` that sends the data of all the edges between two nodes in a single message between
+   the leader ranks of the nodes, and moves the data within a node through shared memory as `PETSCSFSHMEM` does
+
+   Options Database Keys:
++  -sf_type hierarchical                       - use this type
+.  -sf_hierarchical_mode <auto,flat,node>      - send the data between nodes directly (flat), through the node leaders (node), or
+                                                 choose at setup (auto, the default)
+.  -sf_hierarchical_msg_size <n>               - in auto mode, aggregate if the messages between nodes have on average fewer
+                                                 entries than this (default 1024)
+-  -sf_hierarchical_node_size <n>              - take groups of n consecutive ranks as nodes instead of the shared-memory nodes
+
+   Level: intermediate
+
+   Notes:
+   The leader, the first rank, of a node gathers through shared memory the root data its node sends to other nodes, sends to the
+   leader of each other node a single message with the data of all the edges between the two nodes, and scatters the data it
+   receives to the leaves of its node through shared memory. `PetscSFReduceBegin()` follows the reverse path. This replaces
+   the many small messages between the ranks of two nodes by one message, at the cost of two copies through shared memory
+   and of the serialization of the messages between nodes on the leaders, so it pays off when the messages are small and
+   latency bound.
+
+   In auto mode the type counts at setup the messages between nodes without and with aggregation and their average number of
+   entries, and aggregates only if this saves messages and the messages are small. Otherwise, and for `PetscSFFetchAndOpBegin()`
+   and data in device memory, all the edges go through `PETSCSFBASIC`. The operations are collective on the ranks of a node.
+   The `-sf_basic_` options, such as `-sf_basic_compress_size`, apply to the messages between nodes.
+
+.seealso: `PetscSF`, `PetscSFType`, `PetscSFSetType()`, `PETSCSFBASIC`, `PETSCSFSHMEM`, `PetscShmCommGet()`
+M*/
+PETSC_INTERN PetscErrorCode PetscSFCreate_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *dat;
+
+  PetscFunctionBegin;
+  sf->ops->CreateEmbeddedRootSF = PetscSFCreateEmbeddedRootSF_Basic;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Basic;
+  sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
+  sf->ops->SetCommunicationOps  = PetscSFSetCommunicationOps_Basic;
+
+  sf->ops->SetUp          = PetscSFSetUp_Hierarchical;
+  sf->ops->Reset          = PetscSFReset_Hierarchical;
+  sf->ops->Destroy        = PetscSFDestroy_Hierarchical;
+  sf->ops->SetFromOptions = PetscSFSetFromOptions_Hierarchical;
+  sf->ops->View           = PetscSFView_Hierarchical;
+  sf->ops->BcastBegin     = PetscSFBcastBegin_Hierarchical;
+  sf->ops->BcastEnd       = PetscSFBcastEnd_Hierarchical;
+  sf->ops->ReduceBegin    = PetscSFReduceBegin_Hierarchical;
+  sf->ops->ReduceEnd      = PetscSFReduceEnd_Hierarchical;
+
+  sf->persistent = PETSC_TRUE; // the PETSCSFBASIC routines use persistent send/recv
+  sf->collective = PETSC_TRUE;
+
+  PetscCall(PetscNew(&dat));
+  dat->mode    = PETSCSF_HIERARCHICAL_AUTO;
+  dat->msgsize = 1024;
+  sf->data     = (void *)dat;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -2,6 +2,40 @@
 #include <../src/vec/is/sf/impls/basic/sfpack.h>
 #include <petsc/private/viewerimpl.h>
 
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+// Does the link use MPI-4 partitioned send/recv? It must give the same answer on all processes, so only host buffers are supported
+static inline PetscBool PetscSFLinkUsePartitioned_Basic(PetscSF sf, PetscSFLink link)
+{
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data;
+
+  return (bas->partitionsize > 0 && PetscMemTypeHost(link->rootmtype_mpi) && PetscMemTypeHost(link->leafmtype_mpi)) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+// Number of partitions of a message of cnt units. It only depends on cnt and the partition size so that the sender and the receiver agree on it
+static inline PetscMPIInt PetscSFGetNumPartitions_Basic(PetscSF sf, PetscInt cnt)
+{
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data;
+  PetscInt       n   = PetscMax(cnt / bas->partitionsize, 1);
+
+  while (cnt % n) n--; // partitions must have the same number of units
+  return (PetscMPIInt)n;
+}
+
+static inline PetscErrorCode MPIU_Psend_init(void *buf, PetscMPIInt nparts, PetscInt cnt, MPI_Datatype unit, PetscMPIInt dest, PetscMPIInt tag, MPI_Comm comm, MPI_Request *req)
+{
+  PetscFunctionBegin;
+  PetscCallMPI(MPI_Psend_init(buf, nparts, (MPI_Count)(cnt / nparts), unit, dest, tag, comm, MPI_INFO_NULL, req));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static inline PetscErrorCode MPIU_Precv_init(void *buf, PetscMPIInt nparts, PetscInt cnt, MPI_Datatype unit, PetscMPIInt source, PetscMPIInt tag, MPI_Comm comm, MPI_Request *req)
+{
+  PetscFunctionBegin;
+  PetscCallMPI(MPI_Precv_init(buf, nparts, (MPI_Count)(cnt / nparts), unit, source, tag, comm, MPI_INFO_NULL, req));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+#endif
+
 // Init persistent MPI send/recv requests
 static PetscErrorCode PetscSFLinkInitMPIRequests_Persistent_Basic(PetscSF sf, PetscSFLink link, PetscSFDirection direction)
 {
@@ -18,7 +52,17 @@ static PetscErrorCode PetscSFLinkInitMPIRequests_Persistent_Basic(PetscSF sf, Pe
   PetscFunctionBegin;
   if (bas->rootbuflen[PETSCSF_REMOTE] && !link->rootreqsinited[direction][rootmtype_mpi][rootdirect_mpi]) {
     PetscCall(PetscSFGetRootInfo_Basic(sf, &nrootranks, &ndrootranks, NULL, &rootoffset, NULL));
-    if (direction == PETSCSF_LEAF2ROOT) {
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+    if (PetscSFLinkUsePartitioned_Basic(sf, link)) {
+      for (PetscMPIInt i = ndrootranks, j = 0; i < nrootranks; i++, j++) {
+        disp = (rootoffset[i] - rootoffset[ndrootranks]) * link->unitbytes;
+        cnt  = rootoffset[i + 1] - rootoffset[i];
+        if (direction == PETSCSF_LEAF2ROOT) PetscCall(MPIU_Precv_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi] + disp, PetscSFGetNumPartitions_Basic(sf, cnt), cnt, unit, bas->iranks[i], link->tag, comm, link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi] + j));
+        else PetscCall(MPIU_Psend_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi] + disp, PetscSFGetNumPartitions_Basic(sf, cnt), cnt, unit, bas->iranks[i], link->tag, comm, link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi] + j));
+      }
+    } else
+#endif
+      if (direction == PETSCSF_LEAF2ROOT) {
       for (PetscMPIInt i = ndrootranks, j = 0; i < nrootranks; i++, j++) {
         disp = (rootoffset[i] - rootoffset[ndrootranks]) * link->unitbytes;
         cnt  = rootoffset[i + 1] - rootoffset[i];
@@ -36,7 +80,17 @@ static PetscErrorCode PetscSFLinkInitMPIRequests_Persistent_Basic(PetscSF sf, Pe
 
   if (sf->leafbuflen[PETSCSF_REMOTE] && !link->leafreqsinited[direction][leafmtype_mpi][leafdirect_mpi]) {
     PetscCall(PetscSFGetLeafInfo_Basic(sf, &nleafranks, &ndleafranks, NULL, &leafoffset, NULL, NULL));
-    if (direction == PETSCSF_LEAF2ROOT) {
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+    if (PetscSFLinkUsePartitioned_Basic(sf, link)) {
+      for (PetscMPIInt i = ndleafranks, j = 0; i < nleafranks; i++, j++) {
+        disp = (leafoffset[i] - leafoffset[ndleafranks]) * link->unitbytes;
+        cnt  = leafoffset[i + 1] - leafoffset[i];
+        if (direction == PETSCSF_LEAF2ROOT) PetscCall(MPIU_Psend_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi] + disp, PetscSFGetNumPartitions_Basic(sf, cnt), cnt, unit, sf->ranks[i], link->tag, comm, link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi] + j));
+        else PetscCall(MPIU_Precv_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi] + disp, PetscSFGetNumPartitions_Basic(sf, cnt), cnt, unit, sf->ranks[i], link->tag, comm, link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi] + j));
+      }
+    } else
+#endif
+      if (direction == PETSCSF_LEAF2ROOT) {
       for (PetscMPIInt i = ndleafranks, j = 0; i < nleafranks; i++, j++) {
         disp = (leafoffset[i] - leafoffset[ndleafranks]) * link->unitbytes;
         cnt  = leafoffset[i + 1] - leafoffset[i];
@@ -89,6 +143,245 @@ static PetscErrorCode PetscSFLinkStartCommunication_Persistent_Basic(PetscSF sf,
   PetscCall(PetscSFLinkSyncStreamBeforeCallMPI(sf, link)); // need to sync the stream to make BOTH sendbuf and recvbuf ready
   if (rbuflen) PetscCallMPI(MPI_Startall_irecv(rbuflen, link->unit, nrreqs, rreqs));
   if (sbuflen) PetscCallMPI(MPI_Startall_isend(sbuflen, link->unit, nsreqs, sreqs));
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+  if (sbuflen && PetscSFLinkUsePartitioned_Basic(sf, link)) { // the send buffers are ready as a whole
+    PetscMPIInt     nranks, ndranks;
+    const PetscInt *offset;
+
+    if (direction == PETSCSF_ROOT2LEAF) PetscCall(PetscSFGetRootInfo_Basic(sf, &nranks, &ndranks, NULL, &offset, NULL));
+    else PetscCall(PetscSFGetLeafInfo_Basic(sf, &nranks, &ndranks, NULL, &offset, NULL, NULL));
+    for (PetscMPIInt i = ndranks, j = 0; i < nranks; i++, j++) PetscCallMPI(MPI_Pready_range(0, PetscSFGetNumPartitions_Basic(sf, offset[i + 1] - offset[i]) - 1, sreqs[j]));
+  }
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Pack the remote root (leaf) data and start the communication in direction ROOT2LEAF (LEAF2ROOT)
+
+   With -sf_basic_fused_pack, receives are started first, then the data of each remote rank is packed and its
+   (persistent) send is started right away, instead of packing the whole send buffer before starting any send.
+   With partitioned communication, each partition is released with MPI_Pready() as soon as it is packed.
+   Fusing is only done when the data is on host and needs packing; otherwise we fall back to pack-then-start.
+*/
+static PetscErrorCode PetscSFLinkPackAndStartCommunication_Basic(PetscSF sf, PetscSFLink link, PetscSFDirection direction, const void *data)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic *)sf->data;
+  PetscMPIInt     nranks, ndranks, nrreqs;
+  const PetscInt *offset, *loc;
+  PetscInt        start, sbuflen, rbuflen;
+  PetscBool       contig, direct;
+  char           *buf;
+  MPI_Request    *sreqs = NULL, *rreqs = NULL;
+  PetscBool       partitioned = PETSC_FALSE;
+  PetscErrorCode (*Pack)(PetscSFLink, PetscInt, PetscInt, PetscSFPackOpt, const PetscInt *, const void *, void *) = NULL;
+
+  PetscFunctionBegin;
+  direct = (direction == PETSCSF_ROOT2LEAF) ? link->rootdirect[PETSCSF_REMOTE] : link->leafdirect[PETSCSF_REMOTE];
+  if (!bas->fusedpack || direct || link->StartCommunication != PetscSFLinkStartCommunication_Persistent_Basic || PetscMemTypeDevice(link->rootmtype) || PetscMemTypeDevice(link->leafmtype) || PetscMemTypeDevice(link->rootmtype_mpi) || PetscMemTypeDevice(link->leafmtype_mpi)) {
+    if (direction == PETSCSF_ROOT2LEAF) PetscCall(PetscSFLinkPackRootData(sf, link, PETSCSF_REMOTE, data));
+    else PetscCall(PetscSFLinkPackLeafData(sf, link, PETSCSF_REMOTE, data));
+    PetscCall(PetscSFLinkStartCommunication(sf, link, direction));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  if (direction == PETSCSF_ROOT2LEAF) {
+    PetscCall(PetscSFGetRootInfo_Basic(sf, &nranks, &ndranks, NULL, &offset, &loc));
+    sbuflen = bas->rootbuflen[PETSCSF_REMOTE];
+    rbuflen = sf->leafbuflen[PETSCSF_REMOTE];
+    nrreqs  = sf->nleafreqs;
+    contig  = bas->rootcontig[PETSCSF_REMOTE];
+    start   = bas->rootstart[PETSCSF_REMOTE];
+    buf     = link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST];
+    PetscCall(PetscSFLinkGetMPIBuffersAndRequests(sf, link, direction, NULL, NULL, &sreqs, &rreqs));
+  } else {
+    PetscCall(PetscSFGetLeafInfo_Basic(sf, &nranks, &ndranks, NULL, &offset, &loc, NULL));
+    sbuflen = sf->leafbuflen[PETSCSF_REMOTE];
+    rbuflen = bas->rootbuflen[PETSCSF_REMOTE];
+    nrreqs  = bas->nrootreqs;
+    contig  = sf->leafcontig[PETSCSF_REMOTE];
+    start   = sf->leafstart[PETSCSF_REMOTE];
+    buf     = link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST];
+    PetscCall(PetscSFLinkGetMPIBuffersAndRequests(sf, link, direction, NULL, NULL, &rreqs, &sreqs));
+  }
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+  partitioned = PetscSFLinkUsePartitioned_Basic(sf, link);
+#endif
+  if (rbuflen) PetscCallMPI(MPI_Startall_irecv(rbuflen, link->unit, nrreqs, rreqs));
+  if (sbuflen) {
+    PetscCall(PetscSFLinkGetPack(link, PETSC_MEMTYPE_HOST, &Pack));
+    PetscCall(PetscLogEventBegin(PETSCSF_Pack, sf, 0, 0, 0));
+    for (PetscMPIInt i = ndranks, j = 0; i < nranks; i++, j++) {
+      const PetscInt first = offset[i] - offset[ndranks], cnt = offset[i + 1] - offset[i]; // position and length of the message in the send buffer
+      PetscMPIInt    nparts = 1;
+
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+      if (partitioned) {
+        nparts = PetscSFGetNumPartitions_Basic(sf, cnt);
+        PetscCallMPI(MPI_Start_isend(cnt, link->unit, &sreqs[j]));
+      }
+#endif
+      for (PetscMPIInt p = 0; p < nparts; p++) {
+        const PetscInt k = first + p * (cnt / nparts);
+
+        // pack plans (PetscSFPackOpt) cover all ranks at once, so pack the message with its indices
+        PetscCall((*Pack)(link, cnt / nparts, start + k, NULL, contig ? NULL : loc + offset[ndranks] + k, data, buf + k * link->unitbytes));
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+        if (partitioned) PetscCallMPI(MPI_Pready(p, sreqs[j]));
+#endif
+      }
+      if (!partitioned) PetscCallMPI(MPI_Start_isend(cnt, link->unit, &sreqs[j]));
+    }
+    PetscCall(PetscLogEventEnd(PETSCSF_Pack, sf, 0, 0, 0));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+// Does the link compress its messages? The sender and the receiver of a message must give the same answer, so it only depends on
+// the options of the SF and on the unit, which are the same on all processes, and not on where the data of this process lives
+static inline PetscBool PetscSFLinkUseCompression_Basic(PetscSF sf, PetscSFLink link)
+{
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data;
+
+  return (bas->compresssize > 0 && link->unitbytes % 8 == 0) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+// Get the ranks, offsets and MPI buffers of the messages sent and received in a direction
+static inline PetscErrorCode PetscSFLinkGetMessages_Basic(PetscSF sf, PetscSFLink link, PetscSFDirection direction, PetscMPIInt *nsranks, PetscMPIInt *ndsranks, const PetscMPIInt **sranks, const PetscInt **soffset, char **sbuf, PetscMPIInt *nrranks, PetscMPIInt *ndrranks, const PetscMPIInt **rranks, const PetscInt **roffset, char **rbuf)
+{
+  PetscFunctionBegin;
+  if (direction == PETSCSF_ROOT2LEAF) {
+    PetscCall(PetscSFGetRootInfo_Basic(sf, nsranks, ndsranks, sranks, soffset, NULL));
+    PetscCall(PetscSFGetLeafInfo_Basic(sf, nrranks, ndrranks, rranks, roffset, NULL, NULL));
+    *sbuf = link->rootbuf[PETSCSF_REMOTE][link->rootmtype_mpi];
+    *rbuf = link->leafbuf[PETSCSF_REMOTE][link->leafmtype_mpi];
+  } else {
+    PetscCall(PetscSFGetLeafInfo_Basic(sf, nsranks, ndsranks, sranks, soffset, NULL, NULL));
+    PetscCall(PetscSFGetRootInfo_Basic(sf, nrranks, ndrranks, rranks, roffset, NULL));
+    *sbuf = link->leafbuf[PETSCSF_REMOTE][link->leafmtype_mpi];
+    *rbuf = link->rootbuf[PETSCSF_REMOTE][link->rootmtype_mpi];
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Start non-persistent MPI send/recv, with the messages of at least -sf_basic_compress_size bytes compressed
+
+   The packed messages are compressed with PetscSFLinkCompress() right before being sent, and the received ones are
+   decompressed into the MPI buffers by PetscSFLinkFinishCommunication_Compressed_Basic(), so pack and unpack are unchanged.
+   The compressed messages received are laid out first in link->zbuf[], followed by the compressed messages sent.
+*/
+static PetscErrorCode PetscSFLinkStartCommunication_Compressed_Basic(PetscSF sf, PetscSFLink link, PetscSFDirection direction)
+{
+  PetscSF_Basic     *bas  = (PetscSF_Basic *)sf->data;
+  MPI_Comm           comm = PetscObjectComm((PetscObject)sf);
+  const size_t       zmin = (size_t)bas->compresssize;
+  PetscMPIInt        nsranks, ndsranks, nrranks, ndrranks;
+  const PetscMPIInt *sranks, *rranks;
+  const PetscInt    *soffset, *roffset;
+  char              *sbuf, *rbuf, *z;
+  size_t             zsize = 0, maxbytes = 0, zbytes;
+  MPI_Request       *sreqs, *rreqs;
+
+  PetscFunctionBegin;
+  link->zactive = PetscSFLinkUseCompression_Basic(sf, link);
+  if (!link->zactive) {
+    PetscCall(PetscSFLinkStartCommunication_Persistent_Basic(sf, link, direction));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCheck(PetscMemTypeHost(link->rootmtype_mpi) && PetscMemTypeHost(link->leafmtype_mpi), PETSC_COMM_SELF, PETSC_ERR_SUP, "-sf_basic_compress_size requires the MPI buffers on the host, it can not be used with GPU-aware MPI and data in device memory");
+  if (direction == PETSCSF_ROOT2LEAF) PetscCall(PetscSFLinkCopyRootBufferInCaseNotUseGpuAwareMPI(sf, link, PETSC_TRUE /* device2host before sending */));
+  else PetscCall(PetscSFLinkCopyLeafBufferInCaseNotUseGpuAwareMPI(sf, link, PETSC_TRUE));
+  PetscCall(PetscSFLinkGetMessages_Basic(sf, link, direction, &nsranks, &ndsranks, &sranks, &soffset, &sbuf, &nrranks, &ndrranks, &rranks, &roffset, &rbuf));
+
+  for (PetscMPIInt i = ndsranks; i < nsranks; i++) {
+    const size_t bytes = (soffset[i + 1] - soffset[i]) * link->unitbytes;
+
+    if (bytes >= zmin) {
+      zsize += bytes + PETSCSF_COMPRESS_HEADER;
+      maxbytes = PetscMax(maxbytes, bytes);
+    }
+  }
+  for (PetscMPIInt i = ndrranks; i < nrranks; i++) {
+    const size_t bytes = (roffset[i + 1] - roffset[i]) * link->unitbytes;
+
+    if (bytes >= zmin) {
+      zsize += bytes + PETSCSF_COMPRESS_HEADER;
+      maxbytes = PetscMax(maxbytes, bytes);
+    }
+  }
+  if (zsize > link->zbufsize) {
+    PetscCall(PetscFree(link->zbuf));
+    PetscCall(PetscMalloc(zsize, &link->zbuf));
+    link->zbufsize = zsize;
+  }
+  if (maxbytes > link->zscratchsize) {
+    PetscCall(PetscFree(link->zscratch));
+    PetscCall(PetscMalloc(maxbytes, &link->zscratch));
+    link->zscratchsize = maxbytes;
+  }
+  if (!link->zreqs) PetscCall(PetscMalloc1(bas->nrootreqs + sf->nleafreqs, &link->zreqs));
+  rreqs = link->zreqs;
+  sreqs = link->zreqs + (nrranks - ndrranks);
+
+  PetscCall(PetscSFLinkSyncStreamBeforeCallMPI(sf, link));
+  z = link->zbuf;
+  for (PetscMPIInt i = ndrranks, j = 0; i < nrranks; i++, j++) {
+    const PetscInt cnt   = roffset[i + 1] - roffset[i];
+    const size_t   bytes = cnt * link->unitbytes;
+
+    if (bytes >= zmin) {
+      PetscCallMPI(MPIU_Irecv(z, bytes + PETSCSF_COMPRESS_HEADER, MPI_BYTE, rranks[i], link->tag, comm, rreqs + j));
+      z += bytes + PETSCSF_COMPRESS_HEADER;
+    } else PetscCallMPI(MPIU_Irecv(rbuf + (roffset[i] - roffset[ndrranks]) * link->unitbytes, cnt, link->unit, rranks[i], link->tag, comm, rreqs + j));
+  }
+  PetscCall(PetscLogEventBegin(PETSCSF_Pack, sf, 0, 0, 0));
+  for (PetscMPIInt i = ndsranks, j = 0; i < nsranks; i++, j++) {
+    const PetscInt cnt   = soffset[i + 1] - soffset[i];
+    const size_t   bytes = cnt * link->unitbytes;
+    const char    *buf   = sbuf + (soffset[i] - soffset[ndsranks]) * link->unitbytes;
+
+    if (bytes >= zmin) {
+      PetscCall(PetscSFLinkCompress(link, cnt, buf, z, &zbytes));
+      PetscCallMPI(MPIU_Isend(z, zbytes, MPI_BYTE, sranks[i], link->tag, comm, sreqs + j));
+      bas->rawbytes += bytes;
+      bas->compressedbytes += zbytes;
+      z += bytes + PETSCSF_COMPRESS_HEADER;
+    } else PetscCallMPI(MPIU_Isend(buf, cnt, link->unit, sranks[i], link->tag, comm, sreqs + j));
+  }
+  PetscCall(PetscLogEventEnd(PETSCSF_Pack, sf, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+// Wait for the messages and decompress the compressed ones. If use non-GPU aware MPI, we might need to copy data from host buf to device buf
+static PetscErrorCode PetscSFLinkFinishCommunication_Compressed_Basic(PetscSF sf, PetscSFLink link, PetscSFDirection direction)
+{
+  PetscSF_Basic     *bas  = (PetscSF_Basic *)sf->data;
+  const size_t       zmin = (size_t)bas->compresssize;
+  PetscMPIInt        nsranks, ndsranks, nrranks, ndrranks;
+  const PetscMPIInt *sranks, *rranks;
+  const PetscInt    *soffset, *roffset;
+  char              *sbuf, *rbuf, *z = link->zbuf;
+
+  PetscFunctionBegin;
+  if (!link->zactive) {
+    PetscCall(PetscSFLinkFinishCommunication_Default(sf, link, direction));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscSFLinkGetMessages_Basic(sf, link, direction, &nsranks, &ndsranks, &sranks, &soffset, &sbuf, &nrranks, &ndrranks, &rranks, &roffset, &rbuf));
+  PetscCallMPI(MPI_Waitall((nsranks - ndsranks) + (nrranks - ndrranks), link->zreqs, MPI_STATUSES_IGNORE));
+  PetscCall(PetscLogEventBegin(PETSCSF_Unpack, sf, 0, 0, 0));
+  for (PetscMPIInt i = ndrranks; i < nrranks; i++) {
+    const PetscInt cnt   = roffset[i + 1] - roffset[i];
+    const size_t   bytes = cnt * link->unitbytes;
+
+    if (bytes >= zmin) {
+      PetscCall(PetscSFLinkDecompress(link, cnt, z, rbuf + (roffset[i] - roffset[ndrranks]) * link->unitbytes));
+      z += bytes + PETSCSF_COMPRESS_HEADER;
+    }
+  }
+  PetscCall(PetscLogEventEnd(PETSCSF_Unpack, sf, 0, 0, 0));
+  link->zactive = PETSC_FALSE;
+  if (direction == PETSCSF_ROOT2LEAF) PetscCall(PetscSFLinkCopyLeafBufferInCaseNotUseGpuAwareMPI(sf, link, PETSC_FALSE /* host2device after recving */));
+  else PetscCall(PetscSFLinkCopyRootBufferInCaseNotUseGpuAwareMPI(sf, link, PETSC_FALSE));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -158,11 +451,15 @@ static PetscErrorCode PetscSFLinkFinishCommunication_MPIX_Stream(PetscSF sf, Pet
 }
 #endif
 
-static PetscErrorCode PetscSFSetCommunicationOps_Basic(PetscSF sf, PetscSFLink link)
+PETSC_INTERN PetscErrorCode PetscSFSetCommunicationOps_Basic(PetscSF sf, PetscSFLink link)
 {
   PetscFunctionBegin;
   link->InitMPIRequests    = PetscSFLinkInitMPIRequests_Persistent_Basic;
   link->StartCommunication = PetscSFLinkStartCommunication_Persistent_Basic;
+  if (((PetscSF_Basic *)sf->data)->compresssize > 0) { // falls back to the persistent requests for the data it does not compress
+    link->StartCommunication  = PetscSFLinkStartCommunication_Compressed_Basic;
+    link->FinishCommunication = PetscSFLinkFinishCommunication_Compressed_Basic;
+  }
 #if defined(PETSC_HAVE_MPIX_STREAM)
   const PetscMemType rootmtype_mpi = link->rootmtype_mpi, leafmtype_mpi = link->leafmtype_mpi;
   if (sf->use_stream_aware_mpi && (PetscMemTypeDevice(rootmtype_mpi) || PetscMemTypeDevice(leafmtype_mpi))) {
@@ -262,6 +559,9 @@ PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 
   PetscFunctionBegin;
   PetscCheck(!bas->inuse, PetscObjectComm((PetscObject)sf), PETSC_ERR_ARG_WRONGSTATE, "Outstanding operation has not been completed");
+  if (bas->rawbytes > 0) PetscCall(PetscInfo(sf, "Compressed %g bytes of messages into %g bytes, compression ratio %g\n", bas->rawbytes, bas->compressedbytes, bas->rawbytes / bas->compressedbytes));
+  bas->rawbytes        = 0;
+  bas->compressedbytes = 0;
   PetscCall(PetscFree2(bas->iranks, bas->ioffset));
   PetscCall(PetscFree(bas->irootloc));
 
@@ -331,13 +631,53 @@ PETSC_INTERN PetscErrorCode PetscSFView_Basic_PatternAndSizes(PetscSF sf, PetscV
 }
 #endif
 
+/* Also used by the types built on PETSCSFBASIC, which pass the options to their inner SFs with PetscSFBasicCopyOptions_Private() */
+PETSC_INTERN PetscErrorCode PetscSFSetFromOptions_Basic(PetscSF sf, PetscOptionItems PetscOptionsObject)
+{
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "PetscSF Basic options");
+  PetscCall(PetscOptionsBool("-sf_basic_fused_pack", "Pack the data of each remote rank and start its send right away", "PetscSFSetFromOptions", bas->fusedpack, &bas->fusedpack, NULL));
+#if defined(PETSC_HAVE_MPI_PARTITIONED)
+  PetscCall(PetscOptionsInt("-sf_basic_partition_size", "Use MPI partitioned communication with partitions of about this many units, 0 to disable", "PetscSFSetFromOptions", bas->partitionsize, &bas->partitionsize, NULL));
+#endif
+  PetscCall(PetscOptionsInt("-sf_basic_compress_size", "Compress the messages of at least this many bytes whose units are made of 8-byte words, 0 to disable", "PetscSFSetFromOptions", bas->compresssize, &bas->compresssize, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Give the -sf_basic_ options of sf to newsf, an SF of a type built on PETSCSFBASIC created by sf */
+PETSC_INTERN PetscErrorCode PetscSFBasicCopyOptions_Private(PetscSF sf, PetscSF newsf)
+{
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data, *nbas = (PetscSF_Basic *)newsf->data;
+
+  PetscFunctionBegin;
+  nbas->fusedpack     = bas->fusedpack;
+  nbas->partitionsize = bas->partitionsize;
+  nbas->compresssize  = bas->compresssize;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf, PetscViewer viewer)
 {
-  PetscBool isascii;
+  PetscSF_Basic *bas = (PetscSF_Basic *)sf->data;
+  PetscBool      isascii;
 
   PetscFunctionBegin;
   PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
-  if (isascii && viewer->format != PETSC_VIEWER_ASCII_MATLAB) PetscCall(PetscViewerASCIIPrintf(viewer, "  MultiSF sort=%s\n", sf->rankorder ? "rank-order" : "unordered"));
+  if (isascii && viewer->format != PETSC_VIEWER_ASCII_MATLAB) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  MultiSF sort=%s\n", sf->rankorder ? "rank-order" : "unordered"));
+    if (bas->fusedpack) PetscCall(PetscViewerASCIIPrintf(viewer, "  Remote data is packed and sent rank by rank\n"));
+    if (bas->partitionsize > 0) PetscCall(PetscViewerASCIIPrintf(viewer, "  Partitioned communication with partitions of about %" PetscInt_FMT " units\n", bas->partitionsize));
+    if (bas->compresssize > 0) {
+      PetscLogDouble bytes[2] = {bas->rawbytes, bas->compressedbytes};
+
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  Messages of at least %" PetscInt_FMT " bytes are compressed\n", bas->compresssize));
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, bytes, 2, MPIU_PETSCLOGDOUBLE, MPI_SUM, PetscObjectComm((PetscObject)sf)));
+      if (bytes[0] > 0) PetscCall(PetscViewerASCIIPrintf(viewer, "  Compression ratio %g of the messages sent so far\n", bytes[0] / bytes[1]));
+    }
+  }
 #if defined(PETSC_USE_SINGLE_LIBRARY)
   else {
     PetscBool isdraw, isbinary;
@@ -356,10 +696,8 @@ PETSC_INTERN PetscErrorCode PetscSFBcastBegin_Basic(PetscSF sf, MPI_Datatype uni
   PetscFunctionBegin;
   /* Create a communication link, which provides buffers, MPI requests etc (if MPI is used) */
   PetscCall(PetscSFLinkCreate(sf, unit, rootmtype, rootdata, leafmtype, leafdata, op, PETSCSF_BCAST, &link));
-  /* Pack rootdata to rootbuf for remote communication */
-  PetscCall(PetscSFLinkPackRootData(sf, link, PETSCSF_REMOTE, rootdata));
-  /* Start communication, e.g., post MPIU_Isend */
-  PetscCall(PetscSFLinkStartCommunication(sf, link, PETSCSF_ROOT2LEAF));
+  /* Pack rootdata to rootbuf for remote communication and start communication, e.g., post MPIU_Isend */
+  PetscCall(PetscSFLinkPackAndStartCommunication_Basic(sf, link, PETSCSF_ROOT2LEAF, rootdata));
   /* Do local scatter (i.e., self to self communication), which overlaps with the remote communication above */
   PetscCall(PetscSFLinkScatterLocal(sf, link, PETSCSF_ROOT2LEAF, (void *)rootdata, leafdata, op));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -388,8 +726,7 @@ static inline PetscErrorCode PetscSFLeafToRootBegin_Basic(PetscSF sf, MPI_Dataty
 
   PetscFunctionBegin;
   PetscCall(PetscSFLinkCreate(sf, unit, rootmtype, rootdata, leafmtype, leafdata, op, sfop, &link));
-  PetscCall(PetscSFLinkPackLeafData(sf, link, PETSCSF_REMOTE, leafdata));
-  PetscCall(PetscSFLinkStartCommunication(sf, link, PETSCSF_LEAF2ROOT));
+  PetscCall(PetscSFLinkPackAndStartCommunication_Basic(sf, link, PETSCSF_LEAF2ROOT, leafdata));
   *out = link;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -622,6 +959,7 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
   sf->ops->CreateEmbeddedRootSF = PetscSFCreateEmbeddedRootSF_Basic;
   sf->ops->SetCommunicationOps  = PetscSFSetCommunicationOps_Basic;
+  sf->ops->SetFromOptions       = PetscSFSetFromOptions_Basic;
 
   sf->persistent = PETSC_TRUE; // currently SFBASIC always uses persistent send/recv
   sf->collective = PETSC_FALSE;
@@ -18,7 +18,12 @@
   PetscBool      rootdups[2];      /* Indices of roots in irootloc[local/remote] have dups. Used for data-race test */ \
   PetscMPIInt    nrootreqs;        /* Number of MPI requests */ \
   PetscSFLink    avail;            /* One or more entries per MPI Datatype, lazily constructed */ \
-  PetscSFLink    inuse             /* Buffers being used for transactions that have not yet completed */
+  PetscSFLink    inuse;            /* Buffers being used for transactions that have not yet completed */ \
+  PetscBool      fusedpack;        /* Pack remote data rank by rank and start the send of each rank as soon as its data is packed */ \
+  PetscInt       partitionsize;    /* If positive, use MPI-4 partitioned send/recv with partitions of about this many units */ \
+  PetscInt       compresssize;     /* If positive, compress the messages of at least this many bytes made of 8-byte words */ \
+  PetscLogDouble rawbytes;         /* Bytes of the messages that went through the compression ... */ \
+  PetscLogDouble compressedbytes   /* ... and bytes actually sent for them */
 
 typedef struct {
   SFBASICHEADER;
@@ -63,6 +68,8 @@ static inline PetscErrorCode PetscSFGetLeafInfo_Basic(PetscSF sf, PetscMPIInt *n
 }
 
 PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFSetFromOptions_Basic(PetscSF, PetscOptionItems);
+PETSC_INTERN PetscErrorCode PetscSFBasicCopyOptions_Private(PetscSF, PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF, PetscViewer);
 PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFDestroy_Basic(PetscSF);
@@ -74,6 +81,7 @@ PETSC_INTERN PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF, MPI_Datatype,
 PETSC_INTERN PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF, MPI_Datatype, void *, const void *, void *, MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedRootSF_Basic(PetscSF, PetscInt, const PetscInt *, PetscSF *);
 PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF, PetscMPIInt *, const PetscMPIInt **, const PetscInt **, const PetscInt **);
+PETSC_INTERN PetscErrorCode PetscSFSetCommunicationOps_Basic(PetscSF, PetscSFLink);
 
 #if defined(PETSC_HAVE_NVSHMEM)
 PETSC_INTERN PetscErrorCode PetscSFReset_Basic_NVSHMEM(PetscSF);
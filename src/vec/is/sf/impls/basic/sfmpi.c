@@ -3,7 +3,7 @@
 // Though there is no default mechanism to start a communication, we have a
 // default to finish communication, which is just waiting on the requests.
 // It should work for both non-blocking or persistent send/recvs or collectivwes.
-static PetscErrorCode PetscSFLinkFinishCommunication_Default(PetscSF sf, PetscSFLink link, PetscSFDirection direction)
+PetscErrorCode PetscSFLinkFinishCommunication_Default(PetscSF sf, PetscSFLink link, PetscSFDirection direction)
 {
   PetscSF_Basic     *bas           = (PetscSF_Basic *)sf->data;
   const PetscMemType rootmtype_mpi = link->rootmtype_mpi, leafmtype_mpi = link->leafmtype_mpi;
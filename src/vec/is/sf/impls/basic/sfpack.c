@@ -408,6 +408,9 @@ DEF_DumbType(DumbInt, 1, 1) DEF_DumbType(DumbInt, 2, 1) DEF_DumbType(DumbInt, 4,
       if (link->reqs[i] != MPI_REQUEST_NULL) PetscCallMPI(MPI_Request_free(&link->reqs[i]));
     }
     PetscCall(PetscFree(link->reqs));
+    PetscCall(PetscFree(link->zreqs));
+    PetscCall(PetscFree(link->zbuf));
+    PetscCall(PetscFree(link->zscratch));
     for (i = PETSCSF_LOCAL; i <= PETSCSF_REMOTE; i++) {
       PetscCall(PetscFree(link->rootbuf_alloc[i][PETSC_MEMTYPE_HOST]));
       PetscCall(PetscFree(link->leafbuf_alloc[i][PETSC_MEMTYPE_HOST]));
@@ -1164,6 +1167,98 @@ PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF sf, PetscSFLink link, void *ro
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+  Lossless compression of packed messages whose units are made of 8-byte words, typically PetscScalar (double) data.
+
+  Each word is XOR'ed with the same word of the previous unit, so that smooth fields (and multi-field data of which
+  each field is smooth) leave mostly zero high order bytes. Byte b of all the words is then gathered in plane b, and
+  the planes are run-length encoded: a control byte c < 128 is followed by c + 1 literal bytes, while c >= 128 stands
+  for c - 127 zero bytes.
+
+  A compressed message starts with a PetscInt64 header holding the length of the encoded data, or -1 when the
+  encoding is not smaller than the raw data, in which case the raw data follows. A message of count units thus
+  takes at most count * unitbytes + PETSCSF_COMPRESS_HEADER bytes.
+*/
+PetscErrorCode PetscSFLinkCompress(PetscSFLink link, PetscInt count, const void *buf, void *zbuf, size_t *zbytes)
+{
+  const size_t    n = count * link->unitbytes / 8, s = link->unitbytes / 8, nbytes = 8 * n;
+  const uint64_t *w = (const uint64_t *)buf;
+  unsigned char  *t = (unsigned char *)link->zscratch, *z = (unsigned char *)zbuf + PETSCSF_COMPRESS_HEADER;
+  size_t          i = 0, o = 0;
+  PetscInt64      len;
+
+  PetscFunctionBegin;
+  PetscCheck(link->zscratchsize >= nbytes, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Scratch buffer of the compression is too small");
+  for (size_t k = 0; k < n; k++) {
+    const uint64_t d = k < s ? w[k] : w[k] ^ w[k - s];
+
+    for (size_t b = 0; b < 8; b++) t[b * n + k] = (unsigned char)(d >> (8 * b));
+  }
+  while (i < nbytes) {
+    size_t r = 0;
+
+    if (!t[i]) {
+      while (i + r < nbytes && r < 128 && !t[i + r]) r++;
+      if (o + 1 >= nbytes) break;
+      z[o++] = (unsigned char)(127 + r);
+    } else {
+      while (i + r < nbytes && r < 128 && t[i + r]) r++;
+      if (o + 1 + r >= nbytes) break;
+      z[o++] = (unsigned char)(r - 1);
+      PetscCall(PetscMemcpy(z + o, t + i, r));
+      o += r;
+    }
+    i += r;
+  }
+  if (i < nbytes) { /* not compressible, send the raw data */
+    len = -1;
+    PetscCall(PetscMemcpy(z, buf, nbytes));
+    o = nbytes;
+  } else len = (PetscInt64)o;
+  PetscCall(PetscMemcpy(zbuf, &len, sizeof(len)));
+  *zbytes = o + PETSCSF_COMPRESS_HEADER;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Decompress a message made by PetscSFLinkCompress() into count units at buf */
+PetscErrorCode PetscSFLinkDecompress(PetscSFLink link, PetscInt count, const void *zbuf, void *buf)
+{
+  const size_t         n = count * link->unitbytes / 8, s = link->unitbytes / 8, nbytes = 8 * n;
+  const unsigned char *z = (const unsigned char *)zbuf + PETSCSF_COMPRESS_HEADER;
+  unsigned char       *t = (unsigned char *)link->zscratch;
+  uint64_t            *w = (uint64_t *)buf;
+  size_t               i = 0, o = 0;
+  PetscInt64           len;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMemcpy(&len, zbuf, sizeof(len)));
+  if (len < 0) {
+    PetscCall(PetscMemcpy(buf, z, nbytes));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCheck(link->zscratchsize >= nbytes, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Scratch buffer of the compression is too small");
+  while (o < (size_t)len) {
+    const unsigned char c = z[o++];
+    const size_t        r = c >= 128 ? (size_t)c - 127 : (size_t)c + 1;
+
+    PetscCheck(i + r <= nbytes, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Corrupted compressed message");
+    if (c >= 128) PetscCall(PetscMemzero(t + i, r));
+    else {
+      PetscCall(PetscMemcpy(t + i, z + o, r));
+      o += r;
+    }
+    i += r;
+  }
+  PetscCheck(i == nbytes, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Compressed message decodes to %zu bytes instead of %zu", i, nbytes);
+  for (size_t k = 0; k < n; k++) {
+    uint64_t d = 0;
+
+    for (size_t b = 0; b < 8; b++) d |= (uint64_t)t[b * n + k] << (8 * b);
+    w[k] = k < s ? d : d ^ w[k - s];
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
   Create per-rank pack/unpack optimizations based on indices patterns
 
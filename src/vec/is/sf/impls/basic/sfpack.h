@@ -193,6 +193,12 @@ struct _n_PetscSFLink {
   PetscBool    rootreqsinited[2][2][2]; /* Are root requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][rootdirect_mpi]*/
   PetscBool    leafreqsinited[2][2][2]; /* Are leaf requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][leafdirect_mpi]*/
   MPI_Request *reqs;                    /* An array of length (nrootreqs+nleafreqs)*8. Pointers in rootreqs[][][] and leafreqs[][][] point here */
+  MPI_Request *zreqs;                   /* [nrootreqs+nleafreqs] Requests of the communication with compressed messages */
+  PetscBool    zactive;                 /* Is the ongoing communication using zreqs[]? */
+  char        *zbuf;                    /* Buffer of the compressed messages sent and received */
+  size_t       zbufsize;
+  char        *zscratch;                /* Scratch buffer of the codec, large enough for any message */
+  size_t       zscratchsize;
   PetscSFLink  next;
 
   PetscBool use_nvshmem; /* Does this link use nvshem (vs. MPI) for communication? */
@@ -245,6 +251,12 @@ PETSC_INTERN PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF, PetscSFLink, voi
 PETSC_INTERN PetscErrorCode PetscSFSetUpPackFields(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFResetPackFields(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFLinkCreate_MPI(PetscSF, MPI_Datatype, PetscMemType, const void *, PetscMemType, const void *, MPI_Op, PetscSFOperation, PetscSFLink *);
+PETSC_INTERN PetscErrorCode PetscSFLinkFinishCommunication_Default(PetscSF, PetscSFLink, PetscSFDirection);
+
+/* Lossless compression of messages made of 8-byte words. A compressed message of n bytes of data takes at most n + PETSCSF_COMPRESS_HEADER bytes */
+#define PETSCSF_COMPRESS_HEADER ((size_t)sizeof(PetscInt64))
+PETSC_INTERN PetscErrorCode PetscSFLinkCompress(PetscSFLink, PetscInt, const void *, void *, size_t *);
+PETSC_INTERN PetscErrorCode PetscSFLinkDecompress(PetscSFLink, PetscInt, const void *, void *);
 
 #if defined(PETSC_HAVE_CUDA)
 PETSC_INTERN PetscErrorCode PetscSFLinkSetUp_CUDA(PetscSF, PetscSFLink, MPI_Datatype);
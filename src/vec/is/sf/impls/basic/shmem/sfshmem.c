@@ -0,0 +1,429 @@
+#include <../src/vec/is/sf/impls/basic/sfpack.h>
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+
+/*
+   SFShmem moves the data between ranks of the same shared-memory node through an MPI-3 shared memory window instead
+   of MPI messages. Each rank owns a segment of the window split in two phases used by consecutive operations in turn.
+   A sender packs its blocks for all its peers on the node into the current phase of its segment, the ranks of the node
+   synchronize once, and each receiver unpacks its blocks directly from the segments of its peers. Contiguous blocks are
+   packed and unpacked with memcpy. Edges to the rank itself and to ranks on other nodes go through a PETSCSFBASIC.
+*/
+typedef struct {
+  SFBASICHEADER;
+  PetscSF       mpisf;                  /* PETSCSFBASIC holding the edges to myself and to ranks on other nodes */
+  PetscBool     usempisf;               /* Does mpisf have edges on any rank? */
+  MPI_Comm      shmcomm;                /* Ranks sharing memory with me. Not owned */
+  PetscMPIInt   shmrank, shmsize;       /* My rank and the size of shmcomm */
+  PetscBool     active;                 /* Does any rank of shmcomm have edges to another rank of shmcomm? */
+  PetscMPIInt   nrpeers, nlpeers;       /* Number of ranks on my node owning roots of my leaves, and having leaves on my roots */
+  PetscMPIInt  *rpeers, *lpeers;        /* Their ranks in shmcomm */
+  PetscInt     *rpoffset, *lpoffset;    /* Offsets of each peer in leafloc[] and rootloc[], which are also the offsets (in units) of its block in my segment */
+  PetscInt     *leafloc, *rootloc;      /* Locations of my leaves connected to each root peer, and of my roots connected to each leaf peer */
+  PetscInt     *rpstart, *lpstart;      /* If nonnegative, the locations for a peer are contiguous and start there */
+  PetscInt     *rpdisp, *lpdisp;        /* Offsets (in units) of my block in the segment of each peer */
+  PetscInt      buflen;                 /* Length (in units) of one phase of my segment */
+  PetscInt      nshmleaves, nmpileaves; /* Number of my leaves connected through shared memory and through mpisf */
+  MPI_Win       win;                    /* Shared memory window holding the segments */
+  size_t        winunitbytes;           /* The segments are large enough for units of this size */
+  char        **base;                   /* [shmsize] Base address of the segment of each rank of shmcomm */
+  MPI_Aint     *phasebytes;             /* [shmsize] Size in bytes of one phase of the segment of each rank of shmcomm */
+  PetscInt      phase;                  /* The phase of the segments the next operation uses */
+  PetscSFLink   links;                  /* Pack kernels, one per unit */
+} PetscSF_Shmem;
+
+/*===================================================================================*/
+/*              Internal utility routines                                            */
+/*===================================================================================*/
+
+/* Get the pack kernels for unit, or NULL if the operation can not be done through shared memory, in which case all the
+   edges of sf are handled by the PETSCSFBASIC routines. The result is the same on all ranks of a node, since unit and op
+   are the same for a collective operation.
+*/
+static PetscErrorCode PetscSFShmemGetLink(PetscSF sf, MPI_Datatype unit, PetscMemType rootmtype, PetscMemType leafmtype, MPI_Op op, PetscSFLink *mylink)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+  PetscSFLink    link;
+  PetscErrorCode (*UnpackAndOp)(PetscSFLink, PetscInt, PetscInt, PetscSFPackOpt, const PetscInt *, void *, const void *);
+
+  PetscFunctionBegin;
+  *mylink = NULL;
+  if (!shm->active || !PetscMemTypeHost(rootmtype) || !PetscMemTypeHost(leafmtype)) PetscFunctionReturn(PETSC_SUCCESS);
+  for (link = shm->links; link; link = link->next) {
+    PetscBool match;
+
+    PetscCall(MPIPetsc_Type_compare(unit, link->unit, &match));
+    if (match) break;
+  }
+  if (!link) {
+    PetscCall(PetscNew(&link));
+    PetscCall(PetscSFLinkSetUp_Host(sf, link, unit));
+    link->next = shm->links;
+    shm->links = link;
+  }
+  PetscCall(PetscSFLinkGetUnpackAndOp(link, PETSC_MEMTYPE_HOST, op, PETSC_FALSE, &UnpackAndOp));
+  if (UnpackAndOp) *mylink = link;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Did the operation on rootdata and leafdata go through the PETSCSFBASIC routines on the whole graph? */
+static PetscErrorCode PetscSFShmemUsedBasic(PetscSF sf, MPI_Datatype unit, const void *rootdata, const void *leafdata, PetscBool *used)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+
+  PetscFunctionBegin;
+  *used = PETSC_FALSE;
+  for (PetscSFLink link = shm->inuse; link; link = link->next) {
+    PetscBool match;
+
+    PetscCall(MPIPetsc_Type_compare(unit, link->unit, &match));
+    if (match && rootdata == link->rootdata && leafdata == link->leafdata) {
+      *used = PETSC_TRUE;
+      break;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Make sure the window holds two phases of buflen units of unitbytes bytes on each rank. Collective on shmcomm */
+static PetscErrorCode PetscSFShmemGetWindow(PetscSF sf, size_t unitbytes)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+  MPI_Info       info;
+  char          *mybase;
+
+  PetscFunctionBegin;
+  if (shm->win != MPI_WIN_NULL && unitbytes <= shm->winunitbytes) PetscFunctionReturn(PETSC_SUCCESS);
+  if (shm->win != MPI_WIN_NULL) {
+    PetscCallMPI(MPI_Win_unlock_all(shm->win));
+    PetscCallMPI(MPI_Win_free(&shm->win));
+  }
+  PetscCallMPI(MPI_Info_create(&info));
+  PetscCallMPI(MPI_Info_set(info, "alloc_shared_noncontig", "true")); /* Let each segment be allocated close to its owner */
+  PetscCallMPI(MPI_Win_allocate_shared((MPI_Aint)(2 * shm->buflen * unitbytes), 1, info, shm->shmcomm, &mybase, &shm->win));
+  PetscCallMPI(MPI_Info_free(&info));
+  for (PetscMPIInt i = 0; i < shm->shmsize; i++) {
+    MPI_Aint    size;
+    PetscMPIInt dispunit;
+
+    PetscCallMPI(MPI_Win_shared_query(shm->win, i, &size, &dispunit, &shm->base[i]));
+    shm->phasebytes[i] = size / 2;
+  }
+  PetscCallMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, shm->win));
+  shm->winunitbytes = unitbytes;
+  shm->phase        = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Move the data of the edges between ranks of my node from src to dst, packing my blocks into my segment and unpacking
+   the blocks of my peers from their segments. Collective on shmcomm
+*/
+static PetscErrorCode PetscSFShmemCommunicate(PetscSF sf, PetscSFLink link, PetscSFDirection direction, const void *src, void *dst, MPI_Op op)
+{
+  PetscSF_Shmem     *shm       = (PetscSF_Shmem *)sf->data;
+  PetscBool          bcast     = direction == PETSCSF_ROOT2LEAF ? PETSC_TRUE : PETSC_FALSE;
+  PetscMPIInt        nsend     = bcast ? shm->nlpeers : shm->nrpeers, nrecv = bcast ? shm->nrpeers : shm->nlpeers;
+  const PetscMPIInt *recvpeers = bcast ? shm->rpeers : shm->lpeers;
+  const PetscInt    *soffset   = bcast ? shm->lpoffset : shm->rpoffset, *sloc = bcast ? shm->rootloc : shm->leafloc, *sstart = bcast ? shm->lpstart : shm->rpstart;
+  const PetscInt    *roffset   = bcast ? shm->rpoffset : shm->lpoffset, *rloc = bcast ? shm->leafloc : shm->rootloc, *rstart = bcast ? shm->rpstart : shm->lpstart;
+  const PetscInt    *rdisp     = bcast ? shm->rpdisp : shm->lpdisp;
+  size_t             unitbytes = link->unitbytes;
+  char              *buf;
+  PetscErrorCode (*UnpackAndOp)(PetscSFLink, PetscInt, PetscInt, PetscSFPackOpt, const PetscInt *, void *, const void *);
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFShmemGetWindow(sf, unitbytes));
+  PetscCall(PetscSFLinkGetUnpackAndOp(link, PETSC_MEMTYPE_HOST, op, PETSC_FALSE, &UnpackAndOp));
+
+  buf = shm->base[shm->shmrank] + shm->phase * shm->phasebytes[shm->shmrank];
+  PetscCall(PetscLogEventBegin(PETSCSF_Pack, sf, 0, 0, 0));
+  for (PetscMPIInt i = 0; i < nsend; i++) {
+    PetscInt n = soffset[i + 1] - soffset[i];
+
+    PetscCall(link->h_Pack(link, n, sstart[i], NULL, sstart[i] >= 0 ? NULL : sloc + soffset[i], src, buf + soffset[i] * unitbytes));
+  }
+  PetscCall(PetscLogEventEnd(PETSCSF_Pack, sf, 0, 0, 0));
+
+  /* Make my segment visible to my peers and theirs to me */
+  PetscCallMPI(MPI_Win_sync(shm->win));
+  PetscCallMPI(MPI_Barrier(shm->shmcomm));
+  PetscCallMPI(MPI_Win_sync(shm->win));
+
+  PetscCall(PetscLogEventBegin(PETSCSF_Unpack, sf, 0, 0, 0));
+  for (PetscMPIInt i = 0; i < nrecv; i++) {
+    PetscMPIInt peer = recvpeers[i];
+    PetscInt    n    = roffset[i + 1] - roffset[i];
+
+    buf = shm->base[peer] + shm->phase * shm->phasebytes[peer] + rdisp[i] * unitbytes;
+    PetscCall((*UnpackAndOp)(link, n, rstart[i], NULL, rstart[i] >= 0 ? NULL : rloc + roffset[i], dst, buf));
+  }
+  PetscCall(PetscLogEventEnd(PETSCSF_Unpack, sf, 0, 0, 0));
+  /* A peer may still read the current phase of my segment, but it has to pass the barrier of the next operation before I can write it again */
+  shm->phase = 1 - shm->phase;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Split the blocks of the ranks in ranks[ndranks, nranks) between peers on my node and the other ranks */
+static PetscErrorCode PetscSFShmemSetUpPeers(PetscShmComm pshmcomm, PetscMPIInt nranks, PetscMPIInt ndranks, const PetscMPIInt *ranks, const PetscInt *offset, const PetscInt *loc, PetscMPIInt *lranks, PetscMPIInt *npeers, PetscMPIInt **peers, PetscInt **peeroffset, PetscInt **peerloc, PetscInt **peerstart, PetscInt **peerdisp)
+{
+  PetscMPIInt n = 0;
+
+  PetscFunctionBegin;
+  for (PetscMPIInt i = 0; i < nranks; i++) {
+    lranks[i] = MPI_PROC_NULL;
+    if (i >= ndranks) PetscCall(PetscShmCommGlobalToLocal(pshmcomm, ranks[i], &lranks[i]));
+    if (lranks[i] != MPI_PROC_NULL) n++;
+  }
+  *npeers = n;
+  PetscCall(PetscMalloc4(n, peers, n + 1, peeroffset, n, peerstart, n, peerdisp));
+  (*peeroffset)[0] = 0;
+  for (PetscMPIInt i = 0, p = 0; i < nranks; i++) {
+    if (lranks[i] == MPI_PROC_NULL) continue;
+    (*peers)[p]          = lranks[i];
+    (*peeroffset)[p + 1] = (*peeroffset)[p] + offset[i + 1] - offset[i];
+    p++;
+  }
+  PetscCall(PetscMalloc1((*peeroffset)[n], peerloc));
+  for (PetscMPIInt i = 0, p = 0; i < nranks; i++) {
+    const PetscInt *l   = loc + offset[i];
+    PetscInt        cnt = offset[i + 1] - offset[i];
+
+    if (lranks[i] == MPI_PROC_NULL) continue;
+    PetscCall(PetscArraycpy(*peerloc + (*peeroffset)[p], l, cnt));
+    (*peerstart)[p] = l[0];
+    for (PetscInt k = 1; k < cnt; k++) {
+      if (l[k] != l[0] + k) {
+        (*peerstart)[p] = -1;
+        break;
+      }
+    }
+    p++;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*===================================================================================*/
+/*              Implementations of SF public APIs                                    */
+/*===================================================================================*/
+static PetscErrorCode PetscSFSetUp_Shmem(PetscSF sf)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+  PetscShmComm   pshmcomm;
+  MPI_Comm       comm;
+  PetscMPIInt   *rlranks, *llranks;
+  PetscInt      *dispsend, *disprecv, *ilocal, n = 0;
+  PetscSFNode   *remote;
+
+  PetscFunctionBegin;
+  /* SFShmem inherits from Basic, whose routines on the whole graph are used for what can not be done through shared memory */
+  PetscCall(PetscSFSetUp_Basic(sf));
+  PetscCall(PetscObjectGetComm((PetscObject)sf, &comm));
+  PetscCall(PetscShmCommGet(comm, &pshmcomm));
+  PetscCall(PetscShmCommGetMpiShmComm(pshmcomm, &shm->shmcomm));
+  PetscCallMPI(MPI_Comm_rank(shm->shmcomm, &shm->shmrank));
+  PetscCallMPI(MPI_Comm_size(shm->shmcomm, &shm->shmsize));
+
+  /* My leaves connected to roots on my node, and my roots connected to leaves on my node */
+  PetscCall(PetscMalloc2(sf->nranks, &rlranks, shm->niranks, &llranks));
+  PetscCall(PetscSFShmemSetUpPeers(pshmcomm, sf->nranks, sf->ndranks, sf->ranks, sf->roffset, sf->rmine, rlranks, &shm->nrpeers, &shm->rpeers, &shm->rpoffset, &shm->leafloc, &shm->rpstart, &shm->rpdisp));
+  PetscCall(PetscSFShmemSetUpPeers(pshmcomm, shm->niranks, shm->ndiranks, shm->iranks, shm->ioffset, shm->irootloc, llranks, &shm->nlpeers, &shm->lpeers, &shm->lpoffset, &shm->rootloc, &shm->lpstart, &shm->lpdisp));
+  shm->nshmleaves = shm->rpoffset[shm->nrpeers];
+  shm->buflen     = PetscMax(shm->rpoffset[shm->nrpeers], shm->lpoffset[shm->nlpeers]);
+
+  /* Tell each peer where its block is in my segment */
+  PetscCall(PetscMalloc2(2 * shm->shmsize, &dispsend, 2 * shm->shmsize, &disprecv));
+  for (PetscMPIInt j = 0; j < 2 * shm->shmsize; j++) dispsend[j] = -1;
+  for (PetscMPIInt p = 0; p < shm->nlpeers; p++) dispsend[2 * shm->lpeers[p]] = shm->lpoffset[p];
+  for (PetscMPIInt q = 0; q < shm->nrpeers; q++) dispsend[2 * shm->rpeers[q] + 1] = shm->rpoffset[q];
+  PetscCallMPI(MPI_Alltoall(dispsend, 2, MPIU_INT, disprecv, 2, MPIU_INT, shm->shmcomm));
+  for (PetscMPIInt q = 0; q < shm->nrpeers; q++) shm->rpdisp[q] = disprecv[2 * shm->rpeers[q]];
+  for (PetscMPIInt p = 0; p < shm->nlpeers; p++) shm->lpdisp[p] = disprecv[2 * shm->lpeers[p] + 1];
+  PetscCall(PetscFree2(dispsend, disprecv));
+  PetscCall(PetscMalloc2(shm->shmsize, &shm->base, shm->shmsize, &shm->phasebytes));
+  shm->active = (shm->nrpeers || shm->nlpeers) ? PETSC_TRUE : PETSC_FALSE;
+  PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, &shm->active, 1, MPIU_BOOL, MPI_LOR, shm->shmcomm));
+
+  /* The remaining edges go through MPI */
+  shm->nmpileaves = sf->roffset[sf->nranks] - shm->nshmleaves;
+  PetscCall(PetscMalloc1(shm->nmpileaves, &ilocal));
+  PetscCall(PetscMalloc1(shm->nmpileaves, &remote));
+  for (PetscMPIInt i = 0; i < sf->nranks; i++) {
+    if (rlranks[i] != MPI_PROC_NULL) continue;
+    for (PetscInt k = sf->roffset[i]; k < sf->roffset[i + 1]; k++, n++) {
+      ilocal[n]       = sf->rmine[k];
+      remote[n].rank  = sf->ranks[i];
+      remote[n].index = sf->rremote[k];
+    }
+  }
+  PetscCall(PetscFree2(rlranks, llranks));
+  PetscCall(PetscSFCreate(comm, &shm->mpisf));
+  PetscCall(PetscSFSetType(shm->mpisf, PETSCSFBASIC));
+  PetscCall(PetscSFBasicCopyOptions_Private(sf, shm->mpisf));
+  PetscCall(PetscSFSetGraph(shm->mpisf, sf->nroots, shm->nmpileaves, ilocal, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER));
+  PetscCall(PetscSFSetUp(shm->mpisf));
+  shm->usempisf = shm->nmpileaves ? PETSC_TRUE : PETSC_FALSE;
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &shm->usempisf, 1, MPIU_BOOL, MPI_LOR, comm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReset_Shmem(PetscSF sf)
+{
+  PetscSF_Shmem *shm  = (PetscSF_Shmem *)sf->data;
+  PetscSFLink    link = shm->links, next;
+
+  PetscFunctionBegin;
+  PetscCheck(!shm->inuse, PetscObjectComm((PetscObject)sf), PETSC_ERR_ARG_WRONGSTATE, "Outstanding operation has not been completed");
+  PetscCall(PetscSFDestroy(&shm->mpisf));
+  PetscCall(PetscFree4(shm->rpeers, shm->rpoffset, shm->rpstart, shm->rpdisp));
+  PetscCall(PetscFree4(shm->lpeers, shm->lpoffset, shm->lpstart, shm->lpdisp));
+  PetscCall(PetscFree(shm->leafloc));
+  PetscCall(PetscFree(shm->rootloc));
+  PetscCall(PetscFree2(shm->base, shm->phasebytes));
+  if (shm->win != MPI_WIN_NULL) {
+    PetscCallMPI(MPI_Win_unlock_all(shm->win));
+    PetscCallMPI(MPI_Win_free(&shm->win));
+  }
+  shm->winunitbytes = 0;
+  for (; link; link = next) {
+    next = link->next;
+    if (!link->isbuiltin) PetscCallMPI(MPI_Type_free(&link->unit));
+    PetscCall(PetscFree(link));
+  }
+  shm->links = NULL;
+  PetscCall(PetscSFReset_Basic(sf)); /* Common part */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFDestroy_Shmem(PetscSF sf)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscSFReset_Shmem(sf));
+  PetscCall(PetscFree(sf->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFView_Shmem(PetscSF sf, PetscViewer viewer)
+{
+  PetscSF_Shmem    *shm = (PetscSF_Shmem *)sf->data;
+  PetscBool         isascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFView_Basic(sf, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCall(PetscViewerGetFormat(viewer, &format));
+  if (isascii && format != PETSC_VIEWER_ASCII_MATLAB && sf->setupcalled) {
+    PetscInt nleaves[2] = {shm->nshmleaves, shm->nmpileaves};
+
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, nleaves, 2, MPIU_INT, MPI_SUM, PetscObjectComm((PetscObject)sf)));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  Leaves connected through shared memory %" PetscInt_FMT ", through MPI %" PetscInt_FMT "\n", nleaves[0], nleaves[1]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Shmem(PetscSF sf, MPI_Datatype unit, PetscMemType rootmtype, const void *rootdata, PetscMemType leafmtype, void *leafdata, MPI_Op op)
+{
+  PetscSF_Shmem *shm  = (PetscSF_Shmem *)sf->data;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFShmemGetLink(sf, unit, rootmtype, leafmtype, op, &link));
+  if (shm->active && !link) {
+    PetscCall(PetscSFBcastBegin_Basic(sf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (shm->usempisf) PetscCall(PetscSFBcastWithMemTypeBegin(shm->mpisf, unit, rootmtype, rootdata, leafmtype, leafdata, op));
+  if (link) PetscCall(PetscSFShmemCommunicate(sf, link, PETSCSF_ROOT2LEAF, rootdata, leafdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Shmem(PetscSF sf, MPI_Datatype unit, const void *rootdata, void *leafdata, MPI_Op op)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+  PetscBool      usedbasic;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFShmemUsedBasic(sf, unit, rootdata, leafdata, &usedbasic));
+  if (usedbasic) PetscCall(PetscSFBcastEnd_Basic(sf, unit, rootdata, leafdata, op));
+  else if (shm->usempisf) PetscCall(PetscSFBcastEnd(shm->mpisf, unit, rootdata, leafdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Shmem(PetscSF sf, MPI_Datatype unit, PetscMemType leafmtype, const void *leafdata, PetscMemType rootmtype, void *rootdata, MPI_Op op)
+{
+  PetscSF_Shmem *shm  = (PetscSF_Shmem *)sf->data;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFShmemGetLink(sf, unit, rootmtype, leafmtype, op, &link));
+  if (shm->active && !link) {
+    PetscCall(PetscSFReduceBegin_Basic(sf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (shm->usempisf) PetscCall(PetscSFReduceWithMemTypeBegin(shm->mpisf, unit, leafmtype, leafdata, rootmtype, rootdata, op));
+  if (link) PetscCall(PetscSFShmemCommunicate(sf, link, PETSCSF_LEAF2ROOT, leafdata, rootdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Shmem(PetscSF sf, MPI_Datatype unit, const void *leafdata, void *rootdata, MPI_Op op)
+{
+  PetscSF_Shmem *shm = (PetscSF_Shmem *)sf->data;
+  PetscBool      usedbasic;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSFShmemUsedBasic(sf, unit, rootdata, leafdata, &usedbasic));
+  if (usedbasic) PetscCall(PetscSFReduceEnd_Basic(sf, unit, leafdata, rootdata, op));
+  else if (shm->usempisf) PetscCall(PetscSFReduceEnd(shm->mpisf, unit, leafdata, rootdata, op));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PETSCSFSHMEM - A `PetscSFType` that moves the data between MPI ranks of the same shared-memory node through an MPI-3 shared
+   memory window, and the data between ranks on different nodes with MPI messages as `PETSCSFBASIC` does
+
+   Options Database Key:
+.  -sf_type shmem - use this type
+
+   Level: intermediate
+
+   Notes:
+   A rank packs the data for its peers on the node into its segment of the window, the ranks of the node synchronize, and each
+   rank unpacks its data directly from the segments of its peers, so the on-node data is copied once into shared memory and
+   once out of it. The on-node part of `PetscSFBcastBegin()` and `PetscSFReduceBegin()` is complete when they return.
+
+   The operations are collective on the ranks of a node. `PetscSFFetchAndOpBegin()`, data in device memory and reductions
+   without a packing kernel for the datatype go through `PETSCSFBASIC` on the whole graph.
+
+   Use `-noshared` to treat all ranks as if they were on different nodes. The `-sf_basic_` options, such as `-sf_basic_compress_size`,
+   apply to the MPI messages.
+
+.seealso: `PetscSF`, `PetscSFType`, `PetscSFSetType()`, `PETSCSFBASIC`, `PETSCSFWINDOW`, `PetscShmCommGet()`
+M*/
+PETSC_INTERN PetscErrorCode PetscSFCreate_Shmem(PetscSF sf)
+{
+  PetscSF_Shmem *dat;
+
+  PetscFunctionBegin;
+  sf->ops->CreateEmbeddedRootSF = PetscSFCreateEmbeddedRootSF_Basic;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Basic;
+  sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
+  sf->ops->SetCommunicationOps  = PetscSFSetCommunicationOps_Basic;
+
+  sf->ops->SetUp          = PetscSFSetUp_Shmem;
+  sf->ops->Reset          = PetscSFReset_Shmem;
+  sf->ops->Destroy        = PetscSFDestroy_Shmem;
+  sf->ops->SetFromOptions = PetscSFSetFromOptions_Basic;
+  sf->ops->View           = PetscSFView_Shmem;
+  sf->ops->BcastBegin     = PetscSFBcastBegin_Shmem;
+  sf->ops->BcastEnd       = PetscSFBcastEnd_Shmem;
+  sf->ops->ReduceBegin    = PetscSFReduceBegin_Shmem;
+  sf->ops->ReduceEnd      = PetscSFReduceEnd_Shmem;
+
+  sf->persistent = PETSC_TRUE; // the PETSCSFBASIC routines use persistent send/recv
+  sf->collective = PETSC_TRUE;
+
+  PetscCall(PetscNew(&dat));
+  dat->win = MPI_WIN_NULL;
+  sf->data = (void *)dat;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -42,6 +42,9 @@ const char *const PetscSFConcatenateRootModes[] = {"local", "shared", "global",
 + -sf_type basic                 - Use MPI persistent Isend/Irecv for communication (Default)
 . -sf_type window                - Use MPI-3 one-sided window for communication
 . -sf_type neighbor              - Use MPI-3 neighborhood collectives for communication
+. -sf_type shmem                 - Use an MPI-3 shared memory window for communication between ranks of the same node
+. -sf_type hierarchical          - Send the data between two nodes in one message between their leader ranks
+. -sf_type auto                  - Time several types on the graph at setup and use the fastest
 - -sf_neighbor_persistent <bool> - If true, use MPI-4 persistent neighborhood collectives for communication (used along with -sf_type neighbor)
 
   Level: intermediate
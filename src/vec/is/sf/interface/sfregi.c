@@ -9,9 +9,14 @@ PETSC_INTERN PetscErrorCode PetscSFCreate_Allgather(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFCreate_Gatherv(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFCreate_Gather(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFCreate_Alltoall(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFCreate_Auto(PetscSF);
 #if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
 PETSC_INTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF);
 #endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+PETSC_INTERN PetscErrorCode PetscSFCreate_Shmem(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFCreate_Hierarchical(PetscSF);
+#endif
 
 PetscFunctionList PetscSFList;
 PetscBool         PetscSFRegisterAllCalled;
@@ -39,8 +44,13 @@ PetscErrorCode PetscSFRegisterAll(void)
   PetscCall(PetscSFRegister(PETSCSFGATHERV, PetscSFCreate_Gatherv));
   PetscCall(PetscSFRegister(PETSCSFGATHER, PetscSFCreate_Gather));
   PetscCall(PetscSFRegister(PETSCSFALLTOALL, PetscSFCreate_Alltoall));
+  PetscCall(PetscSFRegister(PETSCSFAUTO, PetscSFCreate_Auto));
 #if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
   PetscCall(PetscSFRegister(PETSCSFNEIGHBOR, PetscSFCreate_Neighbor));
+#endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscCall(PetscSFRegister(PETSCSFSHMEM, PetscSFCreate_Shmem));
+  PetscCall(PetscSFRegister(PETSCSFHIERARCHICAL, PetscSFCreate_Hierarchical));
 #endif
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -0,0 +1,242 @@
+static char help[] = "Tests PetscSF Bcast, Reduce and FetchAndOp of the PETSCSFBASIC options and of the types built on PETSCSFBASIC against PETSCSFBASIC.\n\n";
+
+#include <petscsf.h>
+
+int main(int argc, char **argv)
+{
+  PetscSF      sf, sfref, sfcopy;
+  PetscSFNode *remote;
+  PetscInt    *ilocal = NULL;
+  PetscReal   *rootdata, *leafdata, *rootref, *leafref, *leafupdate, *leafupdateref;
+  PetscInt     n = 64, m = 40, nneigh = 3, stride = 7, bs = 1, niter = 1, nleaves, nl;
+  PetscMPIInt  rank, size;
+  PetscBool    contig = PETSC_FALSE, noise = PETSC_FALSE, view = PETSC_FALSE, viewcopy = PETSC_FALSE;
+  MPI_Datatype unit;
+  unsigned int seed;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+  PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &size));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nneigh", &nneigh, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-niter", &niter, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-contig", &contig, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-noise", &noise, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-view", &view, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-view_copy", &viewcopy, NULL));
+  PetscCheck(m <= n, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "m %" PetscInt_FMT " must not be larger than n %" PetscInt_FMT, m, n);
+  nneigh = PetscMin(nneigh, size);
+
+  /* the leaves of block k reference m roots on rank (rank + k) % size, either contiguous or strided, and are stored interleaved with a gap */
+  nleaves = nneigh * m;
+  nl      = 2 * nleaves;
+  PetscCall(PetscMalloc1(nleaves, &remote));
+  if (!contig) PetscCall(PetscMalloc1(nleaves, &ilocal));
+  for (PetscInt k = 0; k < nneigh; k++) {
+    for (PetscInt j = 0; j < m; j++) {
+      remote[k * m + j].rank  = (rank + k) % size;
+      remote[k * m + j].index = contig ? j : (j * stride) % n;
+      if (!contig) ilocal[k * m + j] = 2 * (j * nneigh + k) + 1;
+    }
+  }
+  if (contig) nl = nleaves;
+
+  PetscCall(PetscSFCreate(PETSC_COMM_WORLD, &sfref));
+  PetscCall(PetscSFSetType(sfref, PETSCSFBASIC));
+  PetscCall(PetscSFSetGraph(sfref, n, nleaves, ilocal, PETSC_COPY_VALUES, remote, PETSC_COPY_VALUES));
+  PetscCall(PetscSFSetUp(sfref));
+  PetscCall(PetscSFCreate(PETSC_COMM_WORLD, &sf));
+  PetscCall(PetscSFSetFromOptions(sf));
+  PetscCall(PetscSFSetGraph(sf, n, nleaves, ilocal, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER));
+  PetscCall(PetscSFSetUp(sf));
+
+  if (bs > 1) {
+    PetscCallMPI(MPI_Type_contiguous((PetscMPIInt)bs, MPIU_REAL, &unit));
+    PetscCallMPI(MPI_Type_commit(&unit));
+  } else unit = MPIU_REAL;
+  PetscCall(PetscMalloc6(n * bs, &rootdata, n * bs, &rootref, nl * bs, &leafdata, nl * bs, &leafref, nl * bs, &leafupdate, nl * bs, &leafupdateref));
+
+  seed = (unsigned int)rank + 1;
+  for (PetscInt it = 0; it < niter; it++) {
+    const MPI_Op ops[] = {MPI_REPLACE, MPI_SUM, MPI_MAX};
+
+    for (PetscInt o = 0; o < 3; o++) {
+      /* broadcast of smooth fields, one per component of the units, or of noise which does not compress */
+      for (PetscInt i = 0; i < n; i++) {
+        for (PetscInt c = 0; c < bs; c++) {
+          if (noise) {
+            seed                 = 1103515245 * seed + 12345;
+            rootdata[i * bs + c] = (PetscReal)seed / 7.0;
+          } else rootdata[i * bs + c] = PetscSinReal(0.01 * (rank * n + i + it)) + c;
+        }
+      }
+      for (PetscInt i = 0; i < nl * bs; i++) leafdata[i] = leafref[i] = i % 5;
+      PetscCall(PetscSFBcastBegin(sf, unit, rootdata, leafdata, ops[o]));
+      PetscCall(PetscSFBcastEnd(sf, unit, rootdata, leafdata, ops[o]));
+      PetscCall(PetscSFBcastBegin(sfref, unit, rootdata, leafref, ops[o]));
+      PetscCall(PetscSFBcastEnd(sfref, unit, rootdata, leafref, ops[o]));
+      for (PetscInt i = 0; i < nl * bs; i++) PetscCheck(leafdata[i] == leafref[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Bcast %" PetscInt_FMT ": leaf entry %" PetscInt_FMT " is %g but should be %g", o, i, (double)leafdata[i], (double)leafref[i]);
+
+      /* reduction, with integer values so that the sums are exact in any order, and several leaves may update the same root so MPI_REPLACE is not deterministic */
+      if (ops[o] == MPI_REPLACE) continue;
+      for (PetscInt i = 0; i < nl * bs; i++) leafdata[i] = (rank + i + it) % 11;
+      for (PetscInt i = 0; i < n * bs; i++) rootdata[i] = rootref[i] = i % 7;
+      PetscCall(PetscSFReduceBegin(sf, unit, leafdata, rootdata, ops[o]));
+      PetscCall(PetscSFReduceEnd(sf, unit, leafdata, rootdata, ops[o]));
+      PetscCall(PetscSFReduceBegin(sfref, unit, leafdata, rootref, ops[o]));
+      PetscCall(PetscSFReduceEnd(sfref, unit, leafdata, rootref, ops[o]));
+      for (PetscInt i = 0; i < n * bs; i++) PetscCheck(rootdata[i] == rootref[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Reduce %" PetscInt_FMT ": root entry %" PetscInt_FMT " is %g but should be %g", o, i, (double)rootdata[i], (double)rootref[i]);
+    }
+
+    /* fetch-and-op, the order of the updates is not deterministic so only the roots are compared */
+    PetscCall(PetscSFFetchAndOpBegin(sf, unit, rootdata, leafdata, leafupdate, MPI_SUM));
+    PetscCall(PetscSFFetchAndOpEnd(sf, unit, rootdata, leafdata, leafupdate, MPI_SUM));
+    PetscCall(PetscSFFetchAndOpBegin(sfref, unit, rootref, leafdata, leafupdateref, MPI_SUM));
+    PetscCall(PetscSFFetchAndOpEnd(sfref, unit, rootref, leafdata, leafupdateref, MPI_SUM));
+    for (PetscInt i = 0; i < n * bs; i++) PetscCheck(rootdata[i] == rootref[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "FetchAndOp: root entry %" PetscInt_FMT " is %g but should be %g", i, (double)rootdata[i], (double)rootref[i]);
+  }
+  if (view) PetscCall(PetscSFView(sf, NULL));
+  if (viewcopy) { /* another PetscSF with the same graph */
+    const PetscInt    *il;
+    const PetscSFNode *ir;
+
+    PetscCall(PetscSFGetGraph(sf, NULL, NULL, &il, &ir));
+    PetscCall(PetscSFCreate(PETSC_COMM_WORLD, &sfcopy));
+    PetscCall(PetscSFSetFromOptions(sfcopy));
+    PetscCall(PetscSFSetGraph(sfcopy, n, nleaves, (PetscInt *)il, PETSC_COPY_VALUES, (PetscSFNode *)ir, PETSC_COPY_VALUES));
+    PetscCall(PetscSFSetUp(sfcopy));
+    PetscCall(PetscSFView(sfcopy, NULL));
+    PetscCall(PetscSFDestroy(&sfcopy));
+  }
+
+  PetscCall(PetscFree6(rootdata, rootref, leafdata, leafref, leafupdate, leafupdateref));
+  if (bs > 1) PetscCallMPI(MPI_Type_free(&unit));
+  PetscCall(PetscSFDestroy(&sf));
+  PetscCall(PetscSFDestroy(&sfref));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: fused
+    nsize: 4
+    args: -sf_basic_fused_pack -contig {{0 1}} -bs {{1 3}} -niter 2
+    output_file: output/empty.out
+
+  test:
+    suffix: fused_view
+    nsize: 3
+    args: -sf_basic_fused_pack -view
+    filter: grep "rank by rank"
+
+  test:
+    suffix: partitioned
+    requires: defined(PETSC_HAVE_MPI_PARTITIONED)
+    nsize: 4
+    args: -sf_basic_partition_size {{1 7}} -sf_basic_fused_pack {{0 1}} -contig {{0 1}} -bs {{1 3}} -niter 2
+    output_file: output/empty.out
+
+  test:
+    suffix: compress
+    requires: double
+    nsize: 4
+    args: -n 200 -m 150 -sf_basic_compress_size {{1 1000}} -contig {{0 1}} -bs {{1 3}} -noise {{0 1}} -niter 2
+    output_file: output/empty.out
+
+  test:
+    suffix: compress_view
+    requires: double
+    nsize: 3
+    args: -n 200 -m 150 -sf_basic_compress_size 1000 -bs 10 -contig -view
+    filter: grep -i compress
+
+  testset:
+    requires: defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    args: -sf_type shmem
+
+    test:
+      suffix: shmem
+      nsize: {{1 4}}
+      args: -contig {{0 1}} -bs {{1 3}} -niter 2
+      output_file: output/empty.out
+
+    test:
+      suffix: shmem_noshared
+      nsize: 3
+      args: -noshared -niter 2
+      output_file: output/empty.out
+
+    test:
+      suffix: shmem_view
+      nsize: 3
+      args: -view
+      filter: grep "shared memory"
+
+  testset:
+    requires: defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    args: -sf_type hierarchical -niter 2
+    output_file: output/empty.out
+
+    test:
+      suffix: hierarchical
+      nsize: 4
+      args: -sf_hierarchical_node_size 2 -sf_hierarchical_mode {{auto node}} -contig {{0 1}} -bs {{1 3}}
+
+    test:
+      suffix: hierarchical_uneven
+      nsize: 5
+      args: -sf_hierarchical_node_size 3 -sf_hierarchical_mode node -nneigh 4
+
+    test:
+      suffix: hierarchical_flat
+      nsize: 4
+      args: -sf_hierarchical_node_size {{1 2}} -sf_hierarchical_mode {{auto flat}} -sf_hierarchical_msg_size 10
+
+    test:
+      suffix: hierarchical_shm
+      nsize: 3
+      args: -sf_hierarchical_mode node
+
+  test:
+    suffix: hierarchical_view
+    requires: defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    nsize: 4
+    args: -sf_type hierarchical -sf_hierarchical_node_size 2 -view
+    filter: grep "between nodes"
+
+  test:
+    suffix: auto
+    nsize: {{1 4}}
+    args: -sf_type auto -sf_auto_trials 2 -contig {{0 1}} -bs {{1 3}} -niter 2
+    output_file: output/empty.out
+
+  test:
+    suffix: auto_view
+    nsize: 3
+    args: -sf_type auto -sf_auto_types basic,window -view -view_copy
+    filter: grep "Autotuned" | sed -e "s/type [a-z]* among/type TYPE among/"
+
+  testset:
+    requires: double defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    nsize: 4
+    args: -noshared -n 200 -m 150 -sf_basic_compress_size 1 -bs {{1 3}} -niter 2
+    output_file: output/empty.out
+
+    test:
+      suffix: compress_shmem
+      args: -sf_type shmem
+
+    test:
+      suffix: compress_hierarchical
+      args: -sf_type hierarchical -sf_hierarchical_node_size 2 -sf_hierarchical_mode node
+
+    test:
+      suffix: compress_auto
+      args: -sf_type auto -sf_auto_trials 1
+
+TEST*/
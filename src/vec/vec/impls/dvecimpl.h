@@ -40,6 +40,8 @@ PETSC_INTERN PetscErrorCode VecMDot_Seq(Vec, PetscInt, const Vec[], PetscScalar
 PETSC_INTERN PetscErrorCode VecMTDot_Seq(Vec, PetscInt, const Vec[], PetscScalar *);
 PETSC_INTERN PetscErrorCode VecSet_Seq(Vec, PetscScalar);
 PETSC_INTERN PetscErrorCode VecMAXPY_Seq(Vec, PetscInt, const PetscScalar *, Vec *);
+PETSC_INTERN PetscErrorCode VecMAXPYNorm_Seq(Vec, PetscInt, const PetscScalar *, Vec *, PetscReal *);
+PETSC_INTERN PetscErrorCode VecOrthogonalize_Seq(Vec, PetscInt, const Vec[], PetscScalar *, PetscReal *);
 PETSC_INTERN PetscErrorCode VecAYPX_Seq(Vec, PetscScalar, Vec);
 PETSC_INTERN PetscErrorCode VecWAXPY_Seq(Vec, PetscScalar, Vec, Vec);
 PETSC_INTERN PetscErrorCode VecAXPBYPCZ_Seq(Vec, PetscScalar, PetscScalar, PetscScalar, Vec, Vec);
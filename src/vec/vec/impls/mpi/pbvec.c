@@ -543,6 +543,7 @@ static struct _VecOps DvOps = {
   PetscDesignatedInitializer(setvaluescoo, VecSetValuesCOO_MPI),
   PetscDesignatedInitializer(errorwnorm, NULL),
   PetscDesignatedInitializer(maxpby, NULL),
+  PetscDesignatedInitializer(orthogonalize, VecOrthogonalize_MPI),
 };
 
 /*
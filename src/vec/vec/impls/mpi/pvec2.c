@@ -25,6 +25,21 @@ PetscErrorCode VecMDot_MPI(Vec xin, PetscInt nv, const Vec y[], PetscScalar *z)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+PetscErrorCode VecOrthogonalize_MPI(Vec xin, PetscInt nv, const Vec y[], PetscScalar h[], PetscReal *nrm)
+{
+  PetscFunctionBegin;
+  PetscCall(VecMXDot_MPI_Default(xin, nv, y, h, xin->ops->mdot_local));
+  for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+  PetscCall(VecMAXPYNorm_Seq(xin, nv, h, (Vec *)y, nrm));
+  for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+  if (nrm) { /* the local norms are combined as in VecNorm_MPI() */
+    *nrm *= *nrm;
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, nrm, 1, MPIU_REAL, MPIU_SUM, PetscObjectComm((PetscObject)xin)));
+    *nrm = PetscSqrtReal(*nrm);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode VecMDot_MPI_GEMV(Vec xin, PetscInt nv, const Vec y[], PetscScalar *z)
 {
   PetscFunctionBegin;
@@ -83,6 +83,7 @@ PETSC_INTERN PetscErrorCode VecSetValuesCOO_MPI(Vec, const PetscScalar[], Insert
 
 PETSC_INTERN PetscErrorCode VecDot_MPI(Vec, Vec, PetscScalar *);
 PETSC_INTERN PetscErrorCode VecMDot_MPI(Vec, PetscInt, const Vec[], PetscScalar *);
+PETSC_INTERN PetscErrorCode VecOrthogonalize_MPI(Vec, PetscInt, const Vec[], PetscScalar *, PetscReal *);
 PETSC_INTERN PetscErrorCode VecTDot_MPI(Vec, Vec, PetscScalar *);
 PETSC_INTERN PetscErrorCode VecNorm_MPI(Vec, NormType, PetscReal *);
 PETSC_INTERN PetscErrorCode VecMax_MPI(Vec, PetscInt *, PetscReal *);
@@ -20,6 +20,7 @@ static PetscErrorCode VecXDot_Seq_Private(Vec xin, Vec yin, PetscScalar *z, Pets
   PetscFunctionBegin;
   PetscCall(PetscBLASIntCast(n, &bn));
   if (n > 0) PetscCall(PetscLogFlops(2.0 * n - 1));
+  PetscCall(PetscLogBytes(2.0 * n * sizeof(PetscScalar)));
   PetscCall(VecGetArrayRead(xin, &xa));
   PetscCall(VecGetArrayRead(yin, &ya));
   /* arguments ya, xa are reversed because BLAS complex conjugates the first argument, PETSc
@@ -60,6 +61,7 @@ PetscErrorCode VecScale_Seq(Vec xin, PetscScalar alpha)
 
     PetscCall(PetscBLASIntCast(xin->map->n, &bn));
     PetscCall(PetscLogFlops(bn));
+    PetscCall(PetscLogBytes(2.0 * bn * sizeof(PetscScalar)));
     PetscCall(VecGetArray(xin, &xarray));
     PetscCallBLAS("BLASscal", BLASscal_(&bn, &alpha, xarray, &one));
     PetscCall(VecRestoreArray(xin, &xarray));
@@ -79,6 +81,7 @@ PetscErrorCode VecAXPY_Seq(Vec yin, PetscScalar alpha, Vec xin)
 
     PetscCall(PetscBLASIntCast(yin->map->n, &bn));
     PetscCall(PetscLogFlops(2.0 * bn));
+    PetscCall(PetscLogBytes(3.0 * bn * sizeof(PetscScalar)));
     PetscCall(VecGetArrayRead(xin, &xarray));
     PetscCall(VecGetArray(yin, &yarray));
     PetscCallBLAS("BLASaxpy", BLASaxpy_(&bn, &alpha, xarray, &one, yarray, &one));
@@ -107,9 +110,11 @@ PetscErrorCode VecAXPBY_Seq(Vec yin, PetscScalar a, PetscScalar b, Vec xin)
     if (b == (PetscScalar)0.0) {
       for (PetscInt i = 0; i < n; ++i) yy[i] = a * xx[i];
       PetscCall(PetscLogFlops(n));
+      PetscCall(PetscLogBytes(2.0 * n * sizeof(PetscScalar)));
     } else {
       for (PetscInt i = 0; i < n; ++i) yy[i] = a * xx[i] + b * yy[i];
       PetscCall(PetscLogFlops(3.0 * n));
+      PetscCall(PetscLogBytes(3.0 * n * sizeof(PetscScalar)));
     }
     PetscCall(VecRestoreArrayRead(xin, &xx));
     PetscCall(VecRestoreArray(yin, &yy));
@@ -143,5 +148,6 @@ PetscErrorCode VecAXPBYPCZ_Seq(Vec zin, PetscScalar alpha, PetscScalar beta, Pet
   PetscCall(VecRestoreArrayRead(yin, &yy));
   PetscCall(VecRestoreArray(zin, &zz));
   PetscCall(PetscLogFlops(flops));
+  PetscCall(PetscLogBytes((gamma == (PetscScalar)0.0 ? 3.0 : 4.0) * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
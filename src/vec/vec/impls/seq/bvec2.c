@@ -22,6 +22,7 @@ static PetscErrorCode VecPointwiseApply_Seq(Vec win, Vec xin, Vec yin, PetscScal
   PetscCall(VecRestoreArrayRead(yin, (const PetscScalar **)&yy));
   PetscCall(VecRestoreArray(win, &ww));
   PetscCall(PetscLogFlops(n));
+  PetscCall(PetscLogBytes(3.0 * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -93,6 +94,7 @@ PetscErrorCode VecPointwiseMult_Seq(Vec win, Vec xin, Vec yin)
   PetscCall(VecRestoreArrayRead(yin, (const PetscScalar **)&yy));
   PetscCall(VecRestoreArray(win, &ww));
   PetscCall(PetscLogFlops(n));
+  PetscCall(PetscLogBytes(3.0 * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -162,6 +164,7 @@ PetscErrorCode VecCopy_Seq(Vec xin, Vec yin)
     PetscCall(PetscArraycpy(ya, xa, xin->map->n));
     PetscCall(VecRestoreArrayRead(xin, &xa));
     PetscCall(VecRestoreArrayWrite(yin, &ya));
+    PetscCall(PetscLogBytes(2.0 * xin->map->n * sizeof(PetscScalar)));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -180,6 +183,7 @@ PetscErrorCode VecSwap_Seq(Vec xin, Vec yin)
     PetscCallBLAS("BLASswap", BLASswap_(&bn, xa, &one, ya, &one));
     PetscCall(VecRestoreArray(xin, &xa));
     PetscCall(VecRestoreArray(yin, &ya));
+    PetscCall(PetscLogBytes(4.0 * bn * sizeof(PetscScalar)));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -198,6 +202,7 @@ PetscErrorCode VecNorm_Seq(Vec xin, NormType type, PetscReal *z)
 
     PetscCall(PetscBLASIntCast(n, &bn));
     PetscCall(VecGetArrayRead(xin, &xx));
+    PetscCall(PetscLogBytes(n * sizeof(PetscScalar)));
     if (type == NORM_2 || type == NORM_FROBENIUS) {
     NORM_1_AND_2_DOING_NORM_2:
       if (PetscDefined(USE_REAL___FP16)) {
@@ -803,6 +808,7 @@ static struct _VecOps DvOps = {
   PetscDesignatedInitializer(setvaluescoo, VecSetValuesCOO_Seq),
   PetscDesignatedInitializer(errorwnorm, NULL),
   PetscDesignatedInitializer(maxpby, NULL),
+  PetscDesignatedInitializer(orthogonalize, VecOrthogonalize_Seq),
 };
 
 /*
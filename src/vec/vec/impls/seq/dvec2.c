@@ -5,6 +5,126 @@
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
+/*
+  Tiled kernels of VecMDot_Seq() and VecMAXPY_Seq() for more than four vectors: they sweep x one tile at a time and apply up to
+  VEC_SEQ_MULTI_NV vectors to a tile before moving to the next one, so x is read from memory once per VEC_SEQ_MULTI_NV vectors
+  instead of once per group of four. The sums of each entry are accumulated in the same order as in the untiled kernels,
+  so the results are identical.
+*/
+#define VEC_SEQ_MULTI_TILE 512
+#define VEC_SEQ_MULTI_NV   32
+
+static void VecMDotTiled_Private(PetscInt n, const PetscScalar *x, PetscInt nv, const PetscScalar *const y[], PetscScalar z[])
+{
+  const PetscInt j_rem = n & 0x3;
+
+  for (PetscInt i = 0; i < nv; i++) z[i] = 0.0;
+  for (PetscInt start = 0, end; start < n; start = end) {
+    end = PetscMin(n, (start ? start : j_rem) + VEC_SEQ_MULTI_TILE);
+    for (PetscInt i = 0; i < nv; i++) {
+      const PetscScalar *yy  = y[i];
+      PetscScalar        sum = z[i];
+      PetscInt           j   = start;
+
+      if (!start) {
+        for (; j < j_rem; j++) sum += x[j_rem - 1 - j] * PetscConj(yy[j_rem - 1 - j]);
+      }
+      for (; j < end; j += 4) sum += x[j] * PetscConj(yy[j]) + x[j + 1] * PetscConj(yy[j + 1]) + x[j + 2] * PetscConj(yy[j + 2]) + x[j + 3] * PetscConj(yy[j + 3]);
+      z[i] = sum;
+    }
+  }
+}
+
+/* adds |a|^2 to the scaled sum of squares, the 2-norm is scale * sqrt(ssq) as in LAPACK's lassq so it neither overflows nor underflows */
+static inline void VecSumSquaresScaledAdd_Private(PetscReal a, PetscReal *scale, PetscReal *ssq)
+{
+  a = PetscAbsReal(a);
+  if (a == 0.0) return;
+  if (*scale < a) {
+    *ssq   = 1.0 + *ssq * PetscSqr(*scale / a);
+    *scale = a;
+  } else *ssq += PetscSqr(a / *scale);
+}
+
+static inline void VecSumSquaresScaled_Private(PetscInt n, const PetscScalar *x, PetscReal *scale, PetscReal *ssq)
+{
+  for (PetscInt i = 0; i < n; i++) {
+    VecSumSquaresScaledAdd_Private(PetscRealPart(x[i]), scale, ssq);
+#if defined(PETSC_USE_COMPLEX)
+    VecSumSquaresScaledAdd_Private(PetscImaginaryPart(x[i]), scale, ssq);
+#endif
+  }
+}
+
+/* the first nv & 0x3 vectors are applied together, then groups of four; if scale is given the result is added to the scaled sum of squares (scale, ssq) */
+static PetscErrorCode VecMAXPYTiled_Private(PetscInt n, PetscScalar *x, PetscInt nv, const PetscScalar alpha[], const PetscScalar *const y[], PetscReal *scale, PetscReal *ssq)
+{
+  const PetscInt j_rem = nv & 0x3;
+
+  PetscFunctionBegin;
+  for (PetscInt start = 0; start < n; start += VEC_SEQ_MULTI_TILE) {
+    PetscInt     len = PetscMin(VEC_SEQ_MULTI_TILE, n - start);
+    PetscScalar *xx  = x + start;
+
+    switch (j_rem) {
+    case 3: {
+      const PetscScalar *y0 = y[0] + start, *y1 = y[1] + start, *y2 = y[2] + start;
+
+      PetscKernelAXPY3(xx, alpha[0], alpha[1], alpha[2], y0, y1, y2, len);
+    } break;
+    case 2: {
+      const PetscScalar *y0 = y[0] + start, *y1 = y[1] + start;
+
+      PetscKernelAXPY2(xx, alpha[0], alpha[1], y0, y1, len);
+    } break;
+    case 1: {
+      const PetscScalar *y0 = y[0] + start;
+
+      PetscKernelAXPY(xx, alpha[0], y0, len);
+    } break;
+    default:
+      break;
+    }
+    for (PetscInt j = j_rem; j < nv; j += 4) {
+      const PetscScalar *y0 = y[j] + start, *y1 = y[j + 1] + start, *y2 = y[j + 2] + start, *y3 = y[j + 3] + start;
+
+      xx  = x + start;
+      len = PetscMin(VEC_SEQ_MULTI_TILE, n - start);
+      PetscKernelAXPY4(xx, alpha[j], alpha[j + 1], alpha[j + 2], alpha[j + 3], y0, y1, y2, y3, len);
+    }
+    if (scale) VecSumSquaresScaled_Private(PetscMin(VEC_SEQ_MULTI_TILE, n - start), x + start, scale, ssq);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  VecMAXPYNorm_Seq - Computes x = x + sum alpha[i] y[i] with the tiled kernel and, if nrm is not NULL, the local 2-norm of
+  the result in the same sweep, with a scaled sum of squares like BLASnrm2_()
+*/
+PetscErrorCode VecMAXPYNorm_Seq(Vec xin, PetscInt nv, const PetscScalar alpha[], Vec y[], PetscReal *nrm)
+{
+  const PetscInt     n = xin->map->n;
+  const PetscScalar *yy[VEC_SEQ_MULTI_NV];
+  PetscScalar       *xx;
+  PetscReal          scale = 0.0, ssq = 1.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogFlops(nv * 2.0 * n + (nrm ? 2.0 * n : 0.0)));
+  PetscCall(PetscLogBytes((nv + 2.0) * n * sizeof(PetscScalar)));
+  PetscCall(VecGetArray(xin, &xx));
+  /* the first chunk keeps the nv & 0x3 leading vectors so the later chunks are made of whole groups of four */
+  for (PetscInt start = 0, end; start < nv; start = end) {
+    end = PetscMin(nv, start ? start + VEC_SEQ_MULTI_NV : (nv & 0x3) + VEC_SEQ_MULTI_NV - 4);
+    for (PetscInt i = start; i < end; i++) PetscCall(VecGetArrayRead(y[i], &yy[i - start]));
+    PetscCall(VecMAXPYTiled_Private(n, xx, end - start, alpha + start, yy, nrm && end == nv ? &scale : NULL, &ssq));
+    for (PetscInt i = start; i < end; i++) PetscCall(VecRestoreArrayRead(y[i], &yy[i - start]));
+  }
+  if (!nv && nrm) VecSumSquaresScaled_Private(n, xx, &scale, &ssq);
+  PetscCall(VecRestoreArray(xin, &xx));
+  if (nrm) *nrm = scale * PetscSqrtReal(ssq);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
   #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
 PetscErrorCode VecMDot_Seq(Vec xin, PetscInt nv, const Vec yin[], PetscScalar *z)
@@ -76,6 +196,7 @@ PetscErrorCode VecMDot_Seq(Vec xin, PetscInt nv, const Vec yin[], PetscScalar *z
   }
   PetscCall(VecRestoreArrayRead(xin, &x));
   PetscCall(PetscLogFlops(PetscMax(nv * (2.0 * n - 1), 0.0)));
+  PetscCall(PetscLogBytes((nv + 1.0) * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -94,6 +215,20 @@ PetscErrorCode VecMDot_Seq(Vec xin, PetscInt nv, const Vec yin[], PetscScalar *z
     PetscFunctionReturn(PETSC_SUCCESS);
   }
   PetscCall(VecGetArrayRead(xin, &xbase));
+  if (nv > 4) {
+    const PetscScalar *ya[VEC_SEQ_MULTI_NV];
+
+    for (PetscInt start = 0, end; start < nv; start = end) {
+      end = PetscMin(nv, start + VEC_SEQ_MULTI_NV);
+      for (PetscInt k = start; k < end; k++) PetscCall(VecGetArrayRead(yin[k], &ya[k - start]));
+      VecMDotTiled_Private(n, xbase, end - start, ya, z + start);
+      for (PetscInt k = start; k < end; k++) PetscCall(VecRestoreArrayRead(yin[k], &ya[k - start]));
+    }
+    PetscCall(VecRestoreArrayRead(xin, &xbase));
+    PetscCall(PetscLogFlops(PetscMax(nv * (2.0 * n - 1), 0.0)));
+    PetscCall(PetscLogBytes((nv + 1.0) * n * sizeof(PetscScalar)));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   x = xbase;
   switch (nv_rem) {
   case 3:
@@ -294,6 +429,7 @@ PetscErrorCode VecMDot_Seq(Vec xin, PetscInt nv, const Vec yin[], PetscScalar *z
   }
   PetscCall(VecRestoreArrayRead(xin, &xbase));
   PetscCall(PetscLogFlops(PetscMax(nv * (2.0 * n - 1), 0.0)));
+  PetscCall(PetscLogBytes((nv + 1.0) * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 #endif
@@ -510,6 +646,7 @@ PetscErrorCode VecMTDot_Seq(Vec xin, PetscInt nv, const Vec yin[], PetscScalar *
   }
   PetscCall(VecRestoreArrayRead(xin, &xbase));
   PetscCall(PetscLogFlops(PetscMax(nv * (2.0 * n - 1), 0.0)));
+  PetscCall(PetscLogBytes((nv + 1.0) * n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -557,6 +694,7 @@ static PetscErrorCode VecMultiDot_Seq_GEMV(PetscBool conjugate, Vec xin, PetscIn
 
       PetscCallBLAS("BLASgemv", BLASgemv_(trans, &n, &m, &one, yarray, &lda2, xarray, &ione, &zero, z + i, &ione));
       PetscCall(PetscLogFlops(PetscMax(m * (2.0 * n - 1), 0.0)));
+      PetscCall(PetscLogBytes((m + 1.0) * n * sizeof(PetscScalar)));
     } else {
       if (nfail == 0) {
         if (conjugate) PetscCall(VecDot_Seq(xin, yin[i], z + i));
@@ -659,6 +797,7 @@ PetscErrorCode VecSet_Seq(Vec xin, PetscScalar alpha)
     for (PetscInt i = 0; i < n; i++) xx[i] = alpha;
   }
   PetscCall(VecRestoreArrayWrite(xin, &xx));
+  PetscCall(PetscLogBytes(n * sizeof(PetscScalar)));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -672,7 +811,12 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv, const PetscScalar *alpha, Vec
 #endif
 
   PetscFunctionBegin;
+  if (nv > 4) {
+    PetscCall(VecMAXPYNorm_Seq(xin, nv, alpha, y, NULL));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(PetscLogFlops(nv * 2.0 * n));
+  PetscCall(PetscLogBytes((nv + 2.0) * n * sizeof(PetscScalar)));
   PetscCall(VecGetArray(xin, &xx));
   for (PetscInt i = 0; i < j_rem; ++i) PetscCall(VecGetArrayRead(y[i], yptr + i));
   switch (j_rem) {
@@ -699,6 +843,20 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv, const PetscScalar *alpha, Vec
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+  Computes h with the local multiple dot product of the vector type, then subtracts sum h[i] y[i] from x and computes the
+  2-norm of the result in a single tiled sweep
+*/
+PetscErrorCode VecOrthogonalize_Seq(Vec xin, PetscInt nv, const Vec y[], PetscScalar h[], PetscReal *nrm)
+{
+  PetscFunctionBegin;
+  PetscUseTypeMethod(xin, mdot_local, nv, y, h);
+  for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+  PetscCall(VecMAXPYNorm_Seq(xin, nv, h, (Vec *)y, nrm));
+  for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*  y = y + sum alpha[i] x[i] */
 PetscErrorCode VecMAXPY_Seq_GEMV(Vec yin, PetscInt nv, const PetscScalar alpha[], Vec xin[])
 {
@@ -741,6 +899,7 @@ PetscErrorCode VecMAXPY_Seq_GEMV(Vec yin, PetscInt nv, const PetscScalar alpha[]
       PetscScalar  one = 1;
       PetscCallBLAS("BLASgemv", BLASgemv_("N", &n, &m, &one, xarray, &lda2, alpha + i, &incx, &one, yarray, &incy));
       PetscCall(PetscLogFlops(m * 2.0 * n));
+      PetscCall(PetscLogBytes((m + 2.0) * n * sizeof(PetscScalar)));
     } else {
       // we only allow falling back on VecAXPY once
       if (nfail++ == 0) PetscCall(VecAXPY_Seq(yin, alpha[i], xin[i]));
@@ -782,6 +941,7 @@ PetscErrorCode VecAYPX_Seq(Vec yin, PetscScalar alpha, Vec xin)
 #endif
       PetscCall(PetscLogFlops(2 * n));
     }
+    PetscCall(PetscLogBytes(3.0 * n * sizeof(PetscScalar)));
     PetscCall(VecRestoreArrayRead(xin, &xx));
     PetscCall(VecRestoreArray(yin, &yy));
   }
@@ -822,6 +982,7 @@ PetscErrorCode VecWAXPY_Seq(Vec win, PetscScalar alpha, Vec xin, Vec yin)
     for (PetscInt i = 0; i < n; i++) ww[i] = yy[i] + alpha * xx[i];
 #endif
   }
+  PetscCall(PetscLogBytes((alpha == (PetscScalar)0.0 ? 2.0 : 3.0) * n * sizeof(PetscScalar)));
   PetscCall(VecRestoreArrayRead(xin, &xx));
   PetscCall(VecRestoreArrayRead(yin, &yy));
   PetscCall(VecRestoreArray(win, &ww));
@@ -846,6 +1007,7 @@ PetscErrorCode VecMaxPointwiseDivide_Seq(Vec xin, Vec yin, PetscReal *max)
   PetscCall(VecRestoreArrayRead(xin, &xx));
   PetscCall(VecRestoreArrayRead(yin, &yy));
   PetscCall(PetscLogFlops(n));
+  PetscCall(PetscLogBytes(2.0 * n * sizeof(PetscScalar)));
   *max = m;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
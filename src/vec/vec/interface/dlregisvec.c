@@ -196,6 +196,7 @@ PetscErrorCode VecInitializePackage(void)
   PetscCall(PetscLogEventRegister("VecAXPBYCZ", VEC_CLASSID, &VEC_AXPBYPCZ));
   PetscCall(PetscLogEventRegister("VecWAXPY", VEC_CLASSID, &VEC_WAXPY));
   PetscCall(PetscLogEventRegister("VecMAXPY", VEC_CLASSID, &VEC_MAXPY));
+  PetscCall(PetscLogEventRegister("VecOrthogonalize", VEC_CLASSID, &VEC_Orthogonalize));
   PetscCall(PetscLogEventRegister("VecSwap", VEC_CLASSID, &VEC_Swap));
   PetscCall(PetscLogEventRegister("VecOps", VEC_CLASSID, &VEC_Ops));
   PetscCall(PetscLogEventRegister("VecAssemblyBegin", VEC_CLASSID, &VEC_AssemblyBegin));
@@ -1262,7 +1262,7 @@ PetscErrorCode VecMTDot(Vec x, PetscInt nv, const Vec y[], PetscScalar val[])
   Note:
   The implementation may use BLAS 2 operations when the vectors `y` have been obtained with `VecDuplicateVecs()`
 
-.seealso: [](ch_vectors), `Vec`, `VecMTDot()`, `VecDot()`, `VecDuplicateVecs()`
+.seealso: [](ch_vectors), `Vec`, `VecMTDot()`, `VecDot()`, `VecDuplicateVecs()`, `VecOrthogonalize()`
 @*/
 PetscErrorCode VecMDot(Vec x, PetscInt nv, const Vec y[], PetscScalar val[])
 {
@@ -1327,7 +1327,7 @@ PetscErrorCode VecMAXPYAsync_Private(Vec y, PetscInt nv, const PetscScalar alpha
 
   The implementation may use BLAS 2 operations when the vectors `y` have been obtained with `VecDuplicateVecs()`
 
-.seealso: [](ch_vectors), `Vec`, `VecMAXPBY()`,`VecAYPX()`, `VecWAXPY()`, `VecAXPY()`, `VecAXPBYPCZ()`, `VecAXPBY()`, `VecDuplicateVecs()`
+.seealso: [](ch_vectors), `Vec`, `VecMAXPBY()`,`VecAYPX()`, `VecWAXPY()`, `VecAXPY()`, `VecAXPBYPCZ()`, `VecAXPBY()`, `VecDuplicateVecs()`, `VecOrthogonalize()`
 @*/
 PetscErrorCode VecMAXPY(Vec y, PetscInt nv, const PetscScalar alpha[], Vec x[])
 {
@@ -1406,6 +1406,77 @@ PetscErrorCode VecMAXPBY(Vec y, PetscInt nv, const PetscScalar alpha[], PetscSca
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  VecOrthogonalize - Orthogonalizes a vector against a set of vectors with one step of classical Gram-Schmidt,
+  computing `h[i] = (x, y[i])` and then `x = x - sum h[i] y[i]`
+
+  Collective
+
+  Input Parameters:
++ x  - the vector to orthogonalize
+. nv - number of vectors
+- y  - array of vectors, usually orthonormal
+
+  Output Parameters:
++ h   - array of the dot products computed before `x` is updated (does not allocate the array)
+- nrm - the 2-norm of `x` after the update, pass `NULL` if it is not needed
+
+  Level: intermediate
+
+  Notes:
+  `x` cannot be any of the `y` vectors.
+
+  The dot products are those of `VecMDot()`. The implementations of `VECSEQ` and `VECMPI` apply the update and compute the norm
+  in one sweep over `x`, tiled so that `x` is read from memory once for up to 32 vectors `y`, which saves one pass over the vectors
+  compared with `VecMDot()` followed by `VecMAXPY()` and `VecNorm()`. The local norm is accumulated as a scaled sum of squares, as the BLAS
+  routine nrm2 does, so squaring the entries does not overflow or underflow.
+
+  This is used by `KSPGMRESClassicalGramSchmidtOrthogonalization()`, the default orthogonalization of `KSPGMRES`, `KSPFGMRES`,
+  `KSPLGMRES` and `KSPDGMRES`, and by `KSPGCRODR` to orthogonalize against its recycled subspace.
+
+.seealso: [](ch_vectors), `Vec`, `VecMDot()`, `VecMAXPY()`, `VecNorm()`, `KSPGMRESClassicalGramSchmidtOrthogonalization()`
+@*/
+PetscErrorCode VecOrthogonalize(Vec x, PetscInt nv, const Vec y[], PetscScalar h[], PetscReal *nrm)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(x, VEC_CLASSID, 1);
+  PetscValidType(x, 1);
+  VecCheckAssembled(x);
+  PetscValidLogicalCollectiveInt(x, nv, 2);
+  PetscCall(VecSetErrorIfLocked(x, 1));
+  PetscCheck(nv >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of vectors (given %" PetscInt_FMT ") cannot be negative", nv);
+  if (nv) {
+    PetscAssertPointer(y, 3);
+    PetscAssertPointer(h, 4);
+  }
+  if (nrm) PetscAssertPointer(nrm, 5);
+  /* the fused kernels of VECSEQ and VECMPI work on the host array, vectors whose entries live on a device use their own kernels */
+  if (!x->ops->orthogonalize || !nv || PetscOffloadDevice(x->offloadmask) || x->offloadmask == PETSC_OFFLOAD_KOKKOS) {
+    PetscCall(VecMDot(x, nv, y, h));
+    for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+    PetscCall(VecMAXPY(x, nv, h, (Vec *)y));
+    for (PetscInt i = 0; i < nv; i++) h[i] = -h[i];
+    if (nrm) PetscCall(VecNorm(x, NORM_2, nrm));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (PetscInt i = 0; i < nv; ++i) {
+    PetscValidHeaderSpecific(y[i], VEC_CLASSID, 3);
+    PetscValidType(y[i], 3);
+    PetscCheckSameTypeAndComm(x, 1, y[i], 3);
+    VecCheckSameSize(x, 1, y[i], 3);
+    PetscCheck(x != y[i], PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Array of vectors 'y' cannot contain x, found y[%" PetscInt_FMT "] == x", i);
+    VecCheckAssembled(y[i]);
+    PetscCall(VecLockReadPush(y[i]));
+  }
+  PetscCall(PetscLogEventBegin(VEC_Orthogonalize, x, *y, 0, 0));
+  PetscUseTypeMethod(x, orthogonalize, nv, y, h, nrm);
+  PetscCall(PetscLogEventEnd(VEC_Orthogonalize, x, *y, 0, 0));
+  PetscCall(PetscObjectStateIncrease((PetscObject)x));
+  if (nrm) PetscCall(PetscObjectComposedDataSetReal((PetscObject)x, NormIds[NORM_2], *nrm));
+  for (PetscInt i = 0; i < nv; ++i) PetscCall(VecLockReadPop(y[i]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   VecConcatenate - Creates a new vector that is a vertical concatenation of all the given array of vectors
   in the order they appear in the array. The concatenated vector resides on the same
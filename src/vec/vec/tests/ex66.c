@@ -0,0 +1,117 @@
+static char help[] = "Tests the tiled VecMDot() and VecMAXPY() for many vectors and VecOrthogonalize().\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckEqual(Vec x, Vec y, const char *op)
+{
+  PetscBool equal;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecEqual(x, y, &equal));
+  PetscCheck(equal, PetscObjectComm((PetscObject)x), PETSC_ERR_PLIB, "%s differs from the untiled kernels", op);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Vec         x, w, r, *y;
+  PetscInt    n = 1027, nv = 11;
+  PetscBool   dup = PETSC_FALSE;
+  PetscScalar *h, *hr;
+  PetscReal   nrm, nrmr, scale = 1.0;
+  PetscRandom rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nv", &nv, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-duplicate_vecs", &dup, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-scale", &scale, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(VecCreate(PETSC_COMM_WORLD, &x));
+  PetscCall(VecSetSizes(x, n, PETSC_DECIDE));
+  PetscCall(VecSetFromOptions(x));
+  PetscCall(VecSetRandom(x, rand));
+  /* with a tiny scale the squares of the entries underflow, VecOrthogonalize() must still compute the norm */
+  PetscCall(VecScale(x, scale));
+  PetscCall(VecDuplicate(x, &w));
+  PetscCall(VecDuplicate(x, &r));
+  /* vectors duplicated one by one are not contiguous in memory, so VecMDot() does not use BLAS 2 */
+  if (dup) PetscCall(VecDuplicateVecs(x, nv, &y));
+  else {
+    PetscCall(PetscMalloc1(nv, &y));
+    for (PetscInt i = 0; i < nv; i++) PetscCall(VecDuplicate(x, &y[i]));
+  }
+  for (PetscInt i = 0; i < nv; i++) PetscCall(VecSetRandom(y[i], rand));
+  PetscCall(PetscMalloc2(nv, &h, nv, &hr));
+
+  /*
+    the tiled kernels accumulate in the same order as the untiled ones applied to the leading nv % 4 vectors, then groups of four;
+    with BLAS 2 for contiguous vectors the dot products depend on the BLAS implementation
+  */
+  if (!dup) {
+    PetscCall(VecMDot(x, nv, y, h));
+    for (PetscInt i = 0, m = nv % 4 ? nv % 4 : 4; i < nv; i += m, m = 4) PetscCall(VecMDot(x, m, y + i, hr + i));
+    for (PetscInt i = 0; i < nv; i++) PetscCheck(h[i] == hr[i], PETSC_COMM_WORLD, PETSC_ERR_PLIB, "VecMDot() differs from the untiled kernels for vector %" PetscInt_FMT, i);
+  }
+
+  for (PetscInt i = 0; i < nv; i++) h[i] = 1.0 / (i + 1.0);
+  PetscCall(VecCopy(x, w));
+  PetscCall(VecCopy(x, r));
+  PetscCall(VecMAXPY(w, nv, h, y));
+  for (PetscInt i = 0, m = nv % 4 ? nv % 4 : 4; i < nv; i += m, m = 4) PetscCall(VecMAXPY(r, m, h + i, y + i));
+  PetscCall(CheckEqual(w, r, "VecMAXPY()"));
+
+  /* VecOrthogonalize() gives the same results as VecMDot() followed by VecMAXPY(), and the norm of the result */
+  PetscCall(VecCopy(x, w));
+  PetscCall(VecCopy(x, r));
+  PetscCall(VecOrthogonalize(w, nv, y, h, &nrm));
+  PetscCall(VecMDot(r, nv, y, hr));
+  for (PetscInt i = 0; i < nv; i++) {
+    PetscCheck(h[i] == hr[i], PETSC_COMM_WORLD, PETSC_ERR_PLIB, "VecOrthogonalize() computes a different dot product for vector %" PetscInt_FMT, i);
+    hr[i] = -hr[i];
+  }
+  PetscCall(VecMAXPY(r, nv, hr, y));
+  PetscCall(CheckEqual(w, r, "VecOrthogonalize()"));
+  PetscCall(VecScale(r, 1.0 / scale));
+  PetscCall(VecNorm(r, NORM_2, &nrmr));
+  nrmr *= scale;
+  PetscCheck(PetscAbsReal(nrm - nrmr) <= 100 * PETSC_MACHINE_EPSILON * nrmr, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "VecOrthogonalize() norm %g instead of %g", (double)nrm, (double)nrmr);
+  PetscCall(VecOrthogonalize(w, nv, y, h, NULL));
+
+  PetscCall(PetscFree2(h, hr));
+  if (dup) PetscCall(VecDestroyVecs(nv, &y));
+  else {
+    for (PetscInt i = 0; i < nv; i++) PetscCall(VecDestroy(&y[i]));
+    PetscCall(PetscFree(y));
+  }
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&w));
+  PetscCall(VecDestroy(&r));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 1
+    nsize: {{1 2}}
+    args: -n {{3 1027 2050}} -nv {{5 8 39}} -vec_mdot_use_gemv 0
+    output_file: output/empty.out
+
+  test:
+    suffix: duplicate_vecs
+    nsize: {{1 2}}
+    args: -duplicate_vecs -nv {{6 40}}
+    output_file: output/empty.out
+
+  test:
+    suffix: underflow
+    requires: double
+    args: -scale 1e-170 -vec_mdot_use_gemv 0
+    output_file: output/empty.out
+
+TEST*/